@@ -9,6 +9,7 @@
 #include <cstring>
 #include <cstdio>
 #include <csetjmp>
+#include <cstdarg>
 #include <setjmp.h> /* Some compilers do not want to play by the standard, specifically ARM CC */
 #include <stdio.h> /* Some compilers do not want to play by the standard, specifically ARM CC */
 #define C_LINKAGE "C"
@@ -19,6 +20,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <setjmp.h>
+#include <stdarg.h>
 #include <wchar.h>
 #define C_LINKAGE
 #define C_LINKAGE_PREFIX
@@ -30,6 +32,7 @@
 #include "c_logging/logger.h"
 
 #if defined _MSC_VER
+#include <intrin.h> /* _ReadWriteBarrier, for CTEST_CLOBBER_MEMORY */
 #include "ctest_windows.h"
 #define CTEST_USE_STDINT
 #if _MSC_VER < 1900
@@ -81,7 +84,8 @@ typedef void(*TEST_FUNC)(void);
     CTEST_TEST_SUITE_INITIALIZE, \
     CTEST_TEST_SUITE_CLEANUP, \
     CTEST_TEST_FUNCTION_INITIALIZE, \
-    CTEST_TEST_FUNCTION_CLEANUP
+    CTEST_TEST_FUNCTION_CLEANUP, \
+    CTEST_BENCHMARK_FUNCTION
 
 MU_DEFINE_ENUM(CTEST_FUNCTION_TYPE, CTEST_FUNCTION_TYPE_VALUES)
 
@@ -89,10 +93,16 @@ MU_DEFINE_ENUM(CTEST_FUNCTION_TYPE, CTEST_FUNCTION_TYPE_VALUES)
     TEST_SUCCESS, \
     TEST_FAILED, \
     TEST_NOT_EXECUTED, \
-    TEST_SKIPPED_FILTER
+    TEST_SKIPPED_FILTER, \
+    TEST_SKIPPED_SHARD
 
 MU_DEFINE_ENUM(TEST_RESULT, TEST_RESULT_VALUES)
 
+/* Flags carried by a TEST_FUNCTION_DATA entry. On the CTEST_BEGIN_SUITE entry they apply to the whole suite. */
+#define CTEST_FUNCTION_FLAG_NONE                0x00
+#define CTEST_FUNCTION_FLAG_NOT_THREAD_SAFE     0x01 /* never run on a worker thread concurrently with other tests */
+#define CTEST_FUNCTION_FLAG_SECTION_REGISTRATION 0x02 /* on the CTEST_END_SUITE entry: the entries of the suite are in the ctest_test_data section */
+
 typedef struct TEST_FUNCTION_DATA_TAG
 {
     const TEST_FUNC TestFunction;
@@ -100,12 +110,32 @@ typedef struct TEST_FUNCTION_DATA_TAG
     const void* const NextTestFunctionData;
     TEST_RESULT* const TestResult;
     const CTEST_FUNCTION_TYPE FunctionType;
+    const unsigned int Flags;
 } TEST_FUNCTION_DATA;
 
+/* a suite in the suites of the process, see CTEST_END_TEST_SUITE and ctest_run_all */
+typedef struct CTEST_SUITE_REGISTRATION_TAG
+{
+    const TEST_FUNCTION_DATA* test_list_head;
+    const char* test_suite_name;
+    struct CTEST_SUITE_REGISTRATION_TAG* next;
+} CTEST_SUITE_REGISTRATION;
+
 #define EXPAND_1(A) A
 
-extern const TEST_FUNCTION_DATA* g_CurrentTestFunction;
-extern jmp_buf g_ExceptionJump;
+/*g_CurrentTestFunction and g_ExceptionJump are per thread so that tests running on parallel worker threads (see CTEST_WORKER_THREADS) only ever unwind their own worker*/
+#if defined _MSC_VER
+#define CTEST_THREAD_LOCAL __declspec(thread)
+#elif defined __GNUC__ || defined __clang__
+#define CTEST_THREAD_LOCAL __thread
+#elif defined __cplusplus
+#define CTEST_THREAD_LOCAL thread_local
+#else
+#define CTEST_THREAD_LOCAL _Thread_local
+#endif
+
+extern CTEST_THREAD_LOCAL const TEST_FUNCTION_DATA* g_CurrentTestFunction;
+extern CTEST_THREAD_LOCAL jmp_buf g_ExceptionJump;
 
 #ifndef CTEST_CUSTOM_TEST_SUITE_INITIALIZE_CODE
 #define CTEST_CUSTOM_TEST_SUITE_INITIALIZE_CODE(funcName)
@@ -127,18 +157,108 @@ extern jmp_buf g_ExceptionJump;
 #define CTEST_CUSTOM_TEST_FUNCTION_CODE(funcName)
 #endif
 
-#define CTEST_BEGIN_TEST_SUITE(testSuiteName) \
+/* By default the entries of a suite (tests and fixtures) are chained into a list by the numbers __COUNTER__ gives their names, which
+limits a suite to the numbers MU_INC/MU_DEC support. Defining CTEST_USE_SECTION_REGISTRATION before including ctest.h places the
+entries in the ctest_test_data section instead (GCC/clang, ELF targets only), one contiguous array that RunTests reads through the
+__start_/__stop_ symbols of the section, without limit on the number of tests. Each suite (translation unit) chooses on its own. */
+#if defined CTEST_USE_SECTION_REGISTRATION && (defined __GNUC__ || defined __clang__) && defined __ELF__
+#define CTEST_REGISTRATION_USES_SECTION
+#endif
+
+#if defined CTEST_REGISTRATION_USES_SECTION
+/* the entries point to the CTEST_BEGIN_SUITE entry of their suite, which tells the suites apart in the shared section */
+#define CTEST_DEFINE_TEST_FUNCTION_DATA(testFunction, testFunctionName, testResult, functionType, flags) \
+    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, __COUNTER__) __attribute__((used, section("ctest_test_data"), aligned(__alignof__(TEST_FUNCTION_DATA)))) = \
+{ testFunction, testFunctionName, &TestSuiteBeginData, testResult, functionType, flags };
+
+#define CTEST_DEFINE_TEST_SUITE_BEGIN_DATA(flags) \
+    static const TEST_FUNCTION_DATA TestSuiteBeginData = { NULL, NULL, NULL, NULL, CTEST_BEGIN_SUITE, flags };
+
+#define CTEST_DEFINE_TEST_LIST_HEAD(testSuiteName) \
+    C_LINKAGE_PREFIX const TEST_FUNCTION_DATA TestListHead_##testSuiteName = { NULL, NULL, &TestSuiteBeginData, NULL, CTEST_END_SUITE, CTEST_FUNCTION_FLAG_SECTION_REGISTRATION };
+#else
+/* each entry points to the previous one, the list ends with the CTEST_BEGIN_SUITE entry */
+#define CTEST_DEFINE_TEST_FUNCTION_DATA(testFunction, testFunctionName, testResult, functionType, flags) \
+    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, MU_INC(__COUNTER__)) = \
+{ testFunction, testFunctionName, &MU_C2(TestFunctionData, MU_DEC(MU_DEC(__COUNTER__))), testResult, functionType, flags };
+
+#define CTEST_DEFINE_TEST_SUITE_BEGIN_DATA(flags) \
+    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, __COUNTER__) = { NULL, NULL, NULL, NULL, CTEST_BEGIN_SUITE, flags };
+
+#define CTEST_DEFINE_TEST_LIST_HEAD(testSuiteName) \
+    C_LINKAGE_PREFIX const TEST_FUNCTION_DATA TestListHead_##testSuiteName = { NULL, NULL, &MU_C2(TestFunctionData, MU_DEC(__COUNTER__)), NULL, CTEST_END_SUITE, CTEST_FUNCTION_FLAG_NONE };
+#endif
+
+/* The manifest (GCC/clang, ELF targets): each suite, test, benchmark and parameterized case adds a string to the ctest_manifest section,
+so tools list the tests of an executable without running it (readelf -p ctest_manifest). The fields of a string are separated by tabs:
+    suite <file> <suite>
+    test <file> <test>
+    benchmark <file> <benchmark>
+    case <file> <test> <parameterized test> <case>
+<file> is the translation unit (__BASE_FILE__), it tells the suite of a test since a translation unit has one suite. */
+#if (defined __GNUC__ || defined __clang__) && defined __ELF__
+#define CTEST_DEFINE_MANIFEST_ENTRY(entryName, kind, fields) \
+    static const char entryName[] __attribute__((used, section("ctest_manifest"))) = kind "\t" __BASE_FILE__ "\t" fields;
+#else
+#define CTEST_DEFINE_MANIFEST_ENTRY(entryName, kind, fields)
+#endif
+
+#define CTEST_BEGIN_TEST_SUITE_WITH_FLAGS(testSuiteName, flags) \
     C_LINKAGE_PREFIX const int TestListHead_Begin_##testSuiteName = 0; \
-    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, __COUNTER__) = { NULL, NULL, NULL, NULL, CTEST_BEGIN_SUITE }; \
+    CTEST_DEFINE_MANIFEST_ENTRY(CTestManifestSuite, "suite", #testSuiteName) \
+    CTEST_DEFINE_TEST_SUITE_BEGIN_DATA(flags) \
+
+#define CTEST_BEGIN_TEST_SUITE(testSuiteName) \
+    CTEST_BEGIN_TEST_SUITE_WITH_FLAGS(testSuiteName, CTEST_FUNCTION_FLAG_NONE)
+
+/* A suite that uses shared state without synchronization opts out of parallel execution as a whole */
+#define CTEST_BEGIN_TEST_SUITE_NOT_THREAD_SAFE(testSuiteName) \
+    CTEST_BEGIN_TEST_SUITE_WITH_FLAGS(testSuiteName, CTEST_FUNCTION_FLAG_NOT_THREAD_SAFE)
+
+#define CTEST_FUNCTION_WITH_FLAGS(funcName, flags) \
+    static void funcName(void); \
+    static TEST_RESULT funcName##_TestResult; \
+    CTEST_DEFINE_MANIFEST_ENTRY(funcName##_ManifestEntry, "test", #funcName) \
+    CTEST_DEFINE_TEST_FUNCTION_DATA(funcName, #funcName, &funcName##_TestResult, CTEST_TEST_FUNCTION, flags) \
+    CTEST_CUSTOM_TEST_FUNCTION_CODE(funcName) \
+    static void funcName(void)
 
 #define CTEST_FUNCTION(funcName) \
+    CTEST_FUNCTION_WITH_FLAGS(funcName, CTEST_FUNCTION_FLAG_NONE)
+
+/* A test that cannot run concurrently with other tests; in parallel mode it runs on the calling thread after the parallel tests */
+#define CTEST_FUNCTION_NOT_THREAD_SAFE(funcName) \
+    CTEST_FUNCTION_WITH_FLAGS(funcName, CTEST_FUNCTION_FLAG_NOT_THREAD_SAFE)
+
+/* A benchmark: RunTests calls the body in a timed loop, calibrating the number of iterations so that the measurement lasts at least
+CTEST_BENCHMARK_MIN_TIME_MS, and logs mean, median, standard deviation and minimum ns per iteration. TEST_FUNCTION_INITIALIZE and
+TEST_FUNCTION_CLEANUP run once around the whole measurement, a failing assert fails the benchmark. Benchmarks never run concurrently
+with other tests on worker threads. */
+#define CTEST_BENCHMARK(funcName) \
     static void funcName(void); \
     static TEST_RESULT funcName##_TestResult; \
-    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, MU_INC(__COUNTER__)) = \
-{ funcName, #funcName, &MU_C2(TestFunctionData, MU_DEC(MU_DEC(__COUNTER__))), &funcName##_TestResult, CTEST_TEST_FUNCTION }; \
+    CTEST_DEFINE_MANIFEST_ENTRY(funcName##_ManifestEntry, "benchmark", #funcName) \
+    CTEST_DEFINE_TEST_FUNCTION_DATA(funcName, #funcName, &funcName##_TestResult, CTEST_BENCHMARK_FUNCTION, CTEST_FUNCTION_FLAG_NOT_THREAD_SAFE) \
     CTEST_CUSTOM_TEST_FUNCTION_CODE(funcName) \
     static void funcName(void)
 
+/* CTEST_DO_NOT_OPTIMIZE(variable): the compiler has to assume that variable (an lvalue) is read, so the computation producing it is
+not removed from a benchmark body. CTEST_CLOBBER_MEMORY(): the compiler has to assume that all memory is read and written, so
+stores are not removed or moved across it. Both emit no instruction with GCC and clang. */
+extern C_LINKAGE void ctest_benchmark_use_pointer(const volatile void* pointer);
+
+#if defined __GNUC__ || defined __clang__
+#define CTEST_DO_NOT_OPTIMIZE(variable) __asm__ volatile("" : : "g"(&(variable)) : "memory")
+#define CTEST_CLOBBER_MEMORY() __asm__ volatile("" : : : "memory")
+#else
+#define CTEST_DO_NOT_OPTIMIZE(variable) ctest_benchmark_use_pointer((const volatile void*)&(variable))
+#if defined _MSC_VER
+#define CTEST_CLOBBER_MEMORY() _ReadWriteBarrier()
+#else
+#define CTEST_CLOBBER_MEMORY() ctest_benchmark_use_pointer(NULL)
+#endif
+#endif
+
 /*
  * CTEST_PARAMETERIZED_TEST_FUNCTION - A macro for defining parameterized test functions
  *
@@ -185,8 +305,13 @@ extern jmp_buf g_ExceptionJump;
 /* Indirection to force full expansion of funcName before CTEST_FUNCTION applies ## */
 #define CTEST_PARAMETERIZED_TEST_CALL_CTEST_FUNCTION(funcName) CTEST_FUNCTION(funcName)
 
+/* Indirection to force full expansion of funcName before the manifest entry applies ## and #, the case tells tools which test it belongs to */
+#define CTEST_PARAMETERIZED_TEST_DEFINE_MANIFEST_CASE(funcName, base_name, suffix) \
+    CTEST_DEFINE_MANIFEST_ENTRY(MU_C2(funcName, _ManifestCase), "case", MU_TOSTRING(funcName) "\t" #base_name "\t" #suffix)
+
 /* Generate a single CTEST_FUNCTION wrapper for one CASE */
 #define CTEST_PARAMETERIZED_TEST_WRAPPER_IMPL(base_name, values, suffix) \
+    CTEST_PARAMETERIZED_TEST_DEFINE_MANIFEST_CASE(MU_C3(base_name, _, suffix), base_name, suffix) \
     CTEST_PARAMETERIZED_TEST_CALL_CTEST_FUNCTION(MU_C3(base_name, _, suffix)) \
     { \
         MU_C2(base_name, _impl)(CTEST_PARAMETERIZED_TEST_STRIP_PARENS values); \
@@ -212,8 +337,7 @@ extern jmp_buf g_ExceptionJump;
 
 #define CTEST_SUITE_INITIALIZE(funcName, ...)                                                                                                           \
     static void TestSuiteInitialize(void);                                                                                                              \
-    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, MU_INC(__COUNTER__)) =                                                               \
-{ TestSuiteInitialize, "TestSuiteInitialize", &MU_C2(TestFunctionData, MU_DEC(MU_DEC(__COUNTER__))), NULL, CTEST_TEST_SUITE_INITIALIZE };        \
+    CTEST_DEFINE_TEST_FUNCTION_DATA(TestSuiteInitialize, "TestSuiteInitialize", NULL, CTEST_TEST_SUITE_INITIALIZE, CTEST_FUNCTION_FLAG_NONE)            \
     CTEST_CUSTOM_TEST_SUITE_INITIALIZE_CODE(funcName)                                                                                                   \
     static void TestSuiteInitialize_user(void);                                                                                                         \
     static void TestSuiteInitialize(void)                                                                                                               \
@@ -225,8 +349,7 @@ extern jmp_buf g_ExceptionJump;
 
 #define CTEST_SUITE_CLEANUP(funcName, ...)                                                                                                              \
     static void TestSuiteCleanup(void);                                                                                                                 \
-    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, MU_INC(__COUNTER__)) =                                                               \
-{ &TestSuiteCleanup, "TestSuiteCleanup", &MU_C2(TestFunctionData, MU_DEC(MU_DEC(__COUNTER__))), NULL, CTEST_TEST_SUITE_CLEANUP };                \
+    CTEST_DEFINE_TEST_FUNCTION_DATA(&TestSuiteCleanup, "TestSuiteCleanup", NULL, CTEST_TEST_SUITE_CLEANUP, CTEST_FUNCTION_FLAG_NONE)                    \
     CTEST_CUSTOM_TEST_SUITE_CLEANUP_CODE(funcName)                                                                                                      \
     static void TestSuiteCleanup_user(void);                                                                                                            \
     static void TestSuiteCleanup(void)                                                                                                                  \
@@ -238,8 +361,7 @@ extern jmp_buf g_ExceptionJump;
 
 #define CTEST_FUNCTION_INITIALIZE(funcName, ...)                                                                                                            \
     static void TestFunctionInitialize(void);                                                                                                               \
-    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, MU_INC(__COUNTER__)) =                                                                   \
-{ TestFunctionInitialize, "TestFunctionInitialize", &MU_C2(TestFunctionData, MU_DEC(MU_DEC(__COUNTER__))), NULL, CTEST_TEST_FUNCTION_INITIALIZE };   \
+    CTEST_DEFINE_TEST_FUNCTION_DATA(TestFunctionInitialize, "TestFunctionInitialize", NULL, CTEST_TEST_FUNCTION_INITIALIZE, CTEST_FUNCTION_FLAG_NONE)       \
     CTEST_CUSTOM_TEST_FUNCTION_INITIALIZE_CODE(funcName)                                                                                                    \
     static void TestFunctionInitialize_user(void);                                                                                                          \
     static void TestFunctionInitialize(void)                                                                                                                \
@@ -251,8 +373,7 @@ extern jmp_buf g_ExceptionJump;
 
 #define CTEST_FUNCTION_CLEANUP(funcName, ...)                                                                                                               \
     static void TestFunctionCleanup(void);                                                                                                                  \
-    static const TEST_FUNCTION_DATA MU_C2(TestFunctionData, MU_INC(__COUNTER__)) =                                                                   \
-{ &TestFunctionCleanup, "TestFunctionCleanup", &MU_C2(TestFunctionData, MU_DEC(MU_DEC(__COUNTER__))), NULL, CTEST_TEST_FUNCTION_CLEANUP };           \
+    CTEST_DEFINE_TEST_FUNCTION_DATA(&TestFunctionCleanup, "TestFunctionCleanup", NULL, CTEST_TEST_FUNCTION_CLEANUP, CTEST_FUNCTION_FLAG_NONE)               \
     CTEST_CUSTOM_TEST_FUNCTION_CLEANUP_CODE(funcName)                                                                                                       \
     static void TestFunctionCleanup_user(void);                                                                                                             \
     static void TestFunctionCleanup(void)                                                                                                                   \
@@ -262,8 +383,38 @@ extern jmp_buf g_ExceptionJump;
     }                                                                                                                                                       \
     static void TestFunctionCleanup_user(void)
 
+/* Every suite adds itself to the suites of the process (for ctest_run_all) before main runs, from a function the loader calls: a
+constructor with GCC/clang, an entry of the .CRT$XCU section with MSVC. With other compilers the suites are not registered. */
+#if defined _MSC_VER
+#pragma section(".CRT$XCU", read)
+#if defined _WIN64
+#define CTEST_SYMBOL_PREFIX ""
+#else
+#define CTEST_SYMBOL_PREFIX "_"
+#endif
+/* the linker would drop the pointer, nothing references it */
+#define CTEST_DEFINE_SUITE_REGISTRATION(testSuiteName) \
+    static CTEST_SUITE_REGISTRATION TestSuiteRegistration_##testSuiteName = { &TestListHead_##testSuiteName, #testSuiteName, NULL }; \
+    static void ctest_register_suite_##testSuiteName(void) \
+    { \
+        ctest_register_suite(&TestSuiteRegistration_##testSuiteName); \
+    } \
+    C_LINKAGE_PREFIX __declspec(allocate(".CRT$XCU")) void (*ctest_register_suite_pointer_##testSuiteName)(void) = ctest_register_suite_##testSuiteName; \
+    __pragma(comment(linker, "/include:" CTEST_SYMBOL_PREFIX "ctest_register_suite_pointer_" #testSuiteName))
+#elif defined __GNUC__ || defined __clang__
+#define CTEST_DEFINE_SUITE_REGISTRATION(testSuiteName) \
+    static CTEST_SUITE_REGISTRATION TestSuiteRegistration_##testSuiteName = { &TestListHead_##testSuiteName, #testSuiteName, NULL }; \
+    __attribute__((constructor)) static void ctest_register_suite_##testSuiteName(void) \
+    { \
+        ctest_register_suite(&TestSuiteRegistration_##testSuiteName); \
+    }
+#else
+#define CTEST_DEFINE_SUITE_REGISTRATION(testSuiteName)
+#endif
+
 #define CTEST_END_TEST_SUITE(testSuiteName) \
-    C_LINKAGE_PREFIX const TEST_FUNCTION_DATA TestListHead_##testSuiteName = { NULL, NULL, &MU_C2(TestFunctionData, MU_DEC(__COUNTER__)), NULL, CTEST_END_SUITE }; \
+    CTEST_DEFINE_TEST_LIST_HEAD(testSuiteName) \
+    CTEST_DEFINE_SUITE_REGISTRATION(testSuiteName) \
 
 /* PRINT_MY_ARG macros for accumulating failed test count
    The counting goes in reverse order (last arg is 1, second to last is 2, etc.)
@@ -325,33 +476,44 @@ typedef unsigned long unsigned_long;
 
 
 extern C_LINKAGE char* ctest_sprintf_char(const char* format, ...);
+extern C_LINKAGE char* ctest_vsprintf_char(const char* format, va_list va);
 extern C_LINKAGE void ctest_sprintf_free(char* string);
 
 #define CTEST_DECLARE_EQUALITY_ASSERTION_FUNCTIONS_FOR_TYPE(type) \
-extern C_LINKAGE void MU_C2(type,_AssertAreEqual)(type left, type right, char* ctest_message, int line_no); \
-extern C_LINKAGE void MU_C2(type,_AssertAreNotEqual)(type left, type right, char* ctest_message, int line_no);
+extern C_LINKAGE void MU_C2(type,_AssertAreEqual)(type left, type right, int line_no, const char* format, ...); \
+extern C_LINKAGE void MU_C2(type,_AssertAreNotEqual)(type left, type right, int line_no, const char* format, ...);
 
+/* the values and the optional message (format and the variable arguments of the enclosing function) are only formatted when the
+assert fails, a passing assert costs just the _Compare call */
 #define CTEST_EQUALITY_ASSERT_IMPL_FOR_TYPE(type, check_for_is_equal, line_no) \
-    char expectedString[1024]; \
-    char actualString[1024]; \
-    MU_C2(type,_ToString)(expectedString, sizeof(expectedString), left); \
-    MU_C2(type,_ToString)(actualString, sizeof(actualString), right); \
     if (!!MU_C2(type,_Compare)(left, right) == check_for_is_equal) \
     { \
+        char expectedString[1024]; \
+        char actualString[1024]; \
+        char* ctest_message = NULL; \
+        if (format != NULL) \
+        { \
+            va_list va; \
+            va_start(va, format); \
+            ctest_message = ctest_vsprintf_char(format, va); \
+            va_end(va); \
+        } \
+        MU_C2(type,_ToString)(expectedString, sizeof(expectedString), left); \
+        MU_C2(type,_ToString)(actualString, sizeof(actualString), right); \
         LogError("  Assert failed in line %d %s Expected: %s, Actual: %s\n", line_no, (ctest_message == NULL) ? "" : ctest_message, expectedString, actualString); \
+        ctest_events_assert_failed(line_no, NULL, expectedString, actualString, ctest_message); \
         ctest_sprintf_free(ctest_message); \
         if (g_CurrentTestFunction != NULL) *g_CurrentTestFunction->TestResult = TEST_FAILED; \
         do_jump(&g_ExceptionJump, expectedString, actualString); \
-    } \
-    ctest_sprintf_free(ctest_message);
+    }
 
 #define CTEST_DEFINE_EQUALITY_ASSERTION_FUNCTIONS_FOR_TYPE(type, qualifier) \
 MU_SUPPRESS_WARNING(4505) /* warning C4505: 'xxx_AssertAreNotEqual': unreferenced local function has been removed */ \
-qualifier void MU_C2(type,_AssertAreEqual)(type left, type right, char* ctest_message, int line_no) \
+qualifier void MU_C2(type,_AssertAreEqual)(type left, type right, int line_no, const char* format, ...) \
 { \
     CTEST_EQUALITY_ASSERT_IMPL_FOR_TYPE(type, true, line_no) \
 } \
-qualifier void MU_C2(type,_AssertAreNotEqual)(type left, type right, char* ctest_message, int line_no) \
+qualifier void MU_C2(type,_AssertAreNotEqual)(type left, type right, int line_no, const char* format, ...) \
 { \
     CTEST_EQUALITY_ASSERT_IMPL_FOR_TYPE(type, false, line_no) \
 }
@@ -384,8 +546,31 @@ static void MU_C2(toStringType,_ToString)(char* string, size_t bufferSize, cType
 #define GET_MESSAGE(...) \
     MU_IF(MU_COUNT_ARG(__VA_ARGS__), GET_MESSAGE_FORMATTED, GET_MESSAGE_FORMATTED_EMPTY)(__VA_ARGS__)
 
+// these macros pass the optional message unformatted (format, ...) to the equality assert functions, which format it only on failure
+// CHECK_MESSAGE_FORMAT keeps the compiler checking the arguments against the format
+#define CHECK_MESSAGE_FORMAT_FORMATTED(format, ...) \
+    MU_IF(MU_COUNT_ARG(__VA_ARGS__), (void)(0 && printf(format, __VA_ARGS__)), (void)0)
+
+#define CHECK_MESSAGE_FORMAT_EMPTY(...) \
+    (void)0
+
+#define CHECK_MESSAGE_FORMAT(...) \
+    MU_IF(MU_COUNT_ARG(__VA_ARGS__), CHECK_MESSAGE_FORMAT_FORMATTED, CHECK_MESSAGE_FORMAT_EMPTY)(__VA_ARGS__)
+
+#define GET_MESSAGE_ARGS_FORMATTED(...) \
+    __VA_ARGS__
+
+#define GET_MESSAGE_ARGS_EMPTY(...) \
+    NULL
+
+#define GET_MESSAGE_ARGS(...) \
+    MU_IF(MU_COUNT_ARG(__VA_ARGS__), GET_MESSAGE_ARGS_FORMATTED, GET_MESSAGE_ARGS_EMPTY)(__VA_ARGS__)
+
 void do_jump(jmp_buf *exceptionJump, const volatile void* expected, const volatile void* actual);
 
+/* writes the assert_failed event to the event stream (--ctest_event_fd), the arguments that do not apply are NULL */
+extern C_LINKAGE void ctest_events_assert_failed(int line_no, const char* expression, const char* expected, const char* actual, const char* message);
+
 /*CTEST_ASSERT_ARE_EQUAL do a cast to (type) to remove type qualifiers from the arguments.*/
 /*all nice except structs. Structs cannot be cast (at all). See C23's chapter 6.5.5 (basically needs to be scalar or void type).*/
 /*structs are obviously not scalars or void, so the cast needs to be remove from the casts (type)(A)*/
@@ -400,15 +585,15 @@ Note: C++ as opposed to C, supports casting a struct to its own type*/
 #define CTEST_ASSERT_ARE_EQUAL(type, A, B, ...) \
 do \
 { \
-    char* ctest_message = GET_MESSAGE(__VA_ARGS__); \
-    MU_C2(type,_AssertAreEqual)(CTEST_TYPE_CAST(type)(A), CTEST_TYPE_CAST(type)(B), ctest_message, __LINE__); \
+    CHECK_MESSAGE_FORMAT(__VA_ARGS__); \
+    MU_C2(type,_AssertAreEqual)(CTEST_TYPE_CAST(type)(A), CTEST_TYPE_CAST(type)(B), __LINE__, GET_MESSAGE_ARGS(__VA_ARGS__)); \
 } while (0)
 
 #define CTEST_ASSERT_ARE_NOT_EQUAL(type, A, B, ...) \
 do \
 { \
-    char* ctest_message = GET_MESSAGE(__VA_ARGS__); \
-    MU_C2(type,_AssertAreNotEqual)(CTEST_TYPE_CAST(type)(A), CTEST_TYPE_CAST(type)(B), ctest_message, __LINE__); \
+    CHECK_MESSAGE_FORMAT(__VA_ARGS__); \
+    MU_C2(type,_AssertAreNotEqual)(CTEST_TYPE_CAST(type)(A), CTEST_TYPE_CAST(type)(B), __LINE__, GET_MESSAGE_ARGS(__VA_ARGS__)); \
 } while (0)
 
 #define CTEST_ASSERT_IS_NULL(value, ...) \
@@ -419,6 +604,7 @@ do \
     { \
         char* ctest_message = GET_MESSAGE(__VA_ARGS__); \
         LogError("  Assert failed in line %d: NULL expected, actual: 0x%p. %s\n", __LINE__, copy_of_value, (ctest_message == NULL) ? "" : ctest_message); \
+        ctest_events_assert_failed(__LINE__, #value, "NULL", "non-NULL", ctest_message); \
         ctest_sprintf_free(ctest_message); \
         if (g_CurrentTestFunction != NULL) *g_CurrentTestFunction->TestResult = TEST_FAILED; \
         do_jump(&g_ExceptionJump, "expected it to be NULL (actual is the value)", copy_of_value); \
@@ -434,6 +620,7 @@ do \
     { \
         char* ctest_message = GET_MESSAGE(__VA_ARGS__); \
         LogError("  Assert failed in line %d: non-NULL expected. %s\n", __LINE__, (ctest_message == NULL) ? "" : ctest_message); \
+        ctest_events_assert_failed(__LINE__, #value, "non-NULL", "NULL", ctest_message); \
         ctest_sprintf_free(ctest_message); \
         if (g_CurrentTestFunction != NULL) *g_CurrentTestFunction->TestResult = TEST_FAILED; \
         do_jump(&g_ExceptionJump, "expected it not to be NULL (actual is value)", copy_of_value); \
@@ -447,6 +634,7 @@ do { \
     { \
         char* ctest_message = GET_MESSAGE(__VA_ARGS__); \
         LogError("  Assert failed in line %d: Expression should be true: %s. %s\n", __LINE__, #expression, (ctest_message == NULL) ? "" : ctest_message); \
+        ctest_events_assert_failed(__LINE__, #expression, "true", "false", ctest_message); \
         ctest_sprintf_free(ctest_message); \
         if (g_CurrentTestFunction != NULL) *g_CurrentTestFunction->TestResult = TEST_FAILED; \
         do_jump(&g_ExceptionJump, "expected it to be true", "but it wasn't"); \
@@ -460,6 +648,7 @@ do { \
     { \
         char* ctest_message = GET_MESSAGE(__VA_ARGS__); \
         LogError("  Assert failed in line %d: Expression should be false: %s. %s\n", __LINE__, #expression, (ctest_message == NULL) ? "" : ctest_message); \
+        ctest_events_assert_failed(__LINE__, #expression, "false", "true", ctest_message); \
         ctest_sprintf_free(ctest_message); \
         if (g_CurrentTestFunction != NULL) *g_CurrentTestFunction->TestResult = TEST_FAILED; \
         do_jump(&g_ExceptionJump, "expected it to be false", "but it was true"); \
@@ -471,16 +660,75 @@ do \
 { \
     char* ctest_message = GET_MESSAGE(__VA_ARGS__); \
     LogError("  Assert failed in line %d: %s \n" , __LINE__, (ctest_message == NULL) ? "" : ctest_message); \
+    ctest_events_assert_failed(__LINE__, NULL, NULL, NULL, ctest_message); \
     ctest_sprintf_free(ctest_message); \
     if (g_CurrentTestFunction != NULL) *g_CurrentTestFunction->TestResult = TEST_FAILED; \
     do_jump(&g_ExceptionJump, (void*)"nothing expected, 100% fail", (void*)"nothing actual, 100% fail"); \
 } \
 while(0)
 
-extern C_LINKAGE void bool_AssertAreEqual(int left, int right, char* ctest_message, int line_no);
-extern C_LINKAGE void _Bool_AssertAreEqual(int left, int right, char* ctest_message, int line_no);
-extern C_LINKAGE void bool_AssertAreNotEqual(int left, int right, char* ctest_message, int line_no);
-extern C_LINKAGE void _Bool_AssertAreNotEqual(int left, int right, char* ctest_message, int line_no);
+/* Allocation assertions: count the heap allocations (malloc, calloc, realloc, strdup, operator new) made by the calling thread in a
+scope, and fail the test with the allocation sites when there are more than allowed. Allocations need to be counted by the allocation
+tracker (ctest built with use_leak_tracker, Linux), without it the assertions log a warning and do not check anything.
+
+    CTEST_ASSERT_NO_ALLOCATIONS_BEGIN();
+    process_message(&message);
+    CTEST_ASSERT_NO_ALLOCATIONS_END();
+
+    CTEST_ASSERT_MAX_ALLOCATIONS(1, 256)
+    {
+        process_message(&message);
+    }
+*/
+#define CTEST_ALLOCATION_SCOPE_MAX_SITE_COUNT 8
+
+typedef struct CTEST_ALLOCATION_SITE_TAG
+{
+    const void* caller;
+    const void* stack; /* kept by the allocation tracker */
+    size_t count;
+    size_t bytes;
+} CTEST_ALLOCATION_SITE;
+
+typedef struct CTEST_ALLOCATION_SCOPE_TAG
+{
+    size_t max_count;
+    size_t max_bytes;
+    size_t count;
+    size_t bytes;
+    /* the first sites allocating in the scope */
+    size_t site_count;
+    CTEST_ALLOCATION_SITE sites[CTEST_ALLOCATION_SCOPE_MAX_SITE_COUNT];
+    struct CTEST_ALLOCATION_SCOPE_TAG* outer_scope;
+    int is_open;
+} CTEST_ALLOCATION_SCOPE;
+
+extern C_LINKAGE void ctest_allocation_scope_begin(CTEST_ALLOCATION_SCOPE* scope, size_t max_count, size_t max_bytes);
+/* fails the test (and does not return) when the scope allocated more than allowed */
+extern C_LINKAGE void ctest_allocation_scope_end(CTEST_ALLOCATION_SCOPE* scope, int line_no);
+
+#define CTEST_ASSERT_NO_ALLOCATIONS_BEGIN() \
+    { \
+        CTEST_ALLOCATION_SCOPE ctest_no_allocations_scope; \
+        ctest_allocation_scope_begin(&ctest_no_allocations_scope, 0, 0)
+
+#define CTEST_ASSERT_NO_ALLOCATIONS_END() \
+        ctest_allocation_scope_end(&ctest_no_allocations_scope, __LINE__); \
+    }
+
+#define CTEST_ASSERT_MAX_ALLOCATIONS(max_count, max_bytes) \
+    for (CTEST_ALLOCATION_SCOPE ctest_max_allocations_scope, *ctest_max_allocations_scope_pointer = (ctest_allocation_scope_begin(&ctest_max_allocations_scope, (max_count), (max_bytes)), &ctest_max_allocations_scope); \
+        ctest_max_allocations_scope_pointer->is_open; \
+        ctest_allocation_scope_end(ctest_max_allocations_scope_pointer, __LINE__))
+
+/* true in a test run by the allocation failure sweep (--ctest_allocation_failure_sweep) once the allocation made to fail failed, so the
+   test can expect the error instead of the result */
+extern C_LINKAGE bool ctest_is_allocation_failure_injected(void);
+
+extern C_LINKAGE void bool_AssertAreEqual(int left, int right, int line_no, const char* format, ...);
+extern C_LINKAGE void _Bool_AssertAreEqual(int left, int right, int line_no, const char* format, ...);
+extern C_LINKAGE void bool_AssertAreNotEqual(int left, int right, int line_no, const char* format, ...);
+extern C_LINKAGE void _Bool_AssertAreNotEqual(int left, int right, int line_no, const char* format, ...);
 
 CTEST_DECLARE_EQUALITY_ASSERTION_FUNCTIONS_FOR_TYPE(int)
 CTEST_DECLARE_EQUALITY_ASSERTION_FUNCTIONS_FOR_TYPE(char)
@@ -533,6 +781,49 @@ CTEST_DEFINE_EQUALITY_ASSERTION_FUNCTIONS_FOR_TYPE(enum_name, static)
 
 extern C_LINKAGE size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteName, const char* testNameFilter);
 
+/* adds a suite to the suites of the process, called before main by every CTEST_END_TEST_SUITE */
+extern C_LINKAGE void ctest_register_suite(CTEST_SUITE_REGISTRATION* registration);
+
+/* Applies the ctest options of argv (see ctest_parse_command_line) and runs every suite of the process that has a test matching
+   --ctest_filter, in the order of their names, with RunTests. Returns the total of the failed tests of the suites, non-zero when an
+   option is invalid and CTEST_RETURN_CODE_NO_TESTS_RAN when no test matches. A test binary's main can be:
+       int main(int argc, char** argv) { return ctest_run_all(argc, argv) == 0 ? 0 : 1; } */
+extern C_LINKAGE size_t ctest_run_all(int argc, char** argv);
+
+/* Applies the ctest options found in argv on top of the ones read from the environment, for all following RunTests calls.
+   Arguments that are not ctest options are ignored, so argc/argv can be passed as received by main.
+   --ctest_shard_index=N --ctest_shard_count=M: run only the tests that hash to shard N of M (CTEST_SHARD_INDEX/CTEST_SHARD_COUNT).
+   --ctest_test_timeout_ms=N --ctest_suite_timeout_ms=N: time limits for each test and for each suite, 0 is no limit
+   (CTEST_TEST_TIMEOUT_MS/CTEST_SUITE_TIMEOUT_MS).
+   --ctest_benchmark_min_time_ms=N: minimum measurement time of each CTEST_BENCHMARK (CTEST_BENCHMARK_MIN_TIME_MS).
+   --ctest_baseline_output=path: write the test timings and benchmark measurements to a JSON baseline (CTEST_BASELINE_OUTPUT).
+   --ctest_baseline_compare=path --ctest_regression_threshold_percent=N: fail the tests and benchmarks more than N% slower than
+   in the baseline (CTEST_BASELINE_COMPARE/CTEST_REGRESSION_THRESHOLD_PERCENT).
+   --ctest_perf_counters=1: count cycles, instructions, cache and branch misses, page faults and context switches of each test
+   (CTEST_PERF_COUNTERS, Linux only).
+   --ctest_leak_check_per_test=1: fail the tests leaving allocated blocks after TEST_FUNCTION_CLEANUP and log their allocation stacks
+   (CTEST_LEAK_CHECK_PER_TEST, Linux built with use_leak_tracker only).
+   --ctest_allocation_failure_sweep=N: run each test again in forked processes with each of its first N allocations failing in turn and
+   fail it when one of them crashes, hangs, fails or leaks (CTEST_ALLOCATION_FAILURE_SWEEP, Linux built with use_leak_tracker only).
+   --ctest_report_junit=path --ctest_report_tap=path --ctest_report_json=path: write the results of the tests as they complete to a
+   JUnit XML, TAP version 13 or JSON file (CTEST_REPORT_JUNIT/CTEST_REPORT_TAP/CTEST_REPORT_JSON).
+   --ctest_event_fd=N: write a JSON line to the open file descriptor N when a suite or a test starts or ends and when an assert fails
+   (CTEST_EVENT_FD).
+   --ctest_trace=path: write the suite fixtures, function fixtures and test bodies to a Chrome trace event file, for Perfetto or
+   chrome://tracing (CTEST_TRACE).
+   --ctest_quiet=1: only log what a test logged when it fails, print a '.' for each test that passes (CTEST_QUIET).
+   --ctest_capture_output=1: capture what each test writes to stdout and stderr, only write it and add it to the reports when the
+   test fails (CTEST_CAPTURE_OUTPUT).
+   --ctest_crash_recovery=1: fail a test crashing with a NULL pointer dereference or an arithmetic error and continue the run, 2 does
+   the same for any SIGSEGV, SIGBUS, SIGFPE and SIGILL (CTEST_CRASH_RECOVERY).
+   --ctest_journal=path: append a binary record to the file when each test starts and ends (CTEST_JOURNAL).
+   --ctest_resume=1: relaunched after a crash, take the results of the tests that ended from the journal instead of running them
+   again and fail the test that crashed (CTEST_RESUME).
+   --ctest_filter=filter: the tests ctest_run_all runs, with the syntax of the filter of RunTests ("a,b*,suite.c?,-d") (CTEST_FILTER).
+   --ctest_list=1: write the tests of each suite to stdout, one JSON object per line, instead of running them (CTEST_LIST).
+   Returns 0 on success, non-zero when a ctest option has an invalid value. */
+extern C_LINKAGE int ctest_parse_command_line(int argc, char** argv);
+
 /* Special return code when zero tests were executed (all filtered out or no tests exist).
    Distinct from normal failure counts and VLD leak negative counts. */
 #define CTEST_RETURN_CODE_NO_TESTS_RAN ((size_t)0xFFFFFFFE)
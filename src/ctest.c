@@ -14,6 +14,9 @@
 #include "ctest.h"
 #include "c_logging/logger.h"
 
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
 #if defined _MSC_VER && !defined(WINCE)
 #include <limits.h> // for SIZE_MAX
 #include "windows.h"
@@ -23,8 +26,15 @@
 #include "vld.h" // force
 #endif
 
-const TEST_FUNCTION_DATA* g_CurrentTestFunction;
-jmp_buf g_ExceptionJump;
+#if !defined _MSC_VER
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h> // for _exit
+#endif
+
+CTEST_THREAD_LOCAL const TEST_FUNCTION_DATA* g_CurrentTestFunction;
+CTEST_THREAD_LOCAL jmp_buf g_ExceptionJump;
 
 #ifdef USE_VLD
 static VLD_UINT g_initial_leak_count;
@@ -44,13 +54,440 @@ static void ctest_check_leaks_at_exit(void)
         _exit(-real_leaks);
     }
 }
+#elif defined CTEST_USE_LEAK_TRACKER
+// Same check with the allocation tracker of ctest_leak_tracker.c. atexit handlers run in the reverse order of their registration, so
+// the destructors of the statics constructed during the tests (and of the modules loaded by them) have run by this point.
+static void ctest_check_leaks_at_exit(void)
+{
+    size_t real_leaks = ctest_leak_tracker_report_leaks(false);
+    if (real_leaks > 0)
+    {
+        (void)fprintf(stderr, "ctest: memory leaks detected after teardown: %zu leak(s)\n", real_leaks);
+        (void)ctest_leak_tracker_report_leaks(true);
+        // The exit status keeps 8 bits, at most 255 leaks so that it is never 0.
+        _exit(-(int)((real_leaks > 255) ? 255 : real_leaks));
+    }
+}
 #endif
 
-size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteName, const char* testNameFilter)
+/* Crash dispatch. Every subsystem that has something to do when the process crashes (recover the test, write what it kept for the
+   running tests) sets a hook rather than a handler of its own, so that they run in a defined order, on the alternate stack, and the
+   signal goes once to the handler in place before ctest. A crash in a hook, or in another thread while the hooks run, goes straight
+   to that handler. */
+
+static const int g_crash_signals[CTEST_CRASH_SIGNAL_COUNT] = { CTEST_CRASH_SIGNALS };
+static CTEST_CRASH_HOOK volatile g_crash_hooks[CTEST_CRASH_HOOK_ID_COUNT];
+static bool g_is_crash_installed = false;
+/* set by the first crash that is not recovered */
+static volatile sig_atomic_t g_is_crashing = 0;
+
+static size_t ctest_crash_get_signal_index(int signal_number)
+{
+    size_t result = 0;
+    while ((result < CTEST_CRASH_SIGNAL_COUNT - 1) && (g_crash_signals[result] != signal_number))
+    {
+        result++;
+    }
+    return result;
+}
+
+static void ctest_crash_call_hooks(const CTEST_CRASH* crash)
+{
+    CTEST_CRASH_HOOK recovery_hook = g_crash_hooks[CTEST_CRASH_HOOK_RECOVERY];
+    if (recovery_hook != NULL)
+    {
+        recovery_hook(crash);
+    }
+
+    /* not recovered */
+    if (!g_is_crashing)
+    {
+        g_is_crashing = 1;
+        for (size_t i = CTEST_CRASH_HOOK_RECOVERY + 1; i < CTEST_CRASH_HOOK_ID_COUNT; i++)
+        {
+            CTEST_CRASH_HOOK hook = g_crash_hooks[i];
+            if (hook != NULL)
+            {
+                hook(crash);
+            }
+        }
+    }
+}
+
+#if defined _MSC_VER
+typedef void (*CTEST_CRASH_SIGNAL_HANDLER)(int);
+static CTEST_CRASH_SIGNAL_HANDLER g_previous_crash_handlers[CTEST_CRASH_SIGNAL_COUNT];
+static SRWLOCK g_crash_lock = SRWLOCK_INIT;
+
+static void ctest_crash_on_signal(int signal_number)
+{
+    CTEST_CRASH crash;
+    crash.signal_number = signal_number;
+    crash.signal_index = ctest_crash_get_signal_index(signal_number);
+    crash.is_fault = false;
+    crash.fault_address = NULL;
+    ctest_crash_call_hooks(&crash);
+
+    /* then whatever handled the signal before ctest (the default action: the process dies) */
+    (void)signal(signal_number, g_previous_crash_handlers[crash.signal_index]);
+    (void)raise(signal_number);
+}
+
+static void ctest_crash_install(void)
+{
+    AcquireSRWLockExclusive(&g_crash_lock);
+    if (!g_is_crash_installed)
+    {
+        for (size_t i = 0; i < CTEST_CRASH_SIGNAL_COUNT; i++)
+        {
+            g_previous_crash_handlers[i] = signal(g_crash_signals[i], ctest_crash_on_signal);
+            if (g_previous_crash_handlers[i] == SIG_ERR)
+            {
+                g_previous_crash_handlers[i] = SIG_DFL;
+            }
+        }
+        g_is_crash_installed = true;
+    }
+    ReleaseSRWLockExclusive(&g_crash_lock);
+}
+
+void ctest_crash_begin_thread(void)
+{
+}
+
+void ctest_crash_end_thread(void)
+{
+}
+#else
+#define CTEST_CRASH_ALTERNATE_STACK_SIZE (64 * 1024)
+
+static struct sigaction g_previous_crash_actions[CTEST_CRASH_SIGNAL_COUNT];
+static pthread_mutex_t g_crash_lock = PTHREAD_MUTEX_INITIALIZER;
+static CTEST_THREAD_LOCAL void* g_crash_alternate_stack = NULL;
+
+static void ctest_crash_on_signal(int signal_number, siginfo_t* info, void* context)
+{
+    CTEST_CRASH crash;
+    (void)context;
+    crash.signal_number = signal_number;
+    crash.signal_index = ctest_crash_get_signal_index(signal_number);
+    crash.is_fault = (info != NULL) && (info->si_code > 0);
+    crash.fault_address = (info == NULL) ? NULL : info->si_addr;
+    ctest_crash_call_hooks(&crash);
+
+    /* then whatever handled the signal before ctest (the default action: the process dies) */
+    (void)sigaction(signal_number, &g_previous_crash_actions[crash.signal_index], NULL);
+    (void)raise(signal_number);
+}
+
+static void ctest_crash_install(void)
+{
+    (void)pthread_mutex_lock(&g_crash_lock);
+    if (!g_is_crash_installed)
+    {
+        struct sigaction action;
+        (void)memset(&action, 0, sizeof(action));
+        action.sa_sigaction = ctest_crash_on_signal;
+        /* not blocked while handled: crash recovery longjmps out of the handler */
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_NODEFER;
+        (void)sigemptyset(&action.sa_mask);
+        for (size_t i = 0; i < CTEST_CRASH_SIGNAL_COUNT; i++)
+        {
+            if (sigaction(g_crash_signals[i], &action, &g_previous_crash_actions[i]) != 0)
+            {
+                LogWarning("failure in sigaction(%d), errno=%d, ctest does not handle the crashes with this signal", g_crash_signals[i], errno);
+                (void)memset(&g_previous_crash_actions[i], 0, sizeof(g_previous_crash_actions[i]));
+                g_previous_crash_actions[i].sa_handler = SIG_DFL;
+            }
+        }
+        g_is_crash_installed = true;
+    }
+    (void)pthread_mutex_unlock(&g_crash_lock);
+}
+
+/* a stack overflow leaves no stack for the handler, it runs on a stack of its own */
+void ctest_crash_begin_thread(void)
+{
+    if (g_crash_alternate_stack == NULL)
+    {
+        /* mapped rather than allocated, the alternate stack of the thread is not a leak of the test */
+        void* stack = mmap(NULL, CTEST_CRASH_ALTERNATE_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (stack == MAP_FAILED)
+        {
+            LogWarning("failure in mmap for the alternate signal stack, errno=%d, a stack overflow is not handled", errno);
+        }
+        else
+        {
+            stack_t alternate_stack;
+            alternate_stack.ss_sp = stack;
+            alternate_stack.ss_size = CTEST_CRASH_ALTERNATE_STACK_SIZE;
+            alternate_stack.ss_flags = 0;
+            if (sigaltstack(&alternate_stack, NULL) != 0)
+            {
+                LogWarning("failure in sigaltstack, errno=%d, a stack overflow is not handled", errno);
+                (void)munmap(stack, CTEST_CRASH_ALTERNATE_STACK_SIZE);
+            }
+            else
+            {
+                g_crash_alternate_stack = stack;
+            }
+        }
+    }
+}
+
+void ctest_crash_end_thread(void)
+{
+    void* stack = g_crash_alternate_stack;
+    if (stack != NULL)
+    {
+        stack_t alternate_stack;
+        (void)memset(&alternate_stack, 0, sizeof(alternate_stack));
+        alternate_stack.ss_flags = SS_DISABLE;
+        if (sigaltstack(&alternate_stack, NULL) == 0)
+        {
+            (void)munmap(stack, CTEST_CRASH_ALTERNATE_STACK_SIZE);
+        }
+        g_crash_alternate_stack = NULL;
+    }
+}
+#endif
+
+void ctest_crash_set_hook(CTEST_CRASH_HOOK_ID hook_id, CTEST_CRASH_HOOK hook)
+{
+    g_crash_hooks[hook_id] = hook;
+    ctest_crash_install();
+}
+
+void ctest_crash_clear_hooks(void)
+{
+    for (size_t i = 0; i < CTEST_CRASH_HOOK_ID_COUNT; i++)
+    {
+        g_crash_hooks[i] = NULL;
+    }
+}
+
+bool ctest_is_test_thread_safe(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run)
+{
+    return (((suite_run->suite_flags | test_run->test_function->Flags) & CTEST_FUNCTION_FLAG_NOT_THREAD_SAFE) == 0);
+}
+
+void ctest_run_test(CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run)
+{
+    const TEST_FUNCTION_DATA* currentTestFunction = test_run->test_function;
+    /* always taken before the setjmp it measures, so it is still valid after a longjmp back to it */
+    CTEST_TIMING start;
+    /* opened before the setjmp of the test and not modified until closed after it, for the same reason */
+    CTEST_PERF_COUNTERS_SESSION perf_session;
+#if defined CTEST_USE_LEAK_TRACKER
+    /* same, 0 when the test is not checked for leaks */
+    uint32_t leak_test_scope = 0;
+    /* a failed assert jumps over the end of the allocation scopes it is in, leaving the thread counting in a dead stack frame: the scope
+       in effect before the test is set back after each setjmp */
+    CTEST_ALLOCATION_SCOPE* const allocation_scope = ctest_leak_tracker_get_allocation_scope();
+#endif
+
+    test_run->test_timing.wall_ns = 0;
+    test_run->test_timing.cpu_ns = 0;
+    test_run->fixture_timing.wall_ns = 0;
+    test_run->fixture_timing.cpu_ns = 0;
+    test_run->benchmark_result.sample_count = 0;
+    test_run->perf_counters.iterations = 0;
+    test_run->perf_counters.valid_mask = 0;
+    test_run->allocation_failure_count = 0;
+    test_run->captured_output = NULL;
+    test_run->crash_signal = 0;
+
+    test_run->thread_id = ctest_get_current_thread_id();
+    test_run->start_wall_ns = ctest_timing_get_wall_ns();
+    test_run->state = CTEST_TEST_RUN_RUNNING;
+    ctest_journal_begin_test(suite_run, test_run);
+    ctest_report_begin_test(suite_run, test_run);
+    /* on the path of ctest_events_end_test: a test not executed has a start too */
+    ctest_events_begin_test(suite_run, test_run);
+    ctest_quiet_begin_test(currentTestFunction);
+    if (suite_run->capture_output)
+    {
+        ctest_capture_begin_test(currentTestFunction);
+    }
+
+    if (suite_run->is_test_runner_ok == 1)
+    {
+        int testFunctionInitializeFailed = 0;
+
+#if defined CTEST_USE_LEAK_TRACKER
+        if (suite_run->check_leaks_per_test)
+        {
+            /* the blocks allocated by TEST_FUNCTION_INITIALIZE are freed by TEST_FUNCTION_CLEANUP */
+            leak_test_scope = ctest_leak_tracker_begin_test();
+        }
+#endif
+
+        if (suite_run->test_function_initialize != NULL)
+        {
+            ctest_timing_get_timestamp(&start);
+            if (setjmp(g_ExceptionJump) == 0)
+            {
+                suite_run->test_function_initialize->TestFunction();
+            }
+            else
+            {
+                testFunctionInitializeFailed = 1;
+                LogInfo(CTEST_ANSI_COLOR_RED "TEST_FUNCTION_INITIALIZE failed - next TEST_FUNCTION will fail" CTEST_ANSI_COLOR_RESET);
+            }
+#if defined CTEST_USE_LEAK_TRACKER
+            (void)ctest_leak_tracker_set_allocation_scope(allocation_scope);
+#endif
+            ctest_timing_add_elapsed(&test_run->fixture_timing, &start);
+            ctest_trace_add(CTEST_TRACE_FUNCTION_INITIALIZE, suite_run->test_suite_name, currentTestFunction->TestFunctionName, start.wall_ns);
+        }
+
+        if (testFunctionInitializeFailed)
+        {
+            *currentTestFunction->TestResult = TEST_FAILED;
+            LogInfo(CTEST_ANSI_COLOR_YELLOW "Not executing test %s ..." CTEST_ANSI_COLOR_RESET, currentTestFunction->TestFunctionName);
+        }
+        else
+        {
+#if defined CTEST_USE_LEAK_TRACKER
+            if ((suite_run->allocation_failure_sweep != 0) && (currentTestFunction->FunctionType != CTEST_BENCHMARK_FUNCTION))
+            {
+                test_run->allocation_failure_count = ctest_allocation_failure_sweep(suite_run, test_run);
+            }
+#endif
+
+            LogInfo("Executing test %s ...", currentTestFunction->TestFunctionName);
+
+            // Assume test succeeds
+            *currentTestFunction->TestResult = TEST_SUCCESS;
+
+            g_CurrentTestFunction = currentTestFunction;
+
+            if (suite_run->use_perf_counters)
+            {
+                ctest_perf_counters_open(&perf_session);
+            }
+
+            ctest_crash_begin_thread();
+            ctest_timing_get_timestamp(&start);
+            if ((currentTestFunction->FunctionType != CTEST_BENCHMARK_FUNCTION) && suite_run->use_perf_counters)
+            {
+                ctest_perf_counters_enable(&perf_session);
+            }
+            if (setjmp(g_ExceptionJump) == 0)
+            {
+                ctest_crash_recovery_begin(currentTestFunction);
+                if (currentTestFunction->FunctionType == CTEST_BENCHMARK_FUNCTION)
+                {
+                    ctest_benchmark_run(currentTestFunction, suite_run->benchmark_min_time_ms, suite_run->use_perf_counters ? &perf_session : NULL, &test_run->benchmark_result);
+                }
+                else
+                {
+                    currentTestFunction->TestFunction();
+                }
+            }
+            else
+            {
+                /*can only get here if there was a longjmp called while executing currentTestFunction->TestFunction();*/
+                /*we don't do anything*/
+            }
+            test_run->crash_signal = ctest_crash_recovery_end();
+#if defined CTEST_USE_LEAK_TRACKER
+            (void)ctest_leak_tracker_set_allocation_scope(allocation_scope);
+#endif
+            if (test_run->crash_signal != 0)
+            {
+                *currentTestFunction->TestResult = TEST_FAILED;
+            }
+            if (suite_run->use_perf_counters)
+            {
+                ctest_perf_counters_disable(&perf_session);
+            }
+            ctest_timing_add_elapsed(&test_run->test_timing, &start);
+            ctest_trace_add(CTEST_TRACE_TEST, suite_run->test_suite_name, currentTestFunction->TestFunctionName, start.wall_ns);
+
+            if (suite_run->use_perf_counters)
+            {
+                ctest_perf_counters_close(&perf_session, &test_run->perf_counters);
+                test_run->perf_counters.iterations = (test_run->benchmark_result.sample_count > 0) ?
+                    test_run->benchmark_result.iterations * test_run->benchmark_result.sample_count : 1;
+            }
+            g_CurrentTestFunction = NULL;/*g_CurrentTestFunction is limited to actually executing a TEST_FUNCTION, otherwise it should be NULL*/
+
+            /*in the case when the cleanup can assert... have to prepare the long jump*/
+            ctest_timing_get_timestamp(&start);
+            if (setjmp(g_ExceptionJump) == 0)
+            {
+                if (suite_run->test_function_cleanup != NULL)
+                {
+                    suite_run->test_function_cleanup->TestFunction();
+                }
+            }
+            else
+            {
+                /* this is a fatal error, if we got a fail in cleanup we can't do much */
+                *currentTestFunction->TestResult = TEST_FAILED;
+                suite_run->is_test_runner_ok = 0;
+            }
+#if defined CTEST_USE_LEAK_TRACKER
+            (void)ctest_leak_tracker_set_allocation_scope(allocation_scope);
+#endif
+            if (suite_run->test_function_cleanup != NULL)
+            {
+                ctest_timing_add_elapsed(&test_run->fixture_timing, &start);
+                ctest_trace_add(CTEST_TRACE_FUNCTION_CLEANUP, suite_run->test_suite_name, currentTestFunction->TestFunctionName, start.wall_ns);
+            }
+        }
+
+#if defined CTEST_USE_LEAK_TRACKER
+        if ((leak_test_scope != 0) && (ctest_leak_tracker_end_test(leak_test_scope, currentTestFunction->TestFunctionName) > 0))
+        {
+            *currentTestFunction->TestResult = TEST_FAILED;
+        }
+#endif
+        if (test_run->allocation_failure_count > 0)
+        {
+            *currentTestFunction->TestResult = TEST_FAILED;
+        }
+    }
+    else
+    {
+        *currentTestFunction->TestResult = TEST_NOT_EXECUTED;
+    }
+
+    if (suite_run->capture_output)
+    {
+        test_run->captured_output = ctest_capture_end_test((*currentTestFunction->TestResult == TEST_FAILED) || (*currentTestFunction->TestResult == TEST_NOT_EXECUTED));
+    }
+
+    if (*currentTestFunction->TestResult == TEST_FAILED)
+    {
+        LogInfo(CTEST_ANSI_COLOR_RED "Test %s result = !!! FAILED !!! (%.3f ms wall, %.3f ms cpu, fixtures %.3f ms wall, %.3f ms cpu)" CTEST_ANSI_COLOR_RESET "", currentTestFunction->TestFunctionName,
+            CTEST_TIMING_NS_TO_MS(test_run->test_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test_run->test_timing.cpu_ns),
+            CTEST_TIMING_NS_TO_MS(test_run->fixture_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test_run->fixture_timing.cpu_ns));
+    }
+    else if (*currentTestFunction->TestResult == TEST_NOT_EXECUTED)
+    {
+        LogInfo(CTEST_ANSI_COLOR_YELLOW "Test %s ... SKIPPED due to a failure in test function cleanup. " CTEST_ANSI_COLOR_RESET "", currentTestFunction->TestFunctionName);
+    }
+    else
+    {
+        LogInfo(CTEST_ANSI_COLOR_GREEN "Test %s result = Succeeded. (%.3f ms wall, %.3f ms cpu, fixtures %.3f ms wall, %.3f ms cpu)" CTEST_ANSI_COLOR_RESET "", currentTestFunction->TestFunctionName,
+            CTEST_TIMING_NS_TO_MS(test_run->test_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test_run->test_timing.cpu_ns),
+            CTEST_TIMING_NS_TO_MS(test_run->fixture_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test_run->fixture_timing.cpu_ns));
+    }
+    ctest_perf_counters_log(currentTestFunction->TestFunctionName, &test_run->perf_counters);
+    ctest_quiet_end_test((*currentTestFunction->TestResult == TEST_FAILED) || (*currentTestFunction->TestResult == TEST_NOT_EXECUTED));
+
+    test_run->state = CTEST_TEST_RUN_DONE;
+    ctest_journal_end_test(suite_run, test_run);
+    ctest_report_test(suite_run, test_run, ctest_crash_recovery_get_message(test_run->crash_signal));
+    ctest_events_end_test(suite_run, test_run, ctest_crash_recovery_get_message(test_run->crash_signal));
+}
+
+static size_t ctest_run_suite(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteName, const char* testNameFilter)
 {
 #ifdef USE_VLD
-    // RunTests is single-threaded (see the unguarded g_CurrentTestFunction/g_ExceptionJump globals)
-    // but is called once per suite, so register the exit-time leak check only on the first call.
+    // RunTests is called once per suite, so register the exit-time leak check only on the first call.
     static bool leak_check_registered = false;
     if (!leak_check_registered)
     {
@@ -58,16 +495,74 @@ size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteNam
         g_initial_leak_count = VLDGetLeaksCount();
         (void)atexit(ctest_check_leaks_at_exit);
     }
+#elif defined CTEST_USE_LEAK_TRACKER
+    static bool leak_check_registered = false;
+    if (!leak_check_registered)
+    {
+        leak_check_registered = true;
+        ctest_leak_tracker_start();
+        (void)atexit(ctest_check_leaks_at_exit);
+    }
 #endif
+    const CTEST_CONFIG* config = ctest_config_get();
     size_t totalTestCount = 0;
     size_t failedTestCount = 0;
     size_t skippedByFilterCount = 0;
-    const TEST_FUNCTION_DATA* currentTestFunction = (const TEST_FUNCTION_DATA*)testListHead->NextTestFunctionData;
+    size_t skippedByShardCount = 0;
+    size_t matchingFilterCount = 0;
+    size_t selectedTestCount = 0;
+    const TEST_FUNCTION_DATA* currentTestFunction;
+    size_t suiteTestCount;
+    CTEST_REGISTRATION_SUITE registration_suite;
     const TEST_FUNCTION_DATA* testSuiteInitialize = NULL;
     const TEST_FUNCTION_DATA* testSuiteCleanup = NULL;
-    const TEST_FUNCTION_DATA* testFunctionInitialize = NULL;
-    const TEST_FUNCTION_DATA* testFunctionCleanup = NULL;
     int testSuiteInitializeFailed = 0;
+    CTEST_SUITE_RUN suite_run;
+    CTEST_TIMING start;
+    CTEST_WATCHDOG_HANDLE watchdog = NULL;
+    CTEST_FILTER_HANDLE filter = NULL;
+
+    suite_run.test_suite_name = testSuiteName;
+    suite_run.test_function_initialize = NULL;
+    suite_run.test_function_cleanup = NULL;
+    suite_run.suite_flags = CTEST_FUNCTION_FLAG_NONE;
+    suite_run.tests = NULL;
+    suite_run.test_count = 0;
+    suite_run.is_test_runner_ok = 1;
+    suite_run.test_timeout_ms = config->test_timeout_ms;
+    suite_run.suite_deadline_wall_ns = (config->suite_timeout_ms == 0) ? 0 : ctest_timing_get_wall_ns() + (uint64_t)config->suite_timeout_ms * 1000000;
+    suite_run.running_suite_fixture = NULL;
+    suite_run.suite_fixture_start_wall_ns = 0;
+    suite_run.suite_fixture_thread_id = ctest_get_current_thread_id();
+    suite_run.is_watchdog_paused = 0;
+    suite_run.benchmark_min_time_ms = config->benchmark_min_time_ms;
+    suite_run.use_perf_counters = (config->perf_counters != 0);
+    suite_run.capture_output = (config->capture_output != 0);
+#if defined CTEST_USE_LEAK_TRACKER
+    suite_run.check_leaks_per_test = (config->leak_check_per_test != 0);
+    suite_run.allocation_failure_sweep = config->allocation_failure_sweep;
+#else
+    suite_run.check_leaks_per_test = false;
+    if (config->leak_check_per_test != 0)
+    {
+        static bool is_leak_check_warning_logged = false;
+        if (!is_leak_check_warning_logged)
+        {
+            is_leak_check_warning_logged = true;
+            LogWarning("CTEST_LEAK_CHECK_PER_TEST needs ctest built with use_leak_tracker (Linux), tests are not checked for leaks");
+        }
+    }
+    suite_run.allocation_failure_sweep = 0;
+    if (config->allocation_failure_sweep != 0)
+    {
+        static bool is_allocation_failure_warning_logged = false;
+        if (!is_allocation_failure_warning_logged)
+        {
+            is_allocation_failure_warning_logged = true;
+            LogWarning("CTEST_ALLOCATION_FAILURE_SWEEP needs ctest built with use_leak_tracker (Linux), allocation failures are not injected");
+        }
+    }
+#endif
 
 #if defined _MSC_VER && !defined(WINCE)
     _set_abort_behavior(_CALL_REPORTFAULT, _WRITE_ABORT_MSG | _CALL_REPORTFAULT);
@@ -107,35 +602,126 @@ size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteNam
     if (testNameFilter != NULL && testNameFilter[0] != '\0')
     {
         LogInfo(" ### Test Filter = %s", testNameFilter);
+        filter = ctest_filter_create(testNameFilter);
+        if (filter == NULL)
+        {
+            LogError("failure in ctest_filter_create(%s)", testNameFilter);
+            testSuiteInitializeFailed = 1;
+        }
+    }
+    if (config->shard_count > 1)
+    {
+        LogInfo(" ### Shard %" PRIu32 " of %" PRIu32 "", config->shard_index, config->shard_count);
     }
 
-    while (currentTestFunction->TestFunction != NULL)
+    ctest_registration_get_suite(testListHead, &registration_suite);
+    suiteTestCount = registration_suite.test_count;
+    suite_run.suite_flags = registration_suite.suite_flags;
+
+    if ((testSuiteInitializeFailed == 0) && (suiteTestCount > 0))
     {
-        if (currentTestFunction->FunctionType == CTEST_TEST_FUNCTION_INITIALIZE)
+        suite_run.tests = malloc(sizeof(CTEST_TEST_RUN) * suiteTestCount);
+        if (suite_run.tests == NULL)
         {
-            testFunctionInitialize = currentTestFunction;
+            LogError("failure in malloc(sizeof(CTEST_TEST_RUN) * %zu)", suiteTestCount);
+            testSuiteInitializeFailed = 1;
         }
+    }
 
-        if (currentTestFunction->FunctionType == CTEST_TEST_FUNCTION_CLEANUP)
+    if (testSuiteInitializeFailed == 0)
+    {
+        for (currentTestFunction = ctest_registration_get_first_entry(&registration_suite);
+            currentTestFunction != NULL;
+            currentTestFunction = ctest_registration_get_next_entry(&registration_suite, currentTestFunction))
         {
-            testFunctionCleanup = currentTestFunction;
+            if (currentTestFunction->FunctionType == CTEST_TEST_FUNCTION_INITIALIZE)
+            {
+                suite_run.test_function_initialize = currentTestFunction;
+            }
+            else if (currentTestFunction->FunctionType == CTEST_TEST_FUNCTION_CLEANUP)
+            {
+                suite_run.test_function_cleanup = currentTestFunction;
+            }
+            else if (currentTestFunction->FunctionType == CTEST_TEST_SUITE_INITIALIZE)
+            {
+                testSuiteInitialize = currentTestFunction;
+            }
+            else if (currentTestFunction->FunctionType == CTEST_TEST_SUITE_CLEANUP)
+            {
+                testSuiteCleanup = currentTestFunction;
+            }
+            else if (((currentTestFunction->FunctionType == CTEST_TEST_FUNCTION) || (currentTestFunction->FunctionType == CTEST_BENCHMARK_FUNCTION)) &&
+                (suite_run.test_count < suiteTestCount))
+            {
+                CTEST_TEST_RUN* test_run = &suite_run.tests[suite_run.test_count++];
+                test_run->test_function = currentTestFunction;
+                test_run->test_timing.wall_ns = 0;
+                test_run->test_timing.cpu_ns = 0;
+                test_run->fixture_timing.wall_ns = 0;
+                test_run->fixture_timing.cpu_ns = 0;
+                test_run->benchmark_result.sample_count = 0;
+                test_run->perf_counters.iterations = 0;
+                test_run->perf_counters.valid_mask = 0;
+                test_run->allocation_failure_count = 0;
+                test_run->captured_output = NULL;
+                test_run->crash_signal = 0;
+                test_run->state = CTEST_TEST_RUN_PENDING;
+                test_run->start_wall_ns = 0;
+                test_run->is_in_shard = (config->shard_count <= 1) ||
+                    (ctest_config_get_test_shard(testSuiteName, currentTestFunction->TestFunctionName, config->shard_count) == config->shard_index);
+                /* Check if test should be filtered out */
+                bool matches_filter = (filter == NULL) || ctest_filter_matches(filter, testSuiteName, currentTestFunction->TestFunctionName);
+                if (matches_filter)
+                {
+                    matchingFilterCount++;
+                }
+                test_run->is_selected = test_run->is_in_shard && matches_filter;
+                if (test_run->is_selected)
+                {
+                    selectedTestCount++;
+                }
+            }
         }
+    }
 
-        if (currentTestFunction->FunctionType == CTEST_TEST_SUITE_INITIALIZE)
-        {
-            testSuiteInitialize = currentTestFunction;
-        }
+    ctest_journal_begin_suite();
+    ctest_report_begin_suite(&suite_run);
+    /* before the resumed tests, their results are events too */
+    ctest_events_begin_suite(&suite_run);
 
-        if (currentTestFunction->FunctionType == CTEST_TEST_SUITE_CLEANUP)
+    /* the tests that ended in the run being resumed keep their result and are not run again */
+    if (testSuiteInitializeFailed == 0)
+    {
+        for (size_t i = 0; i < suite_run.test_count; i++)
         {
-            testSuiteCleanup = currentTestFunction;
+            if (suite_run.tests[i].is_selected && ctest_journal_resume_test(&suite_run, &suite_run.tests[i]))
+            {
+                suite_run.tests[i].is_selected = false;
+                selectedTestCount--;
+            }
         }
+    }
 
-        currentTestFunction = (TEST_FUNCTION_DATA*)currentTestFunction->NextTestFunctionData;
+    /* the suite fixtures can be expensive, they are not run when no test of the suite is going to run */
+    if ((testSuiteInitializeFailed == 0) && (selectedTestCount == 0) && ((testSuiteInitialize != NULL) || (testSuiteCleanup != NULL)))
+    {
+        LogInfo(" ### No test selected, TEST_SUITE_INITIALIZE and TEST_SUITE_CLEANUP are not run");
     }
 
-    if (testSuiteInitialize != NULL)
+    ctest_trace_begin_suite();
+    ctest_quiet_begin_suite();
+
+    if ((testSuiteInitializeFailed == 0) && (selectedTestCount > 0))
     {
+        watchdog = ctest_watchdog_start(&suite_run);
+    }
+
+    if ((testSuiteInitializeFailed == 0) && (selectedTestCount > 0) && (testSuiteInitialize != NULL))
+    {
+        CTEST_TIMING suite_initialize_timing = { 0, 0 };
+        ctest_timing_get_timestamp(&start);
+        suite_run.suite_fixture_start_wall_ns = start.wall_ns;
+        suite_run.running_suite_fixture = "TEST_SUITE_INITIALIZE";
         if (setjmp(g_ExceptionJump) == 0)
         {
             testSuiteInitialize->TestFunction();
@@ -145,6 +731,10 @@ size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteNam
             testSuiteInitializeFailed = 1;
             LogInfo("TEST_SUITE_INITIALIZE failed - suite ending");
         }
+        suite_run.running_suite_fixture = NULL;
+        ctest_timing_add_elapsed(&suite_initialize_timing, &start);
+        ctest_trace_add(CTEST_TRACE_SUITE_INITIALIZE, testSuiteName, NULL, start.wall_ns);
+        LogInfo(" ### TEST_SUITE_INITIALIZE took %.3f ms wall, %.3f ms cpu", CTEST_TIMING_NS_TO_MS(suite_initialize_timing.wall_ns), CTEST_TIMING_NS_TO_MS(suite_initialize_timing.cpu_ns));
     }
 
     if (testSuiteInitializeFailed == 1)
@@ -152,113 +742,98 @@ size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteNam
         /* print results */
         LogInfo(CTEST_ANSI_COLOR_RED "0 tests ran, ALL failed, NONE succeeded." CTEST_ANSI_COLOR_RESET);
         failedTestCount = 1;
+        ctest_report_end_suite(&suite_run, 0, failedTestCount, 0);
+        ctest_events_end_suite(&suite_run, 0, failedTestCount, 0);
+        ctest_trace_write();
+        ctest_journal_end_suite();
     }
     else
     {
-        unsigned int is_test_runner_ok = 1;
+        bool run_in_parallel = (config->worker_thread_count > 1) && ((suite_run.suite_flags & CTEST_FUNCTION_FLAG_NOT_THREAD_SAFE) == 0);
 
-        currentTestFunction = (const TEST_FUNCTION_DATA*)testListHead->NextTestFunctionData;
-        while (currentTestFunction->TestFunction != NULL)
+        for (size_t i = 0; i < suite_run.test_count; i++)
         {
-            if (currentTestFunction->FunctionType == CTEST_TEST_FUNCTION)
+            if (!suite_run.tests[i].is_in_shard)
             {
-                /* Check if test should be filtered out */
-                if ((testNameFilter != NULL) && (testNameFilter[0] != '\0') && (strcmp(currentTestFunction->TestFunctionName, testNameFilter) != 0))
-                {
-                    /* Test does not match filter, skip it */
-                    *currentTestFunction->TestResult = TEST_SKIPPED_FILTER;
-                    skippedByFilterCount++;
-                }
-                else if (is_test_runner_ok == 1)
-                {
-                    int testFunctionInitializeFailed = 0;
-
-                    if (testFunctionInitialize != NULL)
-                    {
-                        if (setjmp(g_ExceptionJump) == 0)
-                        {
-                            testFunctionInitialize->TestFunction();
-                        }
-                        else
-                        {
-                            testFunctionInitializeFailed = 1;
-                            LogInfo(CTEST_ANSI_COLOR_RED "TEST_FUNCTION_INITIALIZE failed - next TEST_FUNCTION will fail" CTEST_ANSI_COLOR_RESET);
-                        }
-                    }
-
-                    if (testFunctionInitializeFailed)
-                    {
-                        *currentTestFunction->TestResult = TEST_FAILED;
-                        LogInfo(CTEST_ANSI_COLOR_YELLOW "Not executing test %s ..." CTEST_ANSI_COLOR_RESET, currentTestFunction->TestFunctionName);
-                    }
-                    else
-                    {
-                        LogInfo("Executing test %s ...", currentTestFunction->TestFunctionName);
-
-                        // Assume test succeeds
-                        *currentTestFunction->TestResult = TEST_SUCCESS;
-
-                        g_CurrentTestFunction = currentTestFunction;
-
-                        if (setjmp(g_ExceptionJump) == 0)
-                        {
-                            currentTestFunction->TestFunction();
-                        }
-                        else
-                        {
-                            /*can only get here if there was a longjmp called while executing currentTestFunction->TestFunction();*/
-                            /*we don't do anything*/
-                        }
-                        g_CurrentTestFunction = NULL;/*g_CurrentTestFunction is limited to actually executing a TEST_FUNCTION, otherwise it should be NULL*/
-
-                        /*in the case when the cleanup can assert... have to prepare the long jump*/
-                        if (setjmp(g_ExceptionJump) == 0)
-                        {
-                            if (testFunctionCleanup != NULL)
-                            {
-                                testFunctionCleanup->TestFunction();
-                            }
-                        }
-                        else
-                        {
-                            /* this is a fatal error, if we got a fail in cleanup we can't do much */
-                            *currentTestFunction->TestResult = TEST_FAILED;
-                            is_test_runner_ok = 0;
-                        }
-                    }
-                }
-                else
-                {
-                    *currentTestFunction->TestResult = TEST_NOT_EXECUTED;
-                }
+                /* Test is run by another shard, skip it */
+                *suite_run.tests[i].test_function->TestResult = TEST_SKIPPED_SHARD;
+                LogVerbose(CTEST_ANSI_COLOR_YELLOW "Test %s ... SKIPPED due to shard (not in shard %" PRIu32 " of %" PRIu32 ")." CTEST_ANSI_COLOR_RESET "", suite_run.tests[i].test_function->TestFunctionName, config->shard_index, config->shard_count);
+            }
+            else if (!suite_run.tests[i].is_selected && (suite_run.tests[i].state == CTEST_TEST_RUN_PENDING))
+            {
+                /* Test does not match filter, skip it */
+                *suite_run.tests[i].test_function->TestResult = TEST_SKIPPED_FILTER;
+                LogVerbose(CTEST_ANSI_COLOR_YELLOW "Test %s ... SKIPPED due to filter (%s)." CTEST_ANSI_COLOR_RESET "", suite_run.tests[i].test_function->TestFunctionName, MU_P_OR_NULL(testNameFilter));
+            }
+        }
 
-                if (*currentTestFunction->TestResult == TEST_FAILED)
-                {
-                    failedTestCount++;
-                    LogInfo(CTEST_ANSI_COLOR_RED "Test %s result = !!! FAILED !!!" CTEST_ANSI_COLOR_RESET "", currentTestFunction->TestFunctionName);
-                }
-                else if (*currentTestFunction->TestResult == TEST_NOT_EXECUTED)
+        /* every worker process has its own copy of the process, so tests that are not thread safe can run there as well */
+        suite_run.is_watchdog_paused = 1;
+        bool ran_in_worker_processes = (config->worker_process_count > 1) && ctest_run_tests_in_worker_processes(&suite_run, config->worker_process_count);
+        suite_run.is_watchdog_paused = 0;
+        if (ran_in_worker_processes)
+        {
+            /* all selected tests ran (or crashed, or timed out) in worker processes */
+        }
+        else
+        {
+            if (run_in_parallel)
+            {
+                /* stdout and stderr are shared by the threads, the tests running in parallel are not captured */
+                bool capture_output = suite_run.capture_output;
+                if (capture_output)
                 {
-                    failedTestCount++;
-                    LogInfo(CTEST_ANSI_COLOR_YELLOW "Test %s ... SKIPPED due to a failure in test function cleanup. " CTEST_ANSI_COLOR_RESET "", currentTestFunction->TestFunctionName);
+                    LogWarning(" ### The output of the tests running on %" PRIu32 " threads is not captured", config->worker_thread_count);
+                    suite_run.capture_output = false;
                 }
-                else if (*currentTestFunction->TestResult == TEST_SKIPPED_FILTER)
+                /* the sweep forks, which the other running threads would not survive (locks they hold stay taken in the children) */
+                uint32_t allocation_failure_sweep = suite_run.allocation_failure_sweep;
+                if (allocation_failure_sweep != 0)
                 {
-                    LogVerbose(CTEST_ANSI_COLOR_YELLOW "Test %s ... SKIPPED due to filter (%s)." CTEST_ANSI_COLOR_RESET "", currentTestFunction->TestFunctionName, MU_P_OR_NULL(testNameFilter));
+                    LogWarning(" ### The tests running on %" PRIu32 " threads are not swept for allocation failures", config->worker_thread_count);
+                    suite_run.allocation_failure_sweep = 0;
                 }
-                else
+                ctest_run_tests_parallel(&suite_run, config->worker_thread_count);
+                suite_run.capture_output = capture_output;
+                suite_run.allocation_failure_sweep = allocation_failure_sweep;
+            }
+
+            /* the tests that cannot share the process with other running tests (all tests when not running in parallel) */
+            for (size_t i = 0; i < suite_run.test_count; i++)
+            {
+                if (suite_run.tests[i].is_selected &&
+                    (!run_in_parallel || !ctest_is_test_thread_safe(&suite_run, &suite_run.tests[i])))
                 {
-                    LogInfo(CTEST_ANSI_COLOR_GREEN "Test %s result = Succeeded." CTEST_ANSI_COLOR_RESET "", currentTestFunction->TestFunctionName);
+                    ctest_run_test(&suite_run, &suite_run.tests[i]);
                 }
-                totalTestCount++;
             }
+        }
+        ctest_quiet_end_suite();
 
-            currentTestFunction = (TEST_FUNCTION_DATA*)currentTestFunction->NextTestFunctionData;
+        for (size_t i = 0; i < suite_run.test_count; i++)
+        {
+            TEST_RESULT testResult = *suite_run.tests[i].test_function->TestResult;
+            if ((testResult == TEST_FAILED) || (testResult == TEST_NOT_EXECUTED))
+            {
+                failedTestCount++;
+            }
+            else if (testResult == TEST_SKIPPED_FILTER)
+            {
+                skippedByFilterCount++;
+            }
+            else if (testResult == TEST_SKIPPED_SHARD)
+            {
+                skippedByShardCount++;
+            }
         }
+        totalTestCount = suite_run.test_count;
 
+        ctest_timing_get_timestamp(&start);
+        suite_run.suite_fixture_start_wall_ns = start.wall_ns;
+        suite_run.running_suite_fixture = "TEST_SUITE_CLEANUP";
         if (setjmp(g_ExceptionJump) == 0)
         {
-            if (testSuiteCleanup != NULL)
+            if ((testSuiteCleanup != NULL) && (selectedTestCount > 0))
             {
                 testSuiteCleanup->TestFunction();
             }
@@ -270,19 +845,63 @@ size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteNam
             LogInfo(CTEST_ANSI_COLOR_RED "TEST_SUITE_CLEANUP failed - all tests are marked as failed" CTEST_ANSI_COLOR_RESET "");
             failedTestCount = (totalTestCount > 0) ? totalTestCount : SIZE_MAX;
         }
+        suite_run.running_suite_fixture = NULL;
+        if ((testSuiteCleanup != NULL) && (selectedTestCount > 0))
+        {
+            CTEST_TIMING suite_cleanup_timing = { 0, 0 };
+            ctest_timing_add_elapsed(&suite_cleanup_timing, &start);
+            ctest_trace_add(CTEST_TRACE_SUITE_CLEANUP, testSuiteName, NULL, start.wall_ns);
+            LogInfo(" ### TEST_SUITE_CLEANUP took %.3f ms wall, %.3f ms cpu", CTEST_TIMING_NS_TO_MS(suite_cleanup_timing.wall_ns), CTEST_TIMING_NS_TO_MS(suite_cleanup_timing.cpu_ns));
+        }
+
+        ctest_timing_log_slowest_tests(&suite_run, config->slowest_test_count);
 
         /* print results */
-        if (skippedByFilterCount > 0)
+        size_t executedTestCount = totalTestCount - skippedByFilterCount - skippedByShardCount;
+        if (skippedByShardCount > 0)
         {
-            LogInfo("%s%d tests ran, %d failed, %d succeeded, %d skipped by filter." CTEST_ANSI_COLOR_RESET "", (failedTestCount > 0) ? (CTEST_ANSI_COLOR_RED) : (CTEST_ANSI_COLOR_GREEN), (int)(totalTestCount - skippedByFilterCount), (int)failedTestCount, (int)(totalTestCount - skippedByFilterCount - failedTestCount), (int)skippedByFilterCount);
+            LogInfo("%s%d tests ran, %d failed, %d succeeded, %d skipped by filter, %d skipped by shard." CTEST_ANSI_COLOR_RESET "", (failedTestCount > 0) ? (CTEST_ANSI_COLOR_RED) : (CTEST_ANSI_COLOR_GREEN), (int)executedTestCount, (int)failedTestCount, (int)(executedTestCount - failedTestCount), (int)skippedByFilterCount, (int)skippedByShardCount);
+        }
+        else if (skippedByFilterCount > 0)
+        {
+            LogInfo("%s%d tests ran, %d failed, %d succeeded, %d skipped by filter." CTEST_ANSI_COLOR_RESET "", (failedTestCount > 0) ? (CTEST_ANSI_COLOR_RED) : (CTEST_ANSI_COLOR_GREEN), (int)executedTestCount, (int)failedTestCount, (int)(executedTestCount - failedTestCount), (int)skippedByFilterCount);
         }
         else
         {
             LogInfo("%s%d tests ran, %d failed, %d succeeded." CTEST_ANSI_COLOR_RESET "", (failedTestCount > 0) ? (CTEST_ANSI_COLOR_RED) : (CTEST_ANSI_COLOR_GREEN), (int)totalTestCount, (int)failedTestCount, (int)(totalTestCount - failedTestCount));
         }
+        ctest_report_end_suite(&suite_run, executedTestCount, failedTestCount, skippedByFilterCount + skippedByShardCount);
+        ctest_events_end_suite(&suite_run, executedTestCount, failedTestCount, skippedByFilterCount + skippedByShardCount);
+        ctest_trace_write();
+        ctest_journal_end_suite();
+
+        if (config->baseline_output_path[0] != '\0')
+        {
+            if (!ctest_baseline_write(&suite_run, config->baseline_output_path))
+            {
+                LogError(CTEST_ANSI_COLOR_RED "FAILED: the baseline %s could not be written" CTEST_ANSI_COLOR_RESET "", config->baseline_output_path);
+                failedTestCount++;
+            }
+        }
+
+        /* a regression fails the suite like a failed test */
+        if (config->baseline_compare_path[0] != '\0')
+        {
+            size_t regressionCount = ctest_baseline_compare(&suite_run, config->baseline_compare_path, config->regression_threshold_percent);
+            if (regressionCount > 0)
+            {
+                LogError(CTEST_ANSI_COLOR_RED "FAILED: %zu regressions against the baseline %s" CTEST_ANSI_COLOR_RESET "", regressionCount, config->baseline_compare_path);
+                failedTestCount += regressionCount;
+            }
+        }
 
+        /* a shard can legitimately get none of the tests, that is only an error when the filter matches no test in any shard */
+        if ((executedTestCount == 0) && (skippedByShardCount > 0) && (matchingFilterCount > 0))
+        {
+            LogInfo("No test of the suite is in shard %" PRIu32 " of %" PRIu32 "", config->shard_index, config->shard_count);
+        }
         /* fail if zero tests actually ran (all were skipped by filter or no tests exist) */
-        if (totalTestCount - skippedByFilterCount == 0)
+        else if (executedTestCount == 0)
         {
             LogError(CTEST_ANSI_COLOR_RED "FAILED: zero tests were executed (totalTestCount=%d, skippedByFilter=%d). "
                 "If a test name filter is active, verify it matches at least one test." CTEST_ANSI_COLOR_RESET "",
@@ -291,6 +910,15 @@ size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteNam
         }
     }
 
+    ctest_watchdog_stop(watchdog);
+
+    for (size_t i = 0; i < suite_run.test_count; i++)
+    {
+        free(suite_run.tests[i].captured_output);
+    }
+    free(suite_run.tests);
+    ctest_filter_destroy(filter);
+
 #if defined _MSC_VER && !defined(WINCE)
     if (std_out_handle != INVALID_HANDLE_VALUE)
     {
@@ -308,6 +936,23 @@ size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteNam
     return failedTestCount;
 }
 
+size_t RunTests(const TEST_FUNCTION_DATA* testListHead, const char* testSuiteName, const char* testNameFilter)
+{
+    size_t result;
+
+    /* listing runs nothing, not even the fixtures, and writes nothing else (reports, journal, events) */
+    if (ctest_config_get()->list != 0)
+    {
+        result = ctest_list_suite(testListHead, testSuiteName, testNameFilter);
+    }
+    else
+    {
+        result = ctest_run_suite(testListHead, testSuiteName, testNameFilter);
+    }
+
+    return result;
+}
+
 static void _Bool_ToString(char* string, size_t bufferSize, int val)
 {
     (void)snprintf(string, bufferSize, "%s", val ? "true" : "false");
@@ -553,22 +1198,22 @@ static int int64_t_Compare(int64_t left, int64_t right)
 
 #endif
 
-void bool_AssertAreEqual(int left, int right, char* ctest_message, int line_no)
+void bool_AssertAreEqual(int left, int right, int line_no, const char* format, ...)
 {
     CTEST_EQUALITY_ASSERT_IMPL_FOR_TYPE(_Bool, true, line_no)
 }
 
-void _Bool_AssertAreEqual(int left, int right, char* ctest_message, int line_no)
+void _Bool_AssertAreEqual(int left, int right, int line_no, const char* format, ...)
 {
     CTEST_EQUALITY_ASSERT_IMPL_FOR_TYPE(_Bool, true, line_no)
 }
 
-void bool_AssertAreNotEqual(int left, int right, char* ctest_message, int line_no)
+void bool_AssertAreNotEqual(int left, int right, int line_no, const char* format, ...)
 {
     CTEST_EQUALITY_ASSERT_IMPL_FOR_TYPE(_Bool, false, line_no)
 }
 
-void _Bool_AssertAreNotEqual(int left, int right, char* ctest_message, int line_no)
+void _Bool_AssertAreNotEqual(int left, int right, int line_no, const char* format, ...)
 {
     CTEST_EQUALITY_ASSERT_IMPL_FOR_TYPE(_Bool, false, line_no)
 }
@@ -597,7 +1242,9 @@ CTEST_DEFINE_EQUALITY_ASSERTION_FUNCTIONS_FOR_TYPE(uint64_t,)
 CTEST_DEFINE_EQUALITY_ASSERTION_FUNCTIONS_FOR_TYPE(int64_t,)
 #endif
 
-static char* ctest_vsprintf_char(const char* format, va_list va)
+/*returns a char* that is as if printed by vprintf*/
+/*needs to be free'd after usage*/
+char* ctest_vsprintf_char(const char* format, va_list va)
 {
     char* result;
     va_list va_clone;
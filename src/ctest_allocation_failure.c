@@ -0,0 +1,428 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+#if defined CTEST_USE_LEAK_TRACKER
+
+#include <errno.h>
+#include <poll.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Allocation failure sweep (CTEST_ALLOCATION_FAILURE_SWEEP). After TEST_FUNCTION_INITIALIZE, a first child process runs the test body
+   and TEST_FUNCTION_CLEANUP counting the allocations of the body. Then, for each allocation k, a child forked from the same point
+   (so the fixture does not run again) runs the test with the k-th allocation failing. As many children run at a time as there are
+   processors. A child that crashes, hangs, fails an assert or leaks more blocks than the counting run is reported with its output.
+   The test itself then runs as usual in the process. */
+
+/* how often children are checked for timeouts */
+#define CTEST_ALLOCATION_FAILURE_POLL_PERIOD_MS 50
+/* the output kept for each child, the rest is dropped */
+#define CTEST_ALLOCATION_FAILURE_OUTPUT_SIZE (64 * 1024)
+
+/* written by a child in memory shared with the parent, is_done stays 0 when the child dies before the end of the test */
+typedef struct CTEST_ALLOCATION_FAILURE_RUN_TAG
+{
+    volatile int is_done;
+    TEST_RESULT test_result;
+    uint64_t allocation_count;
+    size_t leak_count;
+    bool is_failure_injected;
+} CTEST_ALLOCATION_FAILURE_RUN;
+
+typedef struct CTEST_ALLOCATION_FAILURE_CHILD_TAG
+{
+    pid_t pid;
+    int read_fd; /* -1 when the slot has no running child */
+    uint64_t failing_allocation;
+    uint64_t start_wall_ns;
+    bool is_timed_out;
+    CTEST_ALLOCATION_FAILURE_RUN* run;
+    char* output;
+    size_t output_length;
+    bool is_output_truncated;
+} CTEST_ALLOCATION_FAILURE_CHILD;
+
+/* the stack of the injected failure, the child then dies of the signal */
+static void ctest_allocation_failure_on_crash(const CTEST_CRASH* crash)
+{
+    (void)crash;
+    ctest_leak_tracker_write_injected_failure(STDERR_FILENO);
+}
+
+static void ctest_allocation_failure_child_main(CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run, uint64_t failing_allocation, CTEST_ALLOCATION_FAILURE_RUN* run)
+{
+    const TEST_FUNCTION_DATA* test_function = test_run->test_function;
+    uint32_t leak_test_scope = ctest_leak_tracker_begin_test();
+
+    /* the test is run (and ended) once more by the parent */
+    ctest_events_disable();
+    /* the output is shown by the parent when the injected failure was not handled */
+    ctest_quiet_disable();
+    /* what was logged before a crash is kept */
+    (void)setvbuf(stdout, NULL, _IOLBF, 0);
+    /* what the parent writes for a crash (its reports, its captured output) is not for the child */
+    ctest_crash_clear_hooks();
+    ctest_crash_set_hook(CTEST_CRASH_HOOK_ALLOCATION_FAILURE, ctest_allocation_failure_on_crash);
+
+    *test_function->TestResult = TEST_SUCCESS;
+    g_CurrentTestFunction = test_function;
+    ctest_leak_tracker_begin_allocation_failure(failing_allocation);
+    if (setjmp(g_ExceptionJump) == 0)
+    {
+        test_function->TestFunction();
+    }
+    run->allocation_count = ctest_leak_tracker_end_allocation_failure();
+    g_CurrentTestFunction = NULL;
+
+    if (setjmp(g_ExceptionJump) == 0)
+    {
+        if (suite_run->test_function_cleanup != NULL)
+        {
+            suite_run->test_function_cleanup->TestFunction();
+        }
+    }
+    else
+    {
+        *test_function->TestResult = TEST_FAILED;
+    }
+
+    ctest_leak_tracker_log_injected_failure();
+    run->leak_count = ctest_leak_tracker_end_test(leak_test_scope, test_function->TestFunctionName);
+    run->test_result = *test_function->TestResult;
+    run->is_failure_injected = ctest_leak_tracker_is_allocation_failure_injected();
+    (void)fflush(NULL);
+    run->is_done = 1;
+}
+
+static bool ctest_allocation_failure_start_child(CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run, uint64_t failing_allocation, CTEST_ALLOCATION_FAILURE_CHILD* child)
+{
+    bool result;
+    int fds[2];
+
+    if (pipe(fds) != 0)
+    {
+        LogError("failure in pipe, errno=%d", errno);
+        result = false;
+    }
+    else
+    {
+        /* anything buffered before the fork would otherwise be written once by every child */
+        (void)fflush(NULL);
+        (void)memset(child->run, 0, sizeof(CTEST_ALLOCATION_FAILURE_RUN));
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            LogError("failure in fork, errno=%d", errno);
+            (void)close(fds[0]);
+            (void)close(fds[1]);
+            result = false;
+        }
+        else if (pid == 0)
+        {
+            /* the output of the child is only shown when the injected failure was not handled */
+            (void)close(fds[0]);
+            (void)dup2(fds[1], STDOUT_FILENO);
+            (void)dup2(fds[1], STDERR_FILENO);
+            (void)close(fds[1]);
+            ctest_allocation_failure_child_main(suite_run, test_run, failing_allocation, child->run);
+            /* _exit: the atexit handlers and static destructors belong to the process that forked the child */
+            _exit(0);
+        }
+        else
+        {
+            (void)close(fds[1]);
+            child->pid = pid;
+            child->read_fd = fds[0];
+            child->failing_allocation = failing_allocation;
+            child->start_wall_ns = ctest_timing_get_wall_ns();
+            child->is_timed_out = false;
+            child->output_length = 0;
+            child->is_output_truncated = false;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+/* false at the end of the output */
+static bool ctest_allocation_failure_read_output(CTEST_ALLOCATION_FAILURE_CHILD* child)
+{
+    char buffer[4096];
+    ssize_t read_bytes = read(child->read_fd, buffer, sizeof(buffer));
+    if (read_bytes > 0)
+    {
+        size_t kept_bytes = (size_t)read_bytes;
+        if (kept_bytes > CTEST_ALLOCATION_FAILURE_OUTPUT_SIZE - child->output_length)
+        {
+            kept_bytes = CTEST_ALLOCATION_FAILURE_OUTPUT_SIZE - child->output_length;
+            child->is_output_truncated = true;
+        }
+        (void)memcpy(child->output + child->output_length, buffer, kept_bytes);
+        child->output_length += kept_bytes;
+    }
+    return (read_bytes > 0) || ((read_bytes < 0) && (errno == EINTR));
+}
+
+/* waits for the child, returns a description of what went wrong, NULL when the injected failure was handled */
+static const char* ctest_allocation_failure_finish_child(CTEST_ALLOCATION_FAILURE_CHILD* child, size_t baseline_leak_count, char* reason, size_t reason_size)
+{
+    const char* result = NULL;
+    int status = 0;
+
+    (void)close(child->read_fd);
+    child->read_fd = -1;
+    while ((waitpid(child->pid, &status, 0) < 0) && (errno == EINTR))
+    {
+    }
+
+    if (child->is_timed_out)
+    {
+        result = "timed out";
+    }
+    else if (WIFSIGNALED(status))
+    {
+        (void)snprintf(reason, reason_size, "crashed with signal %d", WTERMSIG(status));
+        result = reason;
+    }
+    else if (!child->run->is_done)
+    {
+        (void)snprintf(reason, reason_size, "exited with %d before the end of the test", WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+        result = reason;
+    }
+    else if (child->run->test_result == TEST_FAILED)
+    {
+        result = "failed";
+    }
+    else if (child->run->leak_count > baseline_leak_count)
+    {
+        (void)snprintf(reason, reason_size, "leaked %zu blocks", child->run->leak_count - baseline_leak_count);
+        result = reason;
+    }
+    else
+    {
+        /* handled, or the allocation did not happen in this run */
+    }
+
+    return result;
+}
+
+static void ctest_allocation_failure_log_output(const CTEST_ALLOCATION_FAILURE_CHILD* child)
+{
+    (void)fwrite(child->output, 1, child->output_length, stdout);
+    if (child->is_output_truncated)
+    {
+        (void)printf("... output truncated\n");
+    }
+    (void)fflush(stdout);
+}
+
+/* runs the children until they all finished, starting the one of the next allocation in each free slot. Returns the count of
+   injected failures that were not handled */
+static size_t ctest_allocation_failure_run_children(CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run, CTEST_ALLOCATION_FAILURE_CHILD* children, size_t child_count,
+    uint64_t allocation_count, uint64_t failure_count, size_t baseline_leak_count)
+{
+    size_t result = 0;
+    uint64_t next_failure = 0;
+    size_t running_count = 0;
+    struct pollfd* poll_fds = malloc(child_count * sizeof(struct pollfd));
+
+    if (poll_fds == NULL)
+    {
+        LogError("failure in malloc(%zu * sizeof(struct pollfd))", child_count);
+        result = 1;
+    }
+    else
+    {
+        while ((next_failure < failure_count) || (running_count > 0))
+        {
+            uint64_t now;
+
+            for (size_t i = 0; (i < child_count) && (next_failure < failure_count); i++)
+            {
+                if (children[i].read_fd == -1)
+                {
+                    /* spread over all the allocations when there are more than failure_count */
+                    uint64_t failing_allocation = 1 + (uint64_t)(((double)next_failure * (double)allocation_count) / (double)failure_count);
+                    next_failure++;
+                    if (!ctest_allocation_failure_start_child(suite_run, test_run, failing_allocation, &children[i]))
+                    {
+                        result++;
+                    }
+                    else
+                    {
+                        running_count++;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < child_count; i++)
+            {
+                poll_fds[i].fd = children[i].read_fd; /* ignored by poll when -1 */
+                poll_fds[i].events = POLLIN;
+                poll_fds[i].revents = 0;
+            }
+            if ((poll(poll_fds, child_count, CTEST_ALLOCATION_FAILURE_POLL_PERIOD_MS) < 0) && (errno != EINTR))
+            {
+                LogError("failure in poll, errno=%d", errno);
+                break;
+            }
+
+            now = ctest_timing_get_wall_ns();
+            /* the sweep enforces the test timeout on each child, the watchdog only has to see that it progresses */
+            test_run->start_wall_ns = now;
+
+            for (size_t i = 0; i < child_count; i++)
+            {
+                CTEST_ALLOCATION_FAILURE_CHILD* child = &children[i];
+                if (child->read_fd != -1)
+                {
+                    if (((poll_fds[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0) && !ctest_allocation_failure_read_output(child))
+                    {
+                        char reason[64];
+                        const char* failure_reason = ctest_allocation_failure_finish_child(child, baseline_leak_count, reason, sizeof(reason));
+                        running_count--;
+                        if (failure_reason != NULL)
+                        {
+                            result++;
+                            LogError(CTEST_ANSI_COLOR_RED "Test %s with allocation %" PRIu64 " of %" PRIu64 " failing: %s, output:" CTEST_ANSI_COLOR_RESET,
+                                test_run->test_function->TestFunctionName, child->failing_allocation, allocation_count, failure_reason);
+                            ctest_allocation_failure_log_output(child);
+                        }
+                    }
+                    else if ((suite_run->test_timeout_ms > 0) && !child->is_timed_out && ((now - child->start_wall_ns) / 1000000 >= suite_run->test_timeout_ms))
+                    {
+                        /* reaped when its pipe closes */
+                        child->is_timed_out = true;
+                        (void)kill(child->pid, SIGKILL);
+                    }
+                }
+            }
+        }
+
+        free(poll_fds);
+    }
+
+    return result;
+}
+
+static size_t ctest_allocation_failure_get_child_count(void)
+{
+    long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (processor_count < 1) ? 1 : (size_t)processor_count;
+}
+
+size_t ctest_allocation_failure_sweep(CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run)
+{
+    size_t result = 0;
+    const char* test_function_name = test_run->test_function->TestFunctionName;
+    size_t child_count = ctest_allocation_failure_get_child_count();
+    CTEST_ALLOCATION_FAILURE_RUN* runs = mmap(NULL, child_count * sizeof(CTEST_ALLOCATION_FAILURE_RUN), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CTEST_ALLOCATION_FAILURE_CHILD* children = calloc(child_count, sizeof(CTEST_ALLOCATION_FAILURE_CHILD));
+
+    if ((runs == MAP_FAILED) || (children == NULL))
+    {
+        LogError("failure allocating the allocation failure sweep of %zu processes, test %s is not swept", child_count, test_function_name);
+        result = 1;
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < child_count; i++)
+        {
+            children[i].read_fd = -1;
+            children[i].run = &runs[i];
+            children[i].output = malloc(CTEST_ALLOCATION_FAILURE_OUTPUT_SIZE);
+            if (children[i].output == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i < child_count)
+        {
+            LogError("failure in malloc(%d), test %s is not swept", CTEST_ALLOCATION_FAILURE_OUTPUT_SIZE, test_function_name);
+            result = 1;
+        }
+        else if (!ctest_allocation_failure_start_child(suite_run, test_run, 0, &children[0]))
+        {
+            result = 1;
+        }
+        else
+        {
+            /* the counting run, without failure */
+            char reason[64];
+            const char* failure_reason;
+            while (ctest_allocation_failure_read_output(&children[0]))
+            {
+            }
+            failure_reason = ctest_allocation_failure_finish_child(&children[0], SIZE_MAX, reason, sizeof(reason));
+
+            if (failure_reason != NULL)
+            {
+                LogInfo(CTEST_ANSI_COLOR_YELLOW "Test %s %s without allocation failure, it is not swept" CTEST_ANSI_COLOR_RESET, test_function_name, failure_reason);
+            }
+            else
+            {
+                uint64_t allocation_count = runs[0].allocation_count;
+                uint64_t failure_count = (allocation_count > suite_run->allocation_failure_sweep) ? suite_run->allocation_failure_sweep : allocation_count;
+                LogInfo("Test %s makes %" PRIu64 " allocations, running it with each of %" PRIu64 " of them failing (%zu processes at a time)",
+                    test_function_name, allocation_count, failure_count, child_count);
+
+                result = ctest_allocation_failure_run_children(suite_run, test_run, children, child_count, allocation_count, failure_count, runs[0].leak_count);
+                if (result == 0)
+                {
+                    LogInfo("Test %s handled all %" PRIu64 " allocation failures", test_function_name, failure_count);
+                }
+                else
+                {
+                    LogError(CTEST_ANSI_COLOR_RED "Test %s did not handle %zu of %" PRIu64 " allocation failures" CTEST_ANSI_COLOR_RESET, test_function_name, result, failure_count);
+                }
+            }
+        }
+    }
+
+    if (children != NULL)
+    {
+        for (size_t i = 0; i < child_count; i++)
+        {
+            free(children[i].output);
+        }
+        free(children);
+    }
+    if (runs != MAP_FAILED)
+    {
+        (void)munmap(runs, child_count * sizeof(CTEST_ALLOCATION_FAILURE_RUN));
+    }
+
+    return result;
+}
+
+bool ctest_is_allocation_failure_injected(void)
+{
+    return ctest_leak_tracker_is_allocation_failure_injected();
+}
+#else
+bool ctest_is_allocation_failure_injected(void)
+{
+    return false;
+}
+#endif
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* The allocations of a scope are counted by the allocation tracker (ctest_leak_tracker.c) on the thread that opened it. Scopes nest,
+   the allocations of an inner scope also count in the outer ones. */
+
+void ctest_allocation_scope_begin(CTEST_ALLOCATION_SCOPE* scope, size_t max_count, size_t max_bytes)
+{
+    scope->max_count = max_count;
+    scope->max_bytes = max_bytes;
+    scope->count = 0;
+    scope->bytes = 0;
+    scope->site_count = 0;
+    scope->is_open = 1;
+#if defined CTEST_USE_LEAK_TRACKER
+    scope->outer_scope = ctest_leak_tracker_set_allocation_scope(scope);
+#else
+    scope->outer_scope = NULL;
+#endif
+}
+
+#if defined CTEST_USE_LEAK_TRACKER
+static void ctest_allocation_scope_add_to_outer_scope(const CTEST_ALLOCATION_SCOPE* scope, CTEST_ALLOCATION_SCOPE* outer_scope)
+{
+    outer_scope->count += scope->count;
+    outer_scope->bytes += scope->bytes;
+    for (size_t i = 0; i < scope->site_count; i++)
+    {
+        size_t j;
+        for (j = 0; j < outer_scope->site_count; j++)
+        {
+            if (outer_scope->sites[j].caller == scope->sites[i].caller)
+            {
+                outer_scope->sites[j].count += scope->sites[i].count;
+                outer_scope->sites[j].bytes += scope->sites[i].bytes;
+                break;
+            }
+        }
+        if ((j == outer_scope->site_count) && (j < CTEST_ALLOCATION_SCOPE_MAX_SITE_COUNT))
+        {
+            outer_scope->sites[j] = scope->sites[i];
+            outer_scope->site_count++;
+        }
+    }
+}
+#endif
+
+void ctest_allocation_scope_end(CTEST_ALLOCATION_SCOPE* scope, int line_no)
+{
+    scope->is_open = 0;
+
+#if defined CTEST_USE_LEAK_TRACKER
+    /* closed before logging, which can allocate */
+    (void)ctest_leak_tracker_set_allocation_scope(scope->outer_scope);
+    if (scope->outer_scope != NULL)
+    {
+        ctest_allocation_scope_add_to_outer_scope(scope, scope->outer_scope);
+    }
+
+    if ((scope->count > scope->max_count) || (scope->bytes > scope->max_bytes))
+    {
+        size_t sites_bytes = 0;
+        LogError("  Assert failed in line %d: %zu allocations of %zu bytes, at most %zu allocations of %zu bytes expected\n",
+            line_no, scope->count, scope->bytes, scope->max_count, scope->max_bytes);
+        for (size_t i = 0; i < scope->site_count; i++)
+        {
+            LogError("  %zu allocations of %zu bytes at:", scope->sites[i].count, scope->sites[i].bytes);
+            ctest_leak_tracker_log_allocation_site(&scope->sites[i]);
+            sites_bytes += scope->sites[i].bytes;
+        }
+        if (sites_bytes < scope->bytes)
+        {
+            LogError("  %zu bytes allocated at other sites", scope->bytes - sites_bytes);
+        }
+        char expected[64];
+        char actual[64];
+        (void)snprintf(expected, sizeof(expected), "%zu allocations of %zu bytes", scope->max_count, scope->max_bytes);
+        (void)snprintf(actual, sizeof(actual), "%zu allocations of %zu bytes", scope->count, scope->bytes);
+        ctest_events_assert_failed(line_no, NULL, expected, actual, NULL);
+        if (g_CurrentTestFunction != NULL) *g_CurrentTestFunction->TestResult = TEST_FAILED;
+        do_jump(&g_ExceptionJump, "expected at most the allowed allocations", "but there were more");
+    }
+#else
+    static volatile int is_warning_logged = 0;
+    if (!is_warning_logged)
+    {
+        is_warning_logged = 1;
+        LogWarning("The allocation assertions need ctest built with use_leak_tracker (Linux), the one in line %d is not checked", line_no);
+    }
+#endif
+}
@@ -0,0 +1,1060 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <math.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+/* The baseline is the "benchmarks" array of a Google Benchmark JSON file, so the Google Benchmark tools (compare.py) read it:
+   - every sample of a benchmark is an "iteration" run (one repetition), followed by its mean, median and stddev "aggregate" runs
+   - every test is one "iteration" run of 1 iteration
+   Runs are named "suite.test" and times are in ns. The context has "ctest_baseline_version", a baseline with another version is
+   rejected. Reading keeps the "iteration" runs only, so files written by Google Benchmark itself can be compared with. */
+
+#define CTEST_BASELINE_VERSION 1
+#define CTEST_BASELINE_MAX_NAME_LENGTH 512
+#define CTEST_BASELINE_MAX_JSON_DEPTH 64
+
+/* a benchmark slower than the threshold regressed when a one sided Mann-Whitney U test says it is not noise, which needs enough
+   samples on both sides. With fewer samples the threshold alone decides. */
+#define CTEST_BASELINE_U_TEST_MIN_SAMPLE_COUNT 5
+#define CTEST_BASELINE_SIGNIFICANCE 0.05
+
+/* a test is timed once, so a test slower than the threshold by less than this is scheduling noise, not a regression */
+#define CTEST_BASELINE_TEST_MIN_REGRESSION_NS 1000000
+
+typedef struct CTEST_BASELINE_RECORD_TAG
+{
+    char* name; /* suite.test */
+    bool is_benchmark;
+    CTEST_TIMING test_timing;
+    CTEST_BENCHMARK_RESULT benchmark_result;
+    CTEST_PERF_COUNTERS perf_counters;
+} CTEST_BASELINE_RECORD;
+
+/* one "iteration" run read from a baseline */
+typedef struct CTEST_BASELINE_SAMPLE_TAG
+{
+    char* name;
+    double time_ns;
+} CTEST_BASELINE_SAMPLE;
+
+/* the records of all the suites run by the process so far, sorted by name between suites, each suite rewrites the output file with all
+   of them */
+static CTEST_BASELINE_RECORD* g_records;
+static size_t g_record_count;
+static size_t g_record_capacity;
+
+/* the last baseline read, sorted by name, kept for the next suites */
+static char g_baseline_path[CTEST_CONFIG_PATH_SIZE];
+static bool g_is_baseline_valid;
+static CTEST_BASELINE_SAMPLE* g_baseline_samples;
+static size_t g_baseline_sample_count;
+static size_t g_baseline_sample_capacity;
+
+static bool g_is_cleanup_registered = false;
+
+static void ctest_baseline_free_baseline(void)
+{
+    for (size_t i = 0; i < g_baseline_sample_count; i++)
+    {
+        free(g_baseline_samples[i].name);
+    }
+    free(g_baseline_samples);
+    g_baseline_samples = NULL;
+    g_baseline_sample_count = 0;
+    g_baseline_sample_capacity = 0;
+    g_baseline_path[0] = '\0';
+    g_is_baseline_valid = false;
+}
+
+/* at exit, so that the leak checks do not report the state kept between suites */
+static void ctest_baseline_cleanup(void)
+{
+    for (size_t i = 0; i < g_record_count; i++)
+    {
+        free(g_records[i].name);
+    }
+    free(g_records);
+    g_records = NULL;
+    g_record_count = 0;
+    g_record_capacity = 0;
+
+    ctest_baseline_free_baseline();
+}
+
+static void ctest_baseline_register_cleanup(void)
+{
+    if (!g_is_cleanup_registered)
+    {
+        g_is_cleanup_registered = true;
+        (void)atexit(ctest_baseline_cleanup);
+    }
+}
+
+static FILE* ctest_baseline_open_file(const char* path, const char* mode)
+{
+    FILE* result;
+#if defined _MSC_VER
+    if (fopen_s(&result, path, mode) != 0)
+    {
+        result = NULL;
+    }
+#else
+    result = fopen(path, mode);
+#endif
+    return result;
+}
+
+static char* ctest_baseline_make_name(const char* test_suite_name, const char* test_function_name)
+{
+    size_t suite_name_length = strlen(test_suite_name);
+    size_t function_name_length = strlen(test_function_name);
+    char* result = malloc(suite_name_length + 1 + function_name_length + 1);
+    if (result == NULL)
+    {
+        LogError("failure in malloc(%zu + 1 + %zu + 1)", suite_name_length, function_name_length);
+    }
+    else
+    {
+        (void)memcpy(result, test_suite_name, suite_name_length);
+        result[suite_name_length] = '.';
+        (void)memcpy(result + suite_name_length + 1, test_function_name, function_name_length + 1);
+    }
+    return result;
+}
+
+/* the tests whose time means something: executed and succeeded, and for benchmarks measured */
+static bool ctest_baseline_is_test_measured(const CTEST_TEST_RUN* test_run)
+{
+    return test_run->is_selected &&
+        (*test_run->test_function->TestResult == TEST_SUCCESS) &&
+        ((test_run->test_function->FunctionType != CTEST_BENCHMARK_FUNCTION) || (test_run->benchmark_result.sample_count > 0));
+}
+
+static int ctest_baseline_compare_record_names(const void* left, const void* right)
+{
+    return strcmp(((const CTEST_BASELINE_RECORD*)left)->name, ((const CTEST_BASELINE_RECORD*)right)->name);
+}
+
+/* the records of the previous suites are the first sorted_record_count ones, the ones of the suite are appended after them */
+static bool ctest_baseline_add_record(const char* test_suite_name, const CTEST_TEST_RUN* test_run, size_t sorted_record_count)
+{
+    bool result;
+    char* name = ctest_baseline_make_name(test_suite_name, test_run->test_function->TestFunctionName);
+    if (name == NULL)
+    {
+        result = false;
+    }
+    else
+    {
+        CTEST_BASELINE_RECORD key;
+        key.name = name;
+        /* a suite run again by the process replaces its previous records, the names of the tests of a suite are unique */
+        CTEST_BASELINE_RECORD* record = (sorted_record_count == 0) ? NULL :
+            bsearch(&key, g_records, sorted_record_count, sizeof(CTEST_BASELINE_RECORD), ctest_baseline_compare_record_names);
+        if (record != NULL)
+        {
+            free(record->name);
+        }
+
+        if ((record == NULL) && (g_record_count == g_record_capacity))
+        {
+            size_t new_capacity = (g_record_capacity == 0) ? 16 : g_record_capacity * 2;
+            CTEST_BASELINE_RECORD* new_records = realloc(g_records, sizeof(CTEST_BASELINE_RECORD) * new_capacity);
+            if (new_records == NULL)
+            {
+                LogError("failure in realloc(sizeof(CTEST_BASELINE_RECORD) * %zu)", new_capacity);
+            }
+            else
+            {
+                g_records = new_records;
+                g_record_capacity = new_capacity;
+            }
+        }
+
+        if ((record == NULL) && (g_record_count < g_record_capacity))
+        {
+            record = &g_records[g_record_count++];
+        }
+
+        if (record == NULL)
+        {
+            free(name);
+            result = false;
+        }
+        else
+        {
+            record->name = name;
+            record->is_benchmark = (test_run->test_function->FunctionType == CTEST_BENCHMARK_FUNCTION);
+            record->test_timing = test_run->test_timing;
+            record->benchmark_result = test_run->benchmark_result;
+            record->perf_counters = test_run->perf_counters;
+            result = true;
+        }
+    }
+    return result;
+}
+
+/* suffix (NULL for none) is appended to text inside the quotes */
+static void ctest_baseline_write_string(FILE* file, const char* text, const char* suffix)
+{
+    (void)fputc('"', file);
+    for (const unsigned char* c = (const unsigned char*)text; *c != '\0'; c++)
+    {
+        if ((*c == '"') || (*c == '\\'))
+        {
+            (void)fprintf(file, "\\%c", *c);
+        }
+        else if (*c < 0x20)
+        {
+            (void)fprintf(file, "\\u%04x", *c);
+        }
+        else
+        {
+            (void)fputc(*c, file);
+        }
+    }
+    if (suffix != NULL)
+    {
+        (void)fprintf(file, "%s", suffix);
+    }
+    (void)fputc('"', file);
+}
+
+/* the perf counters are written per iteration, as Google Benchmark user counters named like "cache_misses" */
+static void ctest_baseline_write_perf_counters(FILE* file, const CTEST_PERF_COUNTERS* perf_counters)
+{
+    for (uint32_t i = 0; i < CTEST_PERF_COUNTER_COUNT; i++)
+    {
+        if ((perf_counters->valid_mask & (1U << i)) != 0)
+        {
+            (void)fprintf(file, "      \"");
+            for (const char* c = ctest_perf_counters_get_name((CTEST_PERF_COUNTER)i); *c != '\0'; c++)
+            {
+                (void)fputc((*c == ' ') ? '_' : *c, file);
+            }
+            (void)fprintf(file, "\": %.4f,\n", (double)perf_counters->values[i] / (double)perf_counters->iterations);
+        }
+    }
+}
+
+static void ctest_baseline_write_run(FILE* file, bool is_first, const char* name, size_t family_index, const char* aggregate_name,
+    uint32_t repetitions, uint32_t repetition_index, uint64_t iterations, double real_time_ns, double cpu_time_ns, const CTEST_PERF_COUNTERS* perf_counters)
+{
+    (void)fprintf(file, "%s\n    {\n      \"name\": ", is_first ? "" : ",");
+    /* like Google Benchmark, the aggregates of x are named x_mean, x_median and x_stddev */
+    ctest_baseline_write_string(file, name, (aggregate_name == NULL) ? NULL : (strcmp(aggregate_name, "mean") == 0) ? "_mean" : (strcmp(aggregate_name, "median") == 0) ? "_median" : "_stddev");
+    (void)fprintf(file, ",\n      \"family_index\": %zu,\n      \"per_family_instance_index\": 0,\n      \"run_name\": ", family_index);
+    ctest_baseline_write_string(file, name, NULL);
+    (void)fprintf(file, ",\n      \"run_type\": \"%s\",\n", (aggregate_name == NULL) ? "iteration" : "aggregate");
+    (void)fprintf(file, "      \"repetitions\": %" PRIu32 ",\n", repetitions);
+    if (aggregate_name == NULL)
+    {
+        (void)fprintf(file, "      \"repetition_index\": %" PRIu32 ",\n", repetition_index);
+    }
+    (void)fprintf(file, "      \"threads\": 1,\n");
+    if (aggregate_name != NULL)
+    {
+        (void)fprintf(file, "      \"aggregate_name\": \"%s\",\n      \"aggregate_unit\": \"time\",\n", aggregate_name);
+    }
+    if ((perf_counters != NULL) && (perf_counters->iterations > 0))
+    {
+        ctest_baseline_write_perf_counters(file, perf_counters);
+    }
+    (void)fprintf(file, "      \"iterations\": %" PRIu64 ",\n      \"real_time\": %.4f,\n      \"cpu_time\": %.4f,\n      \"time_unit\": \"ns\"\n    }",
+        iterations, real_time_ns, cpu_time_ns);
+}
+
+static bool ctest_baseline_write_file(const char* path)
+{
+    bool result;
+    FILE* file = ctest_baseline_open_file(path, "w");
+    if (file == NULL)
+    {
+        LogError("failure opening the baseline %s for writing", path);
+        result = false;
+    }
+    else
+    {
+        bool is_first = true;
+
+        (void)fprintf(file, "{\n  \"context\": {\n");
+        (void)fprintf(file, "    \"num_cpus\": %" PRIu32 ",\n", ctest_get_processor_count());
+#if defined NDEBUG
+        (void)fprintf(file, "    \"library_build_type\": \"release\",\n");
+#else
+        (void)fprintf(file, "    \"library_build_type\": \"debug\",\n");
+#endif
+        (void)fprintf(file, "    \"ctest_baseline_version\": %d\n  },\n  \"benchmarks\": [", CTEST_BASELINE_VERSION);
+
+        for (size_t i = 0; i < g_record_count; i++)
+        {
+            const CTEST_BASELINE_RECORD* record = &g_records[i];
+            if (record->is_benchmark)
+            {
+                const CTEST_BENCHMARK_RESULT* benchmark_result = &record->benchmark_result;
+                /* the samples are wall time, the cpu time of the loop is not measured */
+                for (uint32_t j = 0; j < benchmark_result->sample_count; j++)
+                {
+                    ctest_baseline_write_run(file, is_first, record->name, i, NULL, benchmark_result->sample_count, j,
+                        benchmark_result->iterations, benchmark_result->samples_ns[j], benchmark_result->samples_ns[j], &record->perf_counters);
+                    is_first = false;
+                }
+                ctest_baseline_write_run(file, false, record->name, i, "mean", benchmark_result->sample_count, 0,
+                    benchmark_result->sample_count, benchmark_result->mean_ns, benchmark_result->mean_ns, NULL);
+                ctest_baseline_write_run(file, false, record->name, i, "median", benchmark_result->sample_count, 0,
+                    benchmark_result->sample_count, benchmark_result->median_ns, benchmark_result->median_ns, NULL);
+                ctest_baseline_write_run(file, false, record->name, i, "stddev", benchmark_result->sample_count, 0,
+                    benchmark_result->sample_count, benchmark_result->stddev_ns, benchmark_result->stddev_ns, NULL);
+            }
+            else
+            {
+                ctest_baseline_write_run(file, is_first, record->name, i, NULL, 1, 0, 1,
+                    (double)record->test_timing.wall_ns, (double)record->test_timing.cpu_ns, &record->perf_counters);
+                is_first = false;
+            }
+        }
+
+        (void)fprintf(file, "\n  ]\n}\n");
+
+        result = (ferror(file) == 0);
+        if (fclose(file) != 0)
+        {
+            result = false;
+        }
+        if (!result)
+        {
+            LogError("failure writing the baseline %s", path);
+        }
+    }
+    return result;
+}
+
+bool ctest_baseline_write(const CTEST_SUITE_RUN* suite_run, const char* path)
+{
+    bool result = true;
+
+    ctest_baseline_register_cleanup();
+
+    size_t sorted_record_count = g_record_count;
+    for (size_t i = 0; i < suite_run->test_count; i++)
+    {
+        if (ctest_baseline_is_test_measured(&suite_run->tests[i]) && !ctest_baseline_add_record(suite_run->test_suite_name, &suite_run->tests[i], sorted_record_count))
+        {
+            result = false;
+        }
+    }
+    if (g_record_count > sorted_record_count)
+    {
+        qsort(g_records, g_record_count, sizeof(CTEST_BASELINE_RECORD), ctest_baseline_compare_record_names);
+    }
+
+    if (!ctest_baseline_write_file(path))
+    {
+        result = false;
+    }
+    else
+    {
+        LogInfo(" ### Baseline written to %s", path);
+    }
+
+    return result;
+}
+
+/* a minimal JSON reader: values are read or skipped in place, *json is moved past what was read */
+
+static void ctest_baseline_skip_space(const char** json)
+{
+    while ((**json == ' ') || (**json == '\t') || (**json == '\r') || (**json == '\n'))
+    {
+        (*json)++;
+    }
+}
+
+static bool ctest_baseline_read_char(const char** json, char expected)
+{
+    bool result;
+    ctest_baseline_skip_space(json);
+    if (**json != expected)
+    {
+        result = false;
+    }
+    else
+    {
+        (*json)++;
+        result = true;
+    }
+    return result;
+}
+
+/* buffer NULL skips the string, characters that are not ASCII are read as '?' */
+static bool ctest_baseline_read_string(const char** json, char* buffer, size_t buffer_size)
+{
+    bool result;
+    size_t length = 0;
+
+    if (!ctest_baseline_read_char(json, '"'))
+    {
+        result = false;
+    }
+    else
+    {
+        result = true;
+        while (**json != '"')
+        {
+            char c = **json;
+            if (c == '\0')
+            {
+                result = false;
+                break;
+            }
+            else if (c == '\\')
+            {
+                (*json)++;
+                switch (**json)
+                {
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+                    case '"': case '\\': case '/': c = **json; break;
+                    case 'u':
+                    {
+                        unsigned int code_point = 0;
+                        for (int i = 1; (i <= 4) && result; i++)
+                        {
+                            /* stops at the terminating zero, which is not a hex digit */
+                            char digit = (*json)[i];
+                            if ((digit >= '0') && (digit <= '9'))
+                            {
+                                code_point = code_point * 16 + (unsigned int)(digit - '0');
+                            }
+                            else if ((digit >= 'a') && (digit <= 'f'))
+                            {
+                                code_point = code_point * 16 + (unsigned int)(digit - 'a' + 10);
+                            }
+                            else if ((digit >= 'A') && (digit <= 'F'))
+                            {
+                                code_point = code_point * 16 + (unsigned int)(digit - 'A' + 10);
+                            }
+                            else
+                            {
+                                result = false;
+                            }
+                        }
+                        if (result)
+                        {
+                            c = (code_point < 0x80) ? (char)code_point : '?';
+                            *json += 4;
+                        }
+                        break;
+                    }
+                    default:
+                        result = false;
+                        break;
+                }
+                if (!result)
+                {
+                    break;
+                }
+            }
+
+            if (buffer != NULL)
+            {
+                if (length + 1 >= buffer_size)
+                {
+                    result = false;
+                    break;
+                }
+                buffer[length++] = c;
+            }
+            (*json)++;
+        }
+
+        if (result)
+        {
+            (*json)++;
+            if (buffer != NULL)
+            {
+                buffer[length] = '\0';
+            }
+        }
+    }
+    return result;
+}
+
+static bool ctest_baseline_read_number(const char** json, double* value)
+{
+    bool result;
+    char* end;
+    ctest_baseline_skip_space(json);
+    *value = strtod(*json, &end);
+    if (end == *json)
+    {
+        result = false;
+    }
+    else
+    {
+        *json = end;
+        result = true;
+    }
+    return result;
+}
+
+/* moves to the next member of an object after its '{' or after the previous member and reads its name. Returns false after the
+   closing '}', and on a syntax error (setting *is_valid to false). */
+static bool ctest_baseline_next_member(const char** json, bool* is_first, char* name, size_t name_size, bool* is_valid)
+{
+    bool result = false;
+    ctest_baseline_skip_space(json);
+    if (**json == '}')
+    {
+        (*json)++;
+    }
+    else if (!*is_first && !ctest_baseline_read_char(json, ','))
+    {
+        *is_valid = false;
+    }
+    else if (!ctest_baseline_read_string(json, name, name_size) || !ctest_baseline_read_char(json, ':'))
+    {
+        *is_valid = false;
+    }
+    else
+    {
+        *is_first = false;
+        result = true;
+    }
+    return result;
+}
+
+/* same as ctest_baseline_next_member, for the elements of an array */
+static bool ctest_baseline_next_element(const char** json, bool* is_first, bool* is_valid)
+{
+    bool result = false;
+    ctest_baseline_skip_space(json);
+    if (**json == ']')
+    {
+        (*json)++;
+    }
+    else if (!*is_first && !ctest_baseline_read_char(json, ','))
+    {
+        *is_valid = false;
+    }
+    else
+    {
+        *is_first = false;
+        result = true;
+    }
+    return result;
+}
+
+static bool ctest_baseline_skip_value(const char** json, uint32_t depth)
+{
+    bool result = true;
+    ctest_baseline_skip_space(json);
+    if (depth > CTEST_BASELINE_MAX_JSON_DEPTH)
+    {
+        result = false;
+    }
+    else if (**json == '{')
+    {
+        bool is_first = true;
+        (*json)++;
+        while (ctest_baseline_next_member(json, &is_first, NULL, 0, &result) && result)
+        {
+            result = ctest_baseline_skip_value(json, depth + 1);
+        }
+    }
+    else if (**json == '[')
+    {
+        bool is_first = true;
+        (*json)++;
+        while (ctest_baseline_next_element(json, &is_first, &result) && result)
+        {
+            result = ctest_baseline_skip_value(json, depth + 1);
+        }
+    }
+    else if (**json == '"')
+    {
+        result = ctest_baseline_read_string(json, NULL, 0);
+    }
+    else if (strncmp(*json, "true", 4) == 0)
+    {
+        *json += 4;
+    }
+    else if (strncmp(*json, "false", 5) == 0)
+    {
+        *json += 5;
+    }
+    else if (strncmp(*json, "null", 4) == 0)
+    {
+        *json += 4;
+    }
+    else
+    {
+        double number;
+        result = ctest_baseline_read_number(json, &number);
+    }
+    return result;
+}
+
+static bool ctest_baseline_read_context(const char** json, const char* path)
+{
+    bool result = ctest_baseline_read_char(json, '{');
+    bool is_first = true;
+    char name[CTEST_BASELINE_MAX_NAME_LENGTH];
+
+    while (result && ctest_baseline_next_member(json, &is_first, name, sizeof(name), &result))
+    {
+        if (strcmp(name, "ctest_baseline_version") == 0)
+        {
+            double version;
+            if (!ctest_baseline_read_number(json, &version))
+            {
+                result = false;
+            }
+            else if (version != CTEST_BASELINE_VERSION)
+            {
+                LogError("The baseline %s has version %.0f, expected %d", path, version, CTEST_BASELINE_VERSION);
+                result = false;
+            }
+        }
+        else
+        {
+            result = ctest_baseline_skip_value(json, 1);
+        }
+    }
+    return result;
+}
+
+static bool ctest_baseline_add_sample(const char* name, double time_ns)
+{
+    bool result;
+
+    if (g_baseline_sample_count == g_baseline_sample_capacity)
+    {
+        size_t new_capacity = (g_baseline_sample_capacity == 0) ? 64 : g_baseline_sample_capacity * 2;
+        CTEST_BASELINE_SAMPLE* new_samples = realloc(g_baseline_samples, sizeof(CTEST_BASELINE_SAMPLE) * new_capacity);
+        if (new_samples == NULL)
+        {
+            LogError("failure in realloc(sizeof(CTEST_BASELINE_SAMPLE) * %zu)", new_capacity);
+        }
+        else
+        {
+            g_baseline_samples = new_samples;
+            g_baseline_sample_capacity = new_capacity;
+        }
+    }
+
+    if (g_baseline_sample_count == g_baseline_sample_capacity)
+    {
+        result = false;
+    }
+    else
+    {
+        size_t name_length = strlen(name);
+        CTEST_BASELINE_SAMPLE* sample = &g_baseline_samples[g_baseline_sample_count];
+        sample->name = malloc(name_length + 1);
+        if (sample->name == NULL)
+        {
+            LogError("failure in malloc(%zu + 1)", name_length);
+            result = false;
+        }
+        else
+        {
+            (void)memcpy(sample->name, name, name_length + 1);
+            sample->time_ns = time_ns;
+            g_baseline_sample_count++;
+            result = true;
+        }
+    }
+    return result;
+}
+
+static bool ctest_baseline_read_run(const char** json)
+{
+    bool result = ctest_baseline_read_char(json, '{');
+    bool is_first = true;
+    char member_name[CTEST_BASELINE_MAX_NAME_LENGTH];
+    char name[CTEST_BASELINE_MAX_NAME_LENGTH] = "";
+    char run_name[CTEST_BASELINE_MAX_NAME_LENGTH] = "";
+    char run_type[32] = "iteration";
+    char time_unit[8] = "ns";
+    double real_time = 0;
+    bool has_real_time = false;
+
+    while (result && ctest_baseline_next_member(json, &is_first, member_name, sizeof(member_name), &result))
+    {
+        if (strcmp(member_name, "name") == 0)
+        {
+            result = ctest_baseline_read_string(json, name, sizeof(name));
+        }
+        else if (strcmp(member_name, "run_name") == 0)
+        {
+            result = ctest_baseline_read_string(json, run_name, sizeof(run_name));
+        }
+        else if (strcmp(member_name, "run_type") == 0)
+        {
+            result = ctest_baseline_read_string(json, run_type, sizeof(run_type));
+        }
+        else if (strcmp(member_name, "time_unit") == 0)
+        {
+            result = ctest_baseline_read_string(json, time_unit, sizeof(time_unit));
+        }
+        else if (strcmp(member_name, "real_time") == 0)
+        {
+            result = ctest_baseline_read_number(json, &real_time);
+            has_real_time = true;
+        }
+        else
+        {
+            result = ctest_baseline_skip_value(json, 1);
+        }
+    }
+
+    if (result && has_real_time && (strcmp(run_type, "iteration") == 0))
+    {
+        double ns_per_unit = (strcmp(time_unit, "ns") == 0) ? 1.0 :
+            (strcmp(time_unit, "us") == 0) ? 1000.0 :
+            (strcmp(time_unit, "ms") == 0) ? 1000000.0 :
+            (strcmp(time_unit, "s") == 0) ? 1000000000.0 : 0.0;
+        if (ns_per_unit == 0.0)
+        {
+            LogError("Unknown time_unit %s in the baseline", time_unit);
+            result = false;
+        }
+        else
+        {
+            result = ctest_baseline_add_sample((run_name[0] != '\0') ? run_name : name, real_time * ns_per_unit);
+        }
+    }
+    return result;
+}
+
+static bool ctest_baseline_parse(const char* json, const char* path)
+{
+    bool result = ctest_baseline_read_char(&json, '{');
+    bool is_first = true;
+    char name[CTEST_BASELINE_MAX_NAME_LENGTH];
+
+    while (result && ctest_baseline_next_member(&json, &is_first, name, sizeof(name), &result))
+    {
+        if (strcmp(name, "context") == 0)
+        {
+            result = ctest_baseline_read_context(&json, path);
+        }
+        else if (strcmp(name, "benchmarks") == 0)
+        {
+            bool is_first_run = true;
+            result = ctest_baseline_read_char(&json, '[');
+            while (result && ctest_baseline_next_element(&json, &is_first_run, &result))
+            {
+                result = ctest_baseline_read_run(&json);
+            }
+        }
+        else
+        {
+            result = ctest_baseline_skip_value(&json, 1);
+        }
+    }
+    return result;
+}
+
+static char* ctest_baseline_read_file(const char* path)
+{
+    char* result = NULL;
+    FILE* file = ctest_baseline_open_file(path, "rb");
+    if (file == NULL)
+    {
+        LogError("failure opening the baseline %s", path);
+    }
+    else
+    {
+        long size;
+        if ((fseek(file, 0, SEEK_END) != 0) || ((size = ftell(file)) < 0) || (fseek(file, 0, SEEK_SET) != 0))
+        {
+            LogError("failure getting the size of the baseline %s", path);
+        }
+        else
+        {
+            result = malloc((size_t)size + 1);
+            if (result == NULL)
+            {
+                LogError("failure in malloc(%ld + 1)", size);
+            }
+            else if (fread(result, 1, (size_t)size, file) != (size_t)size)
+            {
+                LogError("failure reading the baseline %s", path);
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                result[size] = '\0';
+            }
+        }
+        (void)fclose(file);
+    }
+    return result;
+}
+
+static int ctest_baseline_compare_sample_names(const void* left, const void* right)
+{
+    return strcmp(((const CTEST_BASELINE_SAMPLE*)left)->name, ((const CTEST_BASELINE_SAMPLE*)right)->name);
+}
+
+/* reads the baseline at path, unless it is the one already read */
+static bool ctest_baseline_load(const char* path)
+{
+    if (strcmp(g_baseline_path, path) != 0)
+    {
+        char* json;
+
+        ctest_baseline_free_baseline();
+        ctest_baseline_register_cleanup();
+        (void)memcpy(g_baseline_path, path, strlen(path) + 1);
+
+        json = ctest_baseline_read_file(path);
+        if (json != NULL)
+        {
+            if (!ctest_baseline_parse(json, path))
+            {
+                LogError("The baseline %s is not a valid baseline", path);
+            }
+            else
+            {
+                qsort(g_baseline_samples, g_baseline_sample_count, sizeof(CTEST_BASELINE_SAMPLE), ctest_baseline_compare_sample_names);
+                g_is_baseline_valid = true;
+            }
+            free(json);
+        }
+    }
+    return g_is_baseline_valid;
+}
+
+/* the samples named name are consecutive, returns the first one (NULL when there is none) and their count */
+static const CTEST_BASELINE_SAMPLE* ctest_baseline_find_samples(const char* name, size_t* sample_count)
+{
+    const CTEST_BASELINE_SAMPLE* result = NULL;
+    size_t low = 0;
+    size_t high = g_baseline_sample_count;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (strcmp(g_baseline_samples[middle].name, name) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    *sample_count = 0;
+    while ((low + *sample_count < g_baseline_sample_count) && (strcmp(g_baseline_samples[low + *sample_count].name, name) == 0))
+    {
+        (*sample_count)++;
+    }
+    if (*sample_count > 0)
+    {
+        result = &g_baseline_samples[low];
+    }
+    return result;
+}
+
+static int ctest_baseline_compare_double(const void* left, const void* right)
+{
+    double left_value = *(const double*)left;
+    double right_value = *(const double*)right;
+    return (left_value < right_value) ? -1 : ((left_value > right_value) ? 1 : 0);
+}
+
+static bool ctest_baseline_get_median(const CTEST_BASELINE_SAMPLE* samples, size_t sample_count, double* median_ns)
+{
+    bool result;
+    double* times_ns = malloc(sizeof(double) * sample_count);
+    if (times_ns == NULL)
+    {
+        LogError("failure in malloc(sizeof(double) * %zu)", sample_count);
+        result = false;
+    }
+    else
+    {
+        for (size_t i = 0; i < sample_count; i++)
+        {
+            times_ns[i] = samples[i].time_ns;
+        }
+        qsort(times_ns, sample_count, sizeof(double), ctest_baseline_compare_double);
+        *median_ns = (sample_count % 2 == 0) ? (times_ns[sample_count / 2 - 1] + times_ns[sample_count / 2]) / 2 : times_ns[sample_count / 2];
+        free(times_ns);
+        result = true;
+    }
+    return result;
+}
+
+/* one sided Mann-Whitney U test: the probability of the current samples being this much slower than the baseline ones if both came
+   from the same distribution. Normal approximation, with continuity and ties corrections. */
+static double ctest_baseline_get_p_value(const double* current_ns, size_t current_count, const CTEST_BASELINE_SAMPLE* baseline, size_t baseline_count)
+{
+    double result;
+    double u = 0;
+    double tie_sum = 0;
+    double n1 = (double)current_count;
+    double n2 = (double)baseline_count;
+    double n = n1 + n2;
+    double variance;
+
+    for (size_t i = 0; i < current_count; i++)
+    {
+        for (size_t j = 0; j < baseline_count; j++)
+        {
+            u += (current_ns[i] > baseline[j].time_ns) ? 1.0 : ((current_ns[i] == baseline[j].time_ns) ? 0.5 : 0.0);
+        }
+    }
+
+    /* sum of t^3 - t over the groups of t equal values, each of the t values of a group adding t^2 - 1 */
+    for (size_t i = 0; i < current_count + baseline_count; i++)
+    {
+        double value = (i < current_count) ? current_ns[i] : baseline[i - current_count].time_ns;
+        double equal_count = 0;
+        for (size_t j = 0; j < current_count + baseline_count; j++)
+        {
+            if (((j < current_count) ? current_ns[j] : baseline[j - current_count].time_ns) == value)
+            {
+                equal_count++;
+            }
+        }
+        tie_sum += equal_count * equal_count - 1;
+    }
+
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_sum / (n * (n - 1)));
+    if (variance <= 0)
+    {
+        /* all the samples are equal */
+        result = 1.0;
+    }
+    else
+    {
+        double z = (u - n1 * n2 / 2 - 0.5) / sqrt(variance);
+        result = 0.5 * erfc(z / sqrt(2.0));
+    }
+    return result;
+}
+
+static bool ctest_baseline_compare_test(const char* name, const CTEST_TEST_RUN* test_run, const CTEST_BASELINE_SAMPLE* samples, size_t sample_count, uint32_t threshold_percent)
+{
+    bool is_regression = false;
+    double baseline_ns;
+
+    if (ctest_baseline_get_median(samples, sample_count, &baseline_ns))
+    {
+        bool is_benchmark = (test_run->test_function->FunctionType == CTEST_BENCHMARK_FUNCTION);
+        double current_ns = is_benchmark ? test_run->benchmark_result.median_ns : (double)test_run->test_timing.wall_ns;
+        double limit_ns = baseline_ns * (1.0 + threshold_percent / 100.0);
+        double change_percent = (baseline_ns > 0) ? (current_ns / baseline_ns - 1) * 100 : 0;
+
+        if (is_benchmark)
+        {
+            const CTEST_BENCHMARK_RESULT* benchmark_result = &test_run->benchmark_result;
+            if ((benchmark_result->sample_count >= CTEST_BASELINE_U_TEST_MIN_SAMPLE_COUNT) && (sample_count >= CTEST_BASELINE_U_TEST_MIN_SAMPLE_COUNT))
+            {
+                double p_value = ctest_baseline_get_p_value(benchmark_result->samples_ns, benchmark_result->sample_count, samples, sample_count);
+                is_regression = (benchmark_result->median_ns > limit_ns) && (p_value < CTEST_BASELINE_SIGNIFICANCE);
+                if (is_regression)
+                {
+                    LogError(CTEST_ANSI_COLOR_RED "Benchmark %s regressed: median %.2f ns/op, baseline %.2f ns/op (%+.1f%%, over %" PRIu32 "%%, p=%.4f)" CTEST_ANSI_COLOR_RESET "",
+                        name, benchmark_result->median_ns, baseline_ns, change_percent, threshold_percent, p_value);
+                }
+                else
+                {
+                    LogInfo("Benchmark %s: median %.2f ns/op, baseline %.2f ns/op (%+.1f%%, p=%.4f)", name, benchmark_result->median_ns, baseline_ns, change_percent, p_value);
+                }
+            }
+            else
+            {
+                is_regression = (benchmark_result->median_ns > limit_ns);
+                if (is_regression)
+                {
+                    LogError(CTEST_ANSI_COLOR_RED "Benchmark %s regressed: median %.2f ns/op, baseline %.2f ns/op (%+.1f%%, over %" PRIu32 "%%, too few samples for a significance test)" CTEST_ANSI_COLOR_RESET "",
+                        name, benchmark_result->median_ns, baseline_ns, change_percent, threshold_percent);
+                }
+                else
+                {
+                    LogInfo("Benchmark %s: median %.2f ns/op, baseline %.2f ns/op (%+.1f%%)", name, benchmark_result->median_ns, baseline_ns, change_percent);
+                }
+            }
+        }
+        else
+        {
+            is_regression = (current_ns > limit_ns) && (current_ns - baseline_ns >= CTEST_BASELINE_TEST_MIN_REGRESSION_NS);
+            if (is_regression)
+            {
+                LogError(CTEST_ANSI_COLOR_RED "Test %s regressed: %.3f ms, baseline %.3f ms (%+.1f%%, over %" PRIu32 "%%)" CTEST_ANSI_COLOR_RESET "",
+                    name, CTEST_TIMING_NS_TO_MS(current_ns), CTEST_TIMING_NS_TO_MS(baseline_ns), change_percent, threshold_percent);
+            }
+            else
+            {
+                LogVerbose("Test %s: %.3f ms, baseline %.3f ms (%+.1f%%)", name, CTEST_TIMING_NS_TO_MS(current_ns), CTEST_TIMING_NS_TO_MS(baseline_ns), change_percent);
+            }
+        }
+    }
+    return is_regression;
+}
+
+size_t ctest_baseline_compare(const CTEST_SUITE_RUN* suite_run, const char* path, uint32_t threshold_percent)
+{
+    size_t result = 0;
+
+    if (!ctest_baseline_load(path))
+    {
+        LogError(CTEST_ANSI_COLOR_RED "Cannot compare suite %s with the baseline %s" CTEST_ANSI_COLOR_RESET "", suite_run->test_suite_name, path);
+        result = 1;
+    }
+    else
+    {
+        LogInfo(" ### Comparing with the baseline %s (regression threshold %" PRIu32 "%%)", path, threshold_percent);
+        for (size_t i = 0; i < suite_run->test_count; i++)
+        {
+            const CTEST_TEST_RUN* test_run = &suite_run->tests[i];
+            if (ctest_baseline_is_test_measured(test_run))
+            {
+                char* name = ctest_baseline_make_name(suite_run->test_suite_name, test_run->test_function->TestFunctionName);
+                if (name == NULL)
+                {
+                    result++;
+                }
+                else
+                {
+                    size_t sample_count;
+                    const CTEST_BASELINE_SAMPLE* samples = ctest_baseline_find_samples(name, &sample_count);
+                    if (samples == NULL)
+                    {
+                        LogInfo("%s is not in the baseline, not compared", name);
+                    }
+                    else if (ctest_baseline_compare_test(name, test_run, samples, sample_count, threshold_percent))
+                    {
+                        result++;
+                    }
+                    free(name);
+                }
+            }
+        }
+    }
+
+    return result;
+}
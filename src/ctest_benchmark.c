@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* the calibration grows the iteration count at least 2x and at most 100x per round, aiming 20% over the sample time */
+#define CTEST_BENCHMARK_MIN_GROWTH 2.0
+#define CTEST_BENCHMARK_MAX_GROWTH 100.0
+#define CTEST_BENCHMARK_TARGET_MARGIN 1.2
+/* a calibration fooled by a slow round (preemption, page faults) gives samples much shorter than the target, they are then measured
+   again with the iteration count computed from the fastest sample, at most this many times */
+#define CTEST_BENCHMARK_MAX_REMEASURE_COUNT 3
+
+void ctest_benchmark_use_pointer(const volatile void* pointer)
+{
+    /* out of line, so the compiler has to assume the pointed memory is read */
+    (void)pointer;
+}
+
+static uint64_t ctest_benchmark_time_iterations(TEST_FUNC benchmark_function, uint64_t iterations)
+{
+    uint64_t start = ctest_timing_get_wall_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        benchmark_function();
+    }
+    return ctest_timing_get_wall_ns() - start;
+}
+
+static int ctest_benchmark_compare_double(const void* left, const void* right)
+{
+    double left_value = *(const double*)left;
+    double right_value = *(const double*)right;
+    return (left_value < right_value) ? -1 : ((left_value > right_value) ? 1 : 0);
+}
+
+void ctest_benchmark_run(const TEST_FUNCTION_DATA* benchmark, uint32_t min_time_ms, const CTEST_PERF_COUNTERS_SESSION* perf_session, CTEST_BENCHMARK_RESULT* result)
+{
+    result->sample_count = 0;
+
+    if (min_time_ms == 0)
+    {
+        if (perf_session != NULL)
+        {
+            ctest_perf_counters_enable(perf_session);
+        }
+        benchmark->TestFunction();
+        LogInfo("Benchmark %s ran once (CTEST_BENCHMARK_MIN_TIME_MS=0), not measured", benchmark->TestFunctionName);
+    }
+    else
+    {
+        uint64_t sample_target_ns = (uint64_t)min_time_ms * 1000000 / CTEST_BENCHMARK_SAMPLE_COUNT;
+        uint64_t iterations = 1;
+        /* the calibration rounds also warm up caches and branch predictors */
+        uint64_t elapsed_ns = ctest_benchmark_time_iterations(benchmark->TestFunction, iterations);
+        double samples_ns[CTEST_BENCHMARK_SAMPLE_COUNT];
+        double sum_ns;
+        double sum_of_squares_ns = 0;
+        uint32_t remeasure_count = 0;
+
+        while (elapsed_ns < sample_target_ns)
+        {
+            double growth = (elapsed_ns == 0) ? CTEST_BENCHMARK_MAX_GROWTH : ((double)sample_target_ns * CTEST_BENCHMARK_TARGET_MARGIN / (double)elapsed_ns);
+            if (growth < CTEST_BENCHMARK_MIN_GROWTH)
+            {
+                growth = CTEST_BENCHMARK_MIN_GROWTH;
+            }
+            else if (growth > CTEST_BENCHMARK_MAX_GROWTH)
+            {
+                growth = CTEST_BENCHMARK_MAX_GROWTH;
+            }
+            iterations = (uint64_t)((double)iterations * growth);
+            elapsed_ns = ctest_benchmark_time_iterations(benchmark->TestFunction, iterations);
+        }
+
+        for (;;)
+        {
+            uint64_t samples_elapsed_ns = 0;
+            double fastest_sample_ns = 0;
+            sum_ns = 0;
+            /* reset for each round, only the samples kept are counted */
+            if (perf_session != NULL)
+            {
+                ctest_perf_counters_enable(perf_session);
+            }
+            for (uint32_t i = 0; i < CTEST_BENCHMARK_SAMPLE_COUNT; i++)
+            {
+                uint64_t sample_elapsed_ns = ctest_benchmark_time_iterations(benchmark->TestFunction, iterations);
+                samples_elapsed_ns += sample_elapsed_ns;
+                samples_ns[i] = (double)sample_elapsed_ns / (double)iterations;
+                sum_ns += samples_ns[i];
+                if ((i == 0) || (samples_ns[i] < fastest_sample_ns))
+                {
+                    fastest_sample_ns = samples_ns[i];
+                }
+            }
+            if (perf_session != NULL)
+            {
+                ctest_perf_counters_disable(perf_session);
+            }
+
+            if ((samples_elapsed_ns >= sample_target_ns * CTEST_BENCHMARK_SAMPLE_COUNT / 2) || (remeasure_count == CTEST_BENCHMARK_MAX_REMEASURE_COUNT))
+            {
+                break;
+            }
+
+            remeasure_count++;
+            {
+                uint64_t estimated_iterations = (uint64_t)((double)sample_target_ns * CTEST_BENCHMARK_TARGET_MARGIN / ((fastest_sample_ns > 0) ? fastest_sample_ns : 1));
+                iterations = (estimated_iterations > iterations) ? estimated_iterations : iterations * 2;
+            }
+        }
+
+        result->iterations = iterations;
+        result->mean_ns = sum_ns / CTEST_BENCHMARK_SAMPLE_COUNT;
+        for (uint32_t i = 0; i < CTEST_BENCHMARK_SAMPLE_COUNT; i++)
+        {
+            sum_of_squares_ns += (samples_ns[i] - result->mean_ns) * (samples_ns[i] - result->mean_ns);
+        }
+        result->stddev_ns = sqrt(sum_of_squares_ns / (CTEST_BENCHMARK_SAMPLE_COUNT - 1));
+        (void)memcpy(result->samples_ns, samples_ns, sizeof(samples_ns));
+
+        qsort(samples_ns, CTEST_BENCHMARK_SAMPLE_COUNT, sizeof(double), ctest_benchmark_compare_double);
+        result->min_ns = samples_ns[0];
+        result->median_ns = (CTEST_BENCHMARK_SAMPLE_COUNT % 2 == 0) ?
+            (samples_ns[CTEST_BENCHMARK_SAMPLE_COUNT / 2 - 1] + samples_ns[CTEST_BENCHMARK_SAMPLE_COUNT / 2]) / 2 :
+            samples_ns[CTEST_BENCHMARK_SAMPLE_COUNT / 2];
+        result->sample_count = CTEST_BENCHMARK_SAMPLE_COUNT;
+
+        LogInfo("Benchmark %s: mean %.2f ns/op, median %.2f ns/op, stddev %.2f ns/op, min %.2f ns/op (%u samples of %" PRIu64 " iterations)",
+            benchmark->TestFunctionName, result->mean_ns, result->median_ns, result->stddev_ns, result->min_ns, (unsigned int)result->sample_count, result->iterations);
+    }
+}
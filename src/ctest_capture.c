@@ -0,0 +1,285 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* Output capture (CTEST_CAPTURE_OUTPUT). While a test runs, the file descriptors 1 and 2 of the process are duplicated from a memory
+   file (memfd on Linux, a temporary file elsewhere), so everything written to stdout and stderr (printf, the console log sink, child
+   processes) goes there instead of the terminal. When the test passes the file is emptied for the next test, when it fails what it
+   holds is written to stdout and attached to the result of the test. The descriptors belong to the process, the tests running on
+   parallel threads are not captured. */
+
+#if defined _MSC_VER
+
+void ctest_capture_begin_test(const TEST_FUNCTION_DATA* test_function)
+{
+    static bool is_warning_logged = false;
+    (void)test_function;
+    if (!is_warning_logged)
+    {
+        is_warning_logged = true;
+        LogWarning("CTEST_CAPTURE_OUTPUT is not supported on this platform, the output of the tests is not captured");
+    }
+}
+
+char* ctest_capture_end_test(bool is_failed)
+{
+    (void)is_failed;
+    return NULL;
+}
+
+#else
+
+#include <errno.h>
+#include <unistd.h>
+
+#if defined __linux__
+#include <sys/syscall.h>
+#include <linux/memfd.h>
+#endif
+
+/* the end of the output of a failed test that is kept, the beginning is dropped */
+#define CTEST_CAPTURE_OUTPUT_SIZE (64 * 1024)
+
+static bool g_is_opened = false;
+/* the memory file, -1 when the output cannot be captured */
+static int g_capture_fd = -1;
+/* the terminal (or whatever 1 and 2 were) while a test is captured */
+static int g_stdout_fd = -1;
+static int g_stderr_fd = -1;
+/* the test whose output is captured, NULL between tests */
+static const char* volatile g_test_name = NULL;
+
+static void ctest_capture_write(int fd, const char* data, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        ssize_t result = write(fd, data + written, size - written);
+        if (result < 0)
+        {
+            if (errno != EINTR)
+            {
+                break;
+            }
+        }
+        else
+        {
+            written += (size_t)result;
+        }
+    }
+}
+
+static void ctest_capture_write_text(int fd, const char* text)
+{
+    ctest_capture_write(fd, text, strlen(text));
+}
+
+/* puts the terminal back on 1 and 2, without formatting or allocating */
+static void ctest_capture_restore(void)
+{
+    (void)dup2(g_stdout_fd, STDOUT_FILENO);
+    (void)dup2(g_stderr_fd, STDERR_FILENO);
+}
+
+/* writes everything captured to fd, without formatting or allocating */
+static void ctest_capture_copy(int fd)
+{
+    char buffer[4096];
+    off_t offset = 0;
+    ssize_t read_result;
+    while (((read_result = pread(g_capture_fd, buffer, sizeof(buffer), offset)) > 0) || ((read_result < 0) && (errno == EINTR)))
+    {
+        if (read_result > 0)
+        {
+            ctest_capture_write(fd, buffer, (size_t)read_result);
+            offset += read_result;
+        }
+    }
+}
+
+/* puts the terminal back and writes the output of the running test to its stderr */
+static void ctest_capture_on_crash(const CTEST_CRASH* crash)
+{
+    const char* test_name = g_test_name;
+    (void)crash;
+    if (test_name != NULL)
+    {
+        g_test_name = NULL;
+        ctest_capture_restore();
+        ctest_capture_write_text(g_stderr_fd, "\nctest: the output of ");
+        ctest_capture_write_text(g_stderr_fd, test_name);
+        ctest_capture_write_text(g_stderr_fd, ", which was running when the process crashed:\n");
+        ctest_capture_copy(g_stderr_fd);
+    }
+}
+
+static void ctest_capture_close_at_exit(void)
+{
+    /* a test calling exit */
+    const char* test_name = g_test_name;
+    if (test_name != NULL)
+    {
+        g_test_name = NULL;
+        (void)fflush(stdout);
+        (void)fflush(stderr);
+        ctest_capture_restore();
+        LogError("The process exited while %s was running, the output of the test:", test_name);
+        (void)fflush(stdout);
+        ctest_capture_copy(STDOUT_FILENO);
+    }
+    (void)close(g_capture_fd);
+    (void)close(g_stdout_fd);
+    (void)close(g_stderr_fd);
+    g_capture_fd = -1;
+}
+
+static int ctest_capture_create_file(void)
+{
+    int result;
+#if defined __linux__ && defined SYS_memfd_create
+    result = (int)syscall(SYS_memfd_create, "ctest_capture", MFD_CLOEXEC);
+    if (result < 0)
+#endif
+    {
+        /* no memfd (older kernels), a deleted file */
+        char path[] = "/tmp/ctest_capture_XXXXXX";
+        result = mkstemp(path);
+        if (result >= 0)
+        {
+            (void)unlink(path);
+        }
+    }
+    return result;
+}
+
+static void ctest_capture_open(void)
+{
+    if ((g_capture_fd = ctest_capture_create_file()) < 0)
+    {
+        LogError("failure creating the file capturing the output, errno=%d, the output of the tests is not captured", errno);
+    }
+    else if (((g_stdout_fd = dup(STDOUT_FILENO)) < 0) || ((g_stderr_fd = dup(STDERR_FILENO)) < 0))
+    {
+        LogError("failure in dup, errno=%d, the output of the tests is not captured", errno);
+        if (g_stdout_fd >= 0)
+        {
+            (void)close(g_stdout_fd);
+        }
+        (void)close(g_capture_fd);
+        g_capture_fd = -1;
+    }
+    else
+    {
+        (void)atexit(ctest_capture_close_at_exit);
+        ctest_crash_set_hook(CTEST_CRASH_HOOK_CAPTURE, ctest_capture_on_crash);
+    }
+}
+
+void ctest_capture_begin_test(const TEST_FUNCTION_DATA* test_function)
+{
+    if (!g_is_opened)
+    {
+        g_is_opened = true;
+        ctest_capture_open();
+    }
+
+    if (g_capture_fd != -1)
+    {
+        /* what is buffered belongs to the terminal */
+        (void)fflush(stdout);
+        (void)fflush(stderr);
+        if ((ftruncate(g_capture_fd, 0) != 0) || (lseek(g_capture_fd, 0, SEEK_SET) != 0))
+        {
+            LogError("failure emptying the file capturing the output, errno=%d, the output of %s is not captured", errno, test_function->TestFunctionName);
+        }
+        else
+        {
+            g_test_name = test_function->TestFunctionName;
+            if ((dup2(g_capture_fd, STDOUT_FILENO) < 0) || (dup2(g_capture_fd, STDERR_FILENO) < 0))
+            {
+                g_test_name = NULL;
+                ctest_capture_restore();
+                LogError("failure in dup2, errno=%d, the output of %s is not captured", errno, test_function->TestFunctionName);
+            }
+        }
+    }
+}
+
+char* ctest_capture_end_test(bool is_failed)
+{
+    char* result = NULL;
+
+    if (g_test_name != NULL)
+    {
+        (void)fflush(stdout);
+        (void)fflush(stderr);
+        g_test_name = NULL;
+        ctest_capture_restore();
+
+        off_t size = lseek(g_capture_fd, 0, SEEK_END);
+        if (is_failed && (size > 0))
+        {
+            char header[128];
+            size_t header_length = 0;
+            size_t output_size = (size_t)size;
+            off_t offset = 0;
+            if (output_size > CTEST_CAPTURE_OUTPUT_SIZE)
+            {
+                header_length = (size_t)snprintf(header, sizeof(header), "(%zu earlier bytes of the output were dropped)\n", output_size - CTEST_CAPTURE_OUTPUT_SIZE);
+                offset = size - CTEST_CAPTURE_OUTPUT_SIZE;
+                output_size = CTEST_CAPTURE_OUTPUT_SIZE;
+            }
+
+            result = malloc(header_length + output_size + 1);
+            if (result == NULL)
+            {
+                LogError("failure in malloc(%zu), the output of the test is written but not reported", header_length + output_size + 1);
+                ctest_capture_copy(STDOUT_FILENO);
+            }
+            else
+            {
+                size_t length = 0;
+                ssize_t read_result;
+                (void)memcpy(result, header, header_length);
+                while ((length < output_size) &&
+                    (((read_result = pread(g_capture_fd, result + header_length + length, output_size - length, offset + (off_t)length)) > 0) || ((read_result < 0) && (errno == EINTR))))
+                {
+                    if (read_result > 0)
+                    {
+                        length += (size_t)read_result;
+                    }
+                }
+                length += header_length;
+                /* the reports take it as a string */
+                for (size_t i = 0; i < length; i++)
+                {
+                    if (result[i] == '\0')
+                    {
+                        result[i] = ' ';
+                    }
+                }
+                result[length] = '\0';
+                ctest_capture_write(STDOUT_FILENO, result, length);
+                if ((length > 0) && (result[length - 1] != '\n'))
+                {
+                    ctest_capture_write_text(STDOUT_FILENO, "\n");
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+#endif
@@ -0,0 +1,471 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#endif
+
+static CTEST_CONFIG g_ctest_config;
+static bool g_ctest_config_loaded = false;
+
+/* returns true if the variable exists, copying its value (truncated to valueSize) in value */
+static bool ctest_config_getenv(const char* name, char* value, size_t valueSize)
+{
+    bool result;
+#if defined _MSC_VER
+    DWORD length = GetEnvironmentVariableA(name, value, (DWORD)valueSize);
+    result = (length > 0) && (length < valueSize);
+#else
+    const char* env_value = getenv(name);
+    if (env_value == NULL)
+    {
+        result = false;
+    }
+    else
+    {
+        (void)strncpy(value, env_value, valueSize - 1);
+        value[valueSize - 1] = '\0';
+        result = true;
+    }
+#endif
+    return result;
+}
+
+static bool ctest_config_parse_uint32(const char* text, uint32_t* value)
+{
+    bool result;
+    char* end;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if ((end == text) || (*end != '\0') || (text[0] == '-') || (parsed > UINT32_MAX))
+    {
+        result = false;
+    }
+    else
+    {
+        *value = (uint32_t)parsed;
+        result = true;
+    }
+    return result;
+}
+
+static void ctest_config_read_uint32(const char* name, uint32_t* value)
+{
+    char text[32];
+    if (ctest_config_getenv(name, text, sizeof(text)))
+    {
+        if (!ctest_config_parse_uint32(text, value))
+        {
+            LogWarning("Ignoring %s=%s, expected an unsigned 32 bit number", name, text);
+        }
+    }
+}
+
+static bool ctest_config_parse_string(const char* text, char* value, size_t value_size)
+{
+    bool result;
+    size_t length = strlen(text);
+    if (length >= value_size)
+    {
+        result = false;
+    }
+    else
+    {
+        (void)memcpy(value, text, length + 1);
+        result = true;
+    }
+    return result;
+}
+
+static bool ctest_config_parse_path(const char* text, char* path)
+{
+    return ctest_config_parse_string(text, path, CTEST_CONFIG_PATH_SIZE);
+}
+
+static void ctest_config_read_path(const char* name, char* path)
+{
+    /* one more character than a valid path, to tell a path that is too long from one that fits */
+    char text[CTEST_CONFIG_PATH_SIZE + 1];
+    if (ctest_config_getenv(name, text, sizeof(text)))
+    {
+        if (!ctest_config_parse_path(text, path))
+        {
+            LogWarning("Ignoring %s, the path is longer than %d characters", name, CTEST_CONFIG_PATH_SIZE - 1);
+        }
+    }
+}
+
+static void ctest_config_read_filter(const char* name, char* filter)
+{
+    char text[CTEST_CONFIG_FILTER_SIZE + 1];
+    if (ctest_config_getenv(name, text, sizeof(text)))
+    {
+        if (!ctest_config_parse_string(text, filter, CTEST_CONFIG_FILTER_SIZE))
+        {
+            LogWarning("Ignoring %s, the filter is longer than %d characters", name, CTEST_CONFIG_FILTER_SIZE - 1);
+        }
+    }
+}
+
+static bool ctest_config_is_shard_valid(uint32_t shard_index, uint32_t shard_count)
+{
+    return (shard_count > 0) && (shard_index < shard_count);
+}
+
+const CTEST_CONFIG* ctest_config_get(void)
+{
+    if (!g_ctest_config_loaded)
+    {
+        g_ctest_config_loaded = true;
+
+        g_ctest_config.worker_thread_count = 1;
+        ctest_config_read_uint32("CTEST_WORKER_THREADS", &g_ctest_config.worker_thread_count);
+        if (g_ctest_config.worker_thread_count == 0)
+        {
+            g_ctest_config.worker_thread_count = ctest_get_processor_count();
+        }
+
+        g_ctest_config.worker_process_count = 1;
+        ctest_config_read_uint32("CTEST_WORKER_PROCESSES", &g_ctest_config.worker_process_count);
+        if (g_ctest_config.worker_process_count == 0)
+        {
+            g_ctest_config.worker_process_count = ctest_get_processor_count();
+        }
+
+        g_ctest_config.shard_index = 0;
+        g_ctest_config.shard_count = 1;
+        ctest_config_read_uint32("CTEST_SHARD_INDEX", &g_ctest_config.shard_index);
+        ctest_config_read_uint32("CTEST_SHARD_COUNT", &g_ctest_config.shard_count);
+        if (!ctest_config_is_shard_valid(g_ctest_config.shard_index, g_ctest_config.shard_count))
+        {
+            LogWarning("Ignoring CTEST_SHARD_INDEX=%" PRIu32 ", CTEST_SHARD_COUNT=%" PRIu32 ", the shard index must be less than the shard count, running all tests",
+                g_ctest_config.shard_index, g_ctest_config.shard_count);
+            g_ctest_config.shard_index = 0;
+            g_ctest_config.shard_count = 1;
+        }
+
+        g_ctest_config.slowest_test_count = 10;
+        ctest_config_read_uint32("CTEST_SLOWEST_TESTS", &g_ctest_config.slowest_test_count);
+
+        g_ctest_config.test_timeout_ms = 0;
+        ctest_config_read_uint32("CTEST_TEST_TIMEOUT_MS", &g_ctest_config.test_timeout_ms);
+        g_ctest_config.suite_timeout_ms = 0;
+        ctest_config_read_uint32("CTEST_SUITE_TIMEOUT_MS", &g_ctest_config.suite_timeout_ms);
+
+        g_ctest_config.benchmark_min_time_ms = 200;
+        ctest_config_read_uint32("CTEST_BENCHMARK_MIN_TIME_MS", &g_ctest_config.benchmark_min_time_ms);
+
+        g_ctest_config.baseline_output_path[0] = '\0';
+        ctest_config_read_path("CTEST_BASELINE_OUTPUT", g_ctest_config.baseline_output_path);
+        g_ctest_config.baseline_compare_path[0] = '\0';
+        ctest_config_read_path("CTEST_BASELINE_COMPARE", g_ctest_config.baseline_compare_path);
+        g_ctest_config.regression_threshold_percent = 10;
+        ctest_config_read_uint32("CTEST_REGRESSION_THRESHOLD_PERCENT", &g_ctest_config.regression_threshold_percent);
+
+        g_ctest_config.perf_counters = 0;
+        ctest_config_read_uint32("CTEST_PERF_COUNTERS", &g_ctest_config.perf_counters);
+
+        g_ctest_config.leak_check_per_test = 0;
+        ctest_config_read_uint32("CTEST_LEAK_CHECK_PER_TEST", &g_ctest_config.leak_check_per_test);
+
+        g_ctest_config.allocation_failure_sweep = 0;
+        ctest_config_read_uint32("CTEST_ALLOCATION_FAILURE_SWEEP", &g_ctest_config.allocation_failure_sweep);
+
+        g_ctest_config.report_junit_path[0] = '\0';
+        ctest_config_read_path("CTEST_REPORT_JUNIT", g_ctest_config.report_junit_path);
+        g_ctest_config.report_tap_path[0] = '\0';
+        ctest_config_read_path("CTEST_REPORT_TAP", g_ctest_config.report_tap_path);
+        g_ctest_config.report_json_path[0] = '\0';
+        ctest_config_read_path("CTEST_REPORT_JSON", g_ctest_config.report_json_path);
+
+        g_ctest_config.event_fd = 0;
+        ctest_config_read_uint32("CTEST_EVENT_FD", &g_ctest_config.event_fd);
+
+        g_ctest_config.trace_path[0] = '\0';
+        ctest_config_read_path("CTEST_TRACE", g_ctest_config.trace_path);
+
+        g_ctest_config.quiet = 0;
+        ctest_config_read_uint32("CTEST_QUIET", &g_ctest_config.quiet);
+
+        g_ctest_config.capture_output = 0;
+        ctest_config_read_uint32("CTEST_CAPTURE_OUTPUT", &g_ctest_config.capture_output);
+
+        g_ctest_config.crash_recovery = 0;
+        ctest_config_read_uint32("CTEST_CRASH_RECOVERY", &g_ctest_config.crash_recovery);
+
+        g_ctest_config.journal_path[0] = '\0';
+        ctest_config_read_path("CTEST_JOURNAL", g_ctest_config.journal_path);
+
+        g_ctest_config.resume = 0;
+        ctest_config_read_uint32("CTEST_RESUME", &g_ctest_config.resume);
+
+        g_ctest_config.test_filter[0] = '\0';
+        ctest_config_read_filter("CTEST_FILTER", g_ctest_config.test_filter);
+
+        g_ctest_config.list = 0;
+        ctest_config_read_uint32("CTEST_LIST", &g_ctest_config.list);
+    }
+
+    return &g_ctest_config;
+}
+
+/* returns the value of the option when argument is "--name=value", NULL otherwise */
+static const char* ctest_config_get_option_value(const char* argument, const char* name)
+{
+    const char* result = NULL;
+    size_t name_length = strlen(name);
+    if ((strncmp(argument, "--", 2) == 0) &&
+        (strncmp(argument + 2, name, name_length) == 0) &&
+        (argument[2 + name_length] == '='))
+    {
+        result = argument + 2 + name_length + 1;
+    }
+    return result;
+}
+
+int ctest_parse_command_line(int argc, char** argv)
+{
+    int result = 0;
+    /* the options override the environment, so the environment has to be read first */
+    CTEST_CONFIG config = *ctest_config_get();
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value;
+        if (argv[i] == NULL)
+        {
+            continue;
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_shard_index")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.shard_index))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_shard_count")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.shard_count))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_test_timeout_ms")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.test_timeout_ms))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_suite_timeout_ms")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.suite_timeout_ms))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_benchmark_min_time_ms")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.benchmark_min_time_ms))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_baseline_output")) != NULL)
+        {
+            if (!ctest_config_parse_path(value, config.baseline_output_path))
+            {
+                LogError("Invalid %s, the path is longer than %d characters", argv[i], CTEST_CONFIG_PATH_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_baseline_compare")) != NULL)
+        {
+            if (!ctest_config_parse_path(value, config.baseline_compare_path))
+            {
+                LogError("Invalid %s, the path is longer than %d characters", argv[i], CTEST_CONFIG_PATH_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_regression_threshold_percent")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.regression_threshold_percent))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_perf_counters")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.perf_counters))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_leak_check_per_test")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.leak_check_per_test))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_allocation_failure_sweep")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.allocation_failure_sweep))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_report_junit")) != NULL)
+        {
+            if (!ctest_config_parse_path(value, config.report_junit_path))
+            {
+                LogError("Invalid %s, the path is longer than %d characters", argv[i], CTEST_CONFIG_PATH_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_report_tap")) != NULL)
+        {
+            if (!ctest_config_parse_path(value, config.report_tap_path))
+            {
+                LogError("Invalid %s, the path is longer than %d characters", argv[i], CTEST_CONFIG_PATH_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_report_json")) != NULL)
+        {
+            if (!ctest_config_parse_path(value, config.report_json_path))
+            {
+                LogError("Invalid %s, the path is longer than %d characters", argv[i], CTEST_CONFIG_PATH_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_event_fd")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.event_fd))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_trace")) != NULL)
+        {
+            if (!ctest_config_parse_path(value, config.trace_path))
+            {
+                LogError("Invalid %s, the path is longer than %d characters", argv[i], CTEST_CONFIG_PATH_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_quiet")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.quiet))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_capture_output")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.capture_output))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_crash_recovery")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.crash_recovery))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_journal")) != NULL)
+        {
+            if (!ctest_config_parse_path(value, config.journal_path))
+            {
+                LogError("Invalid %s, the path is longer than %d characters", argv[i], CTEST_CONFIG_PATH_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_resume")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.resume))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_filter")) != NULL)
+        {
+            if (!ctest_config_parse_string(value, config.test_filter, CTEST_CONFIG_FILTER_SIZE))
+            {
+                LogError("Invalid %s, the filter is longer than %d characters", argv[i], CTEST_CONFIG_FILTER_SIZE - 1);
+                result = MU_FAILURE;
+            }
+        }
+        else if ((value = ctest_config_get_option_value(argv[i], "ctest_list")) != NULL)
+        {
+            if (!ctest_config_parse_uint32(value, &config.list))
+            {
+                LogError("Invalid %s, expected an unsigned 32 bit number", argv[i]);
+                result = MU_FAILURE;
+            }
+        }
+        else
+        {
+            /* not a ctest option */
+        }
+    }
+
+    if ((result == 0) && !ctest_config_is_shard_valid(config.shard_index, config.shard_count))
+    {
+        LogError("Invalid shard %" PRIu32 " of %" PRIu32 ", the shard index must be less than the shard count", config.shard_index, config.shard_count);
+        result = MU_FAILURE;
+    }
+
+    if (result == 0)
+    {
+        g_ctest_config = config;
+    }
+
+    return result;
+}
+
+uint32_t ctest_config_get_test_shard(const char* test_suite_name, const char* test_function_name, uint32_t shard_count)
+{
+    /* 32 bit FNV-1a of "suite.test", it only depends on the names so every shard computes the same split */
+    uint32_t hash = 2166136261U;
+    const char* parts[3] = { test_suite_name, ".", test_function_name };
+
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
+    {
+        for (const unsigned char* c = (const unsigned char*)parts[i]; *c != '\0'; c++)
+        {
+            hash ^= *c;
+            hash *= 16777619U;
+        }
+    }
+
+    return hash % shard_count;
+}
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_CONFIG_H
+#define CTEST_CONFIG_H
+
+#include <stdint.h>
+
+/* the longest path (with its terminating zero) accepted for the files written and read by ctest */
+#define CTEST_CONFIG_PATH_SIZE 512
+#define CTEST_CONFIG_FILTER_SIZE 1024
+
+/* Process wide run configuration. It is read from the environment the first time it is needed. */
+typedef struct CTEST_CONFIG_TAG
+{
+    /* CTEST_WORKER_THREADS: number of threads running the tests of a suite. Unset or 1 runs the tests serially on the thread
+       calling RunTests, 0 uses one thread per processor. */
+    uint32_t worker_thread_count;
+    /* CTEST_WORKER_PROCESSES: number of processes forked after TEST_SUITE_INITIALIZE to run the tests of a suite (POSIX only).
+       Unset or 1 runs the tests in the process calling RunTests, 0 uses one process per processor. Takes precedence over
+       CTEST_WORKER_THREADS. */
+    uint32_t worker_process_count;
+    /* CTEST_SHARD_INDEX/CTEST_SHARD_COUNT (--ctest_shard_index/--ctest_shard_count): only the tests whose suite.test name hashes
+       to shard_index are run. shard_count 1 (the default) runs all tests. */
+    uint32_t shard_index;
+    uint32_t shard_count;
+    /* CTEST_SLOWEST_TESTS: number of tests listed in the slowest tests table logged at the end of each suite, 0 disables the
+       table. Defaults to 10. */
+    uint32_t slowest_test_count;
+    /* CTEST_TEST_TIMEOUT_MS: limit for each test (with its function fixtures) and each suite fixture, 0 (the default) is no limit.
+       CTEST_SUITE_TIMEOUT_MS: limit for a whole suite, 0 (the default) is no limit. */
+    uint32_t test_timeout_ms;
+    uint32_t suite_timeout_ms;
+    /* CTEST_BENCHMARK_MIN_TIME_MS (--ctest_benchmark_min_time_ms): minimum measurement time of each CTEST_BENCHMARK, 0 runs each
+       benchmark body once without measuring. Defaults to 200. */
+    uint32_t benchmark_min_time_ms;
+    /* CTEST_BASELINE_OUTPUT (--ctest_baseline_output): file where the test timings and benchmark measurements of the process are
+       written, as Google Benchmark JSON. Empty (the default) writes nothing. */
+    char baseline_output_path[CTEST_CONFIG_PATH_SIZE];
+    /* CTEST_BASELINE_COMPARE (--ctest_baseline_compare): baseline file the tests and benchmarks are compared with, each regression
+       counts as a failed test. Empty (the default) compares nothing.
+       CTEST_REGRESSION_THRESHOLD_PERCENT (--ctest_regression_threshold_percent): slowdown over which a test or benchmark regressed,
+       defaults to 10. */
+    char baseline_compare_path[CTEST_CONFIG_PATH_SIZE];
+    uint32_t regression_threshold_percent;
+    /* CTEST_PERF_COUNTERS (--ctest_perf_counters): 1 counts cycles, instructions, cache misses, branch misses, page faults and
+       context switches of each test body with perf_event_open (Linux only). 0 (the default) does not. */
+    uint32_t perf_counters;
+    /* CTEST_LEAK_CHECK_PER_TEST (--ctest_leak_check_per_test): 1 fails each test leaving allocated blocks after its
+       TEST_FUNCTION_CLEANUP and logs their allocation stacks (with use_leak_tracker only). 0 (the default) only checks for leaks at
+       exit. */
+    uint32_t leak_check_per_test;
+    /* CTEST_ALLOCATION_FAILURE_SWEEP (--ctest_allocation_failure_sweep): N runs each test again with each of its first N allocations
+       failing in turn (spread over all of them when it makes more), in forked processes (with use_leak_tracker only). 0 (the default)
+       does not. */
+    uint32_t allocation_failure_sweep;
+    /* CTEST_REPORT_JUNIT, CTEST_REPORT_TAP, CTEST_REPORT_JSON (--ctest_report_junit, --ctest_report_tap, --ctest_report_json): files
+       where the results of the tests of the process are written as JUnit XML, TAP version 13 and JSON, as the tests complete. Empty
+       (the default) writes nothing. */
+    char report_junit_path[CTEST_CONFIG_PATH_SIZE];
+    char report_tap_path[CTEST_CONFIG_PATH_SIZE];
+    char report_json_path[CTEST_CONFIG_PATH_SIZE];
+    /* CTEST_EVENT_FD (--ctest_event_fd): open file descriptor (inherited from the parent process) where an event is written as a JSON
+       line when a suite or a test starts or ends and when an assert fails. 0 (the default) writes nothing. */
+    uint32_t event_fd;
+    /* CTEST_TRACE (--ctest_trace): file where the suite fixtures, function fixtures and test bodies of the process (and of its worker
+       processes) are written as Chrome trace events, with their process and thread. Empty (the default) writes nothing. */
+    char trace_path[CTEST_CONFIG_PATH_SIZE];
+    /* CTEST_QUIET (--ctest_quiet): 1 keeps what each test logs in memory and only logs it when the test fails, printing a progress
+       character per test instead. 0 (the default) logs everything. */
+    uint32_t quiet;
+    /* CTEST_CAPTURE_OUTPUT (--ctest_capture_output): 1 redirects stdout and stderr of the process to a memory file while each test runs
+       (POSIX only, not for the tests running on parallel threads), the output of a failed test is written after it and added to the
+       reports. 0 (the default) does not redirect. */
+    uint32_t capture_output;
+    /* CTEST_CRASH_RECOVERY (--ctest_crash_recovery): 1 fails a test body crashing with a NULL pointer dereference or an arithmetic
+       error and continues the run, other crashes (which may have corrupted the heap) end the process. 2 recovers from every
+       SIGSEGV, SIGBUS, SIGFPE and SIGILL. 0 (the default) lets a crash end the process. POSIX only. */
+    uint32_t crash_recovery;
+    /* CTEST_JOURNAL (--ctest_journal): file where a binary record is appended when each test starts and ends, read back by
+       CTEST_RESUME. Empty (the default) writes nothing. */
+    char journal_path[CTEST_CONFIG_PATH_SIZE];
+    /* CTEST_RESUME (--ctest_resume): 1 does not run again the tests that ended in the run that wrote the journal, they keep their result,
+       and fails the test that was running when it crashed. 0 (the default) starts a new journal. */
+    uint32_t resume;
+    /* CTEST_FILTER (--ctest_filter): the tests run by ctest_run_all, with the syntax of the filter of RunTests. Empty (the default) runs
+       all the tests. */
+    char test_filter[CTEST_CONFIG_FILTER_SIZE];
+    /* CTEST_LIST (--ctest_list): 1 writes the tests of each suite to stdout as JSON lines instead of running them, nothing runs, not
+       even the fixtures. 0 (the default) runs the tests. */
+    uint32_t list;
+} CTEST_CONFIG;
+
+const CTEST_CONFIG* ctest_config_get(void);
+
+/* returns the shard (0 to shard_count - 1) a test belongs to, stable across runs, builds and platforms */
+uint32_t ctest_config_get_test_shard(const char* test_suite_name, const char* test_function_name, uint32_t shard_count);
+
+#endif /* CTEST_CONFIG_H */
@@ -0,0 +1,214 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <setjmp.h>
+#include <signal.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+/* Crash recovery (CTEST_CRASH_RECOVERY). While a test body runs, a SIGSEGV, SIGBUS, SIGFPE or SIGILL raised by its thread is handled
+   by the first crash hook (see the crash dispatch in ctest.c), on the alternate stack of the thread (so that a stack overflow can be
+   handled too): the hook writes the stack of the crash to stderr and longjmps to g_ExceptionJump, like a failed assert, the test
+   fails and the run continues. The handlers are installed with SA_NODEFER, the signal is not blocked after the longjmp.
+
+   A crash can leave the process in a bad state (a corrupted heap, a lock held by the crashed code). With CTEST_CRASH_RECOVERY=1 only
+   the crashes that are unlikely to be the consequence of corrupted memory are recovered: a fault on the page at address 0 (a NULL
+   pointer dereference) and an arithmetic error. The others (a fault elsewhere, SIGBUS, SIGILL) go to the previous handlers and end the
+   process as without recovery. CTEST_CRASH_RECOVERY=2 recovers all of them. */
+
+static const char* ctest_crash_recovery_get_signal_name(int signal_number)
+{
+    const char* result;
+    switch (signal_number)
+    {
+    case SIGSEGV: result = "SIGSEGV"; break;
+    case SIGFPE: result = "SIGFPE"; break;
+    case SIGILL: result = "SIGILL"; break;
+    case SIGABRT: result = "SIGABRT"; break;
+#if defined SIGBUS
+    case SIGBUS: result = "SIGBUS"; break;
+#endif
+    default: result = "a signal"; break;
+    }
+    return result;
+}
+
+const char* ctest_crash_recovery_get_message(int signal_number)
+{
+    const char* result;
+    switch (signal_number)
+    {
+    case 0: result = NULL; break;
+    case SIGSEGV: result = "crashed with SIGSEGV"; break;
+    case SIGFPE: result = "crashed with SIGFPE"; break;
+    case SIGILL: result = "crashed with SIGILL"; break;
+    case SIGABRT: result = "crashed with SIGABRT"; break;
+#if defined SIGBUS
+    case SIGBUS: result = "crashed with SIGBUS"; break;
+#endif
+    default: result = "crashed with a signal"; break;
+    }
+    return result;
+}
+
+#if defined _MSC_VER
+
+void ctest_crash_recovery_begin(const TEST_FUNCTION_DATA* test_function)
+{
+    static bool is_warning_logged = false;
+    (void)test_function;
+    if ((ctest_config_get()->crash_recovery != 0) && !is_warning_logged)
+    {
+        is_warning_logged = true;
+        LogWarning("CTEST_CRASH_RECOVERY is not supported on this platform, a crashing test ends the process");
+    }
+}
+
+int ctest_crash_recovery_end(void)
+{
+    return 0;
+}
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+#if defined __GLIBC__
+#include <execinfo.h>
+#define CTEST_CRASH_RECOVERY_HAS_BACKTRACE
+#endif
+
+/* faults below this address are NULL pointer dereferences (reading a field of a NULL struct pointer included) */
+#define CTEST_CRASH_RECOVERY_NULL_PAGE_SIZE 4096
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile bool g_is_installed = false;
+static volatile uint32_t g_policy = 0;
+
+/* the test body running on the thread, NULL when a crash of the thread is not recovered */
+static CTEST_THREAD_LOCAL const char* volatile g_recovered_test_name = NULL;
+static CTEST_THREAD_LOCAL volatile int g_signal_number = 0;
+static CTEST_THREAD_LOCAL void* volatile g_fault_address = NULL;
+
+static void ctest_crash_recovery_write_stderr(const char* text)
+{
+    (void)!write(STDERR_FILENO, text, strlen(text));
+}
+
+static bool ctest_crash_recovery_is_recoverable(const CTEST_CRASH* crash)
+{
+    bool result;
+    if (crash->signal_number == SIGABRT)
+    {
+        /* abort is called on purpose, the process is not expected to go on */
+        result = false;
+    }
+    else if (g_policy >= 2)
+    {
+        result = true;
+    }
+    else if (crash->signal_number == SIGFPE)
+    {
+        result = true;
+    }
+    else
+    {
+        /* a fault the kernel raised (not kill or raise) on the NULL page */
+        result = (crash->signal_number == SIGSEGV) && crash->is_fault && ((uintptr_t)crash->fault_address < CTEST_CRASH_RECOVERY_NULL_PAGE_SIZE);
+    }
+    return result;
+}
+
+/* the first crash hook: the ones after it only see the crashes not recovered */
+static void ctest_crash_recovery_on_crash(const CTEST_CRASH* crash)
+{
+    const char* test_name = g_recovered_test_name;
+
+    if ((test_name != NULL) && ctest_crash_recovery_is_recoverable(crash))
+    {
+        g_recovered_test_name = NULL;
+        g_signal_number = crash->signal_number;
+        g_fault_address = crash->fault_address;
+        ctest_crash_recovery_write_stderr("\nctest: ");
+        ctest_crash_recovery_write_stderr(test_name);
+        ctest_crash_recovery_write_stderr(" crashed with ");
+        ctest_crash_recovery_write_stderr(ctest_crash_recovery_get_signal_name(crash->signal_number));
+        ctest_crash_recovery_write_stderr(", stack of the crash:\n");
+#if defined CTEST_CRASH_RECOVERY_HAS_BACKTRACE
+        {
+            void* frames[64];
+            int frame_count = backtrace(frames, (int)(sizeof(frames) / sizeof(frames[0])));
+            backtrace_symbols_fd(frames, frame_count, STDERR_FILENO);
+        }
+#endif
+        longjmp(g_ExceptionJump, 1);
+    }
+}
+
+static void ctest_crash_recovery_install(void)
+{
+    (void)pthread_mutex_lock(&g_lock);
+    if (!g_is_installed)
+    {
+#if defined CTEST_CRASH_RECOVERY_HAS_BACKTRACE
+        {
+            /* the first backtrace call loads libgcc, which allocates: not something to do for the first time in a signal handler */
+            void* frame;
+            (void)backtrace(&frame, 1);
+        }
+#endif
+        ctest_crash_set_hook(CTEST_CRASH_HOOK_RECOVERY, ctest_crash_recovery_on_crash);
+        g_is_installed = true;
+    }
+    (void)pthread_mutex_unlock(&g_lock);
+}
+
+void ctest_crash_recovery_begin(const TEST_FUNCTION_DATA* test_function)
+{
+    uint32_t policy = ctest_config_get()->crash_recovery;
+    g_signal_number = 0;
+    if (policy != 0)
+    {
+        g_policy = policy;
+        ctest_crash_recovery_install();
+        g_recovered_test_name = test_function->TestFunctionName;
+    }
+}
+
+int ctest_crash_recovery_end(void)
+{
+    int result = g_signal_number;
+    g_recovered_test_name = NULL;
+    if (result != 0)
+    {
+#if defined SIGBUS
+        if ((result == SIGSEGV) || (result == SIGBUS))
+#else
+        if (result == SIGSEGV)
+#endif
+        {
+            LogError("  Test crashed with %s accessing address %p, the stack of the crash is above, the run continues (CTEST_CRASH_RECOVERY=%" PRIu32 ")",
+                ctest_crash_recovery_get_signal_name(result), g_fault_address, g_policy);
+        }
+        else
+        {
+            LogError("  Test crashed with %s, the stack of the crash is above, the run continues (CTEST_CRASH_RECOVERY=%" PRIu32 ")",
+                ctest_crash_recovery_get_signal_name(result), g_policy);
+        }
+        g_signal_number = 0;
+    }
+    return result;
+}
+
+#endif
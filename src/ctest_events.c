@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/* Event stream (CTEST_EVENT_FD): one JSON object per line, written to the file descriptor with a single write as soon as the event
+   happens, for a process watching the tests while they run:
+
+    {"event":"suite_start","suite":"s","test_count":3}
+    {"event":"test_start","suite":"s","test":"t"}
+    {"event":"assert_failed","suite":"s","test":"t","line":12,"expected":"1","actual":"2","message":"..."}
+    {"event":"assert_failed","suite":"s","test":"t","line":14,"expression":"x > 0","expected":"true","actual":"false"}
+    {"event":"test_end","suite":"s","test":"t","result":"failed","wall_ms":0.120,"cpu_ms":0.118,"fixture_wall_ms":0.002,"fixture_cpu_ms":0.002}
+    {"event":"suite_end","suite":"s","executed":3,"failed":1,"skipped":0,"wall_ms":1.250}
+
+   Events of up to PIPE_BUF bytes written to a pipe are not interleaved with the ones of other threads and worker processes (which
+   write their own events to the inherited descriptor). The test of a worker process that dies is ended by the parent. */
+
+static bool g_is_opened = false;
+/* -1 when there is no stream, or after a write failed */
+static volatile int g_event_fd = -1;
+/* the suite running, for the assert events */
+static const char* volatile g_suite_name = NULL;
+static uint64_t g_suite_start_wall_ns;
+
+static void ctest_events_write(CTEST_REPORT_BUFFER* buffer)
+{
+    int fd = g_event_fd;
+    if ((fd != -1) && (buffer->data != NULL))
+    {
+        size_t written = 0;
+        while (written < buffer->length)
+        {
+#if defined _MSC_VER
+            int write_result = _write(fd, buffer->data + written, (unsigned int)(buffer->length - written));
+#else
+            ssize_t write_result = write(fd, buffer->data + written, buffer->length - written);
+#endif
+            if (write_result < 0)
+            {
+                if (errno != EINTR)
+                {
+                    LogError("failure writing to the event stream (fd %d), errno=%d, no more events are written", fd, errno);
+                    g_event_fd = -1;
+                    break;
+                }
+            }
+            else
+            {
+                written += (size_t)write_result;
+            }
+        }
+    }
+    free(buffer->data);
+}
+
+static void ctest_events_begin(CTEST_REPORT_BUFFER* buffer, const char* event_name, const char* suite_name, const char* test_name)
+{
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    buffer->can_grow = true;
+
+    ctest_report_buffer_append_format(buffer, "{\"event\":\"%s\",\"suite\":", event_name);
+    if (suite_name == NULL)
+    {
+        ctest_report_buffer_append(buffer, "null");
+    }
+    else
+    {
+        ctest_report_buffer_append(buffer, "\"");
+        ctest_report_buffer_append_json_escaped(buffer, suite_name);
+        ctest_report_buffer_append(buffer, "\"");
+    }
+    if (test_name != NULL)
+    {
+        ctest_report_buffer_append(buffer, ",\"test\":\"");
+        ctest_report_buffer_append_json_escaped(buffer, test_name);
+        ctest_report_buffer_append(buffer, "\"");
+    }
+}
+
+static void ctest_events_append_string(CTEST_REPORT_BUFFER* buffer, const char* name, const char* value)
+{
+    if (value != NULL)
+    {
+        ctest_report_buffer_append_format(buffer, ",\"%s\":\"", name);
+        ctest_report_buffer_append_json_escaped(buffer, value);
+        ctest_report_buffer_append(buffer, "\"");
+    }
+}
+
+static void ctest_events_end(CTEST_REPORT_BUFFER* buffer)
+{
+    ctest_report_buffer_append(buffer, "}\n");
+    ctest_events_write(buffer);
+}
+
+void ctest_events_begin_suite(const CTEST_SUITE_RUN* suite_run)
+{
+    if (!g_is_opened)
+    {
+        g_is_opened = true;
+        uint32_t event_fd = ctest_config_get()->event_fd;
+        if (event_fd != 0)
+        {
+            g_event_fd = (int)event_fd;
+        }
+    }
+
+    g_suite_name = suite_run->test_suite_name;
+    g_suite_start_wall_ns = ctest_timing_get_wall_ns();
+
+    if (g_event_fd != -1)
+    {
+        size_t selected_test_count = 0;
+        for (size_t i = 0; i < suite_run->test_count; i++)
+        {
+            if (suite_run->tests[i].is_selected)
+            {
+                selected_test_count++;
+            }
+        }
+
+        CTEST_REPORT_BUFFER buffer;
+        ctest_events_begin(&buffer, "suite_start", suite_run->test_suite_name, NULL);
+        ctest_report_buffer_append_format(&buffer, ",\"test_count\":%zu", selected_test_count);
+        ctest_events_end(&buffer);
+    }
+}
+
+void ctest_events_begin_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run)
+{
+    if (g_event_fd != -1)
+    {
+        CTEST_REPORT_BUFFER buffer;
+        ctest_events_begin(&buffer, "test_start", suite_run->test_suite_name, test_run->test_function->TestFunctionName);
+        ctest_events_end(&buffer);
+    }
+}
+
+void ctest_events_end_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run, const char* message)
+{
+    if (g_event_fd != -1)
+    {
+        TEST_RESULT test_result = *test_run->test_function->TestResult;
+        const char* result_name;
+        if (test_result == TEST_SUCCESS)
+        {
+            result_name = "passed";
+        }
+        else if (test_result == TEST_NOT_EXECUTED)
+        {
+            result_name = "not_executed";
+        }
+        else
+        {
+            result_name = "failed";
+        }
+
+        CTEST_REPORT_BUFFER buffer;
+        ctest_events_begin(&buffer, "test_end", suite_run->test_suite_name, test_run->test_function->TestFunctionName);
+        ctest_report_buffer_append_format(&buffer, ",\"result\":\"%s\"", result_name);
+        ctest_events_append_string(&buffer, "message", message);
+        ctest_report_buffer_append_format(&buffer, ",\"wall_ms\":%.3f,\"cpu_ms\":%.3f,\"fixture_wall_ms\":%.3f,\"fixture_cpu_ms\":%.3f",
+            CTEST_TIMING_NS_TO_MS(test_run->test_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test_run->test_timing.cpu_ns),
+            CTEST_TIMING_NS_TO_MS(test_run->fixture_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test_run->fixture_timing.cpu_ns));
+        ctest_events_end(&buffer);
+    }
+}
+
+void ctest_events_end_suite(const CTEST_SUITE_RUN* suite_run, size_t executed_test_count, size_t failed_test_count, size_t skipped_test_count)
+{
+    if (g_event_fd != -1)
+    {
+        CTEST_REPORT_BUFFER buffer;
+        ctest_events_begin(&buffer, "suite_end", suite_run->test_suite_name, NULL);
+        ctest_report_buffer_append_format(&buffer, ",\"executed\":%zu,\"failed\":%zu,\"skipped\":%zu,\"wall_ms\":%.3f",
+            executed_test_count, failed_test_count, skipped_test_count, CTEST_TIMING_NS_TO_MS(ctest_timing_get_wall_ns() - g_suite_start_wall_ns));
+        ctest_events_end(&buffer);
+    }
+    g_suite_name = NULL;
+}
+
+void ctest_events_disable(void)
+{
+    g_event_fd = -1;
+}
+
+void ctest_events_assert_failed(int line_no, const char* expression, const char* expected, const char* actual, const char* message)
+{
+    if (g_event_fd != -1)
+    {
+        const TEST_FUNCTION_DATA* test_function = g_CurrentTestFunction;
+        CTEST_REPORT_BUFFER buffer;
+        ctest_events_begin(&buffer, "assert_failed", g_suite_name, (test_function == NULL) ? NULL : test_function->TestFunctionName);
+        ctest_report_buffer_append_format(&buffer, ",\"line\":%d", line_no);
+        ctest_events_append_string(&buffer, "expression", expression);
+        ctest_events_append_string(&buffer, "expected", expected);
+        ctest_events_append_string(&buffer, "actual", actual);
+        ctest_events_append_string(&buffer, "message", message);
+        ctest_events_end(&buffer);
+    }
+}
@@ -0,0 +1,209 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* A filter is a comma separated list of patterns, compiled once per RunTests call:
+   - "name" matches a test function name, "suite.name" a test of a suite
+   - '*' matches any sequence of characters, '?' any one character
+   - a pattern starting with '-' excludes the tests it matches
+   A test is selected when it matches no negative pattern and it matches one of the positive patterns (or there are none). */
+
+typedef struct CTEST_FILTER_PATTERN_TAG
+{
+    bool is_negative;
+    const char* suite_pattern; /* NULL when the pattern is not qualified with a suite name */
+    const char* test_pattern;
+} CTEST_FILTER_PATTERN;
+
+typedef struct CTEST_FILTER_TAG
+{
+    size_t pattern_count;
+    size_t positive_pattern_count;
+    CTEST_FILTER_PATTERN* patterns;
+    char* text; /* copy of the filter, split in place by the patterns */
+} CTEST_FILTER;
+
+static bool ctest_filter_is_space(char c)
+{
+    return (c == ' ') || (c == '\t');
+}
+
+/* matches with backtracking to the last '*' only, which is linear for patterns without '*' and O(pattern * text) at worst */
+static bool ctest_filter_glob_match(const char* pattern, const char* text)
+{
+    bool result;
+    const char* star_pattern = NULL;
+    const char* star_text = NULL;
+
+    for (;;)
+    {
+        if (*text == '\0')
+        {
+            while (*pattern == '*')
+            {
+                pattern++;
+            }
+            result = (*pattern == '\0');
+            break;
+        }
+        else if (*pattern == '*')
+        {
+            star_pattern = ++pattern;
+            star_text = text;
+        }
+        else if ((*pattern != '\0') && ((*pattern == '?') || (*pattern == *text)))
+        {
+            pattern++;
+            text++;
+        }
+        else if (star_pattern != NULL)
+        {
+            /* let the last '*' take one more character */
+            pattern = star_pattern;
+            text = ++star_text;
+        }
+        else
+        {
+            result = false;
+            break;
+        }
+    }
+
+    return result;
+}
+
+CTEST_FILTER_HANDLE ctest_filter_create(const char* filter)
+{
+    CTEST_FILTER* result;
+    size_t filter_length = strlen(filter);
+    size_t max_pattern_count = 1;
+
+    for (const char* c = filter; *c != '\0'; c++)
+    {
+        if (*c == ',')
+        {
+            max_pattern_count++;
+        }
+    }
+
+    /* one allocation for the filter, its patterns and the text they point into */
+    result = malloc(sizeof(CTEST_FILTER) + (sizeof(CTEST_FILTER_PATTERN) * max_pattern_count) + filter_length + 1);
+    if (result == NULL)
+    {
+        LogError("failure in malloc(sizeof(CTEST_FILTER) + sizeof(CTEST_FILTER_PATTERN) * %zu + %zu + 1)", max_pattern_count, filter_length);
+    }
+    else
+    {
+        char* pattern_text;
+
+        result->pattern_count = 0;
+        result->positive_pattern_count = 0;
+        result->patterns = (CTEST_FILTER_PATTERN*)(result + 1);
+        result->text = (char*)(result->patterns + max_pattern_count);
+        (void)memcpy(result->text, filter, filter_length + 1);
+
+        pattern_text = result->text;
+        while (pattern_text != NULL)
+        {
+            char* pattern_end = strchr(pattern_text, ',');
+            char* next_pattern_text = NULL;
+            if (pattern_end == NULL)
+            {
+                pattern_end = pattern_text + strlen(pattern_text);
+            }
+            else
+            {
+                next_pattern_text = pattern_end + 1;
+            }
+
+            while (ctest_filter_is_space(*pattern_text))
+            {
+                pattern_text++;
+            }
+            while ((pattern_end > pattern_text) && ctest_filter_is_space(pattern_end[-1]))
+            {
+                pattern_end--;
+            }
+            *pattern_end = '\0';
+
+            {
+                bool is_negative = (*pattern_text == '-');
+                if (is_negative)
+                {
+                    pattern_text++;
+                }
+
+                if (*pattern_text == '\0')
+                {
+                    /* empty pattern (",," or a lone "-"), ignored */
+                }
+                else
+                {
+                    CTEST_FILTER_PATTERN* pattern = &result->patterns[result->pattern_count++];
+                    char* separator = strchr(pattern_text, '.');
+                    pattern->is_negative = is_negative;
+                    if (separator == NULL)
+                    {
+                        pattern->suite_pattern = NULL;
+                        pattern->test_pattern = pattern_text;
+                    }
+                    else
+                    {
+                        *separator = '\0';
+                        pattern->suite_pattern = pattern_text;
+                        pattern->test_pattern = separator + 1;
+                    }
+
+                    if (!is_negative)
+                    {
+                        result->positive_pattern_count++;
+                    }
+                }
+            }
+
+            pattern_text = next_pattern_text;
+        }
+    }
+
+    return result;
+}
+
+void ctest_filter_destroy(CTEST_FILTER_HANDLE filter)
+{
+    free(filter);
+}
+
+bool ctest_filter_matches(CTEST_FILTER_HANDLE filter, const char* test_suite_name, const char* test_function_name)
+{
+    bool is_included = (filter->positive_pattern_count == 0);
+    bool is_excluded = false;
+
+    for (size_t i = 0; (i < filter->pattern_count) && !is_excluded; i++)
+    {
+        const CTEST_FILTER_PATTERN* pattern = &filter->patterns[i];
+        if ((pattern->is_negative || !is_included) &&
+            ((pattern->suite_pattern == NULL) || ctest_filter_glob_match(pattern->suite_pattern, test_suite_name)) &&
+            ctest_filter_glob_match(pattern->test_pattern, test_function_name))
+        {
+            if (pattern->is_negative)
+            {
+                is_excluded = true;
+            }
+            else
+            {
+                is_included = true;
+            }
+        }
+    }
+
+    return is_included && !is_excluded;
+}
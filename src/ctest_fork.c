@@ -0,0 +1,546 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+
+bool ctest_run_tests_in_worker_processes(CTEST_SUITE_RUN* suite_run, uint32_t worker_process_count)
+{
+    (void)suite_run;
+    LogWarning("CTEST_WORKER_PROCESSES=%" PRIu32 " is not supported on this platform, running tests in process", worker_process_count);
+    return false;
+}
+
+#else
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* A worker is forked from the process that ran TEST_SUITE_INITIALIZE, so it shares the suite fixtures copy-on-write. Workers take
+   test indexes from a counter in shared memory and report each test over their own pipe: a START message before
+   TEST_FUNCTION_INITIALIZE and an END message with the TEST_RESULT after TEST_FUNCTION_CLEANUP, followed by the captured output of
+   the test when it has some. A worker that dies between the two crashed while running that test. */
+
+#define CTEST_FORK_MESSAGE_TYPE_VALUES \
+    CTEST_FORK_MESSAGE_TEST_START, \
+    CTEST_FORK_MESSAGE_TEST_END
+
+MU_DEFINE_ENUM(CTEST_FORK_MESSAGE_TYPE, CTEST_FORK_MESSAGE_TYPE_VALUES)
+
+/* how often timeouts are checked, and how long a timed out worker has to write its stack before it is killed */
+#define CTEST_FORK_TIMEOUT_CHECK_PERIOD_MS 50
+#define CTEST_FORK_STACK_DUMP_WAIT_MS 1000
+
+typedef struct CTEST_FORK_MESSAGE_TAG
+{
+    CTEST_FORK_MESSAGE_TYPE message_type;
+    uint32_t test_index;
+    TEST_RESULT test_result;
+    CTEST_TIMING test_timing;
+    CTEST_TIMING fixture_timing;
+    CTEST_BENCHMARK_RESULT benchmark_result;
+    CTEST_PERF_COUNTERS perf_counters;
+    int crash_signal;
+    uint32_t output_length; /* the bytes of captured output following the message */
+} CTEST_FORK_MESSAGE;
+
+typedef struct CTEST_FORK_WORKER_TAG
+{
+    pid_t pid;
+    int read_fd; /* -1 when the slot has no running worker */
+    size_t running_test_index; /* SIZE_MAX when the worker is between tests */
+    uint64_t timeout_signal_wall_ns; /* when the running test timed out and SIGQUIT was sent, 0 when it did not */
+    size_t received_bytes;
+    CTEST_FORK_MESSAGE message;
+    char* output; /* the captured output following the message, NULL when there is none or it could not be allocated */
+    size_t received_output_bytes;
+} CTEST_FORK_WORKER;
+
+static bool ctest_fork_write(int fd, const char* buffer, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        ssize_t result = write(fd, buffer + written, size - written);
+        if (result < 0)
+        {
+            if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            written += (size_t)result;
+        }
+    }
+    return true;
+}
+
+static bool ctest_fork_write_message(int fd, CTEST_FORK_MESSAGE_TYPE message_type, size_t test_index, const CTEST_TEST_RUN* test_run)
+{
+    CTEST_FORK_MESSAGE message;
+    const char* output = (message_type == CTEST_FORK_MESSAGE_TEST_END) ? test_run->captured_output : NULL;
+
+    (void)memset(&message, 0, sizeof(message));
+    message.message_type = message_type;
+    message.test_index = (uint32_t)test_index;
+    message.test_result = *test_run->test_function->TestResult;
+    message.test_timing = test_run->test_timing;
+    message.fixture_timing = test_run->fixture_timing;
+    message.benchmark_result = test_run->benchmark_result;
+    message.perf_counters = test_run->perf_counters;
+    message.crash_signal = test_run->crash_signal;
+    message.output_length = (output == NULL) ? 0 : (uint32_t)strlen(output);
+
+    /* the message is smaller than PIPE_BUF, so the loop only repeats when interrupted by a signal */
+    return ctest_fork_write(fd, (const char*)&message, sizeof(message)) &&
+        ((output == NULL) || ctest_fork_write(fd, output, message.output_length));
+}
+
+static void ctest_fork_worker_main(CTEST_SUITE_RUN* suite_run, size_t* next_test_index, int write_fd)
+{
+    size_t test_index;
+
+    /* on timeout the parent sends SIGQUIT, the worker writes the stack of the hung test and exits */
+    ctest_watchdog_install_stack_dump_handler(true);
+
+    while ((test_index = __atomic_fetch_add(next_test_index, 1, __ATOMIC_RELAXED)) < suite_run->test_count)
+    {
+        CTEST_TEST_RUN* test_run = &suite_run->tests[test_index];
+        if (test_run->is_selected)
+        {
+            if (!ctest_fork_write_message(write_fd, CTEST_FORK_MESSAGE_TEST_START, test_index, test_run))
+            {
+                break;
+            }
+
+            ctest_run_test(suite_run, test_run);
+
+            bool is_written = ctest_fork_write_message(write_fd, CTEST_FORK_MESSAGE_TEST_END, test_index, test_run);
+            free(test_run->captured_output);
+            test_run->captured_output = NULL;
+            if (!is_written)
+            {
+                break;
+            }
+
+            if (suite_run->is_test_runner_ok == 0)
+            {
+                /* a failed TEST_FUNCTION_CLEANUP leaves this process in an unknown state, a fresh worker takes over */
+                break;
+            }
+        }
+    }
+
+    (void)fflush(NULL);
+}
+
+static bool ctest_fork_start_worker(CTEST_SUITE_RUN* suite_run, size_t* next_test_index, CTEST_FORK_WORKER* worker)
+{
+    bool result;
+    int fds[2];
+
+    if (pipe(fds) != 0)
+    {
+        LogError("failure in pipe, errno=%d", errno);
+        result = false;
+    }
+    else
+    {
+        /* anything buffered before the fork would otherwise be written once by every worker */
+        (void)fflush(NULL);
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            LogError("failure in fork, errno=%d", errno);
+            (void)close(fds[0]);
+            (void)close(fds[1]);
+            result = false;
+        }
+        else if (pid == 0)
+        {
+            (void)close(fds[0]);
+            ctest_trace_begin_worker_process();
+            ctest_fork_worker_main(suite_run, next_test_index, fds[1]);
+            ctest_trace_write();
+            (void)close(fds[1]);
+            /* _exit: the atexit handlers and static destructors belong to the process that forked the worker */
+            _exit(0);
+        }
+        else
+        {
+            (void)close(fds[1]);
+            worker->pid = pid;
+            worker->read_fd = fds[0];
+            worker->running_test_index = SIZE_MAX;
+            worker->timeout_signal_wall_ns = 0;
+            worker->received_bytes = 0;
+            worker->output = NULL;
+            worker->received_output_bytes = 0;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+static void ctest_fork_handle_message(CTEST_SUITE_RUN* suite_run, CTEST_FORK_WORKER* worker)
+{
+    if (worker->message.test_index >= suite_run->test_count)
+    {
+        LogError("worker %d sent an invalid test index %" PRIu32 "", (int)worker->pid, worker->message.test_index);
+        free(worker->output);
+    }
+    else if (worker->message.message_type == CTEST_FORK_MESSAGE_TEST_START)
+    {
+        CTEST_TEST_RUN* test_run = &suite_run->tests[worker->message.test_index];
+        test_run->start_wall_ns = ctest_timing_get_wall_ns();
+        test_run->state = CTEST_TEST_RUN_RUNNING;
+        worker->running_test_index = worker->message.test_index;
+        ctest_report_begin_test(suite_run, test_run);
+    }
+    else
+    {
+        CTEST_TEST_RUN* test_run = &suite_run->tests[worker->message.test_index];
+        *test_run->test_function->TestResult = worker->message.test_result;
+        test_run->test_timing = worker->message.test_timing;
+        test_run->fixture_timing = worker->message.fixture_timing;
+        test_run->benchmark_result = worker->message.benchmark_result;
+        test_run->perf_counters = worker->message.perf_counters;
+        test_run->captured_output = worker->output;
+        test_run->crash_signal = worker->message.crash_signal;
+        test_run->state = CTEST_TEST_RUN_DONE;
+        worker->running_test_index = SIZE_MAX;
+        ctest_report_test(suite_run, test_run, ctest_crash_recovery_get_message(test_run->crash_signal));
+    }
+}
+
+/* reads what the worker sent and handles the message once it is complete with its output */
+static ssize_t ctest_fork_read(CTEST_SUITE_RUN* suite_run, CTEST_FORK_WORKER* worker)
+{
+    ssize_t result;
+
+    if (worker->received_bytes < sizeof(worker->message))
+    {
+        result = read(worker->read_fd, (char*)&worker->message + worker->received_bytes, sizeof(worker->message) - worker->received_bytes);
+        if (result > 0)
+        {
+            worker->received_bytes += (size_t)result;
+            if ((worker->received_bytes == sizeof(worker->message)) && (worker->message.output_length > 0))
+            {
+                worker->output = malloc((size_t)worker->message.output_length + 1);
+                if (worker->output == NULL)
+                {
+                    LogError("failure in malloc(%" PRIu32 "), the output of the test is not reported", worker->message.output_length + 1);
+                }
+            }
+        }
+    }
+    else
+    {
+        char discarded[4096];
+        size_t size = worker->message.output_length - worker->received_output_bytes;
+        char* destination;
+        if (worker->output == NULL)
+        {
+            destination = discarded;
+            size = (size < sizeof(discarded)) ? size : sizeof(discarded);
+        }
+        else
+        {
+            destination = worker->output + worker->received_output_bytes;
+        }
+        result = read(worker->read_fd, destination, size);
+        if (result > 0)
+        {
+            worker->received_output_bytes += (size_t)result;
+        }
+    }
+
+    if ((result > 0) && (worker->received_bytes == sizeof(worker->message)) && (worker->received_output_bytes == worker->message.output_length))
+    {
+        if (worker->output != NULL)
+        {
+            worker->output[worker->received_output_bytes] = '\0';
+        }
+        /* the output (if any) is now the test's */
+        ctest_fork_handle_message(suite_run, worker);
+        worker->received_bytes = 0;
+        worker->output = NULL;
+        worker->received_output_bytes = 0;
+    }
+
+    return result;
+}
+
+/* reaps the worker and, when it died in the middle of a test, fails that test */
+static void ctest_fork_finish_worker(CTEST_SUITE_RUN* suite_run, CTEST_FORK_WORKER* worker)
+{
+    int status = 0;
+
+    (void)close(worker->read_fd);
+    worker->read_fd = -1;
+    /* the worker died while sending the output of a test */
+    free(worker->output);
+    worker->output = NULL;
+
+    while ((waitpid(worker->pid, &status, 0) < 0) && (errno == EINTR))
+    {
+    }
+
+    if (worker->running_test_index != SIZE_MAX)
+    {
+        CTEST_TEST_RUN* test_run = &suite_run->tests[worker->running_test_index];
+        const TEST_FUNCTION_DATA* test_function = test_run->test_function;
+        *test_function->TestResult = TEST_FAILED;
+        /* the worker did not report the timing, the wall time is what the parent saw */
+        test_run->test_timing.wall_ns = ctest_timing_get_wall_ns() - test_run->start_wall_ns;
+        test_run->state = CTEST_TEST_RUN_DONE;
+        char message[128];
+        if (worker->timeout_signal_wall_ns != 0)
+        {
+            (void)snprintf(message, sizeof(message), "timed out after %" PRIu32 " ms, worker process %d stopped", suite_run->test_timeout_ms, (int)worker->pid);
+        }
+        else if (WIFSIGNALED(status))
+        {
+            (void)snprintf(message, sizeof(message), "worker process %d killed by signal %d", (int)worker->pid, WTERMSIG(status));
+        }
+        else
+        {
+            (void)snprintf(message, sizeof(message), "worker process %d exited with %d", (int)worker->pid, WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+        }
+        LogInfo(CTEST_ANSI_COLOR_RED "Test %s result = !!! FAILED !!! (%s)" CTEST_ANSI_COLOR_RESET "", test_function->TestFunctionName, message);
+        worker->running_test_index = SIZE_MAX;
+        ctest_journal_end_test(suite_run, test_run);
+        ctest_report_test(suite_run, test_run, message);
+        /* the worker wrote the start of the test, not its end */
+        ctest_events_end_test(suite_run, test_run, message);
+    }
+    worker->timeout_signal_wall_ns = 0;
+}
+
+/* asks the worker running a timed out test for its stack (SIGQUIT makes it write it and exit), kills it if it does not exit */
+static void ctest_fork_stop_timed_out_worker(CTEST_FORK_WORKER* worker, uint64_t now)
+{
+    if (worker->timeout_signal_wall_ns == 0)
+    {
+        worker->timeout_signal_wall_ns = now;
+        (void)kill(worker->pid, SIGQUIT);
+    }
+    else if ((now - worker->timeout_signal_wall_ns) / 1000000 >= CTEST_FORK_STACK_DUMP_WAIT_MS)
+    {
+        (void)kill(worker->pid, SIGKILL);
+    }
+}
+
+/* a running test can be watched as soon as its START message arrived */
+static void ctest_fork_check_timeouts(CTEST_SUITE_RUN* suite_run, CTEST_FORK_WORKER* workers, uint32_t worker_process_count, size_t* next_test_index, bool* is_suite_timed_out)
+{
+    uint64_t now = ctest_timing_get_wall_ns();
+
+    if (!*is_suite_timed_out && (suite_run->suite_deadline_wall_ns != 0) && (now >= suite_run->suite_deadline_wall_ns))
+    {
+        LogError(CTEST_ANSI_COLOR_RED "Suite %s timed out, the tests that did not start are not executed" CTEST_ANSI_COLOR_RESET "", suite_run->test_suite_name);
+        *is_suite_timed_out = true;
+        /* no worker takes another test */
+        __atomic_store_n(next_test_index, suite_run->test_count, __ATOMIC_RELAXED);
+    }
+
+    for (uint32_t i = 0; i < worker_process_count; i++)
+    {
+        CTEST_FORK_WORKER* worker = &workers[i];
+        if ((worker->read_fd != -1) && (worker->running_test_index != SIZE_MAX))
+        {
+            const CTEST_TEST_RUN* test_run = &suite_run->tests[worker->running_test_index];
+            if (*is_suite_timed_out ||
+                (worker->timeout_signal_wall_ns != 0) ||
+                ((suite_run->test_timeout_ms > 0) && ((now - test_run->start_wall_ns) / 1000000 >= suite_run->test_timeout_ms)))
+            {
+                ctest_fork_stop_timed_out_worker(worker, now);
+            }
+        }
+    }
+}
+
+bool ctest_run_tests_in_worker_processes(CTEST_SUITE_RUN* suite_run, uint32_t worker_process_count)
+{
+    bool result;
+    size_t selected_test_count = 0;
+
+    for (size_t i = 0; i < suite_run->test_count; i++)
+    {
+        if (suite_run->tests[i].is_selected)
+        {
+            selected_test_count++;
+        }
+    }
+
+    if (worker_process_count > selected_test_count)
+    {
+        worker_process_count = (selected_test_count == 0) ? 1 : (uint32_t)selected_test_count;
+    }
+
+    size_t* next_test_index = mmap(NULL, sizeof(size_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (next_test_index == MAP_FAILED)
+    {
+        LogError("failure in mmap for the shared test queue, errno=%d", errno);
+        result = false;
+    }
+    else
+    {
+        CTEST_FORK_WORKER* workers = malloc(sizeof(CTEST_FORK_WORKER) * worker_process_count);
+        struct pollfd* poll_fds = malloc(sizeof(struct pollfd) * worker_process_count);
+        if ((workers == NULL) || (poll_fds == NULL))
+        {
+            LogError("failure in malloc for %" PRIu32 " worker processes", worker_process_count);
+            result = false;
+        }
+        else
+        {
+            uint32_t running_worker_count = 0;
+            bool is_suite_timed_out = false;
+            int poll_timeout_ms = ((suite_run->test_timeout_ms > 0) || (suite_run->suite_deadline_wall_ns != 0)) ? CTEST_FORK_TIMEOUT_CHECK_PERIOD_MS : -1;
+
+            *next_test_index = 0;
+
+            LogInfo(" ### Running tests in %" PRIu32 " worker processes", worker_process_count);
+
+            for (uint32_t i = 0; i < worker_process_count; i++)
+            {
+                workers[i].read_fd = -1;
+                if (ctest_fork_start_worker(suite_run, next_test_index, &workers[i]))
+                {
+                    running_worker_count++;
+                }
+            }
+
+            if (running_worker_count == 0)
+            {
+                LogError("no worker process could be started, running tests in process");
+                result = false;
+            }
+            else
+            {
+                while (running_worker_count > 0)
+                {
+                    nfds_t poll_fd_count = 0;
+                    for (uint32_t i = 0; i < worker_process_count; i++)
+                    {
+                        if (workers[i].read_fd != -1)
+                        {
+                            poll_fds[poll_fd_count].fd = workers[i].read_fd;
+                            poll_fds[poll_fd_count].events = POLLIN;
+                            poll_fds[poll_fd_count].revents = 0;
+                            poll_fd_count++;
+                        }
+                    }
+
+                    int poll_result = poll(poll_fds, poll_fd_count, poll_timeout_ms);
+                    if (poll_result < 0)
+                    {
+                        if (errno != EINTR)
+                        {
+                            LogError("failure in poll, errno=%d", errno);
+                            break;
+                        }
+                        continue;
+                    }
+
+                    if (poll_timeout_ms != -1)
+                    {
+                        ctest_fork_check_timeouts(suite_run, workers, worker_process_count, next_test_index, &is_suite_timed_out);
+                    }
+
+                    if (poll_result == 0)
+                    {
+                        continue;
+                    }
+
+                    nfds_t poll_fd_index = 0;
+                    for (uint32_t i = 0; i < worker_process_count; i++)
+                    {
+                        CTEST_FORK_WORKER* worker = &workers[i];
+                        if (worker->read_fd == -1)
+                        {
+                            continue;
+                        }
+
+                        short revents = poll_fds[poll_fd_index++].revents;
+                        if (revents == 0)
+                        {
+                            continue;
+                        }
+
+                        ssize_t read_result = ctest_fork_read(suite_run, worker);
+                        if ((read_result == 0) || ((read_result < 0) && (errno != EINTR)))
+                        {
+                            ctest_fork_finish_worker(suite_run, worker);
+                            running_worker_count--;
+
+                            /* a worker that crashed (or bailed out after a failed cleanup) is replaced while tests are left */
+                            if (!is_suite_timed_out &&
+                                (__atomic_load_n(next_test_index, __ATOMIC_RELAXED) < suite_run->test_count) &&
+                                ctest_fork_start_worker(suite_run, next_test_index, worker))
+                            {
+                                running_worker_count++;
+                            }
+                        }
+                    }
+                }
+
+                for (uint32_t i = 0; i < worker_process_count; i++)
+                {
+                    if (workers[i].read_fd != -1)
+                    {
+                        (void)kill(workers[i].pid, SIGKILL);
+                        ctest_fork_finish_worker(suite_run, &workers[i]);
+                    }
+                }
+
+                /* tests that no worker got to (suite timeout, or workers that could not be replaced) */
+                for (size_t i = 0; i < suite_run->test_count; i++)
+                {
+                    if (suite_run->tests[i].is_selected && (suite_run->tests[i].state == CTEST_TEST_RUN_PENDING))
+                    {
+                        *suite_run->tests[i].test_function->TestResult = TEST_NOT_EXECUTED;
+                    }
+                }
+
+                if (is_suite_timed_out)
+                {
+                    /* TEST_SUITE_CLEANUP still runs, limited by the test timeout only */
+                    suite_run->suite_deadline_wall_ns = 0;
+                }
+
+                result = true;
+            }
+        }
+
+        free(poll_fds);
+        free(workers);
+        (void)munmap(next_test_index, sizeof(size_t));
+    }
+
+    return result;
+}
+
+#endif
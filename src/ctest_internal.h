@@ -0,0 +1,437 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_INTERNAL_H
+#define CTEST_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <signal.h>
+
+#include "ctest.h"
+
+#if !defined _MSC_VER
+#include <pthread.h>
+#endif
+
+/* Declarations shared by the source files of the test runner. Not part of the public API. */
+
+#if defined _MSC_VER
+typedef unsigned long CTEST_THREAD_ID; /* DWORD, as returned by GetCurrentThreadId */
+#else
+typedef pthread_t CTEST_THREAD_ID;
+#endif
+
+#define CTEST_TEST_RUN_STATE_VALUES \
+    CTEST_TEST_RUN_PENDING, \
+    CTEST_TEST_RUN_RUNNING, \
+    CTEST_TEST_RUN_DONE
+
+MU_DEFINE_ENUM(CTEST_TEST_RUN_STATE, CTEST_TEST_RUN_STATE_VALUES)
+
+/* wall and CPU time: either a point in time (ctest_timing_get_timestamp, wall_ns from a monotonic clock and cpu_ns the CPU time
+   consumed by the calling thread) or the time elapsed between points in time (ctest_timing_add_elapsed) */
+typedef struct CTEST_TIMING_TAG
+{
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+} CTEST_TIMING;
+
+#define CTEST_TIMING_NS_TO_MS(ns) ((double)(ns) / 1000000.0)
+
+/* a benchmark is measured as CTEST_BENCHMARK_SAMPLE_COUNT samples of the same number of iterations */
+#define CTEST_BENCHMARK_SAMPLE_COUNT 10
+
+/* the measurement of a CTEST_BENCHMARK, sample_count is 0 when the benchmark did not complete. The times are per iteration. */
+typedef struct CTEST_BENCHMARK_RESULT_TAG
+{
+    uint64_t iterations; /* per sample */
+    uint32_t sample_count;
+    double mean_ns;
+    double median_ns;
+    double stddev_ns;
+    double min_ns;
+    double samples_ns[CTEST_BENCHMARK_SAMPLE_COUNT]; /* in the order they were measured */
+} CTEST_BENCHMARK_RESULT;
+
+#define CTEST_PERF_COUNTER_VALUES \
+    CTEST_PERF_COUNTER_CYCLES, \
+    CTEST_PERF_COUNTER_INSTRUCTIONS, \
+    CTEST_PERF_COUNTER_CACHE_MISSES, \
+    CTEST_PERF_COUNTER_BRANCH_MISSES, \
+    CTEST_PERF_COUNTER_PAGE_FAULTS, \
+    CTEST_PERF_COUNTER_CONTEXT_SWITCHES
+
+MU_DEFINE_ENUM_WITHOUT_INVALID(CTEST_PERF_COUNTER, CTEST_PERF_COUNTER_VALUES)
+
+#define CTEST_PERF_COUNTER_COUNT MU_COUNT_ARG(CTEST_PERF_COUNTER_VALUES)
+
+/* the counters of one test (CTEST_PERF_COUNTERS), bit i of valid_mask is set when values[i] was counted. For benchmarks the values
+   cover the iterations of the samples, iterations is 1 for tests and 0 when nothing was counted. */
+typedef struct CTEST_PERF_COUNTERS_TAG
+{
+    uint64_t iterations;
+    uint32_t valid_mask;
+    uint64_t values[CTEST_PERF_COUNTER_COUNT];
+} CTEST_PERF_COUNTERS;
+
+/* the counters opened on the thread running a test, -1 for the ones that are not counted */
+typedef struct CTEST_PERF_COUNTERS_SESSION_TAG
+{
+    int fds[CTEST_PERF_COUNTER_COUNT];
+} CTEST_PERF_COUNTERS_SESSION;
+
+/* state of one CTEST_FUNCTION while its suite is executed by RunTests */
+typedef struct CTEST_TEST_RUN_TAG
+{
+    const TEST_FUNCTION_DATA* test_function;
+    bool is_in_shard; /* false when the test belongs to another shard */
+    bool is_selected; /* false when the test is skipped (shard or filter) and must not be executed */
+    CTEST_TIMING test_timing; /* the CTEST_FUNCTION itself */
+    CTEST_TIMING fixture_timing; /* its TEST_FUNCTION_INITIALIZE and TEST_FUNCTION_CLEANUP */
+    CTEST_BENCHMARK_RESULT benchmark_result; /* CTEST_BENCHMARK only */
+    CTEST_PERF_COUNTERS perf_counters;
+    /* watched by the watchdog: when the test (with its function fixtures) started, on which thread */
+    volatile CTEST_TEST_RUN_STATE state;
+    volatile uint64_t start_wall_ns;
+    CTEST_THREAD_ID thread_id;
+    /* the injected allocation failures the test did not handle, see ctest_allocation_failure.c */
+    size_t allocation_failure_count;
+    /* what the test wrote to stdout and stderr when it failed (CTEST_CAPTURE_OUTPUT), NULL otherwise. Freed with the suite */
+    char* captured_output;
+    /* the signal the test body crashed with and recovered from (CTEST_CRASH_RECOVERY), 0 when it did not crash */
+    int crash_signal;
+} CTEST_TEST_RUN;
+
+/* state of one RunTests call */
+typedef struct CTEST_SUITE_RUN_TAG
+{
+    const char* test_suite_name;
+    const TEST_FUNCTION_DATA* test_function_initialize;
+    const TEST_FUNCTION_DATA* test_function_cleanup;
+    unsigned int suite_flags;
+    CTEST_TEST_RUN* tests;
+    size_t test_count;
+    /* set to 0 when a TEST_FUNCTION_CLEANUP fails, the tests that did not start yet are then not executed */
+    volatile int is_test_runner_ok;
+    /* timeouts, 0 when not limited. suite_deadline_wall_ns is compared with ctest_timing_get_wall_ns */
+    uint32_t test_timeout_ms;
+    volatile uint64_t suite_deadline_wall_ns;
+    /* the TEST_SUITE_INITIALIZE/TEST_SUITE_CLEANUP running in process, NULL when none is */
+    const char* volatile running_suite_fixture;
+    volatile uint64_t suite_fixture_start_wall_ns;
+    CTEST_THREAD_ID suite_fixture_thread_id;
+    /* set while the tests run in worker processes, which watch their own timeouts */
+    volatile int is_watchdog_paused;
+    uint32_t benchmark_min_time_ms;
+    bool use_perf_counters;
+    bool check_leaks_per_test;
+    uint32_t allocation_failure_sweep; /* 0 when tests are not swept */
+    bool capture_output; /* false while tests run on parallel threads */
+} CTEST_SUITE_RUN;
+
+typedef struct CTEST_WATCHDOG_TAG* CTEST_WATCHDOG_HANDLE;
+typedef struct CTEST_FILTER_TAG* CTEST_FILTER_HANDLE;
+
+/* runs TEST_FUNCTION_INITIALIZE, the test and TEST_FUNCTION_CLEANUP on the calling thread and logs the result */
+void ctest_run_test(CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run);
+
+bool ctest_is_test_thread_safe(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run);
+
+/* runs the selected thread safe tests of the suite on worker_thread_count threads (the calling thread being one of them) */
+void ctest_run_tests_parallel(CTEST_SUITE_RUN* suite_run, uint32_t worker_thread_count);
+
+/* runs the selected tests of the suite in worker_process_count processes forked after TEST_SUITE_INITIALIZE, a test crashing its
+   worker is failed and the worker is replaced. Returns false (without running any test) when worker processes are not available. */
+bool ctest_run_tests_in_worker_processes(CTEST_SUITE_RUN* suite_run, uint32_t worker_process_count);
+
+uint32_t ctest_get_processor_count(void);
+
+uint64_t ctest_timing_get_wall_ns(void);
+
+void ctest_timing_get_timestamp(CTEST_TIMING* timestamp);
+
+/* adds the time elapsed since start (taken on the same thread) to timing */
+void ctest_timing_add_elapsed(CTEST_TIMING* timing, const CTEST_TIMING* start);
+
+/* logs a table of the slowest_test_count executed tests of the suite that took the most wall time */
+void ctest_timing_log_slowest_tests(const CTEST_SUITE_RUN* suite_run, uint32_t slowest_test_count);
+
+/* runs the body of a CTEST_BENCHMARK in timed loops lasting min_time_ms in total and logs the result, min_time_ms 0 runs the body
+   once without measuring. The perf counters are enabled around the loops of the samples only. A failing assert in the body longjmps
+   out, leaving result->sample_count 0. */
+void ctest_benchmark_run(const TEST_FUNCTION_DATA* benchmark, uint32_t min_time_ms, const CTEST_PERF_COUNTERS_SESSION* perf_session, CTEST_BENCHMARK_RESULT* result);
+
+/* opens the perf counters on the calling thread (Linux only), disabled. Counters the kernel denies are not counted, after the
+   kernel denied all of them the following calls do not try again. */
+void ctest_perf_counters_open(CTEST_PERF_COUNTERS_SESSION* session);
+/* resets and starts the counters */
+void ctest_perf_counters_enable(const CTEST_PERF_COUNTERS_SESSION* session);
+void ctest_perf_counters_disable(const CTEST_PERF_COUNTERS_SESSION* session);
+/* reads the counters (scaled when they were multiplexed) in counters->values and closes them */
+void ctest_perf_counters_close(CTEST_PERF_COUNTERS_SESSION* session, CTEST_PERF_COUNTERS* counters);
+void ctest_perf_counters_log(const char* test_function_name, const CTEST_PERF_COUNTERS* counters);
+/* the name of a counter in the logs, "cycles"... */
+const char* ctest_perf_counters_get_name(CTEST_PERF_COUNTER counter);
+
+/* adds the timings of the executed tests and the measurements of the benchmarks of the suite to the ones of the previous suites of
+   the process and (re)writes them all to the baseline file at path. Returns false when the file cannot be written. */
+bool ctest_baseline_write(const CTEST_SUITE_RUN* suite_run, const char* path);
+
+/* compares the tests and benchmarks of the suite with the baseline file at path, returns the number of regressions (1 when the
+   baseline cannot be read) */
+size_t ctest_baseline_compare(const CTEST_SUITE_RUN* suite_run, const char* path, uint32_t threshold_percent);
+
+CTEST_THREAD_ID ctest_get_current_thread_id(void);
+
+/* starts a thread that fails the run (stack dump, results so far, abort) when a test or suite fixture running in process exceeds
+   suite_run->test_timeout_ms or the suite exceeds suite_run->suite_deadline_wall_ns. Returns NULL when there is nothing to watch. */
+CTEST_WATCHDOG_HANDLE ctest_watchdog_start(CTEST_SUITE_RUN* suite_run);
+void ctest_watchdog_stop(CTEST_WATCHDOG_HANDLE watchdog);
+
+/* installs the SIGQUIT handler that writes the stack of the thread receiving it to stderr (POSIX with glibc only), a worker
+   process exits after writing it */
+void ctest_watchdog_install_stack_dump_handler(bool exit_after_dump);
+
+void ctest_watchdog_log_results_so_far(const CTEST_SUITE_RUN* suite_run);
+
+/* the entries of a suite, see ctest_registration.c. A suite registered in the section is a slice of the index of the section, a chained
+   suite is walked from its first entry */
+typedef struct CTEST_REGISTRATION_SUITE_TAG
+{
+    bool is_in_section;
+    const TEST_FUNCTION_DATA* const* section_entries;
+    size_t section_entry_count;
+    size_t next_index; /* of the iteration in section_entries */
+    const TEST_FUNCTION_DATA* first_chained_entry;
+    size_t test_count;
+    unsigned int suite_flags;
+} CTEST_REGISTRATION_SUITE;
+
+/* finds the entries of the suite (once per RunTests), with its number of tests and its flags, test_list_head being the CTEST_END_SUITE
+   entry of the suite */
+void ctest_registration_get_suite(const TEST_FUNCTION_DATA* test_list_head, CTEST_REGISTRATION_SUITE* suite);
+
+/* iterate the tests and fixtures of the suite, NULL after the last one. entry is the one returned last */
+const TEST_FUNCTION_DATA* ctest_registration_get_first_entry(CTEST_REGISTRATION_SUITE* suite);
+const TEST_FUNCTION_DATA* ctest_registration_get_next_entry(CTEST_REGISTRATION_SUITE* suite, const TEST_FUNCTION_DATA* entry);
+
+#if defined CTEST_USE_LEAK_TRACKER
+/* allocation tracker replacing malloc and operator new (Linux, built with use_leak_tracker), see ctest_leak_tracker.c. Blocks allocated
+   after ctest_leak_tracker_start and not freed are leaks, ctest_leak_tracker_report_leaks counts them (and writes them to stderr when
+   is_logged) without allocating */
+void ctest_leak_tracker_start(void);
+size_t ctest_leak_tracker_report_leaks(bool is_logged);
+/* the blocks allocated by the calling thread between ctest_leak_tracker_begin_test and ctest_leak_tracker_end_test are the ones of the
+   test, ctest_leak_tracker_end_test logs those still allocated with their stacks and returns their count */
+uint32_t ctest_leak_tracker_begin_test(void);
+size_t ctest_leak_tracker_end_test(uint32_t test_scope, const char* test_function_name);
+void* ctest_leak_tracker_allocate(size_t size, const void* caller);
+/* gets/sets the allocation assertion scope counting the allocations of the calling thread (NULL for none), set returns the previous one */
+CTEST_ALLOCATION_SCOPE* ctest_leak_tracker_get_allocation_scope(void);
+CTEST_ALLOCATION_SCOPE* ctest_leak_tracker_set_allocation_scope(CTEST_ALLOCATION_SCOPE* scope);
+/* logs the stack of a site counted in an allocation assertion scope */
+void ctest_leak_tracker_log_allocation_site(const CTEST_ALLOCATION_SITE* site);
+/* numbers the allocations of the calling thread from ctest_leak_tracker_begin_allocation_failure on and makes the failing_allocation-th
+   one fail (none when 0). ctest_leak_tracker_end_allocation_failure returns how many allocations were made */
+void ctest_leak_tracker_begin_allocation_failure(uint64_t failing_allocation);
+uint64_t ctest_leak_tracker_end_allocation_failure(void);
+bool ctest_leak_tracker_is_allocation_failure_injected(void);
+/* logs the stack of the allocation that was made to fail, if it was */
+void ctest_leak_tracker_log_injected_failure(void);
+/* the same, async-signal-safe, for a test crashing after the failure */
+void ctest_leak_tracker_write_injected_failure(int fd);
+/* runs the test (after its TEST_FUNCTION_INITIALIZE) in forked processes with each of its allocations failing in turn, logs and returns
+   the count of failures that were not handled */
+size_t ctest_allocation_failure_sweep(CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run);
+/* does nothing, referencing it links the operator new replacements of ctest_leak_tracker_new.cpp from the static library */
+void ctest_leak_tracker_link_operator_new(void);
+#endif
+
+/* result reporters (CTEST_REPORT_JUNIT, CTEST_REPORT_TAP, CTEST_REPORT_JSON), see ctest_report.c. The tests are reported as they
+   complete, from any thread, ctest_report_end_suite reports the selected tests that did not run and the summary of the suite.
+   message is NULL for the one matching the result of the test. Only the process that called RunTests reports. ctest_report_begin_test
+   is called when a test starts running (the reports then know it for a crash). */
+void ctest_report_begin_suite(const CTEST_SUITE_RUN* suite_run);
+void ctest_report_begin_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run);
+void ctest_report_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run, const char* message);
+void ctest_report_end_suite(const CTEST_SUITE_RUN* suite_run, size_t executed_test_count, size_t failed_test_count, size_t skipped_test_count);
+/* the process is about to end (crash, timeout): the running tests are reported as failed with reason and the reports are completed */
+void ctest_report_interrupt(const char* reason);
+
+/* event stream (CTEST_EVENT_FD), see ctest_events.c. Each event is written when it happens, by the process running the test.
+   message is NULL for the one matching the result of the test. */
+void ctest_events_begin_suite(const CTEST_SUITE_RUN* suite_run);
+void ctest_events_begin_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run);
+void ctest_events_end_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run, const char* message);
+void ctest_events_end_suite(const CTEST_SUITE_RUN* suite_run, size_t executed_test_count, size_t failed_test_count, size_t skipped_test_count);
+/* no more events are written by the calling process, for the forked processes whose tests are not part of the run */
+void ctest_events_disable(void);
+
+#define CTEST_TRACE_SPAN_VALUES \
+    CTEST_TRACE_SUITE_INITIALIZE, \
+    CTEST_TRACE_FUNCTION_INITIALIZE, \
+    CTEST_TRACE_TEST, \
+    CTEST_TRACE_FUNCTION_CLEANUP, \
+    CTEST_TRACE_SUITE_CLEANUP
+
+MU_DEFINE_ENUM_WITHOUT_INVALID(CTEST_TRACE_SPAN, CTEST_TRACE_SPAN_VALUES)
+
+/* timeline of the run (CTEST_TRACE), see ctest_trace.c. ctest_trace_begin_suite opens the trace (the first time) and, like
+   ctest_trace_begin_thread on the other threads running tests, gives the calling thread its buffer. ctest_trace_add records a span of
+   the calling thread, from start_wall_ns to now. ctest_trace_write writes the spans recorded so far, by all threads. */
+void ctest_trace_begin_suite(void);
+void ctest_trace_begin_thread(void);
+void ctest_trace_end_thread(void);
+void ctest_trace_add(CTEST_TRACE_SPAN span, const char* suite_name, const char* test_name, uint64_t start_wall_ns);
+void ctest_trace_write(void);
+/* in a forked worker process: the spans recorded by the parent are left to it */
+void ctest_trace_begin_worker_process(void);
+
+/* quiet mode (CTEST_QUIET), see ctest_quiet.c. ctest_quiet_begin_suite puts the quiet log sink in place (the first time) and, like
+   ctest_quiet_begin_thread on the other threads running tests, gives the calling thread its log. What the thread logs between
+   ctest_quiet_begin_test and ctest_quiet_end_test is only logged when the test failed. */
+void ctest_quiet_begin_suite(void);
+void ctest_quiet_end_suite(void);
+void ctest_quiet_begin_thread(void);
+void ctest_quiet_end_thread(void);
+void ctest_quiet_begin_test(const TEST_FUNCTION_DATA* test_function);
+void ctest_quiet_end_test(bool is_failed);
+/* everything the calling process logs goes to the configured sinks, for the forked processes whose output is shown by the parent */
+void ctest_quiet_disable(void);
+
+/* output capture (CTEST_CAPTURE_OUTPUT), see ctest_capture.c. Between ctest_capture_begin_test and ctest_capture_end_test what the
+   process writes to stdout and stderr is captured. When the test failed ctest_capture_end_test writes it to stdout and returns it
+   (malloc'd, NULL when the test wrote nothing), otherwise it is discarded. */
+void ctest_capture_begin_test(const TEST_FUNCTION_DATA* test_function);
+char* ctest_capture_end_test(bool is_failed);
+
+/* crash dispatch, see ctest.c. The handlers of the crash signals are installed once, when the first hook is set, and run on the
+   alternate stack of the thread (ctest_crash_begin_thread, released by ctest_crash_end_thread). A crash calls the hooks in the order
+   of CTEST_CRASH_HOOK_ID, then gives the signal to the handler in place before ctest. The hooks run in a signal handler: no lock, no
+   allocation and no formatting. ctest_crash_clear_hooks is for a forked child that only calls the hooks it sets afterwards. */
+#if defined SIGBUS
+#define CTEST_CRASH_SIGNALS SIGSEGV, SIGFPE, SIGILL, SIGBUS, SIGABRT
+#else
+#define CTEST_CRASH_SIGNALS SIGSEGV, SIGFPE, SIGILL, SIGABRT
+#endif
+
+#define CTEST_CRASH_SIGNAL_COUNT MU_COUNT_ARG(CTEST_CRASH_SIGNALS)
+
+#define CTEST_CRASH_HOOK_ID_VALUES \
+    CTEST_CRASH_HOOK_RECOVERY, /* longjmps out of the handler when it recovers the crash, the other hooks are then not called */ \
+    CTEST_CRASH_HOOK_JOURNAL, \
+    CTEST_CRASH_HOOK_ALLOCATION_FAILURE, \
+    CTEST_CRASH_HOOK_CAPTURE, /* puts stdout and stderr back, what the next hooks write is seen */ \
+    CTEST_CRASH_HOOK_QUIET, \
+    CTEST_CRASH_HOOK_REPORT
+
+MU_DEFINE_ENUM_WITHOUT_INVALID(CTEST_CRASH_HOOK_ID, CTEST_CRASH_HOOK_ID_VALUES)
+
+#define CTEST_CRASH_HOOK_ID_COUNT MU_COUNT_ARG(CTEST_CRASH_HOOK_ID_VALUES)
+
+typedef struct CTEST_CRASH_TAG
+{
+    int signal_number;
+    size_t signal_index; /* in CTEST_CRASH_SIGNALS */
+    bool is_fault; /* raised by the kernel for an instruction of the thread (not sent with kill or raise), false on Windows */
+    void* fault_address;
+} CTEST_CRASH;
+
+typedef void (*CTEST_CRASH_HOOK)(const CTEST_CRASH* crash);
+
+void ctest_crash_set_hook(CTEST_CRASH_HOOK_ID hook_id, CTEST_CRASH_HOOK hook);
+void ctest_crash_clear_hooks(void);
+void ctest_crash_begin_thread(void);
+void ctest_crash_end_thread(void);
+
+/* crash recovery (CTEST_CRASH_RECOVERY), see ctest_crash_recovery.c. Called right after the setjmp of the test body, on its thread,
+   ctest_crash_recovery_begin makes a crash of the thread that the policy recovers from longjmp to g_ExceptionJump, like a failed
+   assert. ctest_crash_recovery_end returns the signal recovered from (0 when none). */
+void ctest_crash_recovery_begin(const TEST_FUNCTION_DATA* test_function);
+int ctest_crash_recovery_end(void);
+/* the result message of a test that crashed with signal_number, NULL for 0 */
+const char* ctest_crash_recovery_get_message(int signal_number);
+
+/* result journal (CTEST_JOURNAL), see ctest_journal.c. ctest_journal_begin_suite opens the journal the first time, reading the one of
+   the previous run when resuming (CTEST_RESUME). ctest_journal_resume_test gives the test its result from the previous run and reports
+   it, returning false when it has to run. The process running a test appends its start and its end to the journal (and its crash, from
+   the crash hook), ctest_journal_time_out_test appends the timeout of a test before the watchdog aborts the run. ctest_journal_end_suite
+   makes what was appended durable. */
+void ctest_journal_begin_suite(void);
+bool ctest_journal_resume_test(const CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run);
+void ctest_journal_begin_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run);
+void ctest_journal_end_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run);
+void ctest_journal_time_out_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run);
+void ctest_journal_end_suite(void);
+
+/* list mode (CTEST_LIST), see ctest_list.c. Writes the tests of the suite matching the filter to stdout instead of running them,
+   returns 0 on success */
+size_t ctest_list_suite(const TEST_FUNCTION_DATA* test_list_head, const char* test_suite_name, const char* test_name_filter);
+
+#define CTEST_REPORT_STATUS_VALUES \
+    CTEST_REPORT_PASSED, \
+    CTEST_REPORT_FAILED, \
+    CTEST_REPORT_NOT_EXECUTED, \
+    CTEST_REPORT_INTERRUPTED
+
+MU_DEFINE_ENUM_WITHOUT_INVALID(CTEST_REPORT_STATUS, CTEST_REPORT_STATUS_VALUES)
+
+/* text waiting to be written to a report. A buffer that cannot grow (when the process is interrupted) truncates */
+typedef struct CTEST_REPORT_BUFFER_TAG
+{
+    char* data;
+    size_t length;
+    size_t capacity;
+    bool can_grow;
+} CTEST_REPORT_BUFFER;
+
+void ctest_report_buffer_append(CTEST_REPORT_BUFFER* buffer, const char* text);
+void ctest_report_buffer_append_format(CTEST_REPORT_BUFFER* buffer, const char* format, ...);
+void ctest_report_buffer_append_xml_escaped(CTEST_REPORT_BUFFER* buffer, const char* text);
+void ctest_report_buffer_append_json_escaped(CTEST_REPORT_BUFFER* buffer, const char* text);
+
+typedef struct CTEST_REPORT_TEST_TAG
+{
+    const char* suite_name;
+    const char* test_name;
+    CTEST_REPORT_STATUS status;
+    const char* message; /* NULL for passed tests */
+    const char* output; /* what a failed test wrote to stdout and stderr (CTEST_CAPTURE_OUTPUT), NULL when not captured */
+    CTEST_TIMING test_timing;
+    CTEST_TIMING fixture_timing;
+} CTEST_REPORT_TEST;
+
+typedef struct CTEST_REPORT_SUMMARY_TAG
+{
+    const char* suite_name;
+    size_t executed_test_count;
+    size_t failed_test_count;
+    size_t skipped_test_count;
+    const char* interrupt_reason; /* NULL when the suite completed */
+} CTEST_REPORT_SUMMARY;
+
+/* a report format. A document holds the suites run by the process, each holding its tests. suite_index counts the suites of the
+   document and test_index the tests of the suite (from 0, for separators), test_number the tests of the document (from 1).
+   end_suite and end_document also complete the document each time it is written, until the next suite or test overwrites them. */
+typedef struct CTEST_REPORTER_TAG
+{
+    const char* name;
+    void (*begin_document)(CTEST_REPORT_BUFFER* buffer);
+    void (*begin_suite)(CTEST_REPORT_BUFFER* buffer, const char* suite_name, size_t suite_index);
+    void (*add_test)(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_TEST* test, size_t test_index, size_t test_number);
+    void (*end_suite)(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_SUMMARY* summary);
+    void (*end_document)(CTEST_REPORT_BUFFER* buffer, size_t test_count);
+} CTEST_REPORTER;
+
+extern const CTEST_REPORTER ctest_report_junit;
+extern const CTEST_REPORTER ctest_report_tap;
+extern const CTEST_REPORTER ctest_report_json;
+
+/* compiles a test name filter ("a,b*,suite.c?,-d", see ctest_filter.c), NULL on failure */
+CTEST_FILTER_HANDLE ctest_filter_create(const char* filter);
+void ctest_filter_destroy(CTEST_FILTER_HANDLE filter);
+bool ctest_filter_matches(CTEST_FILTER_HANDLE filter, const char* test_suite_name, const char* test_function_name);
+
+#endif /* CTEST_INTERNAL_H */
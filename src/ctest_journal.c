@@ -0,0 +1,758 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#include <io.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Result journal (CTEST_JOURNAL): a binary file where a record is appended when a test starts and when it ends, by the process running
+   it. Each record is a CTEST_JOURNAL_RECORD followed by the suite name and the test name, written with a single write to the file
+   opened in append mode (the worker processes share it), so a crash of the process loses nothing that was written. Making the records
+   durable (which only matters when the machine goes down) is batched: the file is synced at most every CTEST_JOURNAL_SYNC_PERIOD_MS and
+   at the end of each suite.
+
+   A test that crashes the process gets a crash record, written by the crash hook of the journal on the thread of the test (with write,
+   from the signal handler), and a test that times out gets one from the watchdog before it aborts the run. The other tests that were
+   running at that time (on the other threads) only get their start record.
+
+   With CTEST_RESUME=1 the journal of the previous run is read before the first suite: a test that ended there is not run again, its
+   result, timing and message come from the journal. A test that crashed (or hung) the previous run fails without running again. A
+   test that started and neither ended nor crashed was interrupted by the crash of another one, it runs again. The records are appended
+   to the same journal, a run that crashes again is resumed from there. A journal ending with a partial record (the machine went down
+   while it was written) is cut before it.
+
+   The records are in the byte order and layout of the binary writing them, a journal is resumed by the same binary. */
+
+#define CTEST_JOURNAL_HEADER "CTESTJ1\n"
+#define CTEST_JOURNAL_HEADER_SIZE 8
+#define CTEST_JOURNAL_RECORD_MAGIC 0x4C4E524AU /* "JRNL" */
+#define CTEST_JOURNAL_MAX_NAME_LENGTH 4096
+#define CTEST_JOURNAL_SYNC_PERIOD_MS 1000
+
+#define CTEST_JOURNAL_RECORD_TYPE_VALUES \
+    CTEST_JOURNAL_RECORD_TEST_START, \
+    CTEST_JOURNAL_RECORD_TEST_END, \
+    CTEST_JOURNAL_RECORD_TEST_CRASH /* crash_signal is 0 for a timeout */
+
+MU_DEFINE_ENUM(CTEST_JOURNAL_RECORD_TYPE, CTEST_JOURNAL_RECORD_TYPE_VALUES)
+
+typedef struct CTEST_JOURNAL_RECORD_TAG
+{
+    uint32_t record_magic;
+    uint32_t checksum; /* FNV-1a of the record (with checksum 0) and of the names */
+    uint32_t record_type; /* CTEST_JOURNAL_RECORD_TYPE */
+    uint32_t test_result; /* TEST_RESULT, not in start records */
+    int32_t crash_signal;
+    uint32_t suite_name_length;
+    uint32_t test_name_length;
+    CTEST_TIMING test_timing;
+    CTEST_TIMING fixture_timing;
+} CTEST_JOURNAL_RECORD;
+
+/* a test of the previous run, sorted by suite name, test name and then in the order the tests started (a suite can be run more than
+   once by a process) */
+typedef struct CTEST_JOURNAL_ENTRY_TAG
+{
+    char* suite_name;
+    char* test_name;
+    size_t sequence;
+    bool is_ended;
+    bool is_crashed; /* crashed (or hung) the previous run, when not ended */
+    bool is_resumed; /* taken by a test of this run */
+    TEST_RESULT test_result;
+    int crash_signal;
+    CTEST_TIMING test_timing;
+    CTEST_TIMING fixture_timing;
+} CTEST_JOURNAL_ENTRY;
+
+static bool g_is_opened = false;
+static FILE* g_file = NULL;
+static int g_fd = -1; /* of g_file, for the crash hook */
+static uint64_t g_last_sync_wall_ns = 0;
+
+/* the test running on the thread, for the crash record */
+static CTEST_THREAD_LOCAL const char* volatile g_running_suite_name = NULL;
+static CTEST_THREAD_LOCAL const char* volatile g_running_test_name = NULL;
+static CTEST_JOURNAL_ENTRY* g_entries = NULL;
+static size_t g_entry_count = 0;
+static size_t g_entry_capacity = 0;
+
+#if defined _MSC_VER
+static SRWLOCK g_lock = SRWLOCK_INIT;
+
+static void ctest_journal_lock(void)
+{
+    AcquireSRWLockExclusive(&g_lock);
+}
+
+static void ctest_journal_unlock(void)
+{
+    ReleaseSRWLockExclusive(&g_lock);
+}
+
+static FILE* ctest_journal_open_file(const char* path, const char* mode)
+{
+    FILE* result;
+    if (fopen_s(&result, path, mode) != 0)
+    {
+        result = NULL;
+    }
+    return result;
+}
+
+static bool ctest_journal_sync_file(FILE* file)
+{
+    return _commit(_fileno(file)) == 0;
+}
+
+static bool ctest_journal_truncate_file(FILE* file, uint64_t size)
+{
+    return _chsize_s(_fileno(file), (__int64)size) == 0;
+}
+
+static int ctest_journal_get_fd(FILE* file)
+{
+    return _fileno(file);
+}
+
+static void ctest_journal_write_fd(int fd, const char* data, size_t size)
+{
+    (void)_write(fd, data, (unsigned int)size);
+}
+#else
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void ctest_journal_lock(void)
+{
+    (void)pthread_mutex_lock(&g_lock);
+}
+
+static void ctest_journal_unlock(void)
+{
+    (void)pthread_mutex_unlock(&g_lock);
+}
+
+static FILE* ctest_journal_open_file(const char* path, const char* mode)
+{
+    return fopen(path, mode);
+}
+
+static bool ctest_journal_sync_file(FILE* file)
+{
+#if defined __linux__
+    /* the size of the file is part of the data, the rest of the metadata does not need to be durable */
+    return fdatasync(fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+static bool ctest_journal_truncate_file(FILE* file, uint64_t size)
+{
+    return ftruncate(fileno(file), (off_t)size) == 0;
+}
+
+static int ctest_journal_get_fd(FILE* file)
+{
+    return fileno(file);
+}
+
+static void ctest_journal_write_fd(int fd, const char* data, size_t size)
+{
+    /* a single write to a file opened in append mode, it is not split */
+    (void)!write(fd, data, size);
+}
+#endif
+
+static uint32_t ctest_journal_hash(uint32_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static uint32_t ctest_journal_get_checksum(const CTEST_JOURNAL_RECORD* record, const char* suite_name, const char* test_name)
+{
+    CTEST_JOURNAL_RECORD copy = *record;
+    copy.checksum = 0;
+    uint32_t result = ctest_journal_hash(2166136261U, &copy, sizeof(copy));
+    result = ctest_journal_hash(result, suite_name, record->suite_name_length);
+    return ctest_journal_hash(result, test_name, record->test_name_length);
+}
+
+/* completes the record (zeroed, the padding is part of the checksum) with the names and writes it to buffer, followed by the names.
+   Returns its size. Called from the crash hook too: no lock, no allocation */
+static size_t ctest_journal_format_record(char* buffer, CTEST_JOURNAL_RECORD* record, const char* suite_name, size_t suite_name_length, const char* test_name, size_t test_name_length)
+{
+    record->record_magic = CTEST_JOURNAL_RECORD_MAGIC;
+    record->suite_name_length = (uint32_t)suite_name_length;
+    record->test_name_length = (uint32_t)test_name_length;
+    record->checksum = ctest_journal_get_checksum(record, suite_name, test_name);
+
+    (void)memcpy(buffer, record, sizeof(*record));
+    (void)memcpy(buffer + sizeof(*record), suite_name, suite_name_length);
+    (void)memcpy(buffer + sizeof(*record) + suite_name_length, test_name, test_name_length);
+    return sizeof(*record) + suite_name_length + test_name_length;
+}
+
+/* the crash hook: appends the crash record of the test running on the crashing thread. The other tests running at that time do not
+   get one, a resumed run runs them again */
+static void ctest_journal_on_crash(const CTEST_CRASH* crash)
+{
+    const char* suite_name = g_running_suite_name;
+    const char* test_name = g_running_test_name;
+    if ((g_fd != -1) && (suite_name != NULL) && (test_name != NULL))
+    {
+        size_t suite_name_length = strlen(suite_name);
+        size_t test_name_length = strlen(test_name);
+        /* a test with a name too long for the journal has no start record either */
+        if ((suite_name_length <= CTEST_JOURNAL_MAX_NAME_LENGTH) && (test_name_length <= CTEST_JOURNAL_MAX_NAME_LENGTH))
+        {
+            CTEST_JOURNAL_RECORD record;
+            char buffer[sizeof(CTEST_JOURNAL_RECORD) + 2 * CTEST_JOURNAL_MAX_NAME_LENGTH];
+            (void)memset(&record, 0, sizeof(record));
+            record.record_type = (uint32_t)CTEST_JOURNAL_RECORD_TEST_CRASH;
+            record.test_result = (uint32_t)TEST_FAILED;
+            record.crash_signal = crash->signal_number;
+            size_t size = ctest_journal_format_record(buffer, &record, suite_name, suite_name_length, test_name, test_name_length);
+            ctest_journal_write_fd(g_fd, buffer, size);
+        }
+    }
+}
+
+/* at exit, so that the leak checks do not report the journal kept between suites */
+static void ctest_journal_close_at_exit(void)
+{
+    if (g_file != NULL)
+    {
+        g_fd = -1;
+        (void)ctest_journal_sync_file(g_file);
+        (void)fclose(g_file);
+        g_file = NULL;
+    }
+    for (size_t i = 0; i < g_entry_count; i++)
+    {
+        free(g_entries[i].suite_name);
+        free(g_entries[i].test_name);
+    }
+    free(g_entries);
+    g_entries = NULL;
+    g_entry_count = 0;
+    g_entry_capacity = 0;
+}
+
+static int ctest_journal_compare_entries(const void* left, const void* right)
+{
+    const CTEST_JOURNAL_ENTRY* left_entry = left;
+    const CTEST_JOURNAL_ENTRY* right_entry = right;
+    int result = strcmp(left_entry->suite_name, right_entry->suite_name);
+    if (result == 0)
+    {
+        result = strcmp(left_entry->test_name, right_entry->test_name);
+    }
+    if (result == 0)
+    {
+        result = (left_entry->sequence < right_entry->sequence) ? -1 : (left_entry->sequence > right_entry->sequence) ? 1 : 0;
+    }
+    return result;
+}
+
+/* takes the names (malloc'd) of a start record, or of an end record without one */
+static bool ctest_journal_add_entry(char* suite_name, char* test_name)
+{
+    bool result;
+    if (g_entry_count == g_entry_capacity)
+    {
+        size_t new_capacity = (g_entry_capacity == 0) ? 64 : g_entry_capacity * 2;
+        CTEST_JOURNAL_ENTRY* new_entries = realloc(g_entries, new_capacity * sizeof(CTEST_JOURNAL_ENTRY));
+        if (new_entries == NULL)
+        {
+            LogError("failure in realloc(%zu)", new_capacity * sizeof(CTEST_JOURNAL_ENTRY));
+            result = false;
+        }
+        else
+        {
+            g_entries = new_entries;
+            g_entry_capacity = new_capacity;
+            result = true;
+        }
+    }
+    else
+    {
+        result = true;
+    }
+
+    if (result)
+    {
+        CTEST_JOURNAL_ENTRY* entry = &g_entries[g_entry_count];
+        entry->suite_name = suite_name;
+        entry->test_name = test_name;
+        entry->sequence = g_entry_count;
+        entry->is_ended = false;
+        entry->is_crashed = false;
+        entry->is_resumed = false;
+        entry->test_result = TEST_NOT_EXECUTED;
+        entry->crash_signal = 0;
+        entry->test_timing.wall_ns = 0;
+        entry->test_timing.cpu_ns = 0;
+        entry->fixture_timing.wall_ns = 0;
+        entry->fixture_timing.cpu_ns = 0;
+        g_entry_count++;
+    }
+    else
+    {
+        free(suite_name);
+        free(test_name);
+    }
+    return result;
+}
+
+static void ctest_journal_add_record(const CTEST_JOURNAL_RECORD* record, char* suite_name, char* test_name)
+{
+    if (record->record_type == CTEST_JOURNAL_RECORD_TEST_START)
+    {
+        (void)ctest_journal_add_entry(suite_name, test_name);
+    }
+    else
+    {
+        /* the start of the test is one of the last ones, the tests running at the same time (on threads, in worker processes) are few.
+           The end record of a test that crashed is the one appended by the resumed run */
+        bool is_crash = (record->record_type == CTEST_JOURNAL_RECORD_TEST_CRASH);
+        CTEST_JOURNAL_ENTRY* entry = NULL;
+        for (size_t i = g_entry_count; i > 0; i--)
+        {
+            if (!g_entries[i - 1].is_ended && !(is_crash && g_entries[i - 1].is_crashed) && (strcmp(g_entries[i - 1].test_name, test_name) == 0) && (strcmp(g_entries[i - 1].suite_name, suite_name) == 0))
+            {
+                entry = &g_entries[i - 1];
+                break;
+            }
+        }
+        if (entry != NULL)
+        {
+            free(suite_name);
+            free(test_name);
+        }
+        else if (ctest_journal_add_entry(suite_name, test_name))
+        {
+            entry = &g_entries[g_entry_count - 1];
+        }
+        else
+        {
+            /* already logged */
+        }
+
+        if (entry != NULL)
+        {
+            entry->is_ended = !is_crash;
+            entry->is_crashed = is_crash;
+            entry->test_result = (TEST_RESULT)record->test_result;
+            entry->crash_signal = record->crash_signal;
+            entry->test_timing = record->test_timing;
+            entry->fixture_timing = record->fixture_timing;
+        }
+    }
+}
+
+static char* ctest_journal_read_name(FILE* file, uint32_t length)
+{
+    char* result = malloc((size_t)length + 1);
+    if (result == NULL)
+    {
+        LogError("failure in malloc(%" PRIu32 ")", length + 1);
+    }
+    else if (fread(result, 1, length, file) != length)
+    {
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result[length] = '\0';
+    }
+    return result;
+}
+
+/* reads the records of the journal at path, returns the size of its complete records (header included), 0 when it is not a journal */
+static uint64_t ctest_journal_read(FILE* file, const char* path)
+{
+    uint64_t result;
+    char header[CTEST_JOURNAL_HEADER_SIZE];
+
+    if ((fread(header, 1, CTEST_JOURNAL_HEADER_SIZE, file) != CTEST_JOURNAL_HEADER_SIZE) || (memcmp(header, CTEST_JOURNAL_HEADER, CTEST_JOURNAL_HEADER_SIZE) != 0))
+    {
+        LogWarning("%s is not a ctest journal, all the tests are run", path);
+        result = 0;
+    }
+    else
+    {
+        CTEST_JOURNAL_RECORD record;
+        result = CTEST_JOURNAL_HEADER_SIZE;
+        while (fread(&record, sizeof(record), 1, file) == 1)
+        {
+            char* suite_name;
+            char* test_name;
+            if ((record.record_magic != CTEST_JOURNAL_RECORD_MAGIC) ||
+                ((record.record_type != CTEST_JOURNAL_RECORD_TEST_START) && (record.record_type != CTEST_JOURNAL_RECORD_TEST_END) &&
+                    (record.record_type != CTEST_JOURNAL_RECORD_TEST_CRASH)) ||
+                (record.suite_name_length > CTEST_JOURNAL_MAX_NAME_LENGTH) ||
+                (record.test_name_length > CTEST_JOURNAL_MAX_NAME_LENGTH))
+            {
+                break;
+            }
+            else if ((suite_name = ctest_journal_read_name(file, record.suite_name_length)) == NULL)
+            {
+                break;
+            }
+            else if ((test_name = ctest_journal_read_name(file, record.test_name_length)) == NULL)
+            {
+                free(suite_name);
+                break;
+            }
+            else if (ctest_journal_get_checksum(&record, suite_name, test_name) != record.checksum)
+            {
+                free(suite_name);
+                free(test_name);
+                break;
+            }
+            else
+            {
+                result += sizeof(record) + record.suite_name_length + record.test_name_length;
+                ctest_journal_add_record(&record, suite_name, test_name);
+            }
+        }
+
+        if (g_entry_count > 0)
+        {
+            qsort(g_entries, g_entry_count, sizeof(CTEST_JOURNAL_ENTRY), ctest_journal_compare_entries);
+        }
+    }
+    return result;
+}
+
+/* creates an empty journal at path, the records are then appended */
+static bool ctest_journal_create(const char* path)
+{
+    bool result;
+    FILE* file = ctest_journal_open_file(path, "wb");
+    if (file == NULL)
+    {
+        result = false;
+    }
+    else
+    {
+        result = (fwrite(CTEST_JOURNAL_HEADER, 1, CTEST_JOURNAL_HEADER_SIZE, file) == CTEST_JOURNAL_HEADER_SIZE);
+        if (fclose(file) != 0)
+        {
+            result = false;
+        }
+    }
+    return result;
+}
+
+/* true when the entry at index (sorted) is followed by another entry of the same test: a later run ran the test again */
+static bool ctest_journal_is_run_again_later(size_t index)
+{
+    return (index + 1 < g_entry_count) && (strcmp(g_entries[index].suite_name, g_entries[index + 1].suite_name) == 0) &&
+        (strcmp(g_entries[index].test_name, g_entries[index + 1].test_name) == 0);
+}
+
+static void ctest_journal_open(void)
+{
+    const CTEST_CONFIG* config = ctest_config_get();
+    const char* path = config->journal_path;
+    uint64_t resumed_size = 0;
+
+    if (path[0] == '\0')
+    {
+        if (config->resume != 0)
+        {
+            LogWarning("CTEST_RESUME needs a journal (CTEST_JOURNAL), all the tests are run");
+        }
+    }
+    else
+    {
+        if (config->resume != 0)
+        {
+            FILE* file = ctest_journal_open_file(path, "rb");
+            if (file == NULL)
+            {
+                LogInfo(" ### No journal %s to resume from, all the tests are run", path);
+            }
+            else
+            {
+                resumed_size = ctest_journal_read(file, path);
+                (void)fclose(file);
+            }
+        }
+
+        if ((resumed_size == 0) && !ctest_journal_create(path))
+        {
+            LogError("failure creating the journal %s, the results are not journaled", path);
+        }
+        /* every write goes to the end of the file, wherever the other processes wrote */
+        else if ((g_file = ctest_journal_open_file(path, "ab")) == NULL)
+        {
+            LogError("failure opening the journal %s, the results are not journaled", path);
+        }
+        else
+        {
+            /* unbuffered, each fwrite is a single write */
+            (void)setvbuf(g_file, NULL, _IONBF, 0);
+            g_fd = ctest_journal_get_fd(g_file);
+            ctest_crash_set_hook(CTEST_CRASH_HOOK_JOURNAL, ctest_journal_on_crash);
+            if (resumed_size != 0)
+            {
+                size_t ended_count = 0;
+                size_t crashed_count = 0;
+                size_t interrupted_count = 0;
+                for (size_t i = 0; i < g_entry_count; i++)
+                {
+                    if (g_entries[i].is_ended)
+                    {
+                        ended_count++;
+                    }
+                    else if (g_entries[i].is_crashed)
+                    {
+                        crashed_count++;
+                    }
+                    else if (!ctest_journal_is_run_again_later(i))
+                    {
+                        interrupted_count++;
+                    }
+                    else
+                    {
+                        /* interrupted and already run again by a resumed run, its later entry is counted */
+                    }
+                }
+                LogInfo(" ### Resuming from the journal %s: %zu tests ended, %zu crashed or timed out, %zu were interrupted and run again", path,
+                    ended_count, crashed_count, interrupted_count);
+                /* a partial record at the end, the records appended after it would not be read */
+                if ((fseek(g_file, 0, SEEK_END) == 0) && ((uint64_t)ftell(g_file) > resumed_size) && !ctest_journal_truncate_file(g_file, resumed_size))
+                {
+                    LogError("failure cutting the partial record at the end of the journal %s, the next resume only sees the tests ended so far", path);
+                }
+            }
+            g_last_sync_wall_ns = ctest_timing_get_wall_ns();
+        }
+        (void)atexit(ctest_journal_close_at_exit);
+    }
+}
+
+static void ctest_journal_append(CTEST_JOURNAL_RECORD_TYPE record_type, const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run)
+{
+    if (g_file != NULL)
+    {
+        const char* suite_name = suite_run->test_suite_name;
+        const char* test_name = test_run->test_function->TestFunctionName;
+        size_t suite_name_length = strlen(suite_name);
+        size_t test_name_length = strlen(test_name);
+        CTEST_JOURNAL_RECORD record;
+        char buffer[sizeof(CTEST_JOURNAL_RECORD) + 2 * CTEST_JOURNAL_MAX_NAME_LENGTH];
+
+        if ((suite_name_length > CTEST_JOURNAL_MAX_NAME_LENGTH) || (test_name_length > CTEST_JOURNAL_MAX_NAME_LENGTH))
+        {
+            LogError("the name of %s.%s is too long for the journal", suite_name, test_name);
+        }
+        else
+        {
+            (void)memset(&record, 0, sizeof(record));
+            record.record_type = (uint32_t)record_type;
+            if (record_type != CTEST_JOURNAL_RECORD_TEST_START)
+            {
+                record.test_result = (uint32_t)*test_run->test_function->TestResult;
+                record.crash_signal = test_run->crash_signal;
+                record.test_timing = test_run->test_timing;
+                record.fixture_timing = test_run->fixture_timing;
+            }
+            size_t size = ctest_journal_format_record(buffer, &record, suite_name, suite_name_length, test_name, test_name_length);
+
+            bool is_sync_due = false;
+            ctest_journal_lock();
+            if (fwrite(buffer, 1, size, g_file) != size)
+            {
+                LogError("failure writing %zu bytes to the journal %s", size, ctest_config_get()->journal_path);
+            }
+            else
+            {
+                uint64_t now = ctest_timing_get_wall_ns();
+                if (now - g_last_sync_wall_ns >= (uint64_t)CTEST_JOURNAL_SYNC_PERIOD_MS * 1000000)
+                {
+                    g_last_sync_wall_ns = now;
+                    is_sync_due = true;
+                }
+            }
+            ctest_journal_unlock();
+
+            /* outside of the lock, the other threads keep appending while the file is synced */
+            if (is_sync_due)
+            {
+                (void)ctest_journal_sync_file(g_file);
+            }
+        }
+    }
+}
+
+/* the first entry of the previous run for the test that was not resumed yet and ended or crashed, NULL when none */
+static CTEST_JOURNAL_ENTRY* ctest_journal_find_entry(const char* suite_name, const char* test_name)
+{
+    CTEST_JOURNAL_ENTRY* result = NULL;
+    size_t low = 0;
+    size_t high = g_entry_count;
+
+    /* the first entry that is not before the test */
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        int compare = strcmp(g_entries[middle].suite_name, suite_name);
+        if (compare == 0)
+        {
+            compare = strcmp(g_entries[middle].test_name, test_name);
+        }
+        if (compare < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    for (size_t i = low; (i < g_entry_count) && (strcmp(g_entries[i].suite_name, suite_name) == 0) && (strcmp(g_entries[i].test_name, test_name) == 0); i++)
+    {
+        /* a test not executed because of a failed TEST_FUNCTION_CLEANUP did not run and a test interrupted by the crash of another one
+           did not finish, they run now (the next resume sees the records of that run) */
+        if (!g_entries[i].is_resumed && (g_entries[i].is_ended || g_entries[i].is_crashed) && !(g_entries[i].is_ended && (g_entries[i].test_result == TEST_NOT_EXECUTED)))
+        {
+            result = &g_entries[i];
+            break;
+        }
+    }
+    return result;
+}
+
+void ctest_journal_begin_suite(void)
+{
+    if (!g_is_opened)
+    {
+        g_is_opened = true;
+        ctest_journal_open();
+    }
+}
+
+bool ctest_journal_resume_test(const CTEST_SUITE_RUN* suite_run, CTEST_TEST_RUN* test_run)
+{
+    bool result;
+    const TEST_FUNCTION_DATA* test_function = test_run->test_function;
+    CTEST_JOURNAL_ENTRY* entry = ctest_journal_find_entry(suite_run->test_suite_name, test_function->TestFunctionName);
+    if (entry == NULL)
+    {
+        result = false;
+    }
+    else
+    {
+        const char* message;
+        char crash_message[64];
+        entry->is_resumed = true;
+        test_run->state = CTEST_TEST_RUN_DONE;
+        if (!entry->is_ended)
+        {
+            *test_function->TestResult = TEST_FAILED;
+            test_run->crash_signal = entry->crash_signal;
+            if (entry->crash_signal == 0)
+            {
+                message = "timed out in the previous run";
+            }
+            else
+            {
+                (void)snprintf(crash_message, sizeof(crash_message), "%s in the previous run", ctest_crash_recovery_get_message(entry->crash_signal));
+                message = crash_message;
+            }
+            LogInfo(CTEST_ANSI_COLOR_RED "Test %s result = !!! FAILED !!! (%s, not run again)" CTEST_ANSI_COLOR_RESET "", test_function->TestFunctionName, message);
+            /* a run resumed again sees it as ended */
+            ctest_journal_append(CTEST_JOURNAL_RECORD_TEST_END, suite_run, test_run);
+        }
+        else
+        {
+            *test_function->TestResult = entry->test_result;
+            test_run->test_timing = entry->test_timing;
+            test_run->fixture_timing = entry->fixture_timing;
+            test_run->crash_signal = entry->crash_signal;
+            if (entry->test_result == TEST_FAILED)
+            {
+                message = ctest_crash_recovery_get_message(entry->crash_signal);
+                if (message == NULL)
+                {
+                    message = "failed in a previous run";
+                }
+                LogInfo(CTEST_ANSI_COLOR_RED "Test %s result = !!! FAILED !!! (%s, from the journal)" CTEST_ANSI_COLOR_RESET "", test_function->TestFunctionName, message);
+            }
+            else
+            {
+                message = NULL;
+                LogInfo(CTEST_ANSI_COLOR_GREEN "Test %s result = Succeeded. (%.3f ms wall, %.3f ms cpu, from the journal)" CTEST_ANSI_COLOR_RESET "", test_function->TestFunctionName,
+                    CTEST_TIMING_NS_TO_MS(test_run->test_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test_run->test_timing.cpu_ns));
+            }
+        }
+        ctest_report_test(suite_run, test_run, message);
+        ctest_events_begin_test(suite_run, test_run);
+        ctest_events_end_test(suite_run, test_run, message);
+        result = true;
+    }
+    return result;
+}
+
+void ctest_journal_begin_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run)
+{
+    ctest_journal_append(CTEST_JOURNAL_RECORD_TEST_START, suite_run, test_run);
+    g_running_suite_name = suite_run->test_suite_name;
+    g_running_test_name = test_run->test_function->TestFunctionName;
+}
+
+void ctest_journal_end_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run)
+{
+    g_running_test_name = NULL;
+    g_running_suite_name = NULL;
+    ctest_journal_append(CTEST_JOURNAL_RECORD_TEST_END, suite_run, test_run);
+}
+
+void ctest_journal_time_out_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run)
+{
+    ctest_journal_append(CTEST_JOURNAL_RECORD_TEST_CRASH, suite_run, test_run);
+}
+
+void ctest_journal_end_suite(void)
+{
+    if (g_file != NULL)
+    {
+        ctest_journal_lock();
+        g_last_sync_wall_ns = ctest_timing_get_wall_ns();
+        ctest_journal_unlock();
+        if (!ctest_journal_sync_file(g_file))
+        {
+            LogError("failure syncing the journal %s", ctest_config_get()->journal_path);
+        }
+    }
+}
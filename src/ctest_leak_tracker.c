@@ -0,0 +1,835 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <link.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* Allocation tracker for the at-exit leak check on Linux (built with use_leak_tracker, the equivalent of VLD on Windows).
+
+   malloc, calloc, realloc, reallocarray, free, malloc_usable_size, strdup and strndup are replaced for the whole process (including the shared objects
+   loaded with dlopen) and forward to the glibc allocator (__libc_malloc...). Every block gets a header in front of it pointing to the
+   slot that tracks it. Slots live in per-thread tables:
+   - only the thread owning a table takes slots from it, so taking a slot needs no lock
+   - any thread frees a block (and its slot) with one atomic store, so blocks freed by another thread need no lock either
+   - tables are never freed, the table of a thread that exited is taken over by the next new thread
+   A block allocated after ctest_leak_tracker_start and still allocated when the check runs at exit is a leak, unless it was allocated
+   by the C library or the dynamic loader themselves (stdio buffers, modules loaded with dlopen and never closed...), which are not
+   freed before the process exits. Like VLD ignores the allocations of the CRT.
+
+   Stacks are kept in a shared table of sites, hashed by the code calling the allocation function or by the whole stack.
+
+   Per test (ctest_leak_tracker_begin_test/ctest_leak_tracker_end_test), the blocks allocated by the thread running the test are tagged
+   with the test and with their allocation site. The first time the code calling malloc or operator new is seen in a test its stack is
+   captured with backtrace, later allocations from the same code only look the site up, so the unwinding cost is paid once per site
+   rather than once per allocation. A block of the test still allocated after TEST_FUNCTION_CLEANUP is reported with the stack of its
+   site.
+
+   The allocations made by a thread inside an allocation assertion scope (CTEST_ASSERT_NO_ALLOCATIONS_BEGIN...) are counted in the
+   scope. The first allocation of each site of the scope captures its stack (the scopes are expected to allocate little).
+
+   For the allocation failure sweep (ctest_allocation_failure.c), the allocations of a thread can be numbered and one of them made to
+   fail, returning NULL with errno ENOMEM (operator new then throws std::bad_alloc).
+
+   The aligned allocation functions (posix_memalign, aligned_alloc, memalign...) are not replaced, their blocks are not tracked and are
+   recognized by free because they have no valid header. */
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* pointer, size_t size);
+extern void __libc_free(void* pointer);
+
+#define CTEST_LEAK_TRACKER_CHUNK_SLOT_COUNT 4096
+/* a thread scans at most this many slots for a free one before adding a chunk to its table */
+#define CTEST_LEAK_TRACKER_MAX_SCAN_COUNT 4096
+/* the leaked blocks listed at exit, and for each test */
+#define CTEST_LEAK_TRACKER_MAX_REPORTED_LEAK_COUNT 32
+/* allocation sites with a captured stack (a power of 2), an allocation site probes at most CTEST_LEAK_TRACKER_MAX_SITE_PROBE_COUNT
+   entries, the allocations of the sites that find no entry are reported without stack */
+#define CTEST_LEAK_TRACKER_SITE_COUNT 16384
+#define CTEST_LEAK_TRACKER_MAX_SITE_PROBE_COUNT 32
+#define CTEST_LEAK_TRACKER_MAX_STACK_DEPTH 16
+#define CTEST_LEAK_TRACKER_HEADER_CHECK ((uintptr_t)0x6374657374686472ULL)
+
+typedef struct CTEST_LEAK_TRACKER_SITE_TAG
+{
+    /* hash of the caller or of the stack, 0 when the entry is free */
+    _Atomic uint64_t key;
+    atomic_bool is_captured; /* set once stack and stack_depth are written */
+    int stack_depth;
+    void* stack[CTEST_LEAK_TRACKER_MAX_STACK_DEPTH];
+} CTEST_LEAK_TRACKER_SITE;
+
+typedef struct CTEST_LEAK_TRACKER_SLOT_TAG
+{
+    void* _Atomic header; /* NULL when the slot is free */
+    size_t size;
+    const void* caller;
+    bool is_after_start;
+    /* the test that allocated the block, 0 outside tests */
+    uint32_t test_scope;
+    const CTEST_LEAK_TRACKER_SITE* site;
+} CTEST_LEAK_TRACKER_SLOT;
+
+typedef struct CTEST_LEAK_TRACKER_CHUNK_TAG
+{
+    struct CTEST_LEAK_TRACKER_CHUNK_TAG* _Atomic next;
+    CTEST_LEAK_TRACKER_SLOT slots[CTEST_LEAK_TRACKER_CHUNK_SLOT_COUNT];
+} CTEST_LEAK_TRACKER_CHUNK;
+
+typedef struct CTEST_LEAK_TRACKER_TABLE_TAG
+{
+    struct CTEST_LEAK_TRACKER_TABLE_TAG* next; /* in g_tables, set before the table is published */
+    atomic_int is_orphaned; /* 1 after its thread exited, until another thread takes it over */
+    CTEST_LEAK_TRACKER_CHUNK* first_chunk;
+    /* used by the owning thread only */
+    CTEST_LEAK_TRACKER_CHUNK* last_chunk;
+    CTEST_LEAK_TRACKER_CHUNK* scan_chunk;
+    size_t scan_index;
+} CTEST_LEAK_TRACKER_TABLE;
+
+/* in front of every tracked block, 16 bytes so that the block keeps the alignment of malloc */
+typedef struct CTEST_LEAK_TRACKER_HEADER_TAG
+{
+    CTEST_LEAK_TRACKER_SLOT* slot; /* NULL when the block could not get a slot */
+    uintptr_t check; /* slot ^ CTEST_LEAK_TRACKER_HEADER_CHECK, tells the blocks of the tracker from the other ones */
+} CTEST_LEAK_TRACKER_HEADER;
+
+static CTEST_LEAK_TRACKER_TABLE* _Atomic g_tables;
+static atomic_bool g_is_started;
+static pthread_once_t g_thread_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_thread_key;
+static bool g_is_thread_key_valid;
+static __thread CTEST_LEAK_TRACKER_TABLE* t_table;
+
+static CTEST_LEAK_TRACKER_SITE* _Atomic g_sites;
+static atomic_uint g_last_test_scope;
+static __thread uint32_t t_test_scope;
+/* set while the thread captures a stack, backtrace can allocate */
+static __thread bool t_is_capturing_stack;
+/* the innermost allocation assertion scope of the thread, NULL when none */
+static __thread CTEST_ALLOCATION_SCOPE* t_allocation_scope;
+/* allocation failure injection: while counting, the allocations of the thread are numbered from 1 and the failing_allocation-th one
+   fails (none when 0) */
+static __thread bool t_is_counting_allocations;
+static __thread uint64_t t_allocation_count;
+static __thread uint64_t t_failing_allocation;
+static __thread bool t_is_allocation_failure_injected;
+static __thread int t_injected_failure_stack_depth;
+static __thread void* t_injected_failure_stack[CTEST_LEAK_TRACKER_MAX_STACK_DEPTH];
+
+static void* ctest_leak_tracker_map(size_t size)
+{
+    void* result = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (result == MAP_FAILED) ? NULL : result;
+}
+
+static void ctest_leak_tracker_on_thread_exit(void* table)
+{
+    atomic_store_explicit(&((CTEST_LEAK_TRACKER_TABLE*)table)->is_orphaned, 1, memory_order_release);
+}
+
+static void ctest_leak_tracker_create_thread_key(void)
+{
+    g_is_thread_key_valid = (pthread_key_create(&g_thread_key, ctest_leak_tracker_on_thread_exit) == 0);
+}
+
+static CTEST_LEAK_TRACKER_CHUNK* ctest_leak_tracker_add_chunk(CTEST_LEAK_TRACKER_TABLE* table)
+{
+    /* zeroed by mmap: all slots free */
+    CTEST_LEAK_TRACKER_CHUNK* result = ctest_leak_tracker_map(sizeof(CTEST_LEAK_TRACKER_CHUNK));
+    if (result != NULL)
+    {
+        if (table->last_chunk == NULL)
+        {
+            table->first_chunk = result;
+        }
+        else
+        {
+            atomic_store_explicit(&table->last_chunk->next, result, memory_order_release);
+        }
+        table->last_chunk = result;
+        table->scan_chunk = result;
+        table->scan_index = 0;
+    }
+    return result;
+}
+
+static CTEST_LEAK_TRACKER_TABLE* ctest_leak_tracker_get_table(void)
+{
+    CTEST_LEAK_TRACKER_TABLE* result = t_table;
+    if (result == NULL)
+    {
+        /* take over the table of a thread that exited, or add one */
+        for (CTEST_LEAK_TRACKER_TABLE* table = atomic_load_explicit(&g_tables, memory_order_acquire); table != NULL; table = table->next)
+        {
+            int expected = 1;
+            if (atomic_compare_exchange_strong(&table->is_orphaned, &expected, 0))
+            {
+                result = table;
+                break;
+            }
+        }
+
+        if (result == NULL)
+        {
+            result = ctest_leak_tracker_map(sizeof(CTEST_LEAK_TRACKER_TABLE));
+            if ((result != NULL) && (ctest_leak_tracker_add_chunk(result) == NULL))
+            {
+                (void)munmap(result, sizeof(CTEST_LEAK_TRACKER_TABLE));
+                result = NULL;
+            }
+            if (result != NULL)
+            {
+                result->next = atomic_load_explicit(&g_tables, memory_order_relaxed);
+                while (!atomic_compare_exchange_weak_explicit(&g_tables, &result->next, result, memory_order_release, memory_order_relaxed))
+                {
+                }
+            }
+        }
+
+        if (result != NULL)
+        {
+            t_table = result;
+            /* pthread_key_create and pthread_setspecific do not allocate for the first keys */
+            (void)pthread_once(&g_thread_key_once, ctest_leak_tracker_create_thread_key);
+            if (g_is_thread_key_valid)
+            {
+                (void)pthread_setspecific(g_thread_key, result);
+            }
+        }
+    }
+    return result;
+}
+
+/* a free slot of the table of the calling thread, NULL when there is no memory for one */
+static CTEST_LEAK_TRACKER_SLOT* ctest_leak_tracker_take_slot(void)
+{
+    CTEST_LEAK_TRACKER_SLOT* result = NULL;
+    CTEST_LEAK_TRACKER_TABLE* table = ctest_leak_tracker_get_table();
+    if (table != NULL)
+    {
+        for (size_t scanned = 0; scanned < CTEST_LEAK_TRACKER_MAX_SCAN_COUNT; scanned++)
+        {
+            CTEST_LEAK_TRACKER_SLOT* slot = &table->scan_chunk->slots[table->scan_index];
+            if (++table->scan_index == CTEST_LEAK_TRACKER_CHUNK_SLOT_COUNT)
+            {
+                CTEST_LEAK_TRACKER_CHUNK* next = atomic_load_explicit(&table->scan_chunk->next, memory_order_relaxed);
+                table->scan_chunk = (next == NULL) ? table->first_chunk : next;
+                table->scan_index = 0;
+            }
+            if (atomic_load_explicit(&slot->header, memory_order_acquire) == NULL)
+            {
+                result = slot;
+                break;
+            }
+        }
+
+        if ((result == NULL) && (ctest_leak_tracker_add_chunk(table) != NULL))
+        {
+            result = &table->scan_chunk->slots[table->scan_index++];
+        }
+    }
+    return result;
+}
+
+static CTEST_LEAK_TRACKER_SITE* ctest_leak_tracker_get_sites(void)
+{
+    CTEST_LEAK_TRACKER_SITE* result = atomic_load_explicit(&g_sites, memory_order_acquire);
+    if (result == NULL)
+    {
+        CTEST_LEAK_TRACKER_SITE* sites = ctest_leak_tracker_map(CTEST_LEAK_TRACKER_SITE_COUNT * sizeof(CTEST_LEAK_TRACKER_SITE));
+        if (sites != NULL)
+        {
+            if (atomic_compare_exchange_strong(&g_sites, &result, sites))
+            {
+                result = sites;
+            }
+            else
+            {
+                /* another thread mapped them first */
+                (void)munmap(sites, CTEST_LEAK_TRACKER_SITE_COUNT * sizeof(CTEST_LEAK_TRACKER_SITE));
+            }
+        }
+    }
+    return result;
+}
+
+/* the stack of the code calling the allocation function (caller), returns its depth */
+static int ctest_leak_tracker_capture_stack(void** stack, const void* caller)
+{
+    void* frames[CTEST_LEAK_TRACKER_MAX_STACK_DEPTH + 4];
+    int depth;
+    int first = 0;
+
+    t_is_capturing_stack = true;
+    depth = backtrace(frames, (int)(sizeof(frames) / sizeof(frames[0])));
+    t_is_capturing_stack = false;
+
+    /* the frames of the tracker are not part of the stack */
+    for (int i = 0; i < depth; i++)
+    {
+        if (frames[i] == caller)
+        {
+            first = i;
+            break;
+        }
+    }
+    depth = ((depth - first) > CTEST_LEAK_TRACKER_MAX_STACK_DEPTH) ? CTEST_LEAK_TRACKER_MAX_STACK_DEPTH : (depth - first);
+    (void)memcpy(stack, &frames[first], (size_t)depth * sizeof(void*));
+    return depth;
+}
+
+static uint64_t ctest_leak_tracker_hash(uint64_t hash, const void* value)
+{
+    /* FNV-1a on the whole pointer, then mixed so that the low bits (the index in the table) depend on all the bits */
+    hash = (hash ^ (uint64_t)(uintptr_t)value) * 0x100000001B3ULL;
+    return (hash ^ (hash >> 29)) * 0x9E3779B97F4A7C15ULL;
+}
+
+/* the site with key, added when new with stack (or with the stack captured now when stack is NULL). The first thread adding a key
+   writes its stack, the others can see the site before its stack is written: it is read when a block is reported. NULL when the
+   table is full */
+static const CTEST_LEAK_TRACKER_SITE* ctest_leak_tracker_find_site(uint64_t key, const void* caller, void* const* stack, int stack_depth)
+{
+    const CTEST_LEAK_TRACKER_SITE* result = NULL;
+    CTEST_LEAK_TRACKER_SITE* sites = ctest_leak_tracker_get_sites();
+    if (sites != NULL)
+    {
+        size_t index = (size_t)(key >> 32);
+        for (size_t probe = 0; probe < CTEST_LEAK_TRACKER_MAX_SITE_PROBE_COUNT; probe++)
+        {
+            CTEST_LEAK_TRACKER_SITE* site = &sites[(index + probe) & (CTEST_LEAK_TRACKER_SITE_COUNT - 1)];
+            uint64_t site_key = atomic_load_explicit(&site->key, memory_order_acquire);
+            if (site_key == 0)
+            {
+                if (atomic_compare_exchange_strong(&site->key, &site_key, key))
+                {
+                    if (stack == NULL)
+                    {
+                        site->stack_depth = ctest_leak_tracker_capture_stack(site->stack, caller);
+                    }
+                    else
+                    {
+                        site->stack_depth = stack_depth;
+                        (void)memcpy(site->stack, stack, (size_t)stack_depth * sizeof(void*));
+                    }
+                    atomic_store_explicit(&site->is_captured, true, memory_order_release);
+                    result = site;
+                    break;
+                }
+            }
+            if (site_key == key)
+            {
+                result = site;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/* the site of caller with the first stack seen for it, only the first allocation from caller captures a stack */
+static const CTEST_LEAK_TRACKER_SITE* ctest_leak_tracker_get_caller_site(const void* caller)
+{
+    return ctest_leak_tracker_find_site(ctest_leak_tracker_hash(0, caller) | 1, caller, NULL, 0);
+}
+
+/* the site of the current stack, captured for each call */
+static const CTEST_LEAK_TRACKER_SITE* ctest_leak_tracker_get_stack_site(const void* caller)
+{
+    void* stack[CTEST_LEAK_TRACKER_MAX_STACK_DEPTH];
+    int stack_depth = ctest_leak_tracker_capture_stack(stack, caller);
+    /* a different seed than for ctest_leak_tracker_get_caller_site */
+    uint64_t key = 0xCBF29CE484222325ULL;
+    for (int i = 0; i < stack_depth; i++)
+    {
+        key = ctest_leak_tracker_hash(key, stack[i]);
+    }
+    return ctest_leak_tracker_find_site(key | 1, caller, stack, stack_depth);
+}
+
+static void ctest_leak_tracker_count_allocation(CTEST_ALLOCATION_SCOPE* scope, size_t size, const void* caller)
+{
+    size_t i;
+    scope->count++;
+    scope->bytes += size;
+    for (i = 0; i < scope->site_count; i++)
+    {
+        if (scope->sites[i].caller == caller)
+        {
+            break;
+        }
+    }
+    if ((i == scope->site_count) && (i < CTEST_ALLOCATION_SCOPE_MAX_SITE_COUNT))
+    {
+        scope->sites[i].caller = caller;
+        scope->sites[i].stack = ctest_leak_tracker_get_stack_site(caller);
+        scope->sites[i].count = 0;
+        scope->sites[i].bytes = 0;
+        scope->site_count++;
+    }
+    if (i < scope->site_count)
+    {
+        scope->sites[i].count++;
+        scope->sites[i].bytes += size;
+    }
+}
+
+/* true when the allocation has to fail */
+static bool ctest_leak_tracker_inject_failure(const void* caller)
+{
+    bool result = false;
+    if (t_is_counting_allocations && !t_is_capturing_stack)
+    {
+        t_allocation_count++;
+        if (t_allocation_count == t_failing_allocation)
+        {
+            t_is_allocation_failure_injected = true;
+            t_injected_failure_stack_depth = ctest_leak_tracker_capture_stack(t_injected_failure_stack, caller);
+            result = true;
+        }
+    }
+    return result;
+}
+
+/* returns the block after the header */
+static void* ctest_leak_tracker_track(CTEST_LEAK_TRACKER_HEADER* header, size_t size, const void* caller)
+{
+    CTEST_LEAK_TRACKER_SLOT* slot = ctest_leak_tracker_take_slot();
+    if ((t_allocation_scope != NULL) && !t_is_capturing_stack)
+    {
+        ctest_leak_tracker_count_allocation(t_allocation_scope, size, caller);
+    }
+    header->slot = slot;
+    header->check = (uintptr_t)slot ^ CTEST_LEAK_TRACKER_HEADER_CHECK;
+    if (slot != NULL)
+    {
+        slot->size = size;
+        slot->caller = caller;
+        slot->is_after_start = atomic_load_explicit(&g_is_started, memory_order_relaxed);
+        slot->test_scope = t_test_scope;
+        slot->site = ((t_test_scope != 0) && !t_is_capturing_stack) ? ctest_leak_tracker_get_caller_site(caller) : NULL;
+        atomic_store_explicit(&slot->header, header, memory_order_release);
+    }
+    return header + 1;
+}
+
+/* the header of a block allocated by the tracker, NULL for the other blocks (aligned allocations, blocks of the loader) */
+static CTEST_LEAK_TRACKER_HEADER* ctest_leak_tracker_get_header(void* pointer)
+{
+    CTEST_LEAK_TRACKER_HEADER* header = (CTEST_LEAK_TRACKER_HEADER*)pointer - 1;
+    return ((header->check ^ CTEST_LEAK_TRACKER_HEADER_CHECK) == (uintptr_t)header->slot) ? header : NULL;
+}
+
+void* ctest_leak_tracker_allocate(size_t size, const void* caller)
+{
+    void* result;
+    CTEST_LEAK_TRACKER_HEADER* header = ((size > SIZE_MAX - sizeof(CTEST_LEAK_TRACKER_HEADER)) || ctest_leak_tracker_inject_failure(caller)) ?
+        NULL : __libc_malloc(sizeof(CTEST_LEAK_TRACKER_HEADER) + size);
+    if (header == NULL)
+    {
+        errno = ENOMEM;
+        result = NULL;
+    }
+    else
+    {
+        result = ctest_leak_tracker_track(header, size, caller);
+    }
+    return result;
+}
+
+void* malloc(size_t size)
+{
+    return ctest_leak_tracker_allocate(size, __builtin_return_address(0));
+}
+
+void* calloc(size_t count, size_t size)
+{
+    void* result;
+    CTEST_LEAK_TRACKER_HEADER* header;
+    if (((size != 0) && (count > (SIZE_MAX - sizeof(CTEST_LEAK_TRACKER_HEADER)) / size)) || ctest_leak_tracker_inject_failure(__builtin_return_address(0)))
+    {
+        header = NULL;
+    }
+    else
+    {
+        /* the header is zeroed with the block, which is harmless */
+        header = __libc_calloc(1, sizeof(CTEST_LEAK_TRACKER_HEADER) + count * size);
+    }
+
+    if (header == NULL)
+    {
+        errno = ENOMEM;
+        result = NULL;
+    }
+    else
+    {
+        result = ctest_leak_tracker_track(header, count * size, __builtin_return_address(0));
+    }
+    return result;
+}
+
+void free(void* pointer)
+{
+    if (pointer != NULL)
+    {
+        CTEST_LEAK_TRACKER_HEADER* header = ctest_leak_tracker_get_header(pointer);
+        if (header == NULL)
+        {
+            __libc_free(pointer);
+        }
+        else
+        {
+            CTEST_LEAK_TRACKER_SLOT* slot = header->slot;
+            header->check = 0;
+            if (slot != NULL)
+            {
+                atomic_store_explicit(&slot->header, NULL, memory_order_release);
+            }
+            __libc_free(header);
+        }
+    }
+}
+
+static void* ctest_leak_tracker_reallocate(void* pointer, size_t size, const void* caller)
+{
+    void* result;
+    if (pointer == NULL)
+    {
+        result = ctest_leak_tracker_allocate(size, caller);
+    }
+    else if (size == 0)
+    {
+        /* like glibc */
+        free(pointer);
+        result = NULL;
+    }
+    else
+    {
+        CTEST_LEAK_TRACKER_HEADER* header = ctest_leak_tracker_get_header(pointer);
+        if (header == NULL)
+        {
+            result = __libc_realloc(pointer, size);
+        }
+        else if ((size > SIZE_MAX - sizeof(CTEST_LEAK_TRACKER_HEADER)) || ctest_leak_tracker_inject_failure(caller))
+        {
+            /* the block is left as it was, like when realloc fails */
+            errno = ENOMEM;
+            result = NULL;
+        }
+        else
+        {
+            CTEST_LEAK_TRACKER_HEADER* new_header = __libc_realloc(header, sizeof(CTEST_LEAK_TRACKER_HEADER) + size);
+            if (new_header == NULL)
+            {
+                result = NULL;
+            }
+            else
+            {
+                /* the block keeps its slot, only the thread reallocating the block writes it */
+                CTEST_LEAK_TRACKER_SLOT* slot = new_header->slot;
+                if ((t_allocation_scope != NULL) && !t_is_capturing_stack)
+                {
+                    ctest_leak_tracker_count_allocation(t_allocation_scope, size, caller);
+                }
+                if (slot != NULL)
+                {
+                    slot->size = size;
+                    atomic_store_explicit(&slot->header, new_header, memory_order_release);
+                }
+                result = new_header + 1;
+            }
+        }
+    }
+    return result;
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    return ctest_leak_tracker_reallocate(pointer, size, __builtin_return_address(0));
+}
+
+void* reallocarray(void* pointer, size_t count, size_t size)
+{
+    void* result;
+    if ((size != 0) && (count > SIZE_MAX / size))
+    {
+        errno = ENOMEM;
+        result = NULL;
+    }
+    else
+    {
+        result = ctest_leak_tracker_reallocate(pointer, count * size, __builtin_return_address(0));
+    }
+    return result;
+}
+
+/* replaced too, the allocations made inside the C library are not reported */
+char* strdup(const char* string)
+{
+    size_t size = strlen(string) + 1;
+    char* result = ctest_leak_tracker_allocate(size, __builtin_return_address(0));
+    if (result != NULL)
+    {
+        (void)memcpy(result, string, size);
+    }
+    return result;
+}
+
+char* strndup(const char* string, size_t max_length)
+{
+    size_t length = strnlen(string, max_length);
+    char* result = ctest_leak_tracker_allocate(length + 1, __builtin_return_address(0));
+    if (result != NULL)
+    {
+        (void)memcpy(result, string, length);
+        result[length] = '\0';
+    }
+    return result;
+}
+
+size_t malloc_usable_size(void* pointer)
+{
+    size_t result;
+    if (pointer == NULL)
+    {
+        result = 0;
+    }
+    else
+    {
+        CTEST_LEAK_TRACKER_HEADER* header = ctest_leak_tracker_get_header(pointer);
+        if (header == NULL)
+        {
+            /* no __libc_ name for it, it is not called while the allocator starts */
+            size_t (*libc_malloc_usable_size)(void*) = (size_t (*)(void*))dlsym(RTLD_NEXT, "malloc_usable_size");
+            result = (libc_malloc_usable_size == NULL) ? 0 : libc_malloc_usable_size(pointer);
+        }
+        else
+        {
+            /* what was asked for is all that can be relied on */
+            result = (header->slot == NULL) ? 0 : header->slot->size;
+        }
+    }
+    return result;
+}
+
+void ctest_leak_tracker_start(void)
+{
+    void* frame;
+    ctest_leak_tracker_link_operator_new();
+    /* the first backtrace loads the unwinder, which allocates */
+    (void)backtrace(&frame, 1);
+    atomic_store(&g_is_started, true);
+}
+
+uint32_t ctest_leak_tracker_begin_test(void)
+{
+    uint32_t result;
+    do
+    {
+        result = atomic_fetch_add(&g_last_test_scope, 1) + 1;
+    } while (result == 0);
+    t_test_scope = result;
+    return result;
+}
+
+/* the stack of the site when captured, caller alone otherwise */
+static void ctest_leak_tracker_log_frames(void* const* stack, int stack_depth)
+{
+    char** symbols = backtrace_symbols(stack, stack_depth);
+    for (int i = 0; i < stack_depth; i++)
+    {
+        if (symbols == NULL)
+        {
+            LogError("    #%d %p", i, stack[i]);
+        }
+        else
+        {
+            LogError("    #%d %s", i, symbols[i]);
+        }
+    }
+    free(symbols);
+}
+
+static void ctest_leak_tracker_log_stack(const CTEST_LEAK_TRACKER_SITE* site, const void* caller)
+{
+    void* caller_stack = (void*)caller;
+
+    if ((site != NULL) && atomic_load_explicit(&site->is_captured, memory_order_acquire) && (site->stack_depth > 0))
+    {
+        ctest_leak_tracker_log_frames(site->stack, site->stack_depth);
+    }
+    else
+    {
+        ctest_leak_tracker_log_frames(&caller_stack, 1);
+    }
+}
+
+static void ctest_leak_tracker_log_test_leak(const char* test_function_name, const CTEST_LEAK_TRACKER_SLOT* slot)
+{
+    LogError(CTEST_ANSI_COLOR_RED "Test %s leaked %zu bytes, allocated at:" CTEST_ANSI_COLOR_RESET, test_function_name, slot->size);
+    ctest_leak_tracker_log_stack(slot->site, slot->caller);
+}
+
+CTEST_ALLOCATION_SCOPE* ctest_leak_tracker_get_allocation_scope(void)
+{
+    return t_allocation_scope;
+}
+
+CTEST_ALLOCATION_SCOPE* ctest_leak_tracker_set_allocation_scope(CTEST_ALLOCATION_SCOPE* scope)
+{
+    CTEST_ALLOCATION_SCOPE* result = t_allocation_scope;
+    t_allocation_scope = scope;
+    return result;
+}
+
+void ctest_leak_tracker_log_allocation_site(const CTEST_ALLOCATION_SITE* site)
+{
+    ctest_leak_tracker_log_stack(site->stack, site->caller);
+}
+
+void ctest_leak_tracker_begin_allocation_failure(uint64_t failing_allocation)
+{
+    t_allocation_count = 0;
+    t_failing_allocation = failing_allocation;
+    t_is_allocation_failure_injected = false;
+    t_is_counting_allocations = true;
+}
+
+uint64_t ctest_leak_tracker_end_allocation_failure(void)
+{
+    t_is_counting_allocations = false;
+    return t_allocation_count;
+}
+
+bool ctest_leak_tracker_is_allocation_failure_injected(void)
+{
+    return t_is_allocation_failure_injected;
+}
+
+void ctest_leak_tracker_log_injected_failure(void)
+{
+    if (t_is_allocation_failure_injected)
+    {
+        LogError("  allocation %" PRIu64 " failed at:", t_failing_allocation);
+        ctest_leak_tracker_log_frames(t_injected_failure_stack, t_injected_failure_stack_depth);
+    }
+}
+
+void ctest_leak_tracker_write_injected_failure(int fd)
+{
+    /* called from a signal handler, without allocating or stdio */
+    if (t_is_allocation_failure_injected)
+    {
+        static const char header[] = "  the allocation made to fail was at:\n";
+        (void)write(fd, header, sizeof(header) - 1);
+        backtrace_symbols_fd(t_injected_failure_stack, t_injected_failure_stack_depth, fd);
+    }
+}
+
+size_t ctest_leak_tracker_end_test(uint32_t test_scope, const char* test_function_name)
+{
+    size_t result = 0;
+    /* the blocks of the test were all allocated by this thread, in its table */
+    CTEST_LEAK_TRACKER_TABLE* table = t_table;
+
+    t_test_scope = 0;
+    if (table != NULL)
+    {
+        for (CTEST_LEAK_TRACKER_CHUNK* chunk = table->first_chunk; chunk != NULL; chunk = atomic_load_explicit(&chunk->next, memory_order_acquire))
+        {
+            for (size_t i = 0; i < CTEST_LEAK_TRACKER_CHUNK_SLOT_COUNT; i++)
+            {
+                CTEST_LEAK_TRACKER_SLOT* slot = &chunk->slots[i];
+                if ((slot->test_scope == test_scope) && (atomic_load_explicit(&slot->header, memory_order_acquire) != NULL))
+                {
+                    if (result < CTEST_LEAK_TRACKER_MAX_REPORTED_LEAK_COUNT)
+                    {
+                        ctest_leak_tracker_log_test_leak(test_function_name, slot);
+                    }
+                    result++;
+                    /* the test fails for it, the check at exit does not count it again */
+                    slot->is_after_start = false;
+                }
+            }
+        }
+    }
+
+    if (result > CTEST_LEAK_TRACKER_MAX_REPORTED_LEAK_COUNT)
+    {
+        LogError(CTEST_ANSI_COLOR_RED "Test %s leaked %zu more blocks" CTEST_ANSI_COLOR_RESET, test_function_name, result - CTEST_LEAK_TRACKER_MAX_REPORTED_LEAK_COUNT);
+    }
+    return result;
+}
+
+/* the load address of the module containing address, NULL when unknown */
+static const void* ctest_leak_tracker_get_module_base(const void* address)
+{
+    Dl_info info;
+    return (dladdr(address, &info) == 0) ? NULL : info.dli_fbase;
+}
+
+static bool ctest_leak_tracker_is_system_caller(const void* caller, const void* libc_base, const void* loader_base)
+{
+    const void* caller_base = ctest_leak_tracker_get_module_base(caller);
+    return (caller_base != NULL) && ((caller_base == libc_base) || (caller_base == loader_base));
+}
+
+size_t ctest_leak_tracker_report_leaks(bool is_logged)
+{
+    size_t result = 0;
+    const void* libc_base = ctest_leak_tracker_get_module_base((const void*)__libc_malloc);
+    const void* loader_base = ctest_leak_tracker_get_module_base(&_r_debug);
+
+    for (CTEST_LEAK_TRACKER_TABLE* table = atomic_load_explicit(&g_tables, memory_order_acquire); table != NULL; table = table->next)
+    {
+        for (CTEST_LEAK_TRACKER_CHUNK* chunk = table->first_chunk; chunk != NULL; chunk = atomic_load_explicit(&chunk->next, memory_order_acquire))
+        {
+            for (size_t i = 0; i < CTEST_LEAK_TRACKER_CHUNK_SLOT_COUNT; i++)
+            {
+                CTEST_LEAK_TRACKER_SLOT* slot = &chunk->slots[i];
+                if ((atomic_load_explicit(&slot->header, memory_order_acquire) != NULL) && slot->is_after_start &&
+                    !ctest_leak_tracker_is_system_caller(slot->caller, libc_base, loader_base))
+                {
+                    if (is_logged && (result < CTEST_LEAK_TRACKER_MAX_REPORTED_LEAK_COUNT))
+                    {
+                        /* no allocation here, the heap is what is being checked */
+                        void* caller = (void*)slot->caller;
+                        (void)fprintf(stderr, "ctest: leaked %zu bytes allocated from ", slot->size);
+                        (void)fflush(stderr);
+                        backtrace_symbols_fd(&caller, 1, STDERR_FILENO);
+                    }
+                    result++;
+                }
+            }
+        }
+    }
+
+    if (is_logged && (result > CTEST_LEAK_TRACKER_MAX_REPORTED_LEAK_COUNT))
+    {
+        (void)fprintf(stderr, "ctest: ... and %zu more leaked blocks\n", result - CTEST_LEAK_TRACKER_MAX_REPORTED_LEAK_COUNT);
+    }
+
+    return result;
+}
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// operator new and delete replacements of the allocation tracker (see ctest_leak_tracker.c), so that a leaked C++ object is reported
+// with the code that created it rather than with the operator new of libstdc++. The aligned variants are not replaced, their blocks
+// are not tracked.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+extern "C" void* ctest_leak_tracker_allocate(std::size_t size, const void* caller);
+
+extern "C" void ctest_leak_tracker_link_operator_new(void)
+{
+}
+
+static void* ctest_leak_tracker_new(std::size_t size, const void* caller)
+{
+    void* result;
+    while ((result = ctest_leak_tracker_allocate((size == 0) ? 1 : size, caller)) == NULL)
+    {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == NULL)
+        {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+    return result;
+}
+
+static void* ctest_leak_tracker_new_nothrow(std::size_t size, const void* caller) noexcept
+{
+    void* result;
+    try
+    {
+        result = ctest_leak_tracker_new(size, caller);
+    }
+    catch (...)
+    {
+        result = NULL;
+    }
+    return result;
+}
+
+void* operator new(std::size_t size)
+{
+    return ctest_leak_tracker_new(size, __builtin_return_address(0));
+}
+
+void* operator new[](std::size_t size)
+{
+    return ctest_leak_tracker_new(size, __builtin_return_address(0));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ctest_leak_tracker_new_nothrow(size, __builtin_return_address(0));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ctest_leak_tracker_new_nothrow(size, __builtin_return_address(0));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
@@ -0,0 +1,254 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* List mode (CTEST_LIST): RunTests writes the tests and benchmarks of the suite matching the filter to stdout, one JSON object per line,
+   in the order of the registration, and runs nothing (not even the fixtures):
+
+    {"suite":"s","test":"t","kind":"test"}
+    {"suite":"s","test":"b","kind":"benchmark"}
+    {"suite":"s","test":"p_small","kind":"test","parameterized_test":"p","case":"small"}
+
+   The parameterized test and case of a test come from the manifest of the executable (see ctest.h), so they are only written where
+   there is one (GCC/clang, ELF targets). */
+
+#if (defined __GNUC__ || defined __clang__) && defined __ELF__
+/* defined by the linker when at least one suite was compiled with the manifest, weak so that the runner links without it. Referencing
+   them also keeps the section when the executable is linked with --gc-sections */
+extern const char __start_ctest_manifest[] __attribute__((weak, visibility("hidden")));
+extern const char __stop_ctest_manifest[] __attribute__((weak, visibility("hidden")));
+
+static const char* ctest_list_get_manifest_begin(void)
+{
+    return __start_ctest_manifest;
+}
+
+static const char* ctest_list_get_manifest_end(void)
+{
+    return __stop_ctest_manifest;
+}
+#else
+static const char* ctest_list_get_manifest_begin(void)
+{
+    return NULL;
+}
+
+static const char* ctest_list_get_manifest_end(void)
+{
+    return NULL;
+}
+#endif
+
+/* a field of a manifest entry, not NUL terminated */
+typedef struct CTEST_LIST_FIELD_TAG
+{
+    const char* text;
+    size_t length;
+} CTEST_LIST_FIELD;
+
+typedef struct CTEST_LIST_CASE_TAG
+{
+    CTEST_LIST_FIELD test;
+    CTEST_LIST_FIELD parameterized_test;
+    CTEST_LIST_FIELD case_name;
+} CTEST_LIST_CASE;
+
+/* the next entry of the manifest at or after entry, NULL after the last one. The compiler may pad the entries with NULs */
+static const char* ctest_list_find_manifest_entry(const char* entry)
+{
+    const char* manifest_end = ctest_list_get_manifest_end();
+    while ((entry != NULL) && (entry < manifest_end) && (*entry == '\0'))
+    {
+        entry++;
+    }
+    return ((entry != NULL) && (entry < manifest_end)) ? entry : NULL;
+}
+
+/* splits a manifest entry in its tab separated fields, returns the number of fields (at most max_field_count) */
+static size_t ctest_list_split_manifest_entry(const char* entry, CTEST_LIST_FIELD* fields, size_t max_field_count)
+{
+    size_t field_count = 0;
+    while (field_count < max_field_count)
+    {
+        size_t length = strcspn(entry, "\t");
+        fields[field_count].text = entry;
+        fields[field_count].length = length;
+        field_count++;
+        if (entry[length] != '\t')
+        {
+            break;
+        }
+        entry += length + 1;
+    }
+    return field_count;
+}
+
+static bool ctest_list_field_equals(const CTEST_LIST_FIELD* field, const char* text)
+{
+    return (strncmp(field->text, text, field->length) == 0) && (text[field->length] == '\0');
+}
+
+static int ctest_list_compare_fields(const CTEST_LIST_FIELD* left, const CTEST_LIST_FIELD* right)
+{
+    int result = memcmp(left->text, right->text, (left->length < right->length) ? left->length : right->length);
+    if (result == 0)
+    {
+        result = (left->length < right->length) ? -1 : ((left->length > right->length) ? 1 : 0);
+    }
+    return result;
+}
+
+static int ctest_list_compare_cases(const void* left, const void* right)
+{
+    return ctest_list_compare_fields(&((const CTEST_LIST_CASE*)left)->test, &((const CTEST_LIST_CASE*)right)->test);
+}
+
+/* the first entry at or after entry having field_count fields, the first one being kind, split in fields. NULL after the last one */
+static const char* ctest_list_find_manifest_entry_of_kind(const char* entry, const char* kind, CTEST_LIST_FIELD* fields, size_t field_count)
+{
+    for (entry = ctest_list_find_manifest_entry(entry); entry != NULL; entry = ctest_list_find_manifest_entry(entry + strlen(entry) + 1))
+    {
+        if ((ctest_list_split_manifest_entry(entry, fields, field_count) == field_count) && ctest_list_field_equals(&fields[0], kind))
+        {
+            break;
+        }
+    }
+    return entry;
+}
+
+/* counts the parameterized cases of the translation unit, and copies them to cases when it is not NULL */
+static size_t ctest_list_collect_cases(const CTEST_LIST_FIELD* suite_file, CTEST_LIST_CASE* cases)
+{
+    size_t result = 0;
+    CTEST_LIST_FIELD fields[5];
+    for (const char* entry = ctest_list_find_manifest_entry_of_kind(ctest_list_get_manifest_begin(), "case", fields, 5);
+        entry != NULL;
+        entry = ctest_list_find_manifest_entry_of_kind(entry + strlen(entry) + 1, "case", fields, 5))
+    {
+        if (ctest_list_compare_fields(&fields[1], suite_file) == 0)
+        {
+            if (cases != NULL)
+            {
+                cases[result].test = fields[2];
+                cases[result].parameterized_test = fields[3];
+                cases[result].case_name = fields[4];
+            }
+            result++;
+        }
+    }
+    return result;
+}
+
+/* the parameterized cases of the translation unit of the suite, sorted by test name. NULL (and 0 cases) when the manifest has none */
+static CTEST_LIST_CASE* ctest_list_get_suite_cases(const char* test_suite_name, size_t* case_count)
+{
+    CTEST_LIST_CASE* result = NULL;
+    CTEST_LIST_FIELD fields[3];
+    const char* entry;
+
+    *case_count = 0;
+    for (entry = ctest_list_find_manifest_entry_of_kind(ctest_list_get_manifest_begin(), "suite", fields, 3);
+        (entry != NULL) && !ctest_list_field_equals(&fields[2], test_suite_name);
+        entry = ctest_list_find_manifest_entry_of_kind(entry + strlen(entry) + 1, "suite", fields, 3))
+    {
+        /* not the suite */
+    }
+
+    if (entry != NULL)
+    {
+        CTEST_LIST_FIELD suite_file = fields[1];
+        size_t count = ctest_list_collect_cases(&suite_file, NULL);
+        if (count == 0)
+        {
+            /* no parameterized test */
+        }
+        else if ((result = malloc(count * sizeof(CTEST_LIST_CASE))) == NULL)
+        {
+            LogError("failure in malloc(%zu), the parameterized cases are not listed", count * sizeof(CTEST_LIST_CASE));
+        }
+        else
+        {
+            *case_count = ctest_list_collect_cases(&suite_file, result);
+            qsort(result, *case_count, sizeof(CTEST_LIST_CASE), ctest_list_compare_cases);
+        }
+    }
+
+    return result;
+}
+
+size_t ctest_list_suite(const TEST_FUNCTION_DATA* test_list_head, const char* test_suite_name, const char* test_name_filter)
+{
+    size_t result;
+    CTEST_FILTER_HANDLE filter = NULL;
+
+    if ((test_name_filter != NULL) && (test_name_filter[0] != '\0') && ((filter = ctest_filter_create(test_name_filter)) == NULL))
+    {
+        LogError("failure in ctest_filter_create(%s)", test_name_filter);
+        result = 1;
+    }
+    else
+    {
+        size_t case_count;
+        CTEST_LIST_CASE* cases = ctest_list_get_suite_cases(test_suite_name, &case_count);
+        CTEST_REPORT_BUFFER buffer = { NULL, 0, 0, true };
+        CTEST_REGISTRATION_SUITE registration_suite;
+        ctest_registration_get_suite(test_list_head, &registration_suite);
+
+        for (const TEST_FUNCTION_DATA* entry = ctest_registration_get_first_entry(&registration_suite);
+            entry != NULL;
+            entry = ctest_registration_get_next_entry(&registration_suite, entry))
+        {
+            if (((entry->FunctionType == CTEST_TEST_FUNCTION) || (entry->FunctionType == CTEST_BENCHMARK_FUNCTION)) &&
+                ((filter == NULL) || ctest_filter_matches(filter, test_suite_name, entry->TestFunctionName)))
+            {
+                ctest_report_buffer_append(&buffer, "{\"suite\":\"");
+                ctest_report_buffer_append_json_escaped(&buffer, test_suite_name);
+                ctest_report_buffer_append(&buffer, "\",\"test\":\"");
+                ctest_report_buffer_append_json_escaped(&buffer, entry->TestFunctionName);
+                ctest_report_buffer_append_format(&buffer, "\",\"kind\":\"%s\"", (entry->FunctionType == CTEST_BENCHMARK_FUNCTION) ? "benchmark" : "test");
+
+                if (cases != NULL)
+                {
+                    CTEST_LIST_CASE key;
+                    key.test.text = entry->TestFunctionName;
+                    key.test.length = strlen(entry->TestFunctionName);
+                    const CTEST_LIST_CASE* test_case = bsearch(&key, cases, case_count, sizeof(CTEST_LIST_CASE), ctest_list_compare_cases);
+                    if (test_case != NULL)
+                    {
+                        /* stringified identifiers, nothing to escape */
+                        ctest_report_buffer_append_format(&buffer, ",\"parameterized_test\":\"%.*s\",\"case\":\"%.*s\"",
+                            (int)test_case->parameterized_test.length, test_case->parameterized_test.text, (int)test_case->case_name.length, test_case->case_name.text);
+                    }
+                }
+                ctest_report_buffer_append(&buffer, "}\n");
+            }
+        }
+
+        /* a single write for the whole suite */
+        if ((buffer.length > 0) && ((fwrite(buffer.data, 1, buffer.length, stdout) != buffer.length) || (fflush(stdout) != 0)))
+        {
+            LogError("failure writing the list of the tests of %s to stdout", test_suite_name);
+            result = 1;
+        }
+        else
+        {
+            result = 0;
+        }
+
+        free(buffer.data);
+        free(cases);
+        ctest_filter_destroy(filter);
+    }
+
+    return result;
+}
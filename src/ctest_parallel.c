@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+typedef struct CTEST_PARALLEL_RUN_TAG
+{
+    CTEST_SUITE_RUN* suite_run;
+#if defined _MSC_VER
+    volatile LONG next_test_index;
+#else
+    size_t next_test_index;
+#endif
+} CTEST_PARALLEL_RUN;
+
+static size_t ctest_parallel_take_next_test_index(CTEST_PARALLEL_RUN* parallel_run)
+{
+#if defined _MSC_VER
+    return (size_t)InterlockedIncrement(&parallel_run->next_test_index) - 1;
+#else
+    return __atomic_fetch_add(&parallel_run->next_test_index, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+/* every worker (including the thread that called RunTests) pulls tests from the shared index until none are left */
+static void ctest_parallel_worker(CTEST_PARALLEL_RUN* parallel_run)
+{
+    CTEST_SUITE_RUN* suite_run = parallel_run->suite_run;
+    size_t test_index;
+
+    while ((test_index = ctest_parallel_take_next_test_index(parallel_run)) < suite_run->test_count)
+    {
+        CTEST_TEST_RUN* test_run = &suite_run->tests[test_index];
+        if (test_run->is_selected && ctest_is_test_thread_safe(suite_run, test_run))
+        {
+            ctest_run_test(suite_run, test_run);
+        }
+    }
+}
+
+#if defined _MSC_VER
+typedef HANDLE CTEST_THREAD_HANDLE;
+
+static DWORD WINAPI ctest_parallel_thread_func(LPVOID context)
+{
+    ctest_trace_begin_thread();
+    ctest_quiet_begin_thread();
+    ctest_parallel_worker((CTEST_PARALLEL_RUN*)context);
+    ctest_crash_end_thread();
+    ctest_quiet_end_thread();
+    ctest_trace_end_thread();
+    return 0;
+}
+
+static bool ctest_parallel_thread_create(CTEST_THREAD_HANDLE* thread_handle, CTEST_PARALLEL_RUN* parallel_run)
+{
+    *thread_handle = CreateThread(NULL, 0, ctest_parallel_thread_func, parallel_run, 0, NULL);
+    return (*thread_handle != NULL);
+}
+
+static void ctest_parallel_thread_join(CTEST_THREAD_HANDLE thread_handle)
+{
+    (void)WaitForSingleObject(thread_handle, INFINITE);
+    (void)CloseHandle(thread_handle);
+}
+
+uint32_t ctest_get_processor_count(void)
+{
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return (system_info.dwNumberOfProcessors == 0) ? 1 : (uint32_t)system_info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t CTEST_THREAD_HANDLE;
+
+static void* ctest_parallel_thread_func(void* context)
+{
+    ctest_trace_begin_thread();
+    ctest_quiet_begin_thread();
+    ctest_parallel_worker((CTEST_PARALLEL_RUN*)context);
+    ctest_crash_end_thread();
+    ctest_quiet_end_thread();
+    ctest_trace_end_thread();
+    return NULL;
+}
+
+static bool ctest_parallel_thread_create(CTEST_THREAD_HANDLE* thread_handle, CTEST_PARALLEL_RUN* parallel_run)
+{
+    return (pthread_create(thread_handle, NULL, ctest_parallel_thread_func, parallel_run) == 0);
+}
+
+static void ctest_parallel_thread_join(CTEST_THREAD_HANDLE thread_handle)
+{
+    (void)pthread_join(thread_handle, NULL);
+}
+
+uint32_t ctest_get_processor_count(void)
+{
+    long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (processor_count < 1) ? 1 : (uint32_t)processor_count;
+}
+#endif
+
+void ctest_run_tests_parallel(CTEST_SUITE_RUN* suite_run, uint32_t worker_thread_count)
+{
+    CTEST_PARALLEL_RUN parallel_run;
+    uint32_t created_thread_count = 0;
+
+    parallel_run.suite_run = suite_run;
+    parallel_run.next_test_index = 0;
+
+    /* the calling thread is a worker too, so there is no point in having more threads than tests */
+    if (worker_thread_count > suite_run->test_count)
+    {
+        worker_thread_count = (suite_run->test_count == 0) ? 1 : (uint32_t)suite_run->test_count;
+    }
+
+    CTEST_THREAD_HANDLE* thread_handles = malloc(sizeof(CTEST_THREAD_HANDLE) * worker_thread_count);
+    if (thread_handles == NULL)
+    {
+        LogError("failure in malloc(sizeof(CTEST_THREAD_HANDLE) * %" PRIu32 "), running tests on the calling thread", worker_thread_count);
+    }
+    else
+    {
+        for (created_thread_count = 0; created_thread_count < worker_thread_count - 1; created_thread_count++)
+        {
+            if (!ctest_parallel_thread_create(&thread_handles[created_thread_count], &parallel_run))
+            {
+                LogWarning("Could only create %" PRIu32 " of %" PRIu32 " worker threads", created_thread_count, worker_thread_count - 1);
+                break;
+            }
+        }
+    }
+
+    LogInfo(" ### Running tests on %" PRIu32 " threads", created_thread_count + 1);
+
+    ctest_parallel_worker(&parallel_run);
+
+    for (uint32_t i = 0; i < created_thread_count; i++)
+    {
+        ctest_parallel_thread_join(thread_handles[i]);
+    }
+
+    free(thread_handles);
+}
@@ -0,0 +1,251 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+#if defined __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/* The counters of a test are opened on the thread running it (so tests running on other threads are not counted), before the
+   setjmp of the test and closed after it, only enabled around the test body (or the measured loops of a benchmark). */
+
+static const char* const g_counter_names[CTEST_PERF_COUNTER_COUNT] =
+{
+    "cycles",
+    "instructions",
+    "cache misses",
+    "branch misses",
+    "page faults",
+    "context switches"
+};
+
+const char* ctest_perf_counters_get_name(CTEST_PERF_COUNTER counter)
+{
+    return g_counter_names[counter];
+}
+
+#if defined __linux__
+typedef struct CTEST_PERF_COUNTER_EVENT_TAG
+{
+    uint32_t type;
+    uint64_t config;
+} CTEST_PERF_COUNTER_EVENT;
+
+static const CTEST_PERF_COUNTER_EVENT g_counter_events[CTEST_PERF_COUNTER_COUNT] =
+{
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES }
+};
+
+/* set once the kernel denied all the counters, the following tests do not try again. Written by any test thread, a race only
+   repeats a failing attempt. */
+static volatile int g_is_denied;
+static volatile int g_is_unavailable_logged[CTEST_PERF_COUNTER_COUNT];
+
+static int ctest_perf_counters_get_paranoid_level(void)
+{
+    int result = -100; /* unknown */
+    FILE* file = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+    if (file != NULL)
+    {
+        if (fscanf(file, "%d", &result) != 1)
+        {
+            result = -100;
+        }
+        (void)fclose(file);
+    }
+    return result;
+}
+
+static int ctest_perf_counters_open_event(const CTEST_PERF_COUNTER_EVENT* event, bool exclude_kernel)
+{
+    struct perf_event_attr attr;
+    (void)memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event->type;
+    attr.config = event->config;
+    attr.disabled = 1;
+    attr.exclude_kernel = exclude_kernel ? 1 : 0;
+    attr.exclude_hv = 1;
+    /* more counters than the PMU has are multiplexed, the times tell by how much to scale them */
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    /* calling thread, any CPU */
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+void ctest_perf_counters_open(CTEST_PERF_COUNTERS_SESSION* session)
+{
+    int open_error = 0;
+    size_t open_count = 0;
+
+    for (size_t i = 0; i < CTEST_PERF_COUNTER_COUNT; i++)
+    {
+        session->fds[i] = -1;
+    }
+
+    if (!g_is_denied)
+    {
+        for (size_t i = 0; i < CTEST_PERF_COUNTER_COUNT; i++)
+        {
+            session->fds[i] = ctest_perf_counters_open_event(&g_counter_events[i], false);
+            if ((session->fds[i] < 0) && ((errno == EACCES) || (errno == EPERM)))
+            {
+                /* perf_event_paranoid 2 and more only allow counting user space */
+                session->fds[i] = ctest_perf_counters_open_event(&g_counter_events[i], true);
+            }
+
+            if (session->fds[i] < 0)
+            {
+                open_error = errno;
+                if (!g_is_unavailable_logged[i] && (open_error != EACCES) && (open_error != EPERM))
+                {
+                    /* typically ENOENT for the hardware counters of a virtual machine */
+                    g_is_unavailable_logged[i] = 1;
+                    LogWarning("Performance counter %s is not available (perf_event_open errno %d), not counted", g_counter_names[i], open_error);
+                }
+            }
+            else
+            {
+                open_count++;
+            }
+        }
+
+        if ((open_count == 0) && ((open_error == EACCES) || (open_error == EPERM) || (open_error == ENOSYS)))
+        {
+            g_is_denied = 1;
+            LogWarning("perf_event_open is denied (errno %d, kernel.perf_event_paranoid=%d), running without performance counters",
+                open_error, ctest_perf_counters_get_paranoid_level());
+        }
+    }
+}
+
+void ctest_perf_counters_enable(const CTEST_PERF_COUNTERS_SESSION* session)
+{
+    for (size_t i = 0; i < CTEST_PERF_COUNTER_COUNT; i++)
+    {
+        if (session->fds[i] >= 0)
+        {
+            (void)ioctl(session->fds[i], PERF_EVENT_IOC_RESET, 0);
+            (void)ioctl(session->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void ctest_perf_counters_disable(const CTEST_PERF_COUNTERS_SESSION* session)
+{
+    for (size_t i = 0; i < CTEST_PERF_COUNTER_COUNT; i++)
+    {
+        if (session->fds[i] >= 0)
+        {
+            (void)ioctl(session->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+void ctest_perf_counters_close(CTEST_PERF_COUNTERS_SESSION* session, CTEST_PERF_COUNTERS* counters)
+{
+    counters->valid_mask = 0;
+    for (size_t i = 0; i < CTEST_PERF_COUNTER_COUNT; i++)
+    {
+        if (session->fds[i] >= 0)
+        {
+            /* value, time enabled, time running */
+            uint64_t values[3];
+            if ((read(session->fds[i], values, sizeof(values)) == (ssize_t)sizeof(values)) && (values[2] > 0))
+            {
+                counters->values[i] = (values[2] < values[1]) ? (uint64_t)((double)values[0] * (double)values[1] / (double)values[2]) : values[0];
+                counters->valid_mask |= (1U << i);
+            }
+            (void)close(session->fds[i]);
+            session->fds[i] = -1;
+        }
+    }
+}
+#else
+void ctest_perf_counters_open(CTEST_PERF_COUNTERS_SESSION* session)
+{
+    static bool is_logged = false;
+    for (size_t i = 0; i < CTEST_PERF_COUNTER_COUNT; i++)
+    {
+        session->fds[i] = -1;
+    }
+    if (!is_logged)
+    {
+        is_logged = true;
+        LogWarning("Performance counters are only available on Linux, running without them");
+    }
+}
+
+void ctest_perf_counters_enable(const CTEST_PERF_COUNTERS_SESSION* session)
+{
+    (void)session;
+}
+
+void ctest_perf_counters_disable(const CTEST_PERF_COUNTERS_SESSION* session)
+{
+    (void)session;
+}
+
+void ctest_perf_counters_close(CTEST_PERF_COUNTERS_SESSION* session, CTEST_PERF_COUNTERS* counters)
+{
+    (void)session;
+    counters->valid_mask = 0;
+}
+#endif
+
+void ctest_perf_counters_log(const char* test_function_name, const CTEST_PERF_COUNTERS* counters)
+{
+    if (counters->valid_mask != 0)
+    {
+        char text[256];
+        size_t length = 0;
+        double divisor = (counters->iterations > 1) ? (double)counters->iterations : 1.0;
+
+        text[0] = '\0';
+        for (size_t i = 0; (i < CTEST_PERF_COUNTER_COUNT) && (length < sizeof(text)); i++)
+        {
+            if ((counters->valid_mask & (1U << i)) != 0)
+            {
+                int written = snprintf(text + length, sizeof(text) - length, (counters->iterations > 1) ? "%s%s %.2f" : "%s%s %.0f",
+                    (length == 0) ? "" : ", ", g_counter_names[i], (double)counters->values[i] / divisor);
+                length += (written > 0) ? (size_t)written : 0;
+                if ((i == CTEST_PERF_COUNTER_INSTRUCTIONS) && ((counters->valid_mask & (1U << CTEST_PERF_COUNTER_CYCLES)) != 0) &&
+                    (counters->values[CTEST_PERF_COUNTER_CYCLES] > 0) && (length < sizeof(text)))
+                {
+                    written = snprintf(text + length, sizeof(text) - length, " (IPC %.2f)",
+                        (double)counters->values[CTEST_PERF_COUNTER_INSTRUCTIONS] / (double)counters->values[CTEST_PERF_COUNTER_CYCLES]);
+                    length += (written > 0) ? (size_t)written : 0;
+                }
+            }
+        }
+
+        if (counters->iterations > 1)
+        {
+            LogInfo("Test %s counters per iteration: %s", test_function_name, text);
+        }
+        else
+        {
+            LogInfo("Test %s counters: %s", test_function_name, text);
+        }
+    }
+}
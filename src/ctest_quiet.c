@@ -0,0 +1,384 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include <io.h>
+#include "windows.h"
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Quiet mode (CTEST_QUIET). ctest puts its own log sink in front of the ones configured in c_logging. While a thread runs a test, what
+   the thread logs is kept in the thread's CTEST_QUIET_LOG (the oldest messages are dropped when it is full) and only passed to the
+   configured sinks when the test fails. A test that passes prints a '.' instead, a failed one an 'F'. When the process crashes or
+   times out, the logs of the running tests are written to stderr. Everything else (suite messages, threads that do not run a test)
+   is logged as usual. */
+
+#define CTEST_QUIET_LOG_SIZE (64 * 1024)
+#define CTEST_QUIET_PROGRESS_LINE_LENGTH 80
+
+/* a message in a CTEST_QUIET_LOG, followed by its text (with the terminating zero) */
+typedef struct CTEST_QUIET_RECORD_TAG
+{
+    LOG_LEVEL log_level;
+    const char* file;
+    const char* func;
+    int line_no;
+    size_t size; /* with the text */
+} CTEST_QUIET_RECORD;
+
+/* the messages logged by a thread during its test. The threads that ended release theirs for the next ones */
+typedef struct CTEST_QUIET_LOG_TAG
+{
+    struct CTEST_QUIET_LOG_TAG* next;
+    bool is_used;
+    const char* volatile test_name; /* NULL when the thread is not running a test */
+    size_t length;
+    size_t dropped_count;
+    char data[CTEST_QUIET_LOG_SIZE];
+} CTEST_QUIET_LOG;
+
+static bool g_is_opened = false;
+static bool g_is_quiet = false;
+static volatile int g_is_disabled = 0;
+static LOGGER_CONFIG g_sinks_config;
+static CTEST_QUIET_LOG* volatile g_logs = NULL;
+static CTEST_THREAD_LOCAL CTEST_QUIET_LOG* g_current_log = NULL;
+static uint32_t g_progress_column = 0;
+
+static void ctest_quiet_log(LOG_LEVEL log_level, LOG_CONTEXT_HANDLE log_context, const char* file, const char* func, int line_no, const char* message_format, ...);
+
+static const LOG_SINK_IF g_quiet_sink = { NULL, NULL, ctest_quiet_log };
+static const LOG_SINK_IF* g_quiet_sinks[] = { &g_quiet_sink };
+
+#if defined _MSC_VER
+static SRWLOCK g_lock = SRWLOCK_INIT;
+
+static void ctest_quiet_lock(void)
+{
+    AcquireSRWLockExclusive(&g_lock);
+}
+
+static void ctest_quiet_unlock(void)
+{
+    ReleaseSRWLockExclusive(&g_lock);
+}
+
+static void ctest_quiet_write_stderr(const char* text)
+{
+    (void)_write(2, text, (unsigned int)strlen(text));
+}
+#else
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void ctest_quiet_lock(void)
+{
+    (void)pthread_mutex_lock(&g_lock);
+}
+
+static void ctest_quiet_unlock(void)
+{
+    (void)pthread_mutex_unlock(&g_lock);
+}
+
+static void ctest_quiet_write_stderr(const char* text)
+{
+    (void)!write(STDERR_FILENO, text, strlen(text));
+}
+#endif
+
+/* ends the line of progress characters, with the lock held */
+static void ctest_quiet_end_progress_line(void)
+{
+    if (g_progress_column > 0)
+    {
+        (void)fputc('\n', stdout);
+        (void)fflush(stdout);
+        g_progress_column = 0;
+    }
+}
+
+static void ctest_quiet_log_to_sinks(LOG_LEVEL log_level, const char* file, const char* func, int line_no, const char* message)
+{
+    for (uint32_t i = 0; i < g_sinks_config.log_sink_count; i++)
+    {
+        g_sinks_config.log_sinks[i]->log(log_level, NULL, file, func, line_no, "%s", message);
+    }
+}
+
+/* drops the oldest messages until size bytes are free (a quarter of the log more, so that it does not move the messages every time) */
+static void ctest_quiet_make_room(CTEST_QUIET_LOG* log, size_t size)
+{
+    if (log->length + size > CTEST_QUIET_LOG_SIZE)
+    {
+        size_t dropped_length = 0;
+        while ((dropped_length < log->length) && (log->length - dropped_length + size + CTEST_QUIET_LOG_SIZE / 4 > CTEST_QUIET_LOG_SIZE))
+        {
+            CTEST_QUIET_RECORD record;
+            (void)memcpy(&record, log->data + dropped_length, sizeof(record));
+            dropped_length += record.size;
+            log->dropped_count++;
+        }
+        (void)memmove(log->data, log->data + dropped_length, log->length - dropped_length);
+        log->length -= dropped_length;
+    }
+}
+
+static void ctest_quiet_log(LOG_LEVEL log_level, LOG_CONTEXT_HANDLE log_context, const char* file, const char* func, int line_no, const char* message_format, ...)
+{
+    CTEST_QUIET_LOG* log = g_current_log;
+    va_list args;
+
+    (void)log_context;
+    va_start(args, message_format);
+    if ((log != NULL) && (log->test_name != NULL) && !g_is_disabled)
+    {
+        va_list args_copy;
+        va_copy(args_copy, args);
+        int formatted_length = vsnprintf(NULL, 0, message_format, args_copy);
+        va_end(args_copy);
+        if (formatted_length >= 0)
+        {
+            CTEST_QUIET_RECORD record;
+            size_t text_size = (size_t)formatted_length + 1;
+            if (sizeof(record) + text_size > CTEST_QUIET_LOG_SIZE)
+            {
+                text_size = CTEST_QUIET_LOG_SIZE - sizeof(record);
+            }
+            ctest_quiet_make_room(log, sizeof(record) + text_size);
+
+            record.log_level = log_level;
+            record.file = file;
+            record.func = func;
+            record.line_no = line_no;
+            record.size = sizeof(record) + text_size;
+            (void)vsnprintf(log->data + log->length + sizeof(record), text_size, message_format, args);
+            (void)memcpy(log->data + log->length, &record, sizeof(record));
+            log->length += record.size;
+        }
+    }
+    else
+    {
+        char message[4096];
+        (void)vsnprintf(message, sizeof(message), message_format, args);
+        ctest_quiet_lock();
+        ctest_quiet_end_progress_line();
+        ctest_quiet_log_to_sinks(log_level, file, func, line_no, message);
+        ctest_quiet_unlock();
+    }
+    va_end(args);
+}
+
+/* writes the messages kept for the running tests, without formatting or allocating */
+static void ctest_quiet_on_crash(const CTEST_CRASH* crash)
+{
+    (void)crash;
+    for (CTEST_QUIET_LOG* log = g_logs; log != NULL; log = log->next)
+    {
+        const char* test_name = log->test_name;
+        if (test_name != NULL)
+        {
+            ctest_quiet_write_stderr("\nctest: the log of ");
+            ctest_quiet_write_stderr(test_name);
+            ctest_quiet_write_stderr(", which was running when the process crashed:\n");
+            for (size_t offset = 0; offset < log->length; )
+            {
+                CTEST_QUIET_RECORD record;
+                (void)memcpy(&record, log->data + offset, sizeof(record));
+                ctest_quiet_write_stderr(record.file);
+                ctest_quiet_write_stderr(": ");
+                ctest_quiet_write_stderr(log->data + offset + sizeof(record));
+                ctest_quiet_write_stderr("\n");
+                offset += record.size;
+            }
+        }
+    }
+}
+
+/* logs the messages kept for a test, with the lock held */
+static void ctest_quiet_log_test(const CTEST_QUIET_LOG* log)
+{
+    ctest_quiet_end_progress_line();
+    if (log->dropped_count > 0)
+    {
+        char message[128];
+        (void)snprintf(message, sizeof(message), "(%zu earlier messages of the test were dropped)", log->dropped_count);
+        ctest_quiet_log_to_sinks(LOG_LEVEL_WARNING, __FILE__, __func__, __LINE__, message);
+    }
+    for (size_t offset = 0; offset < log->length; )
+    {
+        CTEST_QUIET_RECORD record;
+        (void)memcpy(&record, log->data + offset, sizeof(record));
+        ctest_quiet_log_to_sinks(record.log_level, record.file, record.func, record.line_no, log->data + offset + sizeof(record));
+        offset += record.size;
+    }
+}
+
+static void ctest_quiet_close_at_exit(void)
+{
+    ctest_quiet_lock();
+    /* a test calling exit */
+    for (CTEST_QUIET_LOG* log = g_logs; log != NULL; log = log->next)
+    {
+        if (log->test_name != NULL)
+        {
+            char message[256];
+            (void)snprintf(message, sizeof(message), "The process exited while %s was running, the log of the test:", log->test_name);
+            ctest_quiet_end_progress_line();
+            ctest_quiet_log_to_sinks(LOG_LEVEL_ERROR, __FILE__, __func__, __LINE__, message);
+            ctest_quiet_log_test(log);
+            log->test_name = NULL;
+        }
+    }
+    ctest_quiet_end_progress_line();
+    LOGGER_CONFIG config = logger_get_config();
+    if (config.log_sinks == g_quiet_sinks)
+    {
+        logger_set_config(g_sinks_config);
+    }
+    ctest_quiet_unlock();
+    /* the process only has the thread that exits left, which is not running a test */
+    while (g_logs != NULL)
+    {
+        CTEST_QUIET_LOG* next = g_logs->next;
+        free(g_logs);
+        g_logs = next;
+    }
+    g_current_log = NULL;
+}
+
+static void ctest_quiet_open(void)
+{
+    if (ctest_config_get()->quiet != 0)
+    {
+        g_is_quiet = true;
+        g_sinks_config = logger_get_config();
+        LOGGER_CONFIG quiet_config;
+        quiet_config.log_sink_count = sizeof(g_quiet_sinks) / sizeof(g_quiet_sinks[0]);
+        quiet_config.log_sinks = g_quiet_sinks;
+        logger_set_config(quiet_config);
+        (void)atexit(ctest_quiet_close_at_exit);
+        ctest_crash_set_hook(CTEST_CRASH_HOOK_QUIET, ctest_quiet_on_crash);
+    }
+}
+
+void ctest_quiet_begin_thread(void)
+{
+    if (g_is_quiet && (g_current_log == NULL))
+    {
+        ctest_quiet_lock();
+        CTEST_QUIET_LOG* log = g_logs;
+        while ((log != NULL) && log->is_used)
+        {
+            log = log->next;
+        }
+        if (log == NULL)
+        {
+            log = malloc(sizeof(CTEST_QUIET_LOG));
+            if (log == NULL)
+            {
+                LogError("failure in malloc(%zu), the tests of the thread are not quiet", sizeof(CTEST_QUIET_LOG));
+            }
+            else
+            {
+                log->test_name = NULL;
+                log->next = g_logs;
+                g_logs = log;
+            }
+        }
+        if (log != NULL)
+        {
+            log->is_used = true;
+            g_current_log = log;
+        }
+        ctest_quiet_unlock();
+    }
+}
+
+void ctest_quiet_end_thread(void)
+{
+    CTEST_QUIET_LOG* log = g_current_log;
+    if (log != NULL)
+    {
+        ctest_quiet_lock();
+        log->is_used = false;
+        ctest_quiet_unlock();
+        g_current_log = NULL;
+    }
+}
+
+void ctest_quiet_begin_suite(void)
+{
+    if (!g_is_opened)
+    {
+        g_is_opened = true;
+        ctest_quiet_open();
+    }
+    ctest_quiet_begin_thread();
+}
+
+void ctest_quiet_end_suite(void)
+{
+    if (g_is_quiet)
+    {
+        ctest_quiet_lock();
+        ctest_quiet_end_progress_line();
+        ctest_quiet_unlock();
+    }
+}
+
+void ctest_quiet_begin_test(const TEST_FUNCTION_DATA* test_function)
+{
+    CTEST_QUIET_LOG* log = g_current_log;
+    if (log != NULL)
+    {
+        log->length = 0;
+        log->dropped_count = 0;
+        log->test_name = test_function->TestFunctionName;
+    }
+}
+
+void ctest_quiet_end_test(bool is_failed)
+{
+    CTEST_QUIET_LOG* log = g_current_log;
+    if ((log != NULL) && (log->test_name != NULL))
+    {
+        ctest_quiet_lock();
+        if (is_failed)
+        {
+            ctest_quiet_log_test(log);
+        }
+        (void)fputc(is_failed ? 'F' : '.', stdout);
+        g_progress_column++;
+        if (g_progress_column == CTEST_QUIET_PROGRESS_LINE_LENGTH)
+        {
+            (void)fputc('\n', stdout);
+            g_progress_column = 0;
+        }
+        (void)fflush(stdout);
+        ctest_quiet_unlock();
+
+        log->test_name = NULL;
+        log->length = 0;
+    }
+}
+
+void ctest_quiet_disable(void)
+{
+    g_is_disabled = 1;
+}
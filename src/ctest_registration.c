@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* The entries of a suite are either a list chained from its CTEST_END_SUITE entry (through NextTestFunctionData, ending with the
+   CTEST_BEGIN_SUITE entry), or, with CTEST_USE_SECTION_REGISTRATION, the entries of the ctest_test_data section whose
+   NextTestFunctionData is the CTEST_BEGIN_SUITE entry of the suite (see ctest.h). */
+
+#if (defined __GNUC__ || defined __clang__) && defined __ELF__
+/* defined by the linker when at least one suite uses the section, weak so that the runner links without it */
+extern const TEST_FUNCTION_DATA __start_ctest_test_data[] __attribute__((weak, visibility("hidden")));
+extern const TEST_FUNCTION_DATA __stop_ctest_test_data[] __attribute__((weak, visibility("hidden")));
+
+static const TEST_FUNCTION_DATA* ctest_registration_get_section_begin(void)
+{
+    return __start_ctest_test_data;
+}
+
+static size_t ctest_registration_get_section_entry_count(void)
+{
+    return (__start_ctest_test_data == NULL) ? 0 : (size_t)(__stop_ctest_test_data - __start_ctest_test_data);
+}
+#else
+static const TEST_FUNCTION_DATA* ctest_registration_get_section_begin(void)
+{
+    /* CTEST_REGISTRATION_USES_SECTION is never defined for these targets */
+    return NULL;
+}
+
+static size_t ctest_registration_get_section_entry_count(void)
+{
+    return 0;
+}
+#endif
+
+/* The section holds the entries of all the suites, in the order the linker placed them. The first call builds an index of the section
+   sorted by suite (then by address), so that the entries of each suite are one contiguous slice of the index, and a table of the
+   suites with their slice and their test count, found with a binary search once per suite. RunTests is not called concurrently,
+   neither is the index built concurrently. */
+typedef struct CTEST_REGISTRATION_SECTION_SUITE_TAG
+{
+    const TEST_FUNCTION_DATA* suite_begin; /* the CTEST_BEGIN_SUITE entry, NextTestFunctionData of the entries of the suite */
+    size_t begin_index;
+    size_t end_index;
+    size_t test_count;
+} CTEST_REGISTRATION_SECTION_SUITE;
+
+static const TEST_FUNCTION_DATA** g_section_index = NULL;
+static size_t g_section_index_count = 0;
+static CTEST_REGISTRATION_SECTION_SUITE* g_section_suites = NULL;
+static size_t g_section_suite_count = 0;
+static bool g_is_section_index_built = false;
+
+static int ctest_registration_compare_addresses(const void* left, const void* right)
+{
+    return ((uintptr_t)left < (uintptr_t)right) ? -1 : (((uintptr_t)left > (uintptr_t)right) ? 1 : 0);
+}
+
+static int ctest_registration_compare_section_entries(const void* left, const void* right)
+{
+    const TEST_FUNCTION_DATA* left_entry = *(const TEST_FUNCTION_DATA* const*)left;
+    const TEST_FUNCTION_DATA* right_entry = *(const TEST_FUNCTION_DATA* const*)right;
+    int result = ctest_registration_compare_addresses(left_entry->NextTestFunctionData, right_entry->NextTestFunctionData);
+    if (result == 0)
+    {
+        result = ctest_registration_compare_addresses(left_entry, right_entry);
+    }
+    return result;
+}
+
+static bool ctest_registration_is_test(const TEST_FUNCTION_DATA* entry)
+{
+    return (entry->FunctionType == CTEST_TEST_FUNCTION) || (entry->FunctionType == CTEST_BENCHMARK_FUNCTION);
+}
+
+static void ctest_registration_free_section_index(void)
+{
+    free((void*)g_section_index);
+    g_section_index = NULL;
+    g_section_index_count = 0;
+    free(g_section_suites);
+    g_section_suites = NULL;
+    g_section_suite_count = 0;
+}
+
+/* splits the sorted index in the slices of the suites */
+static bool ctest_registration_build_section_suites(void)
+{
+    bool result;
+    size_t suite_count = 0;
+    for (size_t i = 0; i < g_section_index_count; i++)
+    {
+        if ((i == 0) || (g_section_index[i]->NextTestFunctionData != g_section_index[i - 1]->NextTestFunctionData))
+        {
+            suite_count++;
+        }
+    }
+
+    g_section_suites = malloc(suite_count * sizeof(CTEST_REGISTRATION_SECTION_SUITE));
+    if (g_section_suites == NULL)
+    {
+        LogError("failure in malloc(%zu)", suite_count * sizeof(CTEST_REGISTRATION_SECTION_SUITE));
+        result = false;
+    }
+    else
+    {
+        CTEST_REGISTRATION_SECTION_SUITE* suite = NULL;
+        for (size_t i = 0; i < g_section_index_count; i++)
+        {
+            if ((suite == NULL) || (g_section_index[i]->NextTestFunctionData != suite->suite_begin))
+            {
+                suite = &g_section_suites[g_section_suite_count++];
+                suite->suite_begin = g_section_index[i]->NextTestFunctionData;
+                suite->begin_index = i;
+                suite->test_count = 0;
+            }
+            suite->end_index = i + 1;
+            if (ctest_registration_is_test(g_section_index[i]))
+            {
+                suite->test_count++;
+            }
+        }
+        result = true;
+    }
+    return result;
+}
+
+static void ctest_registration_build_section_index(void)
+{
+    if (!g_is_section_index_built)
+    {
+        size_t entry_count = ctest_registration_get_section_entry_count();
+        g_is_section_index_built = true;
+        if (entry_count > 0)
+        {
+            g_section_index = malloc(entry_count * sizeof(const TEST_FUNCTION_DATA*));
+            if (g_section_index == NULL)
+            {
+                LogError("failure in malloc(%zu), the suites registered in the section have no test", entry_count * sizeof(const TEST_FUNCTION_DATA*));
+            }
+            else
+            {
+                const TEST_FUNCTION_DATA* section_begin = ctest_registration_get_section_begin();
+                for (size_t i = 0; i < entry_count; i++)
+                {
+                    g_section_index[i] = &section_begin[i];
+                }
+                qsort((void*)g_section_index, entry_count, sizeof(const TEST_FUNCTION_DATA*), ctest_registration_compare_section_entries);
+                g_section_index_count = entry_count;
+                if (!ctest_registration_build_section_suites())
+                {
+                    LogError("the suites registered in the section have no test");
+                    g_section_index_count = 0;
+                }
+                /* freed before the leak check at exit, which was registered by the first RunTests */
+                (void)atexit(ctest_registration_free_section_index);
+            }
+        }
+    }
+}
+
+/* the suite of the table starting with suite_begin, NULL when it has no entry */
+static const CTEST_REGISTRATION_SECTION_SUITE* ctest_registration_find_section_suite(const TEST_FUNCTION_DATA* suite_begin)
+{
+    const CTEST_REGISTRATION_SECTION_SUITE* result = NULL;
+    size_t begin_index = 0;
+    size_t end_index = g_section_suite_count;
+    while (begin_index < end_index)
+    {
+        size_t middle_index = begin_index + (end_index - begin_index) / 2;
+        int compare_result = ctest_registration_compare_addresses(g_section_suites[middle_index].suite_begin, suite_begin);
+        if (compare_result == 0)
+        {
+            result = &g_section_suites[middle_index];
+            break;
+        }
+        else if (compare_result < 0)
+        {
+            begin_index = middle_index + 1;
+        }
+        else
+        {
+            end_index = middle_index;
+        }
+    }
+    return result;
+}
+
+void ctest_registration_get_suite(const TEST_FUNCTION_DATA* test_list_head, CTEST_REGISTRATION_SUITE* suite)
+{
+    suite->section_entries = NULL;
+    suite->section_entry_count = 0;
+    suite->next_index = 0;
+    if ((test_list_head->Flags & CTEST_FUNCTION_FLAG_SECTION_REGISTRATION) != 0)
+    {
+        const TEST_FUNCTION_DATA* suite_begin = test_list_head->NextTestFunctionData;
+        const CTEST_REGISTRATION_SECTION_SUITE* section_suite;
+        ctest_registration_build_section_index();
+        section_suite = ctest_registration_find_section_suite(suite_begin);
+        suite->is_in_section = true;
+        suite->first_chained_entry = NULL;
+        if (section_suite == NULL)
+        {
+            suite->test_count = 0;
+        }
+        else
+        {
+            suite->section_entries = &g_section_index[section_suite->begin_index];
+            suite->section_entry_count = section_suite->end_index - section_suite->begin_index;
+            suite->test_count = section_suite->test_count;
+        }
+        suite->suite_flags = suite_begin->Flags;
+    }
+    else
+    {
+        const TEST_FUNCTION_DATA* entry = (const TEST_FUNCTION_DATA*)test_list_head->NextTestFunctionData;
+        suite->is_in_section = false;
+        suite->first_chained_entry = (entry->TestFunction == NULL) ? NULL : entry;
+        suite->test_count = 0;
+        while (entry->TestFunction != NULL)
+        {
+            if (ctest_registration_is_test(entry))
+            {
+                suite->test_count++;
+            }
+            entry = (const TEST_FUNCTION_DATA*)entry->NextTestFunctionData;
+        }
+        /* the walk stops at the CTEST_BEGIN_SUITE entry, which carries the suite flags */
+        suite->suite_flags = entry->Flags;
+    }
+}
+
+const TEST_FUNCTION_DATA* ctest_registration_get_first_entry(CTEST_REGISTRATION_SUITE* suite)
+{
+    const TEST_FUNCTION_DATA* result;
+    if (suite->is_in_section)
+    {
+        suite->next_index = 1;
+        result = (suite->section_entry_count > 0) ? suite->section_entries[0] : NULL;
+    }
+    else
+    {
+        result = suite->first_chained_entry;
+    }
+    return result;
+}
+
+const TEST_FUNCTION_DATA* ctest_registration_get_next_entry(CTEST_REGISTRATION_SUITE* suite, const TEST_FUNCTION_DATA* entry)
+{
+    const TEST_FUNCTION_DATA* result;
+    if (suite->is_in_section)
+    {
+        /* entry is the one returned last, the next one is the next of the slice */
+        result = (suite->next_index < suite->section_entry_count) ? suite->section_entries[suite->next_index++] : NULL;
+    }
+    else
+    {
+        result = (const TEST_FUNCTION_DATA*)entry->NextTestFunctionData;
+        if (result->TestFunction == NULL)
+        {
+            result = NULL;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,741 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#include <io.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+/* Each report is one file for the whole process, opened by the first RunTests. The tests are formatted into a buffer as they complete
+   and the buffer is written when it holds CTEST_REPORT_WRITE_SIZE bytes and at the end of each suite. Every write is followed by the
+   end of the document (the end of the running suite and of the document), after which the file position is set back, so that the
+   next write overwrites it: the file is a complete document whenever it is not being written, even when the process is killed.
+   When the process crashes (SIGSEGV, SIGABRT...), times out or exits in the middle of a suite, what is buffered is written with the
+   running tests reported as interrupted. The signal handler can neither lock nor format, so the end of the document for a crash is
+   formatted beforehand from the list of the running tests (kept as they start and end, not by going through the suite), each time it
+   changes, and the handler only writes it with write(2), putting the number of the signal in place of CTEST_REPORT_SIGNAL_MARKER. */
+
+#define CTEST_REPORT_WRITE_SIZE (1024 * 1024)
+/* what completes the document when the process is interrupted is formatted without allocating, in a buffer of this size */
+#define CTEST_REPORT_TAIL_SIZE (64 * 1024)
+/* in the reason of the crash tail, replaced by the signal number when it is written. Nothing in it is escaped by the reporters */
+#define CTEST_REPORT_SIGNAL_MARKER "CTEST_REPORT_SIGNAL_NUMBER"
+#define CTEST_REPORT_SIGNAL_MARKER_LENGTH (sizeof(CTEST_REPORT_SIGNAL_MARKER) - 1)
+
+typedef struct CTEST_REPORT_OUTPUT_TAG
+{
+    const CTEST_REPORTER* reporter;
+    FILE* file;
+    const char* path;
+    CTEST_REPORT_BUFFER buffer; /* formatted, not written yet */
+    CTEST_REPORT_BUFFER tail; /* the end of the document */
+    size_t suite_count;
+    size_t test_count;
+    size_t suite_test_count;
+    size_t suite_failed_test_count;
+    bool is_write_failed;
+    int fd; /* of file, for the signal handler */
+    /* the end of the document after a crash, twice: the one the signal handler writes and the one being formatted */
+    CTEST_REPORT_BUFFER crash_tails[2];
+} CTEST_REPORT_OUTPUT;
+
+static CTEST_REPORT_OUTPUT g_outputs[] =
+{
+    { &ctest_report_junit, NULL, NULL, { NULL, 0, 0, true }, { NULL, 0, 0, false }, 0, 0, 0, 0, false, -1, { { NULL, 0, 0, false } } },
+    { &ctest_report_tap, NULL, NULL, { NULL, 0, 0, true }, { NULL, 0, 0, false }, 0, 0, 0, 0, false, -1, { { NULL, 0, 0, false } } },
+    { &ctest_report_json, NULL, NULL, { NULL, 0, 0, true }, { NULL, 0, 0, false }, 0, 0, 0, 0, false, -1, { { NULL, 0, 0, false } } }
+};
+
+#define CTEST_REPORT_OUTPUT_COUNT (sizeof(g_outputs) / sizeof(g_outputs[0]))
+
+static bool g_is_opened = false;
+static size_t g_open_output_count = 0;
+/* the suite being reported, NULL between suites */
+static const CTEST_SUITE_RUN* volatile g_suite_run = NULL;
+static volatile int g_is_interrupted = 0;
+/* the crash tail of the outputs that is complete */
+static volatile int g_crash_tail_set = 0;
+/* the tests of g_suite_run that started and were not reported yet, in the order they started. Allocated for all the tests of the
+   suite, so that it does not move while the suite runs (ctest_report_interrupt reads it without the lock) */
+static const CTEST_TEST_RUN** g_running_tests = NULL;
+static size_t g_running_test_count = 0;
+static size_t g_running_test_capacity = 0;
+
+#if defined _MSC_VER
+static SRWLOCK g_lock = SRWLOCK_INIT;
+
+static void ctest_report_lock(void)
+{
+    AcquireSRWLockExclusive(&g_lock);
+}
+
+static void ctest_report_unlock(void)
+{
+    ReleaseSRWLockExclusive(&g_lock);
+}
+
+static FILE* ctest_report_open_file(const char* path)
+{
+    FILE* result;
+    if (fopen_s(&result, path, "wb") != 0)
+    {
+        result = NULL;
+    }
+    return result;
+}
+
+static bool ctest_report_is_reporting_process(void)
+{
+    return true;
+}
+
+static int ctest_report_get_fd(FILE* file)
+{
+    return _fileno(file);
+}
+
+/* called from signal handlers */
+static void ctest_report_write_fd(int fd, const char* data, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        int result = _write(fd, data + written, (unsigned int)(size - written));
+        if (result <= 0)
+        {
+            break;
+        }
+        written += (size_t)result;
+    }
+}
+
+static void ctest_report_set_reporting_process(void)
+{
+}
+#else
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+/* the forked worker processes (CTEST_WORKER_PROCESSES) share the files, their tests are reported by the parent */
+static pid_t g_reporting_pid;
+
+static void ctest_report_lock(void)
+{
+    (void)pthread_mutex_lock(&g_lock);
+}
+
+static void ctest_report_unlock(void)
+{
+    (void)pthread_mutex_unlock(&g_lock);
+}
+
+static FILE* ctest_report_open_file(const char* path)
+{
+    return fopen(path, "wb");
+}
+
+static bool ctest_report_is_reporting_process(void)
+{
+    return (getpid() == g_reporting_pid);
+}
+
+static void ctest_report_set_reporting_process(void)
+{
+    g_reporting_pid = getpid();
+}
+
+static int ctest_report_get_fd(FILE* file)
+{
+    return fileno(file);
+}
+
+/* called from signal handlers */
+static void ctest_report_write_fd(int fd, const char* data, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        ssize_t result = write(fd, data + written, size - written);
+        if (result < 0)
+        {
+            if (errno != EINTR)
+            {
+                break;
+            }
+        }
+        else
+        {
+            written += (size_t)result;
+        }
+    }
+}
+#endif
+
+static bool ctest_report_buffer_reserve(CTEST_REPORT_BUFFER* buffer, size_t size)
+{
+    bool result;
+    if (buffer->length + size < buffer->capacity)
+    {
+        result = true;
+    }
+    else if (!buffer->can_grow)
+    {
+        result = false;
+    }
+    else
+    {
+        size_t new_capacity = (buffer->capacity == 0) ? 4096 : buffer->capacity * 2;
+        if (new_capacity <= buffer->length + size)
+        {
+            new_capacity = buffer->length + size + 1;
+        }
+        char* new_data = realloc(buffer->data, new_capacity);
+        if (new_data == NULL)
+        {
+            LogError("failure in realloc(%zu) for a test report", new_capacity);
+            result = false;
+        }
+        else
+        {
+            buffer->data = new_data;
+            buffer->capacity = new_capacity;
+            result = true;
+        }
+    }
+    return result;
+}
+
+/* what fits when the buffer cannot hold size more bytes */
+static size_t ctest_report_buffer_get_fitting_size(CTEST_REPORT_BUFFER* buffer, size_t size)
+{
+    size_t result;
+    if (ctest_report_buffer_reserve(buffer, size))
+    {
+        result = size;
+    }
+    else
+    {
+        result = (buffer->capacity > buffer->length) ? buffer->capacity - buffer->length - 1 : 0;
+    }
+    return result;
+}
+
+void ctest_report_buffer_append(CTEST_REPORT_BUFFER* buffer, const char* text)
+{
+    size_t size = ctest_report_buffer_get_fitting_size(buffer, strlen(text));
+    (void)memcpy(buffer->data + buffer->length, text, size);
+    buffer->length += size;
+}
+
+void ctest_report_buffer_append_format(CTEST_REPORT_BUFFER* buffer, const char* format, ...)
+{
+    va_list args;
+    int formatted_length;
+
+    va_start(args, format);
+    formatted_length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (formatted_length > 0)
+    {
+        size_t size = ctest_report_buffer_get_fitting_size(buffer, (size_t)formatted_length);
+        if (size > 0)
+        {
+            va_start(args, format);
+            (void)vsnprintf(buffer->data + buffer->length, size + 1, format, args);
+            va_end(args);
+            buffer->length += size;
+        }
+    }
+}
+
+static void ctest_report_buffer_append_char(CTEST_REPORT_BUFFER* buffer, char c)
+{
+    if (ctest_report_buffer_get_fitting_size(buffer, 1) == 1)
+    {
+        buffer->data[buffer->length++] = c;
+    }
+}
+
+void ctest_report_buffer_append_xml_escaped(CTEST_REPORT_BUFFER* buffer, const char* text)
+{
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        switch (*c)
+        {
+        case '&': ctest_report_buffer_append(buffer, "&amp;"); break;
+        case '<': ctest_report_buffer_append(buffer, "&lt;"); break;
+        case '>': ctest_report_buffer_append(buffer, "&gt;"); break;
+        case '"': ctest_report_buffer_append(buffer, "&quot;"); break;
+        case '\'': ctest_report_buffer_append(buffer, "&apos;"); break;
+        default:
+            /* the other control characters are not allowed in XML 1.0 */
+            if (((unsigned char)*c >= 0x20) || (*c == '\t') || (*c == '\n') || (*c == '\r'))
+            {
+                ctest_report_buffer_append_char(buffer, *c);
+            }
+            break;
+        }
+    }
+}
+
+void ctest_report_buffer_append_json_escaped(CTEST_REPORT_BUFFER* buffer, const char* text)
+{
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        switch (*c)
+        {
+        case '"': ctest_report_buffer_append(buffer, "\\\""); break;
+        case '\\': ctest_report_buffer_append(buffer, "\\\\"); break;
+        case '\n': ctest_report_buffer_append(buffer, "\\n"); break;
+        case '\r': ctest_report_buffer_append(buffer, "\\r"); break;
+        case '\t': ctest_report_buffer_append(buffer, "\\t"); break;
+        default:
+            if ((unsigned char)*c < 0x20)
+            {
+                ctest_report_buffer_append_format(buffer, "\\u%04x", (unsigned int)(unsigned char)*c);
+            }
+            else
+            {
+                ctest_report_buffer_append_char(buffer, *c);
+            }
+            break;
+        }
+    }
+}
+
+static bool ctest_report_write_buffer(CTEST_REPORT_OUTPUT* output, const CTEST_REPORT_BUFFER* buffer)
+{
+    return (buffer->length == 0) || (fwrite(buffer->data, 1, buffer->length, output->file) == buffer->length);
+}
+
+/* the end of the running suite (interrupted by reason, with the tests still running when there are) and of the document, in tail */
+static void ctest_report_format_tail(CTEST_REPORT_OUTPUT* output, CTEST_REPORT_BUFFER* tail, const char* reason, const CTEST_TEST_RUN* const* running_tests, size_t running_test_count)
+{
+    const CTEST_SUITE_RUN* suite_run = g_suite_run;
+    size_t test_count = output->test_count;
+
+    tail->length = 0;
+    if (suite_run != NULL)
+    {
+        CTEST_REPORT_SUMMARY summary;
+        size_t executed_test_count = output->suite_test_count;
+        size_t failed_test_count = output->suite_failed_test_count;
+
+        for (size_t i = 0; i < running_test_count; i++)
+        {
+            CTEST_REPORT_TEST test;
+            (void)memset(&test, 0, sizeof(test));
+            test.suite_name = suite_run->test_suite_name;
+            test.test_name = running_tests[i]->test_function->TestFunctionName;
+            test.status = CTEST_REPORT_INTERRUPTED;
+            test.message = reason;
+            output->reporter->add_test(tail, &test, executed_test_count, test_count + 1);
+            executed_test_count++;
+            failed_test_count++;
+            test_count++;
+        }
+
+        summary.suite_name = suite_run->test_suite_name;
+        summary.executed_test_count = executed_test_count;
+        summary.failed_test_count = failed_test_count;
+        summary.skipped_test_count = 0;
+        summary.interrupt_reason = reason;
+        output->reporter->end_suite(tail, &summary);
+    }
+    output->reporter->end_document(tail, test_count);
+}
+
+/* formats the crash tails of the outputs in the set the signal handler does not write, then makes it the one it writes. Called with
+   the lock held, whenever the running tests or the reported ones change. Only the running tests are formatted, not the suite */
+static void ctest_report_format_crash_tails(void)
+{
+    if (!g_is_interrupted)
+    {
+        int crash_tail_set = 1 - g_crash_tail_set;
+        for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+        {
+            CTEST_REPORT_OUTPUT* output = &g_outputs[i];
+            if ((output->file != NULL) && !output->is_write_failed)
+            {
+                ctest_report_format_tail(output, &output->crash_tails[crash_tail_set], "the process crashed with signal " CTEST_REPORT_SIGNAL_MARKER,
+                    g_running_tests, g_running_test_count);
+            }
+        }
+        g_crash_tail_set = crash_tail_set;
+    }
+}
+
+/* called from the signal handler: writes the crash tail with the number of the signal in place of the markers */
+static void ctest_report_write_crash_tail(int fd, const CTEST_REPORT_BUFFER* tail, int signal_number)
+{
+    char signal_text[16];
+    size_t signal_text_length = 0;
+    char digits[16];
+    size_t digit_count = 0;
+    unsigned int value = (signal_number < 0) ? 0U : (unsigned int)signal_number;
+    do
+    {
+        digits[digit_count++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+    while (digit_count > 0)
+    {
+        signal_text[signal_text_length++] = digits[--digit_count];
+    }
+
+    size_t written = 0;
+    for (size_t i = 0; i + CTEST_REPORT_SIGNAL_MARKER_LENGTH <= tail->length; i++)
+    {
+        if (memcmp(tail->data + i, CTEST_REPORT_SIGNAL_MARKER, CTEST_REPORT_SIGNAL_MARKER_LENGTH) == 0)
+        {
+            ctest_report_write_fd(fd, tail->data + written, i - written);
+            ctest_report_write_fd(fd, signal_text, signal_text_length);
+            i += CTEST_REPORT_SIGNAL_MARKER_LENGTH - 1;
+            written = i + 1;
+        }
+    }
+    ctest_report_write_fd(fd, tail->data + written, tail->length - written);
+}
+
+/* writes what is buffered followed by the end of the document, which the next write overwrites */
+static void ctest_report_write(CTEST_REPORT_OUTPUT* output)
+{
+    if (!output->is_write_failed)
+    {
+        long position;
+
+        ctest_report_format_tail(output, &output->tail, "the test run ended before the end of the suite", NULL, 0);
+        if (!ctest_report_write_buffer(output, &output->buffer) ||
+            ((position = ftell(output->file)) < 0) ||
+            !ctest_report_write_buffer(output, &output->tail) ||
+            (fflush(output->file) != 0) ||
+            (fseek(output->file, position, SEEK_SET) != 0))
+        {
+            LogError("failure writing the %s report %s, it is not written any more", output->reporter->name, output->path);
+            output->is_write_failed = true;
+        }
+    }
+    output->buffer.length = 0;
+}
+
+static void ctest_report_add_test(CTEST_REPORT_OUTPUT* output, const CTEST_REPORT_TEST* test)
+{
+    output->reporter->add_test(&output->buffer, test, output->suite_test_count, output->test_count + 1);
+    output->suite_test_count++;
+    output->test_count++;
+    if (test->status != CTEST_REPORT_PASSED)
+    {
+        output->suite_failed_test_count++;
+    }
+    if (output->buffer.length >= CTEST_REPORT_WRITE_SIZE)
+    {
+        ctest_report_write(output);
+    }
+}
+
+static void ctest_report_close_at_exit(void)
+{
+    if (g_suite_run != NULL)
+    {
+        /* exit in the middle of a suite */
+        ctest_report_interrupt("the process exited");
+    }
+
+    for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+    {
+        CTEST_REPORT_OUTPUT* output = &g_outputs[i];
+        if (output->file != NULL)
+        {
+            if (fclose(output->file) != 0)
+            {
+                (void)fprintf(stderr, "ctest: failure closing the %s report %s\n", output->reporter->name, output->path);
+            }
+            output->file = NULL;
+            free(output->buffer.data);
+            output->buffer.data = NULL;
+            free(output->tail.data);
+            output->tail.data = NULL;
+            for (size_t j = 0; j < 2; j++)
+            {
+                free(output->crash_tails[j].data);
+                output->crash_tails[j].data = NULL;
+            }
+        }
+    }
+    g_open_output_count = 0;
+    free((void*)g_running_tests);
+    g_running_tests = NULL;
+    g_running_test_count = 0;
+    g_running_test_capacity = 0;
+}
+
+static void ctest_report_on_crash(const CTEST_CRASH* crash)
+{
+    /* no lock (the crashed thread may hold it), no formatting and no allocation: what is buffered and the crash tail formatted
+       beforehand are written as they are. The file has nothing buffered, every write of the reports is flushed */
+    if ((g_open_output_count > 0) && !g_is_interrupted && ctest_report_is_reporting_process())
+    {
+        g_is_interrupted = 1;
+        for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+        {
+            CTEST_REPORT_OUTPUT* output = &g_outputs[i];
+            if ((output->file != NULL) && !output->is_write_failed)
+            {
+                ctest_report_write_fd(output->fd, output->buffer.data, output->buffer.length);
+                ctest_report_write_crash_tail(output->fd, &output->crash_tails[g_crash_tail_set], crash->signal_number);
+                output->is_write_failed = true;
+            }
+        }
+    }
+}
+
+static void ctest_report_open(void)
+{
+    const CTEST_CONFIG* config = ctest_config_get();
+    const char* paths[CTEST_REPORT_OUTPUT_COUNT] = { config->report_junit_path, config->report_tap_path, config->report_json_path };
+
+    for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+    {
+        CTEST_REPORT_OUTPUT* output = &g_outputs[i];
+        if (paths[i][0] != '\0')
+        {
+            output->path = paths[i];
+            output->tail.data = malloc(CTEST_REPORT_TAIL_SIZE);
+            if (output->tail.data == NULL)
+            {
+                LogError("failure in malloc(%d), the %s report %s is not written", CTEST_REPORT_TAIL_SIZE, output->reporter->name, output->path);
+            }
+            else if ((output->file = ctest_report_open_file(output->path)) == NULL)
+            {
+                LogError("failure opening %s, the %s report is not written", output->path, output->reporter->name);
+                free(output->tail.data);
+                output->tail.data = NULL;
+            }
+            else
+            {
+                output->fd = ctest_report_get_fd(output->file);
+                output->tail.capacity = CTEST_REPORT_TAIL_SIZE;
+                output->crash_tails[0].can_grow = true;
+                output->crash_tails[1].can_grow = true;
+                output->reporter->begin_document(&output->buffer);
+                g_open_output_count++;
+            }
+        }
+    }
+
+    if (g_open_output_count > 0)
+    {
+        ctest_report_set_reporting_process();
+        (void)atexit(ctest_report_close_at_exit);
+        ctest_crash_set_hook(CTEST_CRASH_HOOK_REPORT, ctest_report_on_crash);
+    }
+}
+
+void ctest_report_begin_suite(const CTEST_SUITE_RUN* suite_run)
+{
+    if (!g_is_opened)
+    {
+        g_is_opened = true;
+        ctest_report_open();
+    }
+
+    if ((g_open_output_count > 0) && ctest_report_is_reporting_process())
+    {
+        ctest_report_lock();
+        g_suite_run = suite_run;
+        g_running_test_count = 0;
+        if (suite_run->test_count > g_running_test_capacity)
+        {
+            const CTEST_TEST_RUN** running_tests = realloc((void*)g_running_tests, suite_run->test_count * sizeof(const CTEST_TEST_RUN*));
+            if (running_tests == NULL)
+            {
+                LogError("failure in realloc(%zu), the running tests are not reported after a crash", suite_run->test_count * sizeof(const CTEST_TEST_RUN*));
+            }
+            else
+            {
+                g_running_tests = running_tests;
+                g_running_test_capacity = suite_run->test_count;
+            }
+        }
+        for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+        {
+            CTEST_REPORT_OUTPUT* output = &g_outputs[i];
+            if (output->file != NULL)
+            {
+                output->reporter->begin_suite(&output->buffer, suite_run->test_suite_name, output->suite_count);
+                output->suite_count++;
+                output->suite_test_count = 0;
+                output->suite_failed_test_count = 0;
+            }
+        }
+        ctest_report_format_crash_tails();
+        ctest_report_unlock();
+    }
+}
+
+void ctest_report_begin_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run)
+{
+    (void)suite_run;
+    if ((g_open_output_count > 0) && ctest_report_is_reporting_process())
+    {
+        ctest_report_lock();
+        if (g_running_test_count < g_running_test_capacity)
+        {
+            g_running_tests[g_running_test_count] = test_run;
+            g_running_test_count++;
+            ctest_report_format_crash_tails();
+        }
+        ctest_report_unlock();
+    }
+}
+
+/* with the lock held. The running tests are few (one per worker thread or process) */
+static void ctest_report_remove_running_test(const CTEST_TEST_RUN* test_run)
+{
+    for (size_t i = 0; i < g_running_test_count; i++)
+    {
+        if (g_running_tests[i] == test_run)
+        {
+            (void)memmove((void*)&g_running_tests[i], &g_running_tests[i + 1], (g_running_test_count - i - 1) * sizeof(const CTEST_TEST_RUN*));
+            g_running_test_count--;
+            break;
+        }
+    }
+}
+
+static void ctest_report_make_test(CTEST_REPORT_TEST* test, const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run, const char* message)
+{
+    TEST_RESULT test_result = *test_run->test_function->TestResult;
+
+    test->suite_name = suite_run->test_suite_name;
+    test->test_name = test_run->test_function->TestFunctionName;
+    if (test_result == TEST_SUCCESS)
+    {
+        test->status = CTEST_REPORT_PASSED;
+        test->message = message;
+    }
+    else if (test_result == TEST_NOT_EXECUTED)
+    {
+        test->status = CTEST_REPORT_NOT_EXECUTED;
+        test->message = (message == NULL) ? "not executed" : message;
+    }
+    else
+    {
+        test->status = CTEST_REPORT_FAILED;
+        test->message = (message == NULL) ? "failed" : message;
+    }
+    test->output = test_run->captured_output;
+    test->test_timing = test_run->test_timing;
+    test->fixture_timing = test_run->fixture_timing;
+}
+
+void ctest_report_test(const CTEST_SUITE_RUN* suite_run, const CTEST_TEST_RUN* test_run, const char* message)
+{
+    if ((g_open_output_count > 0) && ctest_report_is_reporting_process())
+    {
+        CTEST_REPORT_TEST test;
+        ctest_report_make_test(&test, suite_run, test_run, message);
+
+        ctest_report_lock();
+        for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+        {
+            if (g_outputs[i].file != NULL)
+            {
+                ctest_report_add_test(&g_outputs[i], &test);
+            }
+        }
+        ctest_report_remove_running_test(test_run);
+        ctest_report_format_crash_tails();
+        ctest_report_unlock();
+    }
+}
+
+void ctest_report_end_suite(const CTEST_SUITE_RUN* suite_run, size_t executed_test_count, size_t failed_test_count, size_t skipped_test_count)
+{
+    if ((g_open_output_count > 0) && ctest_report_is_reporting_process())
+    {
+        CTEST_REPORT_SUMMARY summary;
+        summary.suite_name = suite_run->test_suite_name;
+        summary.executed_test_count = executed_test_count;
+        summary.failed_test_count = failed_test_count;
+        summary.skipped_test_count = skipped_test_count;
+        summary.interrupt_reason = NULL;
+
+        ctest_report_lock();
+        for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+        {
+            CTEST_REPORT_OUTPUT* output = &g_outputs[i];
+            if (output->file != NULL)
+            {
+                /* selected tests that never started: a failed TEST_SUITE_INITIALIZE, a suite timeout */
+                for (size_t j = 0; j < suite_run->test_count; j++)
+                {
+                    const CTEST_TEST_RUN* test_run = &suite_run->tests[j];
+                    if (test_run->is_selected && (test_run->state == CTEST_TEST_RUN_PENDING))
+                    {
+                        CTEST_REPORT_TEST test;
+                        ctest_report_make_test(&test, suite_run, test_run, NULL);
+                        test.status = CTEST_REPORT_NOT_EXECUTED;
+                        test.message = "not executed";
+                        ctest_report_add_test(output, &test);
+                    }
+                }
+                output->reporter->end_suite(&output->buffer, &summary);
+            }
+        }
+        g_suite_run = NULL;
+        g_running_test_count = 0;
+        for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+        {
+            if (g_outputs[i].file != NULL)
+            {
+                ctest_report_write(&g_outputs[i]);
+            }
+        }
+        ctest_report_format_crash_tails();
+        ctest_report_unlock();
+    }
+}
+
+void ctest_report_interrupt(const char* reason)
+{
+    /* also called from the watchdog while a test hangs: no lock (the hung test may hold it) and no allocation */
+    if ((g_open_output_count > 0) && !g_is_interrupted && ctest_report_is_reporting_process())
+    {
+        g_is_interrupted = 1;
+        for (size_t i = 0; i < CTEST_REPORT_OUTPUT_COUNT; i++)
+        {
+            CTEST_REPORT_OUTPUT* output = &g_outputs[i];
+            if ((output->file != NULL) && !output->is_write_failed)
+            {
+                output->buffer.can_grow = false;
+                ctest_report_format_tail(output, &output->tail, reason, g_running_tests, g_running_test_count);
+                (void)ctest_report_write_buffer(output, &output->buffer);
+                (void)ctest_report_write_buffer(output, &output->tail);
+                (void)fflush(output->file);
+                output->buffer.length = 0;
+                /* nothing is reported any more */
+                output->is_write_failed = true;
+            }
+        }
+        g_suite_run = NULL;
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* JSON: { "ctest_report_version": 1, "suites": [ { "name", "tests": [ { "name", "result", "message", "output", times in ms } ], "summary" } ] }
+   with one test per line. result is "passed", "failed", "not_executed" or "interrupted" (the process ended during the test), the
+   summary of a suite that did not complete has "interrupted" with the reason. */
+
+#define CTEST_REPORT_JSON_VERSION 1
+
+static void ctest_report_json_begin_document(CTEST_REPORT_BUFFER* buffer)
+{
+    ctest_report_buffer_append_format(buffer, "{\n  \"ctest_report_version\": %d,\n  \"suites\": [", CTEST_REPORT_JSON_VERSION);
+}
+
+static void ctest_report_json_begin_suite(CTEST_REPORT_BUFFER* buffer, const char* suite_name, size_t suite_index)
+{
+    ctest_report_buffer_append(buffer, (suite_index == 0) ? "\n    {\n      \"name\": \"" : ",\n    {\n      \"name\": \"");
+    ctest_report_buffer_append_json_escaped(buffer, suite_name);
+    ctest_report_buffer_append(buffer, "\",\n      \"tests\": [");
+}
+
+static const char* ctest_report_json_get_result(CTEST_REPORT_STATUS status)
+{
+    const char* result;
+    switch (status)
+    {
+    case CTEST_REPORT_PASSED: result = "passed"; break;
+    case CTEST_REPORT_FAILED: result = "failed"; break;
+    case CTEST_REPORT_NOT_EXECUTED: result = "not_executed"; break;
+    default: result = "interrupted"; break;
+    }
+    return result;
+}
+
+static void ctest_report_json_add_test(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_TEST* test, size_t test_index, size_t test_number)
+{
+    (void)test_number;
+    ctest_report_buffer_append(buffer, (test_index == 0) ? "\n        { \"name\": \"" : ",\n        { \"name\": \"");
+    ctest_report_buffer_append_json_escaped(buffer, test->test_name);
+    ctest_report_buffer_append_format(buffer, "\", \"result\": \"%s\"", ctest_report_json_get_result(test->status));
+    if (test->message != NULL)
+    {
+        ctest_report_buffer_append(buffer, ", \"message\": \"");
+        ctest_report_buffer_append_json_escaped(buffer, test->message);
+        ctest_report_buffer_append(buffer, "\"");
+    }
+    if (test->output != NULL)
+    {
+        ctest_report_buffer_append(buffer, ", \"output\": \"");
+        ctest_report_buffer_append_json_escaped(buffer, test->output);
+        ctest_report_buffer_append(buffer, "\"");
+    }
+    ctest_report_buffer_append_format(buffer, ", \"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"fixture_wall_ms\": %.3f, \"fixture_cpu_ms\": %.3f }",
+        CTEST_TIMING_NS_TO_MS(test->test_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test->test_timing.cpu_ns),
+        CTEST_TIMING_NS_TO_MS(test->fixture_timing.wall_ns), CTEST_TIMING_NS_TO_MS(test->fixture_timing.cpu_ns));
+}
+
+static void ctest_report_json_end_suite(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_SUMMARY* summary)
+{
+    ctest_report_buffer_append_format(buffer, "\n      ],\n      \"summary\": { \"executed\": %zu, \"failed\": %zu, \"skipped\": %zu",
+        summary->executed_test_count, summary->failed_test_count, summary->skipped_test_count);
+    if (summary->interrupt_reason != NULL)
+    {
+        ctest_report_buffer_append(buffer, ", \"interrupted\": \"");
+        ctest_report_buffer_append_json_escaped(buffer, summary->interrupt_reason);
+        ctest_report_buffer_append(buffer, "\"");
+    }
+    ctest_report_buffer_append(buffer, " }\n    }");
+}
+
+static void ctest_report_json_end_document(CTEST_REPORT_BUFFER* buffer, size_t test_count)
+{
+    (void)test_count;
+    ctest_report_buffer_append(buffer, "\n  ]\n}\n");
+}
+
+const CTEST_REPORTER ctest_report_json =
+{
+    "JSON",
+    ctest_report_json_begin_document,
+    ctest_report_json_begin_suite,
+    ctest_report_json_add_test,
+    ctest_report_json_end_suite,
+    ctest_report_json_end_document
+};
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* JUnit XML: a <testsuite> per suite in <testsuites>, a <testcase> per test with its time in seconds, a failed one with its captured
+   output in <system-out>. The counts are only known at the end of the suite, they are in its <system-out> rather than in attributes
+   of <testsuite>, readers count the test cases. */
+
+static void ctest_report_junit_begin_document(CTEST_REPORT_BUFFER* buffer)
+{
+    ctest_report_buffer_append(buffer, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n");
+}
+
+static void ctest_report_junit_begin_suite(CTEST_REPORT_BUFFER* buffer, const char* suite_name, size_t suite_index)
+{
+    (void)suite_index;
+    ctest_report_buffer_append(buffer, "  <testsuite name=\"");
+    ctest_report_buffer_append_xml_escaped(buffer, suite_name);
+    ctest_report_buffer_append(buffer, "\">\n");
+}
+
+static void ctest_report_junit_add_test(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_TEST* test, size_t test_index, size_t test_number)
+{
+    (void)test_index;
+    (void)test_number;
+    ctest_report_buffer_append(buffer, "    <testcase classname=\"");
+    ctest_report_buffer_append_xml_escaped(buffer, test->suite_name);
+    ctest_report_buffer_append(buffer, "\" name=\"");
+    ctest_report_buffer_append_xml_escaped(buffer, test->test_name);
+    ctest_report_buffer_append_format(buffer, "\" time=\"%.6f\"", (double)(test->test_timing.wall_ns + test->fixture_timing.wall_ns) / 1000000000.0);
+    if (test->status == CTEST_REPORT_PASSED)
+    {
+        ctest_report_buffer_append(buffer, "/>\n");
+    }
+    else
+    {
+        /* an interrupted test did not end, that is an error rather than a failed assert */
+        ctest_report_buffer_append(buffer, (test->status == CTEST_REPORT_INTERRUPTED) ? ">\n      <error message=\"" : ">\n      <failure message=\"");
+        ctest_report_buffer_append_xml_escaped(buffer, test->message);
+        ctest_report_buffer_append(buffer, "\"/>\n");
+        if (test->output != NULL)
+        {
+            ctest_report_buffer_append(buffer, "      <system-out>");
+            ctest_report_buffer_append_xml_escaped(buffer, test->output);
+            ctest_report_buffer_append(buffer, "</system-out>\n");
+        }
+        ctest_report_buffer_append(buffer, "    </testcase>\n");
+    }
+}
+
+static void ctest_report_junit_end_suite(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_SUMMARY* summary)
+{
+    ctest_report_buffer_append_format(buffer, "    <system-out>%zu tests ran, %zu failed, %zu succeeded, %zu skipped.",
+        summary->executed_test_count, summary->failed_test_count,
+        (summary->failed_test_count < summary->executed_test_count) ? summary->executed_test_count - summary->failed_test_count : 0,
+        summary->skipped_test_count);
+    if (summary->interrupt_reason != NULL)
+    {
+        ctest_report_buffer_append(buffer, " Interrupted: ");
+        ctest_report_buffer_append_xml_escaped(buffer, summary->interrupt_reason);
+    }
+    ctest_report_buffer_append(buffer, "</system-out>\n  </testsuite>\n");
+}
+
+static void ctest_report_junit_end_document(CTEST_REPORT_BUFFER* buffer, size_t test_count)
+{
+    (void)test_count;
+    ctest_report_buffer_append(buffer, "</testsuites>\n");
+}
+
+const CTEST_REPORTER ctest_report_junit =
+{
+    "JUnit",
+    ctest_report_junit_begin_document,
+    ctest_report_junit_begin_suite,
+    ctest_report_junit_add_test,
+    ctest_report_junit_end_suite,
+    ctest_report_junit_end_document
+};
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+/* TAP version 13: a test point per test, named suite.test, with a YAML block holding its duration, the reason it failed and its
+   captured output. The suites are comments and the plan comes last, once the number of tests is known. */
+
+static void ctest_report_tap_begin_document(CTEST_REPORT_BUFFER* buffer)
+{
+    ctest_report_buffer_append(buffer, "TAP version 13\n");
+}
+
+static void ctest_report_tap_begin_suite(CTEST_REPORT_BUFFER* buffer, const char* suite_name, size_t suite_index)
+{
+    (void)suite_index;
+    ctest_report_buffer_append_format(buffer, "# Suite %s\n", suite_name);
+}
+
+static void ctest_report_tap_add_test(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_TEST* test, size_t test_index, size_t test_number)
+{
+    (void)test_index;
+    ctest_report_buffer_append_format(buffer, "%s %zu - %s.%s\n  ---\n  duration_ms: %.3f\n",
+        (test->status == CTEST_REPORT_PASSED) ? "ok" : "not ok", test_number, test->suite_name, test->test_name,
+        CTEST_TIMING_NS_TO_MS(test->test_timing.wall_ns + test->fixture_timing.wall_ns));
+    if (test->message != NULL)
+    {
+        /* a YAML double quoted scalar takes the JSON escapes */
+        ctest_report_buffer_append(buffer, "  message: \"");
+        ctest_report_buffer_append_json_escaped(buffer, test->message);
+        ctest_report_buffer_append(buffer, "\"\n");
+    }
+    if (test->output != NULL)
+    {
+        ctest_report_buffer_append(buffer, "  output: \"");
+        ctest_report_buffer_append_json_escaped(buffer, test->output);
+        ctest_report_buffer_append(buffer, "\"\n");
+    }
+    ctest_report_buffer_append(buffer, "  ...\n");
+}
+
+static void ctest_report_tap_end_suite(CTEST_REPORT_BUFFER* buffer, const CTEST_REPORT_SUMMARY* summary)
+{
+    ctest_report_buffer_append_format(buffer, "# Suite %s: %zu tests ran, %zu failed, %zu succeeded, %zu skipped.", summary->suite_name,
+        summary->executed_test_count, summary->failed_test_count,
+        (summary->failed_test_count < summary->executed_test_count) ? summary->executed_test_count - summary->failed_test_count : 0,
+        summary->skipped_test_count);
+    if (summary->interrupt_reason != NULL)
+    {
+        ctest_report_buffer_append_format(buffer, " Interrupted: %s", summary->interrupt_reason);
+    }
+    ctest_report_buffer_append(buffer, "\n");
+}
+
+static void ctest_report_tap_end_document(CTEST_REPORT_BUFFER* buffer, size_t test_count)
+{
+    ctest_report_buffer_append_format(buffer, "1..%zu\n", test_count);
+}
+
+const CTEST_REPORTER ctest_report_tap =
+{
+    "TAP",
+    ctest_report_tap_begin_document,
+    ctest_report_tap_begin_suite,
+    ctest_report_tap_add_test,
+    ctest_report_tap_end_suite,
+    ctest_report_tap_end_document
+};
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+/* The suites register themselves before main runs (see CTEST_END_TEST_SUITE), in the order the loader runs the constructors of the
+   objects, which depends on the link. ctest_run_all runs them sorted by name so the order of a run does not depend on the build. */
+
+/* the registered suites, the last registered first. Only written before main */
+static CTEST_SUITE_REGISTRATION* g_registrations = NULL;
+
+void ctest_register_suite(CTEST_SUITE_REGISTRATION* registration)
+{
+    registration->next = g_registrations;
+    g_registrations = registration;
+}
+
+static int ctest_run_all_compare_suite_names(const void* left, const void* right)
+{
+    const CTEST_SUITE_REGISTRATION* left_registration = *(const CTEST_SUITE_REGISTRATION* const*)left;
+    const CTEST_SUITE_REGISTRATION* right_registration = *(const CTEST_SUITE_REGISTRATION* const*)right;
+    return strcmp(left_registration->test_suite_name, right_registration->test_suite_name);
+}
+
+/* a suite whose tests are all filtered out is not given to RunTests, which would fail it for running no test */
+static bool ctest_run_all_has_matching_test(const CTEST_SUITE_REGISTRATION* registration, CTEST_FILTER_HANDLE filter)
+{
+    bool result = false;
+    CTEST_REGISTRATION_SUITE registration_suite;
+    ctest_registration_get_suite(registration->test_list_head, &registration_suite);
+    for (const TEST_FUNCTION_DATA* entry = ctest_registration_get_first_entry(&registration_suite);
+        entry != NULL;
+        entry = ctest_registration_get_next_entry(&registration_suite, entry))
+    {
+        if (((entry->FunctionType == CTEST_TEST_FUNCTION) || (entry->FunctionType == CTEST_BENCHMARK_FUNCTION)) &&
+            ((filter == NULL) || ctest_filter_matches(filter, registration->test_suite_name, entry->TestFunctionName)))
+        {
+            result = true;
+            break;
+        }
+    }
+    return result;
+}
+
+size_t ctest_run_all(int argc, char** argv)
+{
+    size_t result;
+
+    if (ctest_parse_command_line(argc, argv) != 0)
+    {
+        LogError("Invalid ctest options, no suite is run");
+        result = 1;
+    }
+    else
+    {
+        const char* filter_text = ctest_config_get()->test_filter;
+        CTEST_FILTER_HANDLE filter = NULL;
+        size_t suite_count = 0;
+        CTEST_SUITE_REGISTRATION** suites;
+
+        for (CTEST_SUITE_REGISTRATION* registration = g_registrations; registration != NULL; registration = registration->next)
+        {
+            suite_count++;
+        }
+
+        if ((filter_text[0] != '\0') && ((filter = ctest_filter_create(filter_text)) == NULL))
+        {
+            LogError("failure in ctest_filter_create(%s), no suite is run", filter_text);
+            result = 1;
+        }
+        else if (suite_count == 0)
+        {
+            LogError("No suite is registered, ctest_run_all needs a compiler running the constructors of the suites (GCC, clang, MSVC)");
+            result = CTEST_RETURN_CODE_NO_TESTS_RAN;
+        }
+        else if ((suites = malloc(suite_count * sizeof(CTEST_SUITE_REGISTRATION*))) == NULL)
+        {
+            LogError("failure in malloc(%zu)", suite_count * sizeof(CTEST_SUITE_REGISTRATION*));
+            result = 1;
+        }
+        else
+        {
+            size_t run_suite_count = 0;
+            size_t failed_suite_count = 0;
+            size_t failed_test_count = 0;
+
+            size_t i = 0;
+            for (CTEST_SUITE_REGISTRATION* registration = g_registrations; registration != NULL; registration = registration->next)
+            {
+                suites[i++] = registration;
+            }
+            qsort(suites, suite_count, sizeof(CTEST_SUITE_REGISTRATION*), ctest_run_all_compare_suite_names);
+
+            for (i = 0; i < suite_count; i++)
+            {
+                if (ctest_run_all_has_matching_test(suites[i], filter))
+                {
+                    size_t suite_failed_test_count = RunTests(suites[i]->test_list_head, suites[i]->test_suite_name, (filter == NULL) ? NULL : filter_text);
+                    run_suite_count++;
+                    /* the filter matched a test of the suite, running none of them is a failure */
+                    if (suite_failed_test_count == CTEST_RETURN_CODE_NO_TESTS_RAN)
+                    {
+                        suite_failed_test_count = 1;
+                    }
+                    if (suite_failed_test_count > 0)
+                    {
+                        failed_suite_count++;
+                        failed_test_count += suite_failed_test_count;
+                    }
+                }
+            }
+
+            if (run_suite_count == 0)
+            {
+                LogError("No test of the %zu suites matches the filter %s", suite_count, filter_text);
+                result = CTEST_RETURN_CODE_NO_TESTS_RAN;
+            }
+            else if (ctest_config_get()->list != 0)
+            {
+                /* stdout only holds the list */
+                result = failed_test_count;
+            }
+            else
+            {
+                LogInfo("%s%zu of %zu suites ran, %zu failed with %zu failed tests." CTEST_ANSI_COLOR_RESET "", (failed_test_count > 0) ? (CTEST_ANSI_COLOR_RED) : (CTEST_ANSI_COLOR_GREEN),
+                    run_suite_count, suite_count, failed_suite_count, failed_test_count);
+                result = failed_test_count;
+            }
+            free(suites);
+        }
+
+        ctest_filter_destroy(filter);
+    }
+
+    return result;
+}
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#else
+#include <time.h>
+#endif
+
+#if defined _MSC_VER
+uint64_t ctest_timing_get_wall_ns(void)
+{
+    static LARGE_INTEGER frequency; /* constant for the lifetime of the system */
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0)
+    {
+        (void)QueryPerformanceFrequency(&frequency);
+    }
+    (void)QueryPerformanceCounter(&counter);
+    /* split in seconds and remainder so that the multiplication does not overflow */
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000 + (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000 / (uint64_t)frequency.QuadPart;
+}
+
+static uint64_t ctest_timing_get_thread_cpu_ns(void)
+{
+    uint64_t result;
+    FILETIME creation_time;
+    FILETIME exit_time;
+    FILETIME kernel_time;
+    FILETIME user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+    {
+        result = 0;
+    }
+    else
+    {
+        /* FILETIME is in 100ns units */
+        result = ((((uint64_t)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime) +
+            (((uint64_t)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime)) * 100;
+    }
+    return result;
+}
+#else
+static uint64_t ctest_timing_get_clock_ns(clockid_t clock_id)
+{
+    struct timespec now;
+    return (clock_gettime(clock_id, &now) != 0) ? 0 : (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+uint64_t ctest_timing_get_wall_ns(void)
+{
+    return ctest_timing_get_clock_ns(CLOCK_MONOTONIC);
+}
+
+static uint64_t ctest_timing_get_thread_cpu_ns(void)
+{
+    return ctest_timing_get_clock_ns(CLOCK_THREAD_CPUTIME_ID);
+}
+#endif
+
+void ctest_timing_get_timestamp(CTEST_TIMING* timestamp)
+{
+    timestamp->wall_ns = ctest_timing_get_wall_ns();
+    timestamp->cpu_ns = ctest_timing_get_thread_cpu_ns();
+}
+
+void ctest_timing_add_elapsed(CTEST_TIMING* timing, const CTEST_TIMING* start)
+{
+    CTEST_TIMING now;
+    ctest_timing_get_timestamp(&now);
+    timing->wall_ns += (now.wall_ns > start->wall_ns) ? now.wall_ns - start->wall_ns : 0;
+    timing->cpu_ns += (now.cpu_ns > start->cpu_ns) ? now.cpu_ns - start->cpu_ns : 0;
+}
+
+static int ctest_timing_compare_slowest_first(const void* left, const void* right)
+{
+    const CTEST_TEST_RUN* left_run = *(const CTEST_TEST_RUN* const*)left;
+    const CTEST_TEST_RUN* right_run = *(const CTEST_TEST_RUN* const*)right;
+    uint64_t left_wall_ns = left_run->test_timing.wall_ns + left_run->fixture_timing.wall_ns;
+    uint64_t right_wall_ns = right_run->test_timing.wall_ns + right_run->fixture_timing.wall_ns;
+    return (left_wall_ns < right_wall_ns) ? 1 : ((left_wall_ns > right_wall_ns) ? -1 : 0);
+}
+
+void ctest_timing_log_slowest_tests(const CTEST_SUITE_RUN* suite_run, uint32_t slowest_test_count)
+{
+    size_t executed_test_count = 0;
+
+    for (size_t i = 0; i < suite_run->test_count; i++)
+    {
+        if (suite_run->tests[i].is_selected)
+        {
+            executed_test_count++;
+        }
+    }
+
+    if ((slowest_test_count > 0) && (executed_test_count > 0))
+    {
+        const CTEST_TEST_RUN** sorted_tests = malloc(sizeof(const CTEST_TEST_RUN*) * executed_test_count);
+        if (sorted_tests == NULL)
+        {
+            LogError("failure in malloc(sizeof(const CTEST_TEST_RUN*) * %zu)", executed_test_count);
+        }
+        else
+        {
+            size_t sorted_test_count = 0;
+            for (size_t i = 0; i < suite_run->test_count; i++)
+            {
+                if (suite_run->tests[i].is_selected)
+                {
+                    sorted_tests[sorted_test_count++] = &suite_run->tests[i];
+                }
+            }
+
+            qsort((void*)sorted_tests, sorted_test_count, sizeof(const CTEST_TEST_RUN*), ctest_timing_compare_slowest_first);
+
+            if (sorted_test_count > slowest_test_count)
+            {
+                sorted_test_count = slowest_test_count;
+            }
+
+            LogInfo(" ### %zu slowest tests of %s (fixtures = TEST_FUNCTION_INITIALIZE + TEST_FUNCTION_CLEANUP)", sorted_test_count, suite_run->test_suite_name);
+            LogInfo("     %12s %12s %12s %12s  %s", "wall ms", "cpu ms", "fixt wall ms", "fixt cpu ms", "test");
+            for (size_t i = 0; i < sorted_test_count; i++)
+            {
+                LogInfo("     %12.3f %12.3f %12.3f %12.3f  %s",
+                    CTEST_TIMING_NS_TO_MS(sorted_tests[i]->test_timing.wall_ns), CTEST_TIMING_NS_TO_MS(sorted_tests[i]->test_timing.cpu_ns),
+                    CTEST_TIMING_NS_TO_MS(sorted_tests[i]->fixture_timing.wall_ns), CTEST_TIMING_NS_TO_MS(sorted_tests[i]->fixture_timing.cpu_ns),
+                    sorted_tests[i]->test_function->TestFunctionName);
+            }
+
+            free((void*)sorted_tests);
+        }
+    }
+}
@@ -0,0 +1,338 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_config.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#else
+#include <pthread.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+/* Timeline (CTEST_TRACE): the suite fixtures, function fixtures and test bodies are recorded as Chrome trace "complete" events, written
+   as a JSON array that Perfetto and chrome://tracing load:
+
+    [
+    {"name":"process_name","ph":"M","pid":1234,"tid":0,"args":{"name":"ctest"}},
+    {"name":"TEST_FUNCTION_INITIALIZE","cat":"fixture","ph":"X","ts":1000.000,"dur":2.000,"pid":1234,"tid":1,"args":{"suite":"s","test":"t"}},
+    {"name":"t","cat":"test","ph":"X","ts":1002.000,"dur":30.000,"pid":1234,"tid":1,"args":{"suite":"s","test":"t"}},
+    ...
+    ]
+
+   A thread records its spans in its own preallocated CTEST_TRACE_THREAD, so recording takes no lock and does not allocate. The spans are
+   written at the end of each suite (after the worker threads are joined), by each worker process before it exits and when a thread has
+   recorded CTEST_TRACE_THREAD_EVENT_COUNT spans. Every write appends whole events to the file (opened in append mode, the worker
+   processes share it), the closing ']' is written at exit, a trace viewer loads the file without it when the process died. */
+
+#define CTEST_TRACE_THREAD_EVENT_COUNT 4096
+
+typedef struct CTEST_TRACE_EVENT_TAG
+{
+    CTEST_TRACE_SPAN span;
+    const char* suite_name;
+    const char* test_name; /* NULL for the suite fixtures */
+    uint64_t start_wall_ns;
+    uint64_t end_wall_ns;
+} CTEST_TRACE_EVENT;
+
+/* the spans recorded by a thread. The threads that ended release theirs for the next ones, which keep the same tid in the trace */
+typedef struct CTEST_TRACE_THREAD_TAG
+{
+    struct CTEST_TRACE_THREAD_TAG* next;
+    uint32_t thread_number;
+    bool is_used;
+    size_t event_count;
+    CTEST_TRACE_EVENT events[CTEST_TRACE_THREAD_EVENT_COUNT];
+} CTEST_TRACE_THREAD;
+
+static bool g_is_opened = false;
+static FILE* g_file = NULL;
+/* the process that opened the trace, a worker process exiting (exit instead of _exit) only writes its spans */
+static unsigned long g_trace_pid;
+static CTEST_TRACE_THREAD* g_threads = NULL;
+static uint32_t g_thread_count = 0;
+static CTEST_THREAD_LOCAL CTEST_TRACE_THREAD* g_current_thread = NULL;
+
+#if defined _MSC_VER
+static SRWLOCK g_lock = SRWLOCK_INIT;
+
+static void ctest_trace_lock(void)
+{
+    AcquireSRWLockExclusive(&g_lock);
+}
+
+static void ctest_trace_unlock(void)
+{
+    ReleaseSRWLockExclusive(&g_lock);
+}
+
+static FILE* ctest_trace_open_file(const char* path, const char* mode)
+{
+    FILE* result;
+    if (fopen_s(&result, path, mode) != 0)
+    {
+        result = NULL;
+    }
+    return result;
+}
+
+static unsigned long ctest_trace_get_pid(void)
+{
+    return (unsigned long)GetCurrentProcessId();
+}
+#else
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void ctest_trace_lock(void)
+{
+    (void)pthread_mutex_lock(&g_lock);
+}
+
+static void ctest_trace_unlock(void)
+{
+    (void)pthread_mutex_unlock(&g_lock);
+}
+
+static FILE* ctest_trace_open_file(const char* path, const char* mode)
+{
+    return fopen(path, mode);
+}
+
+static unsigned long ctest_trace_get_pid(void)
+{
+    return (unsigned long)getpid();
+}
+#endif
+
+static const char* const g_span_names[] = { "TEST_SUITE_INITIALIZE", "TEST_FUNCTION_INITIALIZE", NULL, "TEST_FUNCTION_CLEANUP", "TEST_SUITE_CLEANUP" };
+
+/* appends the text to the file in one write, so that it is not mixed with what the other processes write */
+static void ctest_trace_append(const CTEST_REPORT_BUFFER* buffer)
+{
+    if ((buffer->data != NULL) &&
+        ((fwrite(buffer->data, 1, buffer->length, g_file) != buffer->length) || (fflush(g_file) != 0)))
+    {
+        LogError("failure writing %zu bytes to the trace %s", buffer->length, ctest_config_get()->trace_path);
+    }
+}
+
+static void ctest_trace_add_process_name(CTEST_REPORT_BUFFER* buffer, const char* process_name)
+{
+    ctest_report_buffer_append_format(buffer, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":0,\"args\":{\"name\":\"%s\"}}", ctest_trace_get_pid(), process_name);
+}
+
+/* writes the spans of thread, with the lock held */
+static void ctest_trace_write_thread(CTEST_TRACE_THREAD* thread)
+{
+    if (thread->event_count > 0)
+    {
+        unsigned long pid = ctest_trace_get_pid();
+        CTEST_REPORT_BUFFER buffer = { NULL, 0, 0, true };
+        for (size_t i = 0; i < thread->event_count; i++)
+        {
+            const CTEST_TRACE_EVENT* event = &thread->events[i];
+            bool is_test_span = (event->span == CTEST_TRACE_TEST);
+            ctest_report_buffer_append(&buffer, ",\n{\"name\":\"");
+            if (is_test_span)
+            {
+                ctest_report_buffer_append_json_escaped(&buffer, event->test_name);
+            }
+            else
+            {
+                ctest_report_buffer_append(&buffer, g_span_names[event->span]);
+            }
+            ctest_report_buffer_append_format(&buffer, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%" PRIu32 ",\"args\":{\"suite\":\"",
+                is_test_span ? "test" : "fixture", (double)event->start_wall_ns / 1000.0, (double)(event->end_wall_ns - event->start_wall_ns) / 1000.0,
+                pid, thread->thread_number);
+            ctest_report_buffer_append_json_escaped(&buffer, event->suite_name);
+            if (event->test_name != NULL)
+            {
+                ctest_report_buffer_append(&buffer, "\",\"test\":\"");
+                ctest_report_buffer_append_json_escaped(&buffer, event->test_name);
+            }
+            ctest_report_buffer_append(&buffer, "\"}}");
+        }
+        ctest_trace_append(&buffer);
+        free(buffer.data);
+        thread->event_count = 0;
+    }
+}
+
+static void ctest_trace_close_at_exit(void)
+{
+    ctest_trace_lock();
+    for (CTEST_TRACE_THREAD* thread = g_threads; thread != NULL; thread = thread->next)
+    {
+        ctest_trace_write_thread(thread);
+    }
+    if (ctest_trace_get_pid() == g_trace_pid)
+    {
+        if ((fputs("\n]\n", g_file) < 0) || (fclose(g_file) != 0))
+        {
+            LogError("failure completing the trace %s", ctest_config_get()->trace_path);
+        }
+        g_file = NULL;
+        while (g_threads != NULL)
+        {
+            CTEST_TRACE_THREAD* next = g_threads->next;
+            free(g_threads);
+            g_threads = next;
+        }
+    }
+    ctest_trace_unlock();
+}
+
+static void ctest_trace_open(void)
+{
+    const char* path = ctest_config_get()->trace_path;
+    FILE* file;
+
+    if (path[0] != '\0')
+    {
+        if ((file = ctest_trace_open_file(path, "wb")) == NULL)
+        {
+            LogError("failure opening %s, the trace is not written", path);
+        }
+        else
+        {
+            (void)fclose(file);
+            /* every write goes to the end of the file, wherever the other processes wrote */
+            if ((g_file = ctest_trace_open_file(path, "ab")) == NULL)
+            {
+                LogError("failure opening %s, the trace is not written", path);
+            }
+            else
+            {
+                /* unbuffered, each fwrite is a single write */
+                (void)setvbuf(g_file, NULL, _IONBF, 0);
+                g_trace_pid = ctest_trace_get_pid();
+                CTEST_REPORT_BUFFER buffer = { NULL, 0, 0, true };
+                ctest_report_buffer_append(&buffer, "[\n");
+                ctest_trace_add_process_name(&buffer, "ctest");
+                ctest_trace_append(&buffer);
+                free(buffer.data);
+                (void)atexit(ctest_trace_close_at_exit);
+            }
+        }
+    }
+}
+
+void ctest_trace_begin_thread(void)
+{
+    if ((g_file != NULL) && (g_current_thread == NULL))
+    {
+        ctest_trace_lock();
+        CTEST_TRACE_THREAD* thread = g_threads;
+        while ((thread != NULL) && thread->is_used)
+        {
+            thread = thread->next;
+        }
+        if (thread == NULL)
+        {
+            thread = malloc(sizeof(CTEST_TRACE_THREAD));
+            if (thread == NULL)
+            {
+                LogError("failure in malloc(%zu), the spans of the thread are not traced", sizeof(CTEST_TRACE_THREAD));
+            }
+            else
+            {
+                thread->thread_number = ++g_thread_count;
+                thread->event_count = 0;
+                thread->next = g_threads;
+                g_threads = thread;
+            }
+        }
+        if (thread != NULL)
+        {
+            thread->is_used = true;
+            g_current_thread = thread;
+        }
+        ctest_trace_unlock();
+    }
+}
+
+void ctest_trace_end_thread(void)
+{
+    CTEST_TRACE_THREAD* thread = g_current_thread;
+    if (thread != NULL)
+    {
+        ctest_trace_lock();
+        thread->is_used = false;
+        ctest_trace_unlock();
+        g_current_thread = NULL;
+    }
+}
+
+void ctest_trace_begin_suite(void)
+{
+    if (!g_is_opened)
+    {
+        g_is_opened = true;
+        ctest_trace_open();
+    }
+    ctest_trace_begin_thread();
+}
+
+void ctest_trace_write(void)
+{
+    if (g_file != NULL)
+    {
+        ctest_trace_lock();
+        for (CTEST_TRACE_THREAD* thread = g_threads; thread != NULL; thread = thread->next)
+        {
+            ctest_trace_write_thread(thread);
+        }
+        ctest_trace_unlock();
+    }
+}
+
+void ctest_trace_begin_worker_process(void)
+{
+    if (g_file != NULL)
+    {
+        /* the spans recorded before the fork are written by the parent */
+        for (CTEST_TRACE_THREAD* thread = g_threads; thread != NULL; thread = thread->next)
+        {
+            thread->event_count = 0;
+        }
+        CTEST_REPORT_BUFFER buffer = { NULL, 0, 0, true };
+        ctest_report_buffer_append(&buffer, ",\n");
+        ctest_trace_add_process_name(&buffer, "ctest worker process");
+        ctest_trace_append(&buffer);
+        free(buffer.data);
+    }
+}
+
+void ctest_trace_add(CTEST_TRACE_SPAN span, const char* suite_name, const char* test_name, uint64_t start_wall_ns)
+{
+    CTEST_TRACE_THREAD* thread = g_current_thread;
+    if (thread != NULL)
+    {
+        CTEST_TRACE_EVENT* event = &thread->events[thread->event_count];
+        event->span = span;
+        event->suite_name = suite_name;
+        event->test_name = test_name;
+        event->start_wall_ns = start_wall_ns;
+        event->end_wall_ns = ctest_timing_get_wall_ns();
+        thread->event_count++;
+        if (thread->event_count == CTEST_TRACE_THREAD_EVENT_COUNT)
+        {
+            ctest_trace_lock();
+            ctest_trace_write_thread(thread);
+            ctest_trace_unlock();
+        }
+    }
+}
@@ -0,0 +1,319 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+#include "ctest_internal.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#else
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#if defined __GLIBC__
+#include <execinfo.h>
+#define CTEST_WATCHDOG_HAS_BACKTRACE
+#endif
+#endif
+
+/* A test that runs in process cannot be stopped safely (it may hold locks, it owns the stack of its thread), so when it hangs the
+   watchdog reports what it can and aborts. Tests running in worker processes are watched by the parent process instead (see
+   ctest_fork.c), which kills the worker and continues. */
+
+#define CTEST_WATCHDOG_PERIOD_MS 50
+#define CTEST_WATCHDOG_STACK_DUMP_WAIT_MS 1000
+#define CTEST_WATCHDOG_TIMEOUT_EXIT_CODE 124
+
+typedef struct CTEST_WATCHDOG_TAG
+{
+    CTEST_SUITE_RUN* suite_run;
+    volatile int is_stopping;
+#if defined _MSC_VER
+    HANDLE thread_handle;
+#else
+    pthread_t thread_handle;
+#endif
+} CTEST_WATCHDOG;
+
+#if defined _MSC_VER
+CTEST_THREAD_ID ctest_get_current_thread_id(void)
+{
+    return GetCurrentThreadId();
+}
+
+static void ctest_watchdog_sleep_ms(uint32_t milliseconds)
+{
+    Sleep(milliseconds);
+}
+
+void ctest_watchdog_install_stack_dump_handler(bool exit_after_dump)
+{
+    (void)exit_after_dump;
+}
+
+static void ctest_watchdog_dump_stack(CTEST_THREAD_ID thread_id)
+{
+    (void)thread_id;
+    /* abort() reports the fault (_CALL_REPORTFAULT is set by RunTests), the crash dump has the stacks of all threads */
+    LogError("The stack of the thread is in the crash dump written by abort()");
+}
+#else
+static volatile sig_atomic_t g_stack_dumped;
+static volatile sig_atomic_t g_exit_after_stack_dump;
+
+CTEST_THREAD_ID ctest_get_current_thread_id(void)
+{
+    return pthread_self();
+}
+
+static void ctest_watchdog_sleep_ms(uint32_t milliseconds)
+{
+    struct timespec duration;
+    duration.tv_sec = milliseconds / 1000;
+    duration.tv_nsec = (long)(milliseconds % 1000) * 1000000;
+    (void)nanosleep(&duration, NULL);
+}
+
+static void ctest_watchdog_stack_dump_handler(int signal_number)
+{
+    static const char header[] = "\n=== ctest watchdog: stack of the timed out thread ===\n";
+    (void)signal_number;
+    (void)!write(STDERR_FILENO, header, sizeof(header) - 1);
+#if defined CTEST_WATCHDOG_HAS_BACKTRACE
+    {
+        void* frames[64];
+        int frame_count = backtrace(frames, (int)(sizeof(frames) / sizeof(frames[0])));
+        backtrace_symbols_fd(frames, frame_count, STDERR_FILENO);
+    }
+#endif
+    g_stack_dumped = 1;
+    if (g_exit_after_stack_dump)
+    {
+        _exit(CTEST_WATCHDOG_TIMEOUT_EXIT_CODE);
+    }
+}
+
+void ctest_watchdog_install_stack_dump_handler(bool exit_after_dump)
+{
+    struct sigaction action;
+
+#if defined CTEST_WATCHDOG_HAS_BACKTRACE
+    {
+        /* the first backtrace call loads libgcc, which allocates: not something to do for the first time in a signal handler */
+        void* frame;
+        (void)backtrace(&frame, 1);
+    }
+#endif
+
+    g_exit_after_stack_dump = exit_after_dump ? 1 : 0;
+    (void)memset(&action, 0, sizeof(action));
+    action.sa_handler = ctest_watchdog_stack_dump_handler;
+    (void)sigemptyset(&action.sa_mask);
+    if (sigaction(SIGQUIT, &action, NULL) != 0)
+    {
+        LogWarning("failure in sigaction(SIGQUIT), no stack dump for timed out tests");
+    }
+}
+
+static void ctest_watchdog_dump_stack(CTEST_THREAD_ID thread_id)
+{
+    g_stack_dumped = 0;
+    ctest_watchdog_install_stack_dump_handler(false);
+    if (pthread_kill(thread_id, SIGQUIT) != 0)
+    {
+        LogError("failure in pthread_kill, no stack dump");
+    }
+    else
+    {
+        for (uint32_t waited_ms = 0; (g_stack_dumped == 0) && (waited_ms < CTEST_WATCHDOG_STACK_DUMP_WAIT_MS); waited_ms += 10)
+        {
+            ctest_watchdog_sleep_ms(10);
+        }
+    }
+}
+#endif
+
+/* TEST_RESULT has no strings in the library, the user may define them in a test */
+static const char* ctest_watchdog_result_to_string(TEST_RESULT test_result)
+{
+    return (test_result == TEST_SUCCESS) ? "Succeeded" : ((test_result == TEST_FAILED) ? "!!! FAILED !!!" : "NOT EXECUTED");
+}
+
+void ctest_watchdog_log_results_so_far(const CTEST_SUITE_RUN* suite_run)
+{
+    size_t done_count = 0;
+    size_t failed_count = 0;
+    size_t running_count = 0;
+    size_t pending_count = 0;
+
+    LogError(" ### Results so far for suite %s:", suite_run->test_suite_name);
+    for (size_t i = 0; i < suite_run->test_count; i++)
+    {
+        const CTEST_TEST_RUN* test_run = &suite_run->tests[i];
+        if (test_run->is_selected)
+        {
+            if (test_run->state == CTEST_TEST_RUN_DONE)
+            {
+                TEST_RESULT test_result = *test_run->test_function->TestResult;
+                done_count++;
+                if (test_result != TEST_SUCCESS)
+                {
+                    failed_count++;
+                }
+                LogError("     %-20s %s", ctest_watchdog_result_to_string(test_result), test_run->test_function->TestFunctionName);
+            }
+            else if (test_run->state == CTEST_TEST_RUN_RUNNING)
+            {
+                running_count++;
+                LogError("     %-20s %s", "RUNNING", test_run->test_function->TestFunctionName);
+            }
+            else
+            {
+                pending_count++;
+            }
+        }
+    }
+    LogError(" ### %zu tests done (%zu failed), %zu running, %zu not started", done_count, failed_count, running_count, pending_count);
+}
+
+static void ctest_watchdog_fail_run(CTEST_SUITE_RUN* suite_run, CTEST_THREAD_ID thread_id)
+{
+    ctest_watchdog_dump_stack(thread_id);
+    ctest_watchdog_log_results_so_far(suite_run);
+    LogError(CTEST_ANSI_COLOR_RED "Aborting: the tests run in process and a hung test cannot be stopped. Run with CTEST_WORKER_PROCESSES to fail only the timed out test and continue." CTEST_ANSI_COLOR_RESET "");
+    ctest_report_interrupt("timed out");
+    (void)fflush(NULL);
+    abort();
+}
+
+/* returns true when the step started at start_wall_ns (0 when not running) is over the timeout at now */
+static bool ctest_watchdog_is_timed_out(uint64_t start_wall_ns, uint32_t timeout_ms, uint64_t now)
+{
+    return (timeout_ms > 0) && (start_wall_ns != 0) && (now > start_wall_ns) && ((now - start_wall_ns) / 1000000 >= timeout_ms);
+}
+
+static void ctest_watchdog_check(CTEST_SUITE_RUN* suite_run)
+{
+    uint64_t now = ctest_timing_get_wall_ns();
+    const char* running_suite_fixture = suite_run->running_suite_fixture;
+
+    if ((running_suite_fixture != NULL) && ctest_watchdog_is_timed_out(suite_run->suite_fixture_start_wall_ns, suite_run->test_timeout_ms, now))
+    {
+        LogError(CTEST_ANSI_COLOR_RED "%s of suite %s timed out after %" PRIu32 " ms" CTEST_ANSI_COLOR_RESET "", running_suite_fixture, suite_run->test_suite_name, suite_run->test_timeout_ms);
+        ctest_watchdog_fail_run(suite_run, suite_run->suite_fixture_thread_id);
+    }
+
+    for (size_t i = 0; i < suite_run->test_count; i++)
+    {
+        CTEST_TEST_RUN* test_run = &suite_run->tests[i];
+        if ((test_run->state == CTEST_TEST_RUN_RUNNING) && ctest_watchdog_is_timed_out(test_run->start_wall_ns, suite_run->test_timeout_ms, now))
+        {
+            *test_run->test_function->TestResult = TEST_FAILED;
+            LogError(CTEST_ANSI_COLOR_RED "Test %s result = !!! FAILED !!! (timed out after %" PRIu32 " ms)" CTEST_ANSI_COLOR_RESET "", test_run->test_function->TestFunctionName, suite_run->test_timeout_ms);
+            /* the other running tests were only interrupted, a resumed run runs them again */
+            ctest_journal_time_out_test(suite_run, test_run);
+            ctest_watchdog_fail_run(suite_run, test_run->thread_id);
+        }
+    }
+
+    if ((suite_run->suite_deadline_wall_ns != 0) && (now >= suite_run->suite_deadline_wall_ns))
+    {
+        LogError(CTEST_ANSI_COLOR_RED "Suite %s timed out" CTEST_ANSI_COLOR_RESET "", suite_run->test_suite_name);
+        for (size_t i = 0; i < suite_run->test_count; i++)
+        {
+            if (suite_run->tests[i].state == CTEST_TEST_RUN_RUNNING)
+            {
+                ctest_watchdog_fail_run(suite_run, suite_run->tests[i].thread_id);
+            }
+        }
+        ctest_watchdog_fail_run(suite_run, suite_run->suite_fixture_thread_id);
+    }
+}
+
+static void ctest_watchdog_run(CTEST_WATCHDOG* watchdog)
+{
+    while (!watchdog->is_stopping)
+    {
+        ctest_watchdog_sleep_ms(CTEST_WATCHDOG_PERIOD_MS);
+        if (!watchdog->suite_run->is_watchdog_paused)
+        {
+            ctest_watchdog_check(watchdog->suite_run);
+        }
+    }
+}
+
+#if defined _MSC_VER
+static DWORD WINAPI ctest_watchdog_thread_func(LPVOID context)
+{
+    ctest_watchdog_run((CTEST_WATCHDOG*)context);
+    return 0;
+}
+#else
+static void* ctest_watchdog_thread_func(void* context)
+{
+    ctest_watchdog_run((CTEST_WATCHDOG*)context);
+    return NULL;
+}
+#endif
+
+CTEST_WATCHDOG_HANDLE ctest_watchdog_start(CTEST_SUITE_RUN* suite_run)
+{
+    CTEST_WATCHDOG* result;
+
+    if ((suite_run->test_timeout_ms == 0) && (suite_run->suite_deadline_wall_ns == 0))
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = malloc(sizeof(CTEST_WATCHDOG));
+        if (result == NULL)
+        {
+            LogError("failure in malloc(sizeof(CTEST_WATCHDOG)), timeouts are not enforced");
+        }
+        else
+        {
+            result->suite_run = suite_run;
+            result->is_stopping = 0;
+#if defined _MSC_VER
+            result->thread_handle = CreateThread(NULL, 0, ctest_watchdog_thread_func, result, 0, NULL);
+            if (result->thread_handle == NULL)
+#else
+            if (pthread_create(&result->thread_handle, NULL, ctest_watchdog_thread_func, result) != 0)
+#endif
+            {
+                LogError("failure creating the watchdog thread, timeouts are not enforced");
+                free(result);
+                result = NULL;
+            }
+        }
+    }
+
+    return result;
+}
+
+void ctest_watchdog_stop(CTEST_WATCHDOG_HANDLE watchdog)
+{
+    if (watchdog != NULL)
+    {
+        watchdog->is_stopping = 1;
+#if defined _MSC_VER
+        (void)WaitForSingleObject(watchdog->thread_handle, INFINITE);
+        (void)CloseHandle(watchdog->thread_handle);
+#else
+        (void)pthread_join(watchdog->thread_handle, NULL);
+#endif
+        free(watchdog);
+    }
+}
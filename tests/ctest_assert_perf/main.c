@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <wchar.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#else
+#include <time.h>
+#endif
+
+/* Measures the cost of a passing CTEST_ASSERT_ARE_EQUAL for every built-in type.
+   "eager" adds the 2 _ToString calls that the assert used to make before comparing the values (same formats as src/ctest.c),
+   "lazy" is the assert as it is now: the values are only formatted when the comparison fails.
+   The same is measured for an assert with a message, "eager" building the message the way the assert used to (before comparing).
+   A passing assert formatting its values again would make "lazy" as slow as "eager": each measurement fails when "lazy" is not at
+   least ASSERT_PERF_MIN_SPEEDUP times faster. */
+
+#define ASSERT_PERF_ITERATIONS 1000000
+#define ASSERT_PERF_MIN_SPEEDUP 2.0
+
+static volatile char g_sink;
+
+static double get_time_ns(void)
+{
+#if defined _MSC_VER
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+/* logs the measurement, returns 1 when the passing assert is not fast enough */
+static size_t check_speedup(const char* name, double eager_ns, double lazy_ns)
+{
+    size_t result = 0;
+    double speedup = (lazy_ns > 0) ? eager_ns / lazy_ns : 0.0;
+    LogInfo("%-14s eager: %8.2f ns/assert, lazy: %8.2f ns/assert, %6.1fx", name, eager_ns, lazy_ns, speedup);
+    if ((lazy_ns > 0) && (speedup < ASSERT_PERF_MIN_SPEEDUP))
+    {
+        LogError("CTEST TEST FAILED !!! a passing CTEST_ASSERT_ARE_EQUAL(%s) is only %.1fx faster than formatting its values, expected at least %.1fx",
+            name, speedup, ASSERT_PERF_MIN_SPEEDUP);
+        result = 1;
+    }
+    return result;
+}
+
+#define MEASURE_ASSERT_ARE_EQUAL(type, value, format, format_value) \
+do \
+{ \
+    type measured_value = (value); \
+    double start = get_time_ns(); \
+    for (uint32_t i = 0; i < ASSERT_PERF_ITERATIONS; i++) \
+    { \
+        char expectedString[1024]; \
+        char actualString[1024]; \
+        (void)snprintf(expectedString, sizeof(expectedString), format, format_value); \
+        (void)snprintf(actualString, sizeof(actualString), format, format_value); \
+        g_sink = (char)(expectedString[0] + actualString[0]); \
+        CTEST_ASSERT_ARE_EQUAL(type, measured_value, measured_value); \
+    } \
+    double eager_ns = (get_time_ns() - start) / ASSERT_PERF_ITERATIONS; \
+    start = get_time_ns(); \
+    for (uint32_t i = 0; i < ASSERT_PERF_ITERATIONS; i++) \
+    { \
+        CTEST_ASSERT_ARE_EQUAL(type, measured_value, measured_value); \
+    } \
+    double lazy_ns = (get_time_ns() - start) / ASSERT_PERF_ITERATIONS; \
+    failedMeasurements += check_speedup(#type, eager_ns, lazy_ns); \
+} while (0)
+
+static size_t measure_assert_are_equal_with_message(void)
+{
+    int measured_value = 42;
+    double start = get_time_ns();
+    for (uint32_t i = 0; i < ASSERT_PERF_ITERATIONS; i++)
+    {
+        char* ctest_message = ctest_sprintf_char("iteration %" PRIu32 " of %d", i, ASSERT_PERF_ITERATIONS);
+        g_sink = (ctest_message == NULL) ? 0 : ctest_message[0];
+        ctest_sprintf_free(ctest_message);
+        CTEST_ASSERT_ARE_EQUAL(int, measured_value, measured_value, "iteration %" PRIu32 " of %d", i, ASSERT_PERF_ITERATIONS);
+    }
+    double eager_ns = (get_time_ns() - start) / ASSERT_PERF_ITERATIONS;
+    start = get_time_ns();
+    for (uint32_t i = 0; i < ASSERT_PERF_ITERATIONS; i++)
+    {
+        CTEST_ASSERT_ARE_EQUAL(int, measured_value, measured_value, "iteration %" PRIu32 " of %d", i, ASSERT_PERF_ITERATIONS);
+    }
+    double lazy_ns = (get_time_ns() - start) / ASSERT_PERF_ITERATIONS;
+    return check_speedup("int + message", eager_ns, lazy_ns);
+}
+
+int main(void)
+{
+    static char string_value[] = "a string of moderate length";
+    static wchar_t wstring_value[] = L"a wide string of moderate length";
+    size_t failedMeasurements = 0;
+
+    (void)logger_init();
+
+    LogInfo("CTEST_ASSERT_ARE_EQUAL throughput, %d passing asserts per type", ASSERT_PERF_ITERATIONS);
+
+    MEASURE_ASSERT_ARE_EQUAL(bool, true, "%s", measured_value ? "true" : "false");
+    MEASURE_ASSERT_ARE_EQUAL(int, 42, "%d", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(char, 'a', "%d", (int)measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(short, 42, "%d", (int)measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(long, 42L, "%ld", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(size_t, 42, "%d", (int)measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(float, 42.5f, "%.02f", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(double, 42.5, "%.02f", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(long_double, 42.5L, "%.02Lf", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(char_ptr, string_value, "%s", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(wchar_ptr, wstring_value, "%ls", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(void_ptr, string_value, "%p", measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(unsigned_long, 42UL, "%lu", measured_value);
+#if defined CTEST_USE_STDINT
+    MEASURE_ASSERT_ARE_EQUAL(uint8_t, 42, "%" PRIu8, measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(int8_t, 42, "%" PRId8, measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(uint16_t, 42, "%" PRIu16, measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(int16_t, 42, "%" PRId16, measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(uint32_t, 42, "%" PRIu32, measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(int32_t, 42, "%" PRId32, measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(uint64_t, 42, "%" PRIu64, measured_value);
+    MEASURE_ASSERT_ARE_EQUAL(int64_t, 42, "%" PRId64, measured_value);
+#endif
+
+    failedMeasurements += measure_assert_are_equal_with_message();
+
+    logger_deinit();
+
+    return (int)failedMeasurements;
+}
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+
+#include "ctest.h"
+
+/* the number of loop iterations of each call of the benchmark */
+#define CTEST_BASELINE_UT_WORK 100
+
+CTEST_BEGIN_TEST_SUITE(ctest_baseline_ut)
+
+CTEST_FUNCTION(test_that_is_fast)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 2, 1 + 1);
+}
+
+CTEST_BENCHMARK(benchmark_with_fixed_work)
+{
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < CTEST_BASELINE_UT_WORK; i++)
+    {
+        sum += i;
+        CTEST_DO_NOT_OPTIMIZE(sum);
+    }
+}
+
+CTEST_END_TEST_SUITE(ctest_baseline_ut)
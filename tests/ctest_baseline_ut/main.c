@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#define FAST_BASELINE_SAMPLE_COUNT 10
+
+static size_t run_with_options(char* option_1, char* option_2, char* option_3)
+{
+    size_t failed_tests = 0;
+    char* argv[] = { "ctest_baseline_ut", option_1, option_2, option_3 };
+    if (ctest_parse_command_line(4, argv) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parse_command_line(%s, %s, %s) failed", option_1, option_2, option_3);
+        failed_tests = 1;
+    }
+    else
+    {
+        CTEST_RUN_TEST_SUITE(ctest_baseline_ut, failed_tests);
+    }
+    return failed_tests;
+}
+
+/* a baseline where the benchmark and the test took 1 ns, what any run measures is a regression of more than 1000% */
+static bool write_fast_baseline(const char* path)
+{
+    bool result;
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        LogError("CTEST TEST FAILED !!! cannot create %s", path);
+        result = false;
+    }
+    else
+    {
+        (void)fprintf(file, "{\n  \"context\": { \"ctest_baseline_version\": 1 },\n  \"benchmarks\": [\n");
+        for (int i = 0; i < FAST_BASELINE_SAMPLE_COUNT; i++)
+        {
+            (void)fprintf(file, "    { \"name\": \"ctest_baseline_ut.benchmark_with_fixed_work\", \"run_type\": \"iteration\", \"repetition_index\": %d, \"real_time\": 1.0, \"time_unit\": \"ns\" },\n", i);
+        }
+        (void)fprintf(file, "    { \"name\": \"ctest_baseline_ut.test_that_is_fast\", \"run_type\": \"iteration\", \"real_time\": 1.0, \"time_unit\": \"ns\" }\n  ]\n}\n");
+        result = (fclose(file) == 0);
+        if (!result)
+        {
+            LogError("CTEST TEST FAILED !!! cannot write %s", path);
+        }
+    }
+    return result;
+}
+
+/* CMakeLists.txt runs this executable with CTEST_BENCHMARK_MIN_TIME_MS=20. The runs are compared with baselines that do not depend on
+   the load of the machine: their own baseline with a threshold only a 100x slowdown goes over, or a hand written baseline of 1 ns. */
+int main(void)
+{
+    size_t failedTests = 0;
+    size_t temp_failed_tests;
+
+    (void)logger_init();
+
+    /* the run writing the baseline */
+    temp_failed_tests = run_with_options("--ctest_baseline_output=ctest_baseline_ut.json", "--ctest_baseline_compare=", "--ctest_regression_threshold_percent=10");
+    if (temp_failed_tests != 0)
+    {
+        LogError("CTEST TEST FAILED !!! writing the baseline expected no failure, got %zu", temp_failed_tests);
+        failedTests++;
+    }
+
+    /* the baseline written is read back, same work, no regression */
+    temp_failed_tests = run_with_options("--ctest_baseline_output=", "--ctest_baseline_compare=ctest_baseline_ut.json", "--ctest_regression_threshold_percent=10000");
+    if (temp_failed_tests != 0)
+    {
+        LogError("CTEST TEST FAILED !!! comparing the same work expected no regression, got %zu", temp_failed_tests);
+        failedTests++;
+    }
+
+    /* the benchmark is hundreds of times slower than the 1 ns baseline, it regressed. The test is timed once, its regression is under
+       the scheduling noise and does not count */
+    if (!write_fast_baseline("ctest_baseline_ut_fast.json"))
+    {
+        failedTests++;
+    }
+    else
+    {
+        temp_failed_tests = run_with_options("--ctest_baseline_output=", "--ctest_baseline_compare=ctest_baseline_ut_fast.json", "--ctest_regression_threshold_percent=200");
+        if (temp_failed_tests != 1)
+        {
+            LogError("CTEST TEST FAILED !!! comparing with the 1 ns baseline expected 1 regression, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+
+        /* the same slowdown is under a threshold of 100000000% */
+        temp_failed_tests = run_with_options("--ctest_baseline_output=", "--ctest_baseline_compare=ctest_baseline_ut_fast.json", "--ctest_regression_threshold_percent=100000000");
+        if (temp_failed_tests != 0)
+        {
+            LogError("CTEST TEST FAILED !!! comparing with the 1 ns baseline with a 100000000%% threshold expected no regression, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+    }
+
+    /* a baseline that cannot be read fails the suite */
+    temp_failed_tests = run_with_options("--ctest_baseline_output=", "--ctest_baseline_compare=ctest_baseline_ut_does_not_exist.json", "--ctest_regression_threshold_percent=10");
+    if (temp_failed_tests != 1)
+    {
+        LogError("CTEST TEST FAILED !!! comparing with a missing baseline expected 1 failure, got %zu", temp_failed_tests);
+        failedTests++;
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
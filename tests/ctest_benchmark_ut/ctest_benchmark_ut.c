@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ctest.h"
+
+#include "ctest_benchmark_ut.h"
+
+static int test_function_initialize_count;
+static int test_function_cleanup_count;
+static uint64_t sum_call_count;
+static uint64_t store_call_count;
+static uint32_t values[64];
+
+void ctest_benchmark_ut_reset_counts(void)
+{
+    test_function_initialize_count = 0;
+    test_function_cleanup_count = 0;
+    sum_call_count = 0;
+    store_call_count = 0;
+}
+
+int ctest_benchmark_ut_get_test_function_initialize_count(void)
+{
+    return test_function_initialize_count;
+}
+
+int ctest_benchmark_ut_get_test_function_cleanup_count(void)
+{
+    return test_function_cleanup_count;
+}
+
+uint64_t ctest_benchmark_ut_get_sum_call_count(void)
+{
+    return sum_call_count;
+}
+
+uint64_t ctest_benchmark_ut_get_store_call_count(void)
+{
+    return store_call_count;
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_benchmark_ut)
+
+CTEST_SUITE_INITIALIZE()
+{
+    for (uint32_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        values[i] = i;
+    }
+}
+
+CTEST_SUITE_CLEANUP()
+{
+}
+
+CTEST_FUNCTION_INITIALIZE()
+{
+    test_function_initialize_count++;
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+    test_function_cleanup_count++;
+}
+
+CTEST_FUNCTION(test_next_to_the_benchmarks)
+{
+    CTEST_ASSERT_ARE_EQUAL(uint32_t, 63, values[63]);
+}
+
+CTEST_BENCHMARK(benchmark_sum)
+{
+    uint32_t sum = 0;
+    sum_call_count++;
+    for (uint32_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        sum += values[i];
+    }
+    CTEST_DO_NOT_OPTIMIZE(sum);
+}
+
+CTEST_BENCHMARK(benchmark_store)
+{
+    uint32_t buffer[16];
+    store_call_count++;
+    for (uint32_t i = 0; i < sizeof(buffer) / sizeof(buffer[0]); i++)
+    {
+        buffer[i] = i;
+    }
+    CTEST_DO_NOT_OPTIMIZE(buffer);
+    CTEST_CLOBBER_MEMORY();
+}
+
+/* more than the largest mmap threshold of glibc (which grows as mapped blocks are freed), so that each iteration maps new pages and
+   touching them faults. Touching one byte per megabyte keeps the iterations cheap */
+#define TOUCHED_MEMORY_SIZE (64 * 1024 * 1024)
+#define TOUCHED_MEMORY_STRIDE (1024 * 1024)
+CTEST_BENCHMARK(benchmark_that_touches_memory)
+{
+    volatile unsigned char* memory = malloc(TOUCHED_MEMORY_SIZE);
+    CTEST_ASSERT_IS_NOT_NULL((void*)memory);
+    for (size_t i = 0; i < TOUCHED_MEMORY_SIZE; i += TOUCHED_MEMORY_STRIDE)
+    {
+        memory[i] = 1;
+    }
+    free((void*)memory);
+}
+
+CTEST_BENCHMARK(benchmark_that_fails)
+{
+    CTEST_ASSERT_FAIL("expected failure");
+}
+
+CTEST_END_TEST_SUITE(ctest_benchmark_ut)
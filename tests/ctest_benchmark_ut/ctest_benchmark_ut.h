@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_BENCHMARK_UT_H
+#define CTEST_BENCHMARK_UT_H
+
+#include <stdint.h>
+
+void ctest_benchmark_ut_reset_counts(void);
+int ctest_benchmark_ut_get_test_function_initialize_count(void);
+int ctest_benchmark_ut_get_test_function_cleanup_count(void);
+uint64_t ctest_benchmark_ut_get_sum_call_count(void);
+uint64_t ctest_benchmark_ut_get_store_call_count(void);
+
+#endif /* CTEST_BENCHMARK_UT_H */
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+#include "ctest_benchmark_ut.h"
+
+/* whether the kernel lets this process count its page faults (perf_event_paranoid, seccomp in containers) */
+static bool can_count_page_faults(void)
+{
+    bool result = false;
+#if defined __linux__
+    struct perf_event_attr attr;
+    (void)memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    if (fd >= 0)
+    {
+        (void)close(fd);
+        result = true;
+    }
+#endif
+    return result;
+}
+
+/* the page faults per iteration logged for the benchmark, -1 when none are logged */
+static double get_logged_page_faults(const char* benchmark_name)
+{
+    double result = -1;
+    char expected[256];
+    (void)snprintf(expected, sizeof(expected), "Test %s counters per iteration: ", benchmark_name);
+    const char* counters = strstr(ctest_ut_get_captured_log(), expected);
+    const char* end_of_line = (counters == NULL) ? NULL : strchr(counters, '\n');
+    const char* page_faults = (counters == NULL) ? NULL : strstr(counters, "page faults ");
+    if ((page_faults != NULL) && ((end_of_line == NULL) || (page_faults < end_of_line)) &&
+        (sscanf(page_faults + strlen("page faults "), "%lf", &result) != 1))
+    {
+        result = -1;
+    }
+    return result;
+}
+
+/* CMakeLists.txt runs this executable with CTEST_BENCHMARK_MIN_TIME_MS=20 */
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    {
+        size_t temp_failed_tests = 0;
+        ctest_benchmark_ut_reset_counts();
+        CTEST_RUN_TEST_SUITE(ctest_benchmark_ut, temp_failed_tests);
+        if (temp_failed_tests != 1) // benchmark_that_fails
+        {
+            LogError("CTEST TEST FAILED !!! ctest_benchmark_ut expected 1 failed benchmark, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        /* calibration plus 10 samples */
+        if ((ctest_benchmark_ut_get_sum_call_count() <= 10) || (ctest_benchmark_ut_get_store_call_count() <= 10))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_benchmark_ut expected the benchmarks to loop, got %" PRIu64 " and %" PRIu64 " calls",
+                ctest_benchmark_ut_get_sum_call_count(), ctest_benchmark_ut_get_store_call_count());
+            failedTests++;
+        }
+        /* the function fixtures run once around each benchmark, not around each iteration */
+        if ((ctest_benchmark_ut_get_test_function_initialize_count() != 5) || (ctest_benchmark_ut_get_test_function_cleanup_count() != 5))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_benchmark_ut expected 5 TEST_FUNCTION_INITIALIZE and TEST_FUNCTION_CLEANUP, got %d and %d",
+                ctest_benchmark_ut_get_test_function_initialize_count(), ctest_benchmark_ut_get_test_function_cleanup_count());
+            failedTests++;
+        }
+    }
+
+    {
+        /* 0 runs each benchmark body once */
+        char* argv[] = { "ctest_benchmark_ut", "--ctest_benchmark_min_time_ms=0" };
+        size_t temp_failed_tests = 0;
+        if (ctest_parse_command_line(2, argv) != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+            failedTests++;
+        }
+        ctest_benchmark_ut_reset_counts();
+        CTEST_RUN_TEST_SUITE(ctest_benchmark_ut, temp_failed_tests, "benchmark_sum,benchmark_store");
+        if (temp_failed_tests != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_benchmark_ut with CTEST_BENCHMARK_MIN_TIME_MS=0 expected no failure, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if ((ctest_benchmark_ut_get_sum_call_count() != 1) || (ctest_benchmark_ut_get_store_call_count() != 1))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_benchmark_ut with CTEST_BENCHMARK_MIN_TIME_MS=0 expected 1 call of each benchmark, got %" PRIu64 " and %" PRIu64,
+                ctest_benchmark_ut_get_sum_call_count(), ctest_benchmark_ut_get_store_call_count());
+            failedTests++;
+        }
+    }
+
+    {
+        /* the counters the kernel denies (all of them on some machines) are not counted, the run is the same */
+        char* argv[] = { "ctest_benchmark_ut", "--ctest_benchmark_min_time_ms=20", "--ctest_perf_counters=1" };
+        size_t temp_failed_tests = 0;
+        if (ctest_parse_command_line(3, argv) != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+            failedTests++;
+        }
+        ctest_benchmark_ut_reset_counts();
+        ctest_ut_begin_log_capture();
+        CTEST_RUN_TEST_SUITE(ctest_benchmark_ut, temp_failed_tests, "-benchmark_that_fails");
+        ctest_ut_end_log_capture();
+        if (temp_failed_tests != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_benchmark_ut with CTEST_PERF_COUNTERS=1 expected no failure, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if ((ctest_benchmark_ut_get_sum_call_count() <= 10) || (ctest_benchmark_ut_get_store_call_count() <= 10))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_benchmark_ut with CTEST_PERF_COUNTERS=1 expected the benchmarks to loop, got %" PRIu64 " and %" PRIu64 " calls",
+                ctest_benchmark_ut_get_sum_call_count(), ctest_benchmark_ut_get_store_call_count());
+            failedTests++;
+        }
+        /* where the kernel allows it, the software counters are counted: the benchmark mapping new memory faults at each iteration */
+        if (!can_count_page_faults())
+        {
+            LogInfo("Page faults cannot be counted on this machine, their values are not checked");
+        }
+        else
+        {
+            double page_faults = get_logged_page_faults("benchmark_that_touches_memory");
+            if (page_faults <= 0)
+            {
+                LogError("CTEST TEST FAILED !!! ctest_benchmark_ut with CTEST_PERF_COUNTERS=1 expected page faults for benchmark_that_touches_memory, got %.2f in:\n%s",
+                    page_faults, ctest_ut_get_captured_log());
+                failedTests++;
+            }
+        }
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined _MSC_VER
+#include <unistd.h>
+#endif
+
+#include "ctest.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_capture_ut)
+
+CTEST_FUNCTION(test_that_writes_and_fails)
+{
+    (void)printf("stdout of the failing test\n");
+    (void)fprintf(stderr, "stderr of the failing test\n");
+#if !defined _MSC_VER
+    /* not through stdio */
+    const char text[] = "file descriptor 1 of the failing test\n";
+    (void)!write(1, text, strlen(text));
+#endif
+    CTEST_ASSERT_FAIL("failure of the test that writes");
+}
+
+CTEST_FUNCTION(test_that_writes_and_passes)
+{
+    (void)printf("stdout of the passing test\n");
+    (void)fprintf(stderr, "stderr of the passing test\n");
+}
+
+CTEST_END_TEST_SUITE(ctest_capture_ut)
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined _MSC_VER
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+/* the output of the failed test is in the report, the one of the passed test is not */
+static size_t check_report(const char* path)
+{
+    size_t result = 0;
+    /* the output is not captured on Windows */
+#if !defined _MSC_VER
+    result += CTEST_UT_CHECK_FILE(path, 1, NULL, "stdout of the failing test", "stderr of the failing test", "file descriptor 1 of the failing test", "\"output\": \"");
+#endif
+    result += CTEST_UT_CHECK_FILE(path, 0, NULL, "stdout of the passing test", "stderr of the passing test");
+    return result;
+}
+
+static size_t run_suite(const char* report_path)
+{
+    size_t result = 0;
+    size_t failed_tests = 0;
+    char report_option[64];
+    (void)snprintf(report_option, sizeof(report_option), "--ctest_report_json=%s", report_path);
+    char* argv[] = { "ctest_capture_ut", "--ctest_capture_output=1", report_option };
+
+    if (ctest_parse_command_line(3, argv) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+        result++;
+    }
+    else
+    {
+        CTEST_RUN_TEST_SUITE(ctest_capture_ut, failed_tests);
+        if (failed_tests != 1)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_capture_ut expected 1 failed test, got %zu", failed_tests);
+            result++;
+        }
+    }
+    return result;
+}
+
+#if !defined _MSC_VER
+/* the configuration is read by the first RunTests, the tests run in worker processes from a child process that did not call it yet */
+static size_t run_suite_in_worker_processes(void)
+{
+    size_t result;
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LogError("CTEST TEST FAILED !!! fork failed");
+        result = 1;
+    }
+    else if (pid == 0)
+    {
+        (void)setenv("CTEST_WORKER_PROCESSES", "2", 1);
+        (void)fflush(NULL);
+        _exit((int)run_suite("ctest_capture_workers_ut.json"));
+    }
+    else
+    {
+        int status;
+        if (waitpid(pid, &status, 0) != pid)
+        {
+            LogError("CTEST TEST FAILED !!! waitpid failed");
+            result = 1;
+        }
+        else if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+        {
+            LogError("CTEST TEST FAILED !!! the suite run in worker processes failed, status=%d", status);
+            result = 1;
+        }
+        else
+        {
+            result = check_report("ctest_capture_workers_ut.json");
+        }
+    }
+    return result;
+}
+#endif
+
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+#if !defined _MSC_VER
+    failedTests += run_suite_in_worker_processes();
+#endif
+
+    failedTests += run_suite("ctest_capture_ut.json");
+    failedTests += check_report("ctest_capture_ut.json");
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>
+#include <sys/mman.h>
+
+#include "ctest.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_crash_recovery_unsafe_ut)
+
+CTEST_FUNCTION(test_that_succeeds_after_the_crash)
+{
+}
+
+/* a fault away from the NULL page, as a wild pointer would make */
+CTEST_FUNCTION(test_that_writes_to_a_protected_page)
+{
+    volatile int* page = mmap(NULL, 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CTEST_ASSERT_IS_TRUE(page != MAP_FAILED);
+    *page = 42;
+}
+
+CTEST_END_TEST_SUITE(ctest_crash_recovery_unsafe_ut)
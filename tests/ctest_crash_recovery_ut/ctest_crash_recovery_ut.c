@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <signal.h>
+#include <stddef.h>
+
+#include "ctest.h"
+
+static int g_test_count_after_the_crashes = 0;
+
+CTEST_BEGIN_TEST_SUITE(ctest_crash_recovery_ut)
+
+/* the tests run in reverse order, this one runs last */
+CTEST_FUNCTION(test_that_runs_after_the_crashes)
+{
+    g_test_count_after_the_crashes++;
+    CTEST_ASSERT_ARE_EQUAL(int, 1, g_test_count_after_the_crashes);
+}
+
+CTEST_FUNCTION(test_that_raises_SIGFPE)
+{
+    (void)raise(SIGFPE);
+}
+
+CTEST_FUNCTION(test_that_dereferences_NULL)
+{
+    volatile int* volatile pointer = NULL;
+    *pointer = 42;
+}
+
+CTEST_END_TEST_SUITE(ctest_crash_recovery_ut)
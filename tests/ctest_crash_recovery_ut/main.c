@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <signal.h>
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+/* a crash that the policy does not recover ends the process, so the suite runs in a child process that did not call RunTests yet (the
+   configuration is read by the first RunTests). Returns the status of the child. */
+static int run_unsafe_suite_in_child_process(const char* crash_recovery_option)
+{
+    int result;
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LogError("CTEST TEST FAILED !!! fork failed");
+        result = -1;
+    }
+    else if (pid == 0)
+    {
+        size_t failed_tests = 0;
+        char* argv[] = { "ctest_crash_recovery_ut", (char*)crash_recovery_option };
+        if (ctest_parse_command_line(2, argv) == 0)
+        {
+            CTEST_RUN_TEST_SUITE(ctest_crash_recovery_unsafe_ut, failed_tests);
+        }
+        (void)fflush(NULL);
+        _exit((int)failed_tests);
+    }
+    else
+    {
+        if (waitpid(pid, &result, 0) != pid)
+        {
+            LogError("CTEST TEST FAILED !!! waitpid failed");
+            result = -1;
+        }
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+    char* argv[] = { "ctest_crash_recovery_ut", "--ctest_crash_recovery=1", "--ctest_report_json=ctest_crash_recovery_ut.json" };
+
+    (void)logger_init();
+
+    /* a fault away from the NULL page ends the process with CTEST_CRASH_RECOVERY=1 */
+    int status = run_unsafe_suite_in_child_process("--ctest_crash_recovery=1");
+    if (!WIFSIGNALED(status) || (WTERMSIG(status) != SIGSEGV))
+    {
+        LogError("CTEST TEST FAILED !!! with CTEST_CRASH_RECOVERY=1 the process was expected to crash, status=%d", status);
+        failedTests++;
+    }
+
+    /* and is recovered with CTEST_CRASH_RECOVERY=2 */
+    status = run_unsafe_suite_in_child_process("--ctest_crash_recovery=2");
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != 1))
+    {
+        LogError("CTEST TEST FAILED !!! with CTEST_CRASH_RECOVERY=2 1 failed test was expected, status=%d", status);
+        failedTests++;
+    }
+
+    if (ctest_parse_command_line(3, argv) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+        failedTests++;
+    }
+    else
+    {
+        size_t temp_failed_tests = 0;
+        CTEST_RUN_TEST_SUITE(ctest_crash_recovery_ut, temp_failed_tests);
+        if (temp_failed_tests != 2)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_crash_recovery_ut expected 2 failed tests, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+
+        static const char* const expected[] =
+        {
+            "{ \"name\": \"test_that_dereferences_NULL\", \"result\": \"failed\", \"message\": \"crashed with SIGSEGV\"",
+            "{ \"name\": \"test_that_raises_SIGFPE\", \"result\": \"failed\", \"message\": \"crashed with SIGFPE\"",
+            "{ \"name\": \"test_that_runs_after_the_crashes\", \"result\": \"passed\""
+        };
+        failedTests += ctest_ut_check_file("ctest_crash_recovery_ut.json", expected, sizeof(expected) / sizeof(expected[0]), CTEST_UT_AT_LEAST_ONCE, NULL);
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+
+#include "ctest.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_events_ut)
+
+CTEST_FUNCTION(test_that_fails_an_is_true)
+{
+    bool is_done = false;
+    CTEST_ASSERT_IS_TRUE(is_done, "not \"done\"");
+}
+
+CTEST_FUNCTION(test_that_fails)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 3, 1 + 1);
+}
+
+CTEST_FUNCTION(test_that_succeeds)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 2, 1 + 1);
+}
+
+CTEST_END_TEST_SUITE(ctest_events_ut)
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+#if defined _MSC_VER
+#define ctest_events_ut_fileno _fileno
+#else
+#define ctest_events_ut_fileno fileno
+#endif
+
+#define EVENTS_PATH "ctest_events_ut.events"
+
+/* the events at path, one per line, are 10, start with expected_start, end with the line starting with expected_end and every test
+   that started ended */
+static size_t check_event_order(const char* path, const char* expected_start, const char* expected_end)
+{
+    size_t result = 0;
+    char* text = ctest_ut_read_file(path);
+    if (text == NULL)
+    {
+        result = 1;
+    }
+    else
+    {
+        if (strncmp(text, expected_start, strlen(expected_start)) != 0)
+        {
+            LogError("CTEST TEST FAILED !!! expected the events to start with %s:\n%s", expected_start, text);
+            result++;
+        }
+        const char* end = strstr(text, expected_end);
+        if ((end == NULL) || (strchr(end, '\n') != text + strlen(text) - 1))
+        {
+            LogError("CTEST TEST FAILED !!! expected the events to end with %s:\n%s", expected_end, text);
+            result++;
+        }
+        if (ctest_ut_count_occurrences(text, "\n") != 10)
+        {
+            LogError("CTEST TEST FAILED !!! expected 10 events:\n%s", text);
+            result++;
+        }
+        if (ctest_ut_count_occurrences(text, "\"event\":\"test_start\"") != ctest_ut_count_occurrences(text, "\"event\":\"test_end\""))
+        {
+            LogError("CTEST TEST FAILED !!! expected a test_end for each test_start:\n%s", text);
+            result++;
+        }
+        free(text);
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    FILE* file = fopen(EVENTS_PATH, "w");
+    if (file == NULL)
+    {
+        LogError("CTEST TEST FAILED !!! cannot create %s", EVENTS_PATH);
+        failedTests++;
+    }
+    else
+    {
+        char event_fd_option[64];
+        (void)snprintf(event_fd_option, sizeof(event_fd_option), "--ctest_event_fd=%d", ctest_events_ut_fileno(file));
+        char* argv[] = { "ctest_events_ut", event_fd_option };
+
+        if (ctest_parse_command_line(2, argv) != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+            failedTests++;
+        }
+        else
+        {
+            size_t temp_failed_tests = 0;
+            CTEST_RUN_TEST_SUITE(ctest_events_ut, temp_failed_tests);
+            if (temp_failed_tests != 2)
+            {
+                LogError("CTEST TEST FAILED !!! ctest_events_ut expected 2 failed tests, got %zu", temp_failed_tests);
+                failedTests++;
+            }
+
+            failedTests += check_event_order(EVENTS_PATH,
+                "{\"event\":\"suite_start\",\"suite\":\"ctest_events_ut\",\"test_count\":3}\n",
+                "{\"event\":\"suite_end\",\"suite\":\"ctest_events_ut\",\"executed\":3,\"failed\":2,\"skipped\":0,\"wall_ms\":");
+            failedTests += CTEST_UT_CHECK_FILE(EVENTS_PATH, 1, NULL,
+                "{\"event\":\"test_start\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_succeeds\"}\n",
+                "{\"event\":\"test_start\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_fails\"}\n",
+                "{\"event\":\"test_start\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_fails_an_is_true\"}\n",
+                "{\"event\":\"assert_failed\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_fails\",\"line\":18,\"expected\":\"3\",\"actual\":\"2\"}\n",
+                "{\"event\":\"assert_failed\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_fails_an_is_true\",\"line\":13,\"expression\":\"is_done\",\"expected\":\"true\",\"actual\":\"false\",\"message\":\"not \\\"done\\\"\"}\n",
+                "{\"event\":\"test_end\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_succeeds\",\"result\":\"passed\",\"wall_ms\":",
+                "{\"event\":\"test_end\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_fails\",\"result\":\"failed\",\"wall_ms\":",
+                "{\"event\":\"test_end\",\"suite\":\"ctest_events_ut\",\"test\":\"test_that_fails_an_is_true\",\"result\":\"failed\",\"wall_ms\":");
+        }
+        (void)fclose(file);
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "ctest.h"
+
+#include "ctest_fork_ut.h"
+
+static pid_t suite_pid;
+static int suite_state;
+static int suite_initialize_count;
+static int suite_cleanup_count;
+static int test_function_initialize_count;
+static int test_state;
+
+int ctest_fork_ut_get_suite_initialize_count(void)
+{
+    return suite_initialize_count;
+}
+
+int ctest_fork_ut_get_suite_cleanup_count(void)
+{
+    return suite_cleanup_count;
+}
+
+int ctest_fork_ut_get_test_function_initialize_count(void)
+{
+    return test_function_initialize_count;
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_fork_ut)
+
+CTEST_SUITE_INITIALIZE()
+{
+    suite_pid = getpid();
+    suite_state = 42;
+    suite_initialize_count++;
+}
+
+CTEST_SUITE_CLEANUP()
+{
+    suite_cleanup_count++;
+}
+
+CTEST_FUNCTION_INITIALIZE()
+{
+    test_function_initialize_count++;
+    test_state = 0;
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+}
+
+CTEST_FUNCTION(test_runs_in_a_worker_process)
+{
+    CTEST_ASSERT_ARE_NOT_EQUAL(int, (int)suite_pid, (int)getpid());
+}
+
+CTEST_FUNCTION(test_sees_the_state_of_suite_initialize)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 42, suite_state);
+    CTEST_ASSERT_ARE_EQUAL(int, 1, suite_initialize_count);
+}
+
+CTEST_FUNCTION(test_that_crashes_its_worker)
+{
+    (void)raise(SIGSEGV);
+}
+
+CTEST_FUNCTION(test_that_exits_its_worker)
+{
+    exit(3);
+}
+
+CTEST_FUNCTION(test_that_fails)
+{
+    CTEST_ASSERT_FAIL("expected failure");
+}
+
+CTEST_FUNCTION(test_after_the_crash_1)
+{
+    test_state++;
+    CTEST_ASSERT_ARE_EQUAL(int, 1, test_state);
+}
+
+CTEST_FUNCTION(test_after_the_crash_2)
+{
+    test_state++;
+    CTEST_ASSERT_ARE_EQUAL(int, 1, test_state);
+}
+
+CTEST_FUNCTION_NOT_THREAD_SAFE(test_not_thread_safe_runs_in_a_worker_process)
+{
+    CTEST_ASSERT_ARE_NOT_EQUAL(int, (int)suite_pid, (int)getpid());
+}
+
+CTEST_END_TEST_SUITE(ctest_fork_ut)
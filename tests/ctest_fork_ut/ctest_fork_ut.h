@@ -0,0 +1,11 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_FORK_UT_H
+#define CTEST_FORK_UT_H
+
+int ctest_fork_ut_get_suite_initialize_count(void);
+int ctest_fork_ut_get_suite_cleanup_count(void);
+int ctest_fork_ut_get_test_function_initialize_count(void);
+
+#endif /* CTEST_FORK_UT_H */
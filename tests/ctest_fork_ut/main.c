@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_fork_ut.h"
+
+/* CMakeLists.txt runs this executable with CTEST_WORKER_PROCESSES=3 */
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    {
+        size_t temp_failed_tests = 0;
+        CTEST_RUN_TEST_SUITE(ctest_fork_ut, temp_failed_tests);
+        if (temp_failed_tests != 3) // 1 failing test and 2 tests ending their worker process
+        {
+            LogError("CTEST TEST FAILED !!! ctest_fork_ut expected 3 failed tests, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if (ctest_fork_ut_get_suite_initialize_count() != 1)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_fork_ut expected 1 suite initialize, got %d", ctest_fork_ut_get_suite_initialize_count());
+            failedTests++;
+        }
+        if (ctest_fork_ut_get_suite_cleanup_count() != 1)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_fork_ut expected 1 suite cleanup, got %d", ctest_fork_ut_get_suite_cleanup_count());
+            failedTests++;
+        }
+        if (ctest_fork_ut_get_test_function_initialize_count() != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_fork_ut tests ran in the process calling RunTests");
+            failedTests++;
+        }
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "ctest.h"
+
+/* how many times each test ran in the process, checked by main */
+size_t g_journal_ut_run_counts[5];
+
+/* the crashing run has 2 worker threads: test_that_crashes_when_asked aborts while test_that_is_interrupted runs on the other one */
+static volatile bool g_is_interrupted_test_running = false;
+
+CTEST_BEGIN_TEST_SUITE(ctest_journal_ut)
+
+CTEST_FUNCTION(test_that_runs_last)
+{
+    g_journal_ut_run_counts[3]++;
+}
+
+CTEST_FUNCTION(test_that_crashes_when_asked)
+{
+    g_journal_ut_run_counts[2]++;
+    if (getenv("CTEST_JOURNAL_UT_CRASH") != NULL)
+    {
+        for (int i = 0; (i < 500) && !g_is_interrupted_test_running; i++)
+        {
+            (void)usleep(10000);
+        }
+        /* test_that_runs_first and test_that_fails started before it, let them end */
+        (void)usleep(100000);
+        abort();
+    }
+}
+
+CTEST_FUNCTION(test_that_is_interrupted)
+{
+    g_journal_ut_run_counts[4]++;
+    if (getenv("CTEST_JOURNAL_UT_CRASH") != NULL)
+    {
+        g_is_interrupted_test_running = true;
+        (void)sleep(10);
+    }
+}
+
+CTEST_FUNCTION(test_that_fails)
+{
+    g_journal_ut_run_counts[1]++;
+    CTEST_ASSERT_FAIL("expected failure");
+}
+
+CTEST_FUNCTION(test_that_runs_first)
+{
+    g_journal_ut_run_counts[0]++;
+}
+
+CTEST_END_TEST_SUITE(ctest_journal_ut)
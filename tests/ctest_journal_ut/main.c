@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+#define JOURNAL_PATH "ctest_journal_ut.journal"
+#define REPORT_PATH "ctest_journal_ut.json"
+#define EVENTS_PATH "ctest_journal_ut.events"
+
+extern size_t g_journal_ut_run_counts[5];
+
+static long get_file_size(const char* path)
+{
+    struct stat file_stat;
+    return (stat(path, &file_stat) == 0) ? (long)file_stat.st_size : -1;
+}
+
+/* each run is a new process (the configuration is read by the first RunTests, and the previous run has to crash). The child exits
+   with its failed test count plus 8 times a bit mask of the tests that ran (bit 0 for test_that_runs_first, ... bit 4 for
+   test_that_is_interrupted). The events of the child go to EVENTS_PATH. Returns the status of the child. */
+static int run_suite_in_child_process(const char* resume_option, bool crash)
+{
+    int result;
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LogError("CTEST TEST FAILED !!! fork failed");
+        result = -1;
+    }
+    else if (pid == 0)
+    {
+        size_t failed_tests = 0;
+        int ran_tests_mask = 0;
+        char event_fd_option[64];
+        int event_fd = open(EVENTS_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        (void)snprintf(event_fd_option, sizeof(event_fd_option), "--ctest_event_fd=%d", event_fd);
+        char* argv[] = { "ctest_journal_ut", "--ctest_journal=" JOURNAL_PATH, "--ctest_report_json=" REPORT_PATH, event_fd_option, (char*)resume_option };
+        if (crash)
+        {
+            (void)setenv("CTEST_JOURNAL_UT_CRASH", "1", 1);
+            (void)setenv("CTEST_WORKER_THREADS", "2", 1);
+        }
+        if ((event_fd != -1) && (ctest_parse_command_line(5, argv) == 0))
+        {
+            CTEST_RUN_TEST_SUITE(ctest_journal_ut, failed_tests);
+        }
+        for (int i = 0; i < 5; i++)
+        {
+            if (g_journal_ut_run_counts[i] > 0)
+            {
+                ran_tests_mask |= 1 << i;
+            }
+        }
+        (void)fflush(NULL);
+        _exit((int)failed_tests + 8 * ran_tests_mask);
+    }
+    else
+    {
+        if (waitpid(pid, &result, 0) != pid)
+        {
+            LogError("CTEST TEST FAILED !!! waitpid failed");
+            result = -1;
+        }
+    }
+    return result;
+}
+
+static size_t check_exit_code(int status, int expected_exit_code, const char* run)
+{
+    size_t result = 0;
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != expected_exit_code))
+    {
+        LogError("CTEST TEST FAILED !!! %s: expected exit code %d, status=%d", run, expected_exit_code, status);
+        result = 1;
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    /* the first run crashes in test_that_crashes_when_asked, after test_that_runs_first and test_that_fails ended, while
+       test_that_is_interrupted runs on the other thread */
+    int status = run_suite_in_child_process("--ctest_resume=0", true);
+    if (!WIFSIGNALED(status) || (WTERMSIG(status) != SIGABRT))
+    {
+        LogError("CTEST TEST FAILED !!! the first run was expected to crash, status=%d", status);
+        failedTests++;
+    }
+
+    /* the run resumed from the journal runs test_that_runs_last and the interrupted test again, the crashed test fails */
+    status = run_suite_in_child_process("--ctest_resume=1", false);
+    failedTests += check_exit_code(status, 2 + 8 * 0x18, "the resumed run");
+    static const char* const expected[] =
+    {
+        "{ \"name\": \"test_that_runs_first\", \"result\": \"passed\"",
+        "{ \"name\": \"test_that_fails\", \"result\": \"failed\", \"message\": \"failed in a previous run\"",
+        "{ \"name\": \"test_that_is_interrupted\", \"result\": \"passed\"",
+        "{ \"name\": \"test_that_crashes_when_asked\", \"result\": \"failed\", \"message\": \"crashed with SIGABRT in the previous run\"",
+        "{ \"name\": \"test_that_runs_last\", \"result\": \"passed\""
+    };
+    failedTests += ctest_ut_check_file(REPORT_PATH, expected, sizeof(expected) / sizeof(expected[0]), CTEST_UT_AT_LEAST_ONCE, NULL);
+    /* the resumed results are events too */
+    static const char* const expected_events[] =
+    {
+        "{\"event\":\"test_end\",\"suite\":\"ctest_journal_ut\",\"test\":\"test_that_runs_first\",\"result\":\"passed\"",
+        "{\"event\":\"test_end\",\"suite\":\"ctest_journal_ut\",\"test\":\"test_that_fails\",\"result\":\"failed\",\"message\":\"failed in a previous run\"",
+        "{\"event\":\"test_end\",\"suite\":\"ctest_journal_ut\",\"test\":\"test_that_crashes_when_asked\",\"result\":\"failed\",\"message\":\"crashed with SIGABRT in the previous run\""
+    };
+    failedTests += ctest_ut_check_file(EVENTS_PATH, expected_events, sizeof(expected_events) / sizeof(expected_events[0]), CTEST_UT_AT_LEAST_ONCE, NULL);
+
+    /* a partial record at the end (the machine went down while it was written) is cut, everything ended the runs before */
+    long journal_size = get_file_size(JOURNAL_PATH);
+    FILE* journal = fopen(JOURNAL_PATH, "ab");
+    if ((journal == NULL) || (fwrite("JRNL\x01", 1, 5, journal) != 5) || (fclose(journal) != 0))
+    {
+        LogError("CTEST TEST FAILED !!! cannot append to %s", JOURNAL_PATH);
+        failedTests++;
+    }
+    status = run_suite_in_child_process("--ctest_resume=1", false);
+    failedTests += check_exit_code(status, 2, "the run resumed again");
+    if (get_file_size(JOURNAL_PATH) != journal_size)
+    {
+        LogError("CTEST TEST FAILED !!! the partial record was not cut, journal size %ld instead of %ld", get_file_size(JOURNAL_PATH), journal_size);
+        failedTests++;
+    }
+
+    /* without resuming, a new journal is started and all the tests run */
+    status = run_suite_in_child_process("--ctest_resume=0", false);
+    failedTests += check_exit_code(status, 1 + 8 * 0x1F, "the new run");
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Integration test for the allocation assertions (CTEST_ASSERT_NO_ALLOCATIONS_BEGIN/END and
+// CTEST_ASSERT_MAX_ALLOCATIONS), which count allocations with the Linux allocation tracker. The
+// tests named ..._fails exceed their limits or fail an assert inside a scope, this process exits 0
+// when exactly those failed.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#define EXPECTED_FAILED_TEST_COUNT 5
+
+static volatile size_t g_sum;
+
+/* out of line, the allocation site reported for the failures */
+static void* allocate_message(size_t size)
+{
+    void* result = malloc(size);
+    if (result != NULL)
+    {
+        (void)memset(result, 0, size);
+    }
+    return result;
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_leak_check_allocation_assert_int)
+
+CTEST_FUNCTION(no_allocations_passes_for_code_that_does_not_allocate)
+{
+    size_t values[16] = { 0 };
+
+    CTEST_ASSERT_NO_ALLOCATIONS_BEGIN();
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        values[i] = i * i;
+        g_sum += values[i];
+    }
+    CTEST_ASSERT_NO_ALLOCATIONS_END();
+}
+
+CTEST_FUNCTION(no_allocations_fails_for_a_malloc)
+{
+    CTEST_ASSERT_NO_ALLOCATIONS_BEGIN();
+    void* message = allocate_message(32);
+    free(message);
+    CTEST_ASSERT_NO_ALLOCATIONS_END();
+}
+
+CTEST_FUNCTION(max_allocations_passes_within_the_limits)
+{
+    void* message = NULL;
+
+    CTEST_ASSERT_MAX_ALLOCATIONS(1, 64)
+    {
+        message = allocate_message(64);
+    }
+
+    CTEST_ASSERT_IS_NOT_NULL(message);
+    free(message);
+}
+
+CTEST_FUNCTION(max_allocations_fails_over_the_allocation_count)
+{
+    CTEST_ASSERT_MAX_ALLOCATIONS(1, 1024)
+    {
+        void* first = allocate_message(16);
+        void* second = allocate_message(16);
+        free(first);
+        free(second);
+    }
+}
+
+CTEST_FUNCTION(max_allocations_fails_over_the_bytes)
+{
+    CTEST_ASSERT_MAX_ALLOCATIONS(1, 64)
+    {
+        free(allocate_message(128));
+    }
+}
+
+CTEST_FUNCTION(max_allocations_counts_the_allocations_of_nested_scopes)
+{
+    void* first = NULL;
+    void* second = NULL;
+
+    CTEST_ASSERT_MAX_ALLOCATIONS(2, 128)
+    {
+        CTEST_ASSERT_MAX_ALLOCATIONS(1, 64)
+        {
+            first = allocate_message(64);
+        }
+        second = allocate_message(64);
+    }
+
+    free(first);
+    free(second);
+}
+
+/* the tests run in the reverse order of their definition, so each of the ..._does_not_count_in_the_failed_scope tests runs right after the
+   failing test following it. A failed assert jumps over the end of its scopes: were the scope of the failed test still counting, the
+   allocations would be written over the stack, where the dead scope was and where the pattern is now */
+#define STACK_PATTERN_SIZE 8192
+#define STACK_PATTERN 0x5A
+
+static void check_allocations_do_not_count_in_a_failed_scope(void)
+{
+    volatile unsigned char stack[STACK_PATTERN_SIZE];
+    size_t overwritten_count = 0;
+
+    for (size_t i = 0; i < STACK_PATTERN_SIZE; i++)
+    {
+        stack[i] = STACK_PATTERN;
+    }
+    for (size_t i = 0; i < 16; i++)
+    {
+        free(allocate_message(32));
+    }
+    for (size_t i = 0; i < STACK_PATTERN_SIZE; i++)
+    {
+        overwritten_count += (stack[i] != STACK_PATTERN) ? 1 : 0;
+    }
+
+    CTEST_ASSERT_ARE_EQUAL(size_t, 0, overwritten_count);
+
+    void* message = NULL;
+    CTEST_ASSERT_MAX_ALLOCATIONS(1, 64)
+    {
+        message = allocate_message(64);
+    }
+    free(message);
+}
+
+CTEST_FUNCTION(allocation_after_a_failed_assert_does_not_count_in_the_failed_scope)
+{
+    check_allocations_do_not_count_in_a_failed_scope();
+}
+
+CTEST_FUNCTION(assert_inside_no_allocations_fails)
+{
+    CTEST_ASSERT_NO_ALLOCATIONS_BEGIN();
+    CTEST_ASSERT_ARE_EQUAL(int, 1, 2);
+    CTEST_ASSERT_NO_ALLOCATIONS_END();
+}
+
+CTEST_FUNCTION(allocation_after_a_failed_nested_scope_does_not_count_in_the_failed_scope)
+{
+    check_allocations_do_not_count_in_a_failed_scope();
+}
+
+CTEST_FUNCTION(nested_max_allocations_fails_over_the_inner_limit)
+{
+    CTEST_ASSERT_MAX_ALLOCATIONS(4, 1024)
+    {
+        CTEST_ASSERT_MAX_ALLOCATIONS(1, 1024)
+        {
+            free(allocate_message(16));
+            free(allocate_message(16));
+        }
+    }
+}
+
+CTEST_END_TEST_SUITE(ctest_leak_check_allocation_assert_int)
+
+int main(void)
+{
+    size_t failedTestCount = 0;
+
+    (void)logger_init();
+
+    CTEST_RUN_TEST_SUITE(ctest_leak_check_allocation_assert_int, failedTestCount);
+    if (failedTestCount != EXPECTED_FAILED_TEST_COUNT)
+    {
+        LogError("CTEST TEST FAILED !!! expected %d failed tests, %zu tests failed", EXPECTED_FAILED_TEST_COUNT, failedTestCount);
+    }
+
+    logger_deinit();
+
+    return (failedTestCount == EXPECTED_FAILED_TEST_COUNT) ? 0 : 1;
+}
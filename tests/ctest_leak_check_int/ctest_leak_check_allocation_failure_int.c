@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Integration test for the allocation failure sweep (--ctest_allocation_failure_sweep), which runs each
+// test again in forked processes with each of its allocations failing in turn. The tests named ..._fails
+// mishandle a failed allocation, this process exits 0 when exactly those failed.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#define EXPECTED_FAILED_TEST_COUNT 2
+
+typedef struct NAME_PAIR_TAG
+{
+    char* first;
+    char* second;
+} NAME_PAIR;
+
+static char* copy_name(const char* name)
+{
+    size_t size = strlen(name) + 1;
+    char* result = malloc(size);
+    if (result != NULL)
+    {
+        (void)memcpy(result, name, size);
+    }
+    return result;
+}
+
+/* frees what it allocated when an allocation fails */
+static NAME_PAIR* name_pair_create(const char* first, const char* second)
+{
+    NAME_PAIR* result = malloc(sizeof(NAME_PAIR));
+    if (result != NULL)
+    {
+        result->first = copy_name(first);
+        if (result->first == NULL)
+        {
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->second = copy_name(second);
+            if (result->second == NULL)
+            {
+                free(result->first);
+                free(result);
+                result = NULL;
+            }
+        }
+    }
+    return result;
+}
+
+/* leaks the pair when the copy of the second name fails */
+static NAME_PAIR* name_pair_create_leaking(const char* first, const char* second)
+{
+    NAME_PAIR* result = malloc(sizeof(NAME_PAIR));
+    if (result != NULL)
+    {
+        result->first = copy_name(first);
+        result->second = copy_name(second);
+        if ((result->first == NULL) || (result->second == NULL))
+        {
+            result = NULL;
+        }
+    }
+    return result;
+}
+
+static void name_pair_destroy(NAME_PAIR* pair)
+{
+    free(pair->first);
+    free(pair->second);
+    free(pair);
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_leak_check_allocation_failure_int)
+
+CTEST_FUNCTION(handled_allocation_failures_pass)
+{
+    NAME_PAIR* pair = name_pair_create("left", "right");
+
+    if (ctest_is_allocation_failure_injected())
+    {
+        CTEST_ASSERT_IS_NULL(pair);
+    }
+    else
+    {
+        CTEST_ASSERT_IS_NOT_NULL(pair);
+        CTEST_ASSERT_ARE_EQUAL(char_ptr, "left", pair->first);
+        CTEST_ASSERT_ARE_EQUAL(char_ptr, "right", pair->second);
+        name_pair_destroy(pair);
+    }
+}
+
+CTEST_FUNCTION(a_leak_on_an_error_path_fails)
+{
+    NAME_PAIR* pair = name_pair_create_leaking("left", "right");
+
+    if (pair != NULL)
+    {
+        name_pair_destroy(pair);
+    }
+}
+
+CTEST_FUNCTION(an_unchecked_allocation_fails)
+{
+    char* name = malloc(8);
+
+    /* crashes when the allocation fails */
+    (void)memcpy(name, "unsafe", 7);
+    CTEST_ASSERT_ARE_EQUAL(char_ptr, "unsafe", name);
+    free(name);
+}
+
+CTEST_END_TEST_SUITE(ctest_leak_check_allocation_failure_int)
+
+int main(void)
+{
+    size_t failedTestCount = 0;
+    char* argv[] = { "ctest_leak_check_allocation_failure_int", "--ctest_allocation_failure_sweep=100", NULL };
+
+    (void)logger_init();
+
+    if (ctest_parse_command_line(2, argv) != 0)
+    {
+        failedTestCount = 1;
+    }
+    else
+    {
+        CTEST_RUN_TEST_SUITE(ctest_leak_check_allocation_failure_int, failedTestCount);
+        if (failedTestCount != EXPECTED_FAILED_TEST_COUNT)
+        {
+            LogError("CTEST TEST FAILED !!! expected %d failed tests, %zu tests failed", EXPECTED_FAILED_TEST_COUNT, failedTestCount);
+        }
+        failedTestCount = (failedTestCount == EXPECTED_FAILED_TEST_COUNT) ? 0 : 1;
+    }
+
+    logger_deinit();
+
+    return (int)failedTestCount;
+}
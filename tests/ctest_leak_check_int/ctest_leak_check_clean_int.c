@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
-// Integration test for ctest's at-exit VLD leak check (ctest_check_leaks_at_exit in src/ctest.c).
+// Integration test for ctest's at-exit leak check (ctest_check_leaks_at_exit in src/ctest.c).
 // An allocation freed before the test ends is not a leak, so this process exits 0.
 
 #include <stddef.h>
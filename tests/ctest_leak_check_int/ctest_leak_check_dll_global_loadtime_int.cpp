@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
-// Regression test for ctest's at-exit VLD leak check (ctest_check_leaks_at_exit in src/ctest.c).
+// Regression test for ctest's at-exit leak check (ctest_check_leaks_at_exit in src/ctest.c).
 // The helper DLL is load-time (implicitly) linked, so its process-lifetime global is constructed
 // during DLL initialization before main and is captured in the leak baseline. This process exits 0.
 
@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
-// Regression test for ctest's at-exit VLD leak check (ctest_check_leaks_at_exit in src/ctest.c).
+// Regression test for ctest's at-exit leak check (ctest_check_leaks_at_exit in src/ctest.c).
 // A C++ namespace-scope global is constructed before main, so its allocation is captured in the
 // leak baseline; the at-exit check must not report it. This process must exit 0.
 
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Integration test for ctest's per-test leak check (--ctest_leak_check_per_test, Linux allocation
+// tracker only). The block allocated by TEST_FUNCTION_INITIALIZE and freed by TEST_FUNCTION_CLEANUP
+// is not a leak, the block leaked by one test fails that test only. The check at exit does not count
+// the leak again, so this process exits 0 when exactly one test failed.
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+static void* g_fixture_block;
+static void* g_leaked_block;
+
+CTEST_BEGIN_TEST_SUITE(ctest_leak_check_per_test_int)
+
+CTEST_FUNCTION_INITIALIZE()
+{
+    g_fixture_block = malloc(32);
+    CTEST_ASSERT_IS_NOT_NULL(g_fixture_block);
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+    free(g_fixture_block);
+    g_fixture_block = NULL;
+}
+
+CTEST_FUNCTION(allocation_that_is_freed_does_not_fail_the_test)
+{
+    void* block = malloc(64);
+    CTEST_ASSERT_IS_NOT_NULL(block);
+    free(block);
+}
+
+CTEST_FUNCTION(allocation_that_is_never_freed_fails_the_test)
+{
+    g_leaked_block = malloc(64);
+    CTEST_ASSERT_IS_NOT_NULL(g_leaked_block);
+}
+
+CTEST_END_TEST_SUITE(ctest_leak_check_per_test_int)
+
+int main(void)
+{
+    size_t failedTestCount = 0;
+    char* argv[] = { "ctest_leak_check_per_test_int", "--ctest_leak_check_per_test=1", NULL };
+
+    (void)logger_init();
+
+    if (ctest_parse_command_line(2, argv) != 0)
+    {
+        failedTestCount = 1;
+    }
+    else
+    {
+        CTEST_RUN_TEST_SUITE(ctest_leak_check_per_test_int, failedTestCount);
+        if (failedTestCount != 1)
+        {
+            LogError("CTEST TEST FAILED !!! expected the leaking test to fail, %zu tests failed", failedTestCount);
+        }
+        failedTestCount = (failedTestCount == 1) ? 0 : 1;
+    }
+
+    logger_deinit();
+
+    return (int)failedTestCount;
+}
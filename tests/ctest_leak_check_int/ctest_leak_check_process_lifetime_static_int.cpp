@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
-// Regression test for ctest's at-exit VLD leak check (ctest_check_leaks_at_exit in src/ctest.c).
+// Regression test for ctest's at-exit leak check (ctest_check_leaks_at_exit in src/ctest.c).
 // A function-local process-lifetime static (the azure-core Url::Encode pattern) is constructed
 // during a test and freed only at process exit. The old end-of-RunTests sampling misreported it as
 // a leak (exit -8 on the ARM64 Debug gate); the at-exit check must not, so this process exits 0.
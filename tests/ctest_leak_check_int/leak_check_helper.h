@@ -2,13 +2,13 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 // Shared helper for the leak-check integration tests. Built three ways (see CMakeLists.txt): a
-// shared DLL, a static library, and a shared DLL with the static CRT. Each module instance owns one
+// shared DLL, a static library, and a shared DLL with the static CRT (a plain shared object on Linux). Each module instance owns one
 // process-lifetime global that allocates on construction and frees on destruction.
 
 #ifndef LEAK_CHECK_HELPER_H
 #define LEAK_CHECK_HELPER_H
 
-#if defined(LEAK_CHECK_HELPER_STATIC)
+#if defined(LEAK_CHECK_HELPER_STATIC) || !defined(_WIN32)
 #define LEAK_CHECK_HELPER_API
 #elif defined(LEAK_CHECK_HELPER_EXPORTS)
 #define LEAK_CHECK_HELPER_API __declspec(dllexport)
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Loads the helper modules at run time: LoadLibrary on Windows, dlopen on Linux. The module is
+// looked up in the working directory, which the tests set to the directory of the helpers.
+
+#ifndef LEAK_CHECK_MODULE_H
+#define LEAK_CHECK_MODULE_H
+
+#ifdef _WIN32
+#include "windows.h"
+
+typedef HMODULE LEAK_CHECK_MODULE;
+
+// LEAK_CHECK_MODULE_FILE_NAME("ctest_leak_check_helper_dll") is the file of that CMake target
+#define LEAK_CHECK_MODULE_FILE_NAME(target_name) target_name ".dll"
+
+static inline LEAK_CHECK_MODULE leak_check_module_load(const char* file_name)
+{
+    return LoadLibraryA(file_name);
+}
+
+static inline void* leak_check_module_get_function(LEAK_CHECK_MODULE module, const char* function_name)
+{
+    return (void*)GetProcAddress(module, function_name);
+}
+
+static inline bool leak_check_module_unload(LEAK_CHECK_MODULE module)
+{
+    return FreeLibrary(module) != FALSE;
+}
+#else
+#include <dlfcn.h>
+
+typedef void* LEAK_CHECK_MODULE;
+
+#define LEAK_CHECK_MODULE_FILE_NAME(target_name) "./lib" target_name ".so"
+
+static inline LEAK_CHECK_MODULE leak_check_module_load(const char* file_name)
+{
+    return dlopen(file_name, RTLD_NOW | RTLD_LOCAL);
+}
+
+static inline void* leak_check_module_get_function(LEAK_CHECK_MODULE module, const char* function_name)
+{
+    return dlsym(module, function_name);
+}
+
+static inline bool leak_check_module_unload(LEAK_CHECK_MODULE module)
+{
+    return dlclose(module) == 0;
+}
+#endif
+
+#endif // LEAK_CHECK_MODULE_H
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>
+
+#include "ctest.h"
+
+#include "ctest_list_ut.h"
+
+size_t g_ctest_list_ut_run_count = 0;
+
+const char g_ctest_list_ut_file[] = __BASE_FILE__;
+
+CTEST_BEGIN_TEST_SUITE(ctest_list_ut)
+
+CTEST_SUITE_INITIALIZE()
+{
+    g_ctest_list_ut_run_count++;
+}
+
+CTEST_SUITE_CLEANUP()
+{
+    g_ctest_list_ut_run_count++;
+}
+
+CTEST_FUNCTION_INITIALIZE()
+{
+    g_ctest_list_ut_run_count++;
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+    g_ctest_list_ut_run_count++;
+}
+
+CTEST_FUNCTION(test_that_is_listed)
+{
+    g_ctest_list_ut_run_count++;
+}
+
+CTEST_PARAMETERIZED_TEST_FUNCTION(add,
+    ARGS(int, a, int, b, int, expected),
+    CASE((1, 2, 3), small),
+    CASE((100, 200, 300), large))
+{
+    g_ctest_list_ut_run_count++;
+    CTEST_ASSERT_ARE_EQUAL(int, expected, a + b);
+}
+
+CTEST_BENCHMARK(benchmark_that_is_listed)
+{
+    g_ctest_list_ut_run_count++;
+}
+
+CTEST_END_TEST_SUITE(ctest_list_ut)
@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_LIST_UT_H
+#define CTEST_LIST_UT_H
+
+#include <stddef.h>
+
+/* the fixtures and the test bodies that ran */
+extern size_t g_ctest_list_ut_run_count;
+
+/* the translation unit of the suite, as its manifest entries name it */
+extern const char g_ctest_list_ut_file[];
+
+#endif /* CTEST_LIST_UT_H */
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+#include "ctest_list_ut.h"
+
+#define LIST_PATH "ctest_list_ut.txt"
+
+/* the manifest of this executable, the one tools read from the file */
+extern const char __start_ctest_manifest[];
+extern const char __stop_ctest_manifest[];
+
+/* runs the suite with --ctest_list=1 and the filter, stdout going to a file, and checks what was written to it */
+static size_t check_list(const char* filter, const char* expected_list)
+{
+    size_t result = 0;
+    size_t failed_tests = 0;
+    char* argv[] = { "ctest_list_ut", "--ctest_list=1" };
+
+    (void)fflush(stdout);
+    int stdout_fd = dup(STDOUT_FILENO);
+    if ((stdout_fd < 0) || (freopen(LIST_PATH, "w", stdout) == NULL))
+    {
+        LogError("CTEST TEST FAILED !!! cannot redirect stdout to %s", LIST_PATH);
+        result++;
+    }
+    else
+    {
+        if (ctest_parse_command_line(2, argv) == 0)
+        {
+            CTEST_RUN_TEST_SUITE(ctest_list_ut, failed_tests, filter);
+        }
+        (void)fflush(stdout);
+        (void)dup2(stdout_fd, STDOUT_FILENO);
+        (void)close(stdout_fd);
+
+        if (failed_tests != 0)
+        {
+            LogError("CTEST TEST FAILED !!! listing with the filter %s returned %zu", filter, failed_tests);
+            result++;
+        }
+        if (g_ctest_list_ut_run_count != 0)
+        {
+            LogError("CTEST TEST FAILED !!! listing ran %zu fixtures and tests", g_ctest_list_ut_run_count);
+            result++;
+        }
+
+        char* list = ctest_ut_read_file(LIST_PATH);
+        if ((list == NULL) || (strcmp(list, expected_list) != 0))
+        {
+            LogError("CTEST TEST FAILED !!! listing with the filter %s wrote:\n%s\ninstead of:\n%s", filter, (list == NULL) ? "" : list, expected_list);
+            result++;
+        }
+        free(list);
+    }
+    return result;
+}
+
+static bool is_in_manifest(const char* expected_entry)
+{
+    bool result = false;
+    const char* entry = __start_ctest_manifest;
+    while (entry < __stop_ctest_manifest)
+    {
+        if (strcmp(entry, expected_entry) == 0)
+        {
+            result = true;
+            break;
+        }
+        entry += strlen(entry) + 1;
+    }
+    return result;
+}
+
+static size_t check_manifest(void)
+{
+    size_t result = 0;
+    const char* const kinds[] = { "suite", "test", "test", "test", "benchmark", "case", "case" };
+    const char* const fields[] =
+    {
+        "ctest_list_ut",
+        "test_that_is_listed",
+        "add_small",
+        "add_large",
+        "benchmark_that_is_listed",
+        "add_small\tadd\tsmall",
+        "add_large\tadd\tlarge"
+    };
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+    {
+        char expected_entry[512];
+        (void)snprintf(expected_entry, sizeof(expected_entry), "%s\t%s\t%s", kinds[i], g_ctest_list_ut_file, fields[i]);
+        if (!is_in_manifest(expected_entry))
+        {
+            LogError("CTEST TEST FAILED !!! the manifest has no entry %s", expected_entry);
+            result++;
+        }
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    /* the tests in the order of the registration, the parameterized cases named with their test and case */
+    failedTests += check_list(NULL,
+        "{\"suite\":\"ctest_list_ut\",\"test\":\"benchmark_that_is_listed\",\"kind\":\"benchmark\"}\n"
+        "{\"suite\":\"ctest_list_ut\",\"test\":\"add_large\",\"kind\":\"test\",\"parameterized_test\":\"add\",\"case\":\"large\"}\n"
+        "{\"suite\":\"ctest_list_ut\",\"test\":\"add_small\",\"kind\":\"test\",\"parameterized_test\":\"add\",\"case\":\"small\"}\n"
+        "{\"suite\":\"ctest_list_ut\",\"test\":\"test_that_is_listed\",\"kind\":\"test\"}\n");
+
+    /* only the tests matching the filter */
+    failedTests += check_list("add_*,-*_large",
+        "{\"suite\":\"ctest_list_ut\",\"test\":\"add_small\",\"kind\":\"test\",\"parameterized_test\":\"add\",\"case\":\"small\"}\n");
+    failedTests += check_list("no_such_test", "");
+
+    failedTests += check_manifest();
+
+    /* without listing the suite runs */
+    char* argv[] = { "ctest_list_ut", "--ctest_list=0", "--ctest_benchmark_min_time_ms=1" };
+    if (ctest_parse_command_line(3, argv) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+        failedTests++;
+    }
+    else
+    {
+        CTEST_RUN_TEST_SUITE(ctest_list_ut, failedTests);
+        if (g_ctest_list_ut_run_count == 0)
+        {
+            LogError("CTEST TEST FAILED !!! the suite did not run");
+            failedTests++;
+        }
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
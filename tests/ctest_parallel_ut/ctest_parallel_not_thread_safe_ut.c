@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+#include "ctest_parallel_ut.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#define ctest_parallel_ut_sleep_ms(ms) Sleep(ms)
+#else
+#include <unistd.h>
+#define ctest_parallel_ut_sleep_ms(ms) (void)usleep((ms) * 1000)
+#endif
+
+/* the suite opted out of parallel execution, so its tests are only ever touched from the thread calling RunTests */
+static int g_running_count;
+static int g_executed_count;
+static int g_overlap_count;
+
+void ctest_parallel_not_thread_safe_ut_reset_execution_tracking(void)
+{
+    g_running_count = 0;
+    g_executed_count = 0;
+    g_overlap_count = 0;
+}
+
+int ctest_parallel_not_thread_safe_ut_get_executed_count(void)
+{
+    return g_executed_count;
+}
+
+int ctest_parallel_not_thread_safe_ut_get_overlap_count(void)
+{
+    return g_overlap_count;
+}
+
+static void run_alone(void)
+{
+    if (++g_running_count != 1)
+    {
+        g_overlap_count++;
+    }
+    g_executed_count++;
+    ctest_parallel_ut_sleep_ms(5);
+    g_running_count--;
+}
+
+CTEST_BEGIN_TEST_SUITE_NOT_THREAD_SAFE(ctest_parallel_not_thread_safe_ut)
+
+CTEST_FUNCTION(serial_test_1)
+{
+    run_alone();
+}
+
+CTEST_FUNCTION(serial_test_2)
+{
+    run_alone();
+}
+
+CTEST_FUNCTION(serial_test_3)
+{
+    run_alone();
+}
+
+CTEST_END_TEST_SUITE(ctest_parallel_not_thread_safe_ut)
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+#include "ctest_parallel_ut.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+static volatile LONG g_running_count;
+static volatile LONG g_executed_count;
+static volatile LONG g_max_concurrency;
+static volatile LONG g_not_thread_safe_overlap_count;
+#define ctest_parallel_ut_increment(x) InterlockedIncrement(x)
+#define ctest_parallel_ut_decrement(x) InterlockedDecrement(x)
+#define ctest_parallel_ut_load(x) InterlockedCompareExchange(x, 0, 0)
+#define ctest_parallel_ut_store(x, value) (void)InterlockedExchange(x, value)
+/* true when *x was expected and is now desired */
+#define ctest_parallel_ut_compare_exchange(x, expected, desired) (InterlockedCompareExchange(x, desired, expected) == (expected))
+#define ctest_parallel_ut_sleep_ms(ms) Sleep(ms)
+#else
+#include <unistd.h>
+static int g_running_count;
+static int g_executed_count;
+static int g_max_concurrency;
+static int g_not_thread_safe_overlap_count;
+#define ctest_parallel_ut_increment(x) __atomic_add_fetch(x, 1, __ATOMIC_SEQ_CST)
+#define ctest_parallel_ut_decrement(x) __atomic_sub_fetch(x, 1, __ATOMIC_SEQ_CST)
+#define ctest_parallel_ut_load(x) __atomic_load_n(x, __ATOMIC_SEQ_CST)
+#define ctest_parallel_ut_store(x, value) __atomic_store_n(x, value, __ATOMIC_SEQ_CST)
+/* true when *x was expected and is now desired */
+#define ctest_parallel_ut_compare_exchange(x, expected, desired) ctest_parallel_ut_compare_exchange_int(x, expected, desired)
+static int ctest_parallel_ut_compare_exchange_int(int* x, int expected, int desired)
+{
+    return __atomic_compare_exchange_n(x, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#define ctest_parallel_ut_sleep_ms(ms) (void)usleep((ms) * 1000)
+#endif
+
+void ctest_parallel_ut_reset_execution_tracking(void)
+{
+    ctest_parallel_ut_store(&g_running_count, 0);
+    ctest_parallel_ut_store(&g_executed_count, 0);
+    ctest_parallel_ut_store(&g_max_concurrency, 0);
+    ctest_parallel_ut_store(&g_not_thread_safe_overlap_count, 0);
+}
+
+int ctest_parallel_ut_get_executed_count(void)
+{
+    return (int)ctest_parallel_ut_load(&g_executed_count);
+}
+
+int ctest_parallel_ut_get_max_concurrency(void)
+{
+    return (int)ctest_parallel_ut_load(&g_max_concurrency);
+}
+
+int ctest_parallel_ut_get_not_thread_safe_overlap_count(void)
+{
+    return (int)ctest_parallel_ut_load(&g_not_thread_safe_overlap_count);
+}
+
+/* the tests running concurrently raise the maximum together, a plain read-modify-write could lose the highest value */
+static void update_max_concurrency(int running)
+{
+    int max_concurrency = (int)ctest_parallel_ut_load(&g_max_concurrency);
+    while ((running > max_concurrency) && !ctest_parallel_ut_compare_exchange(&g_max_concurrency, max_concurrency, running))
+    {
+        max_concurrency = (int)ctest_parallel_ut_load(&g_max_concurrency);
+    }
+}
+
+/* waits (bounded) until another test runs at the same time, which only happens when tests are executed on several threads */
+static void run_concurrently_with_another_test(void)
+{
+    int running = (int)ctest_parallel_ut_increment(&g_running_count);
+    for (int i = 0; (i < 2000) && (running < 2); i++)
+    {
+        ctest_parallel_ut_sleep_ms(1);
+        running = (int)ctest_parallel_ut_load(&g_running_count);
+    }
+    update_max_concurrency(running);
+    (void)ctest_parallel_ut_increment(&g_executed_count);
+    ctest_parallel_ut_sleep_ms(5);
+    (void)ctest_parallel_ut_decrement(&g_running_count);
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_parallel_ut)
+
+CTEST_FUNCTION(parallel_test_1)
+{
+    run_concurrently_with_another_test();
+}
+
+CTEST_FUNCTION(parallel_test_2)
+{
+    run_concurrently_with_another_test();
+}
+
+CTEST_FUNCTION(parallel_test_3)
+{
+    run_concurrently_with_another_test();
+}
+
+CTEST_FUNCTION(parallel_test_4)
+{
+    run_concurrently_with_another_test();
+}
+
+CTEST_FUNCTION(parallel_test_5)
+{
+    run_concurrently_with_another_test();
+}
+
+CTEST_FUNCTION(parallel_test_6)
+{
+    run_concurrently_with_another_test();
+}
+
+/* an assert on a worker thread only unwinds that worker: the other tests keep running and pass */
+CTEST_FUNCTION(parallel_test_that_fails_1)
+{
+    (void)ctest_parallel_ut_increment(&g_executed_count);
+    CTEST_ASSERT_ARE_EQUAL(int, 1, 2);
+}
+
+CTEST_FUNCTION(parallel_test_that_fails_2)
+{
+    (void)ctest_parallel_ut_increment(&g_executed_count);
+    CTEST_ASSERT_FAIL("failing on purpose");
+}
+
+CTEST_FUNCTION_NOT_THREAD_SAFE(not_thread_safe_test_runs_alone)
+{
+    if (ctest_parallel_ut_load(&g_running_count) != 0)
+    {
+        (void)ctest_parallel_ut_increment(&g_not_thread_safe_overlap_count);
+    }
+    (void)ctest_parallel_ut_increment(&g_executed_count);
+}
+
+CTEST_END_TEST_SUITE(ctest_parallel_ut)
@@ -0,0 +1,16 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_PARALLEL_UT_H
+#define CTEST_PARALLEL_UT_H
+
+void ctest_parallel_ut_reset_execution_tracking(void);
+int ctest_parallel_ut_get_executed_count(void);
+int ctest_parallel_ut_get_max_concurrency(void);
+int ctest_parallel_ut_get_not_thread_safe_overlap_count(void);
+
+void ctest_parallel_not_thread_safe_ut_reset_execution_tracking(void);
+int ctest_parallel_not_thread_safe_ut_get_executed_count(void);
+int ctest_parallel_not_thread_safe_ut_get_overlap_count(void);
+
+#endif // CTEST_PARALLEL_UT_H
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_parallel_ut.h"
+
+/* CMakeLists.txt runs this executable with CTEST_WORKER_THREADS=4 */
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    {
+        size_t temp_failed_tests = 0;
+        ctest_parallel_ut_reset_execution_tracking();
+        CTEST_RUN_TEST_SUITE(ctest_parallel_ut, temp_failed_tests);
+        if (temp_failed_tests != 2) // 2 expected failing tests
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parallel_ut expected 2 failed tests, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if (ctest_parallel_ut_get_executed_count() != 9)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parallel_ut expected 9 executed tests, got %d", ctest_parallel_ut_get_executed_count());
+            failedTests++;
+        }
+        if (ctest_parallel_ut_get_max_concurrency() < 2)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parallel_ut tests did not run concurrently");
+            failedTests++;
+        }
+        if (ctest_parallel_ut_get_not_thread_safe_overlap_count() != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parallel_ut not thread safe test overlapped with another test");
+            failedTests++;
+        }
+    }
+
+    ctest_parallel_not_thread_safe_ut_reset_execution_tracking();
+    CTEST_RUN_TEST_SUITE(ctest_parallel_not_thread_safe_ut, failedTests);
+    if (ctest_parallel_not_thread_safe_ut_get_executed_count() != 3)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parallel_not_thread_safe_ut expected 3 executed tests, got %d", ctest_parallel_not_thread_safe_ut_get_executed_count());
+        failedTests++;
+    }
+    if (ctest_parallel_not_thread_safe_ut_get_overlap_count() != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parallel_not_thread_safe_ut tests overlapped");
+        failedTests++;
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
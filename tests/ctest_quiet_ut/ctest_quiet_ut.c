@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_quiet_ut)
+
+CTEST_FUNCTION(test_that_logs_too_much_and_fails)
+{
+    /* more than the log of the test holds */
+    for (int i = 0; i < 2000; i++)
+    {
+        LogInfo("message %d of the test that logs too much, padded to make it a bit longer than it needs to be", i);
+    }
+    CTEST_ASSERT_FAIL("failure of the test that logs too much");
+}
+
+CTEST_FUNCTION(test_that_logs_and_fails)
+{
+    LogInfo("message of the failing test");
+    CTEST_ASSERT_ARE_EQUAL(int, 3, 1 + 1);
+}
+
+CTEST_FUNCTION(test_that_logs_and_passes)
+{
+    LogInfo("message of the passing test");
+    CTEST_ASSERT_ARE_EQUAL(int, 2, 1 + 1);
+}
+
+CTEST_END_TEST_SUITE(ctest_quiet_ut)
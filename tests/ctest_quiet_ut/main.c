@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+static size_t check_logged(const char* expected, bool is_expected)
+{
+    size_t result = 0;
+    if ((strstr(ctest_ut_get_captured_log(), expected) != NULL) != is_expected)
+    {
+        (void)printf("CTEST TEST FAILED !!! expected \"%s\" %s be logged\n", expected, is_expected ? "to" : "not to");
+        result = 1;
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+    char* argv[] = { "ctest_quiet_ut", "--ctest_quiet=1" };
+
+    (void)logger_init();
+
+    ctest_ut_begin_log_capture();
+
+    if (ctest_parse_command_line(2, argv) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+        failedTests++;
+    }
+    else
+    {
+        size_t temp_failed_tests = 0;
+        CTEST_RUN_TEST_SUITE(ctest_quiet_ut, temp_failed_tests);
+
+        ctest_ut_end_log_capture();
+
+        if (temp_failed_tests != 2)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_quiet_ut expected 2 failed tests, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+
+        /* the suite is logged, the tests only when they fail */
+        failedTests += check_logged("Executing test suite ctest_quiet_ut", true);
+        failedTests += check_logged("tests ran, 2 failed, 1 succeeded.", true);
+        failedTests += check_logged("message of the passing test", false);
+        failedTests += check_logged("Executing test test_that_logs_and_passes", false);
+        failedTests += check_logged("message of the failing test", true);
+        failedTests += check_logged("Executing test test_that_logs_and_fails", true);
+        failedTests += check_logged("Test test_that_logs_and_fails result = !!! FAILED !!!", true);
+        /* the last messages of a test are kept */
+        failedTests += check_logged("earlier messages of the test were dropped", true);
+        failedTests += check_logged("message 0 of the test that logs too much", false);
+        failedTests += check_logged("message 1999 of the test that logs too much", true);
+        failedTests += check_logged("failure of the test that logs too much", true);
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
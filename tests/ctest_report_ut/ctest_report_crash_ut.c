@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <signal.h>
+
+#include "ctest.h"
+
+/* the tests run in the reverse order of their definition, the crash comes after a reported test */
+CTEST_BEGIN_TEST_SUITE(ctest_report_crash_ut)
+
+CTEST_FUNCTION(test_that_crashes)
+{
+    (void)raise(SIGSEGV);
+}
+
+CTEST_FUNCTION(test_that_succeeds_before_the_crash)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 2, 1 + 1);
+}
+
+CTEST_END_TEST_SUITE(ctest_report_crash_ut)
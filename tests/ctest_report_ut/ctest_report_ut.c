@@ -0,0 +1,18 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_report_ut)
+
+CTEST_FUNCTION(test_that_fails)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 3, 1 + 1);
+}
+
+CTEST_FUNCTION(test_that_succeeds)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 2, 1 + 1);
+}
+
+CTEST_END_TEST_SUITE(ctest_report_ut)
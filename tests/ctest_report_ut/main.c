@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined _MSC_VER
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+#if !defined _MSC_VER
+/* the crash ends the process, so the suite runs in a child process that did not call RunTests yet (the reports are opened by the
+   first RunTests) */
+static size_t run_crash_suite_in_child_process(void)
+{
+    size_t result;
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LogError("CTEST TEST FAILED !!! fork failed");
+        result = 1;
+    }
+    else if (pid == 0)
+    {
+        size_t failed_tests = 0;
+        char* argv[] = { "ctest_report_ut", "--ctest_report_junit=ctest_report_crash_ut.xml", "--ctest_report_tap=ctest_report_crash_ut.tap", "--ctest_report_json=ctest_report_crash_ut.json" };
+        if (ctest_parse_command_line(4, argv) == 0)
+        {
+            CTEST_RUN_TEST_SUITE(ctest_report_crash_ut, failed_tests);
+        }
+        _exit(0);
+    }
+    else
+    {
+        int status;
+        if (waitpid(pid, &status, 0) != pid)
+        {
+            LogError("CTEST TEST FAILED !!! waitpid failed");
+            result = 1;
+        }
+        else if (!WIFSIGNALED(status) || (WTERMSIG(status) != SIGSEGV))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_report_crash_ut expected the process to crash, status=%d", status);
+            result = 1;
+        }
+        else
+        {
+            result = CTEST_UT_CHECK_FILE("ctest_report_crash_ut.xml", 1, "</testsuites>\n",
+                "<testcase classname=\"ctest_report_crash_ut\" name=\"test_that_succeeds_before_the_crash\"",
+                "<testcase classname=\"ctest_report_crash_ut\" name=\"test_that_crashes\"",
+                "<error message=\"the process crashed with signal 11\"/>");
+            result += CTEST_UT_CHECK_FILE("ctest_report_crash_ut.tap", 1, "1..2\n",
+                "ok 1 - ctest_report_crash_ut.test_that_succeeds_before_the_crash\n",
+                "not ok 2 - ctest_report_crash_ut.test_that_crashes\n",
+                "Interrupted: the process crashed with signal 11");
+            result += CTEST_UT_CHECK_FILE("ctest_report_crash_ut.json", 1, "\n  ]\n}\n",
+                "\"result\": \"passed\"",
+                "\"result\": \"interrupted\", \"message\": \"the process crashed with signal 11\"",
+                "\"interrupted\": \"the process crashed with signal 11\"");
+        }
+    }
+    return result;
+}
+#endif
+
+int main(void)
+{
+    size_t failedTests = 0;
+    char* argv[] = { "ctest_report_ut", "--ctest_report_junit=ctest_report_ut.xml", "--ctest_report_tap=ctest_report_ut.tap", "--ctest_report_json=ctest_report_ut.json" };
+
+    (void)logger_init();
+
+#if !defined _MSC_VER
+    failedTests += run_crash_suite_in_child_process();
+#endif
+
+    if (ctest_parse_command_line(4, argv) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+        failedTests++;
+    }
+    else
+    {
+        /* two suites in the same reports */
+        for (int i = 0; i < 2; i++)
+        {
+            size_t temp_failed_tests = 0;
+            CTEST_RUN_TEST_SUITE(ctest_report_ut, temp_failed_tests);
+            if (temp_failed_tests != 1)
+            {
+                LogError("CTEST TEST FAILED !!! ctest_report_ut expected 1 failed test, got %zu", temp_failed_tests);
+                failedTests++;
+            }
+        }
+
+        failedTests += CTEST_UT_CHECK_FILE("ctest_report_ut.xml", 2, "</testsuites>\n",
+            "<testsuite name=\"ctest_report_ut\">",
+            "<testcase classname=\"ctest_report_ut\" name=\"test_that_succeeds\" time=\"",
+            "<failure message=\"failed\"/>",
+            "<system-out>2 tests ran, 1 failed, 1 succeeded, 0 skipped.</system-out>");
+        failedTests += CTEST_UT_CHECK_FILE("ctest_report_ut.tap", 1, "1..4\n",
+            "TAP version 13\n",
+            "ok 1 - ctest_report_ut.test_that_succeeds\n",
+            "not ok 2 - ctest_report_ut.test_that_fails\n",
+            "ok 3 - ctest_report_ut.test_that_succeeds\n",
+            "not ok 4 - ctest_report_ut.test_that_fails\n");
+        failedTests += CTEST_UT_CHECK_FILE("ctest_report_ut.json", 2, "\n  ]\n}\n",
+            "\"name\": \"test_that_succeeds\", \"result\": \"passed\"",
+            "\"name\": \"test_that_fails\", \"result\": \"failed\", \"message\": \"failed\"",
+            "\"summary\": { \"executed\": 2, \"failed\": 1, \"skipped\": 0 }");
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
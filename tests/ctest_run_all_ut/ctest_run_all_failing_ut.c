@@ -0,0 +1,16 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+#include "ctest_run_all_ut.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_run_all_failing_ut)
+
+CTEST_FUNCTION(failing_test)
+{
+    ctest_run_all_ut_record_test("failing_test");
+    CTEST_ASSERT_FAIL("expected failure");
+}
+
+CTEST_END_TEST_SUITE(ctest_run_all_failing_ut)
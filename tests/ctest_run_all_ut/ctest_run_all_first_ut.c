@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+#include "ctest_run_all_ut.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_run_all_first_ut)
+
+CTEST_FUNCTION(first_test_b)
+{
+    ctest_run_all_ut_record_test("first_test_b");
+}
+
+CTEST_FUNCTION(first_test_a)
+{
+    ctest_run_all_ut_record_test("first_test_a");
+}
+
+CTEST_END_TEST_SUITE(ctest_run_all_first_ut)
@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+#include "ctest_run_all_ut.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_run_all_second_ut)
+
+CTEST_FUNCTION(second_test)
+{
+    ctest_run_all_ut_record_test("second_test");
+}
+
+CTEST_END_TEST_SUITE(ctest_run_all_second_ut)
@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_RUN_ALL_UT_H
+#define CTEST_RUN_ALL_UT_H
+
+/* the tests append their name to the names of the tests that ran, checked by main */
+void ctest_run_all_ut_record_test(const char* test_name);
+
+#endif /* CTEST_RUN_ALL_UT_H */
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_run_all_ut.h"
+
+static char g_run_tests[256];
+
+void ctest_run_all_ut_record_test(const char* test_name)
+{
+    size_t length = strlen(g_run_tests);
+    if (length + strlen(test_name) + 2 <= sizeof(g_run_tests))
+    {
+        (void)strcpy(g_run_tests + length, test_name);
+        (void)strcat(g_run_tests, ",");
+    }
+}
+
+/* runs ctest_run_all with the filter option and checks what it returned and which tests ran, in which order */
+static size_t check_run_all(const char* filter_option, size_t expected_result, const char* expected_run_tests)
+{
+    size_t result = 0;
+    char* argv[] = { "ctest_run_all_ut", (char*)filter_option };
+
+    g_run_tests[0] = '\0';
+    size_t run_all_result = ctest_run_all(2, argv);
+    if (run_all_result != expected_result)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_run_all with %s returned %zu instead of %zu", filter_option, run_all_result, expected_result);
+        result++;
+    }
+    if (strcmp(g_run_tests, expected_run_tests) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_run_all with %s ran %s instead of %s", filter_option, g_run_tests, expected_run_tests);
+        result++;
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    /* every suite, by name */
+    failedTests += check_run_all("--ctest_filter=", 1, "failing_test,first_test_a,first_test_b,second_test,");
+
+    /* the suites without a selected test are not run */
+    failedTests += check_run_all("--ctest_filter=-ctest_run_all_failing_ut.*", 0, "first_test_a,first_test_b,second_test,");
+    failedTests += check_run_all("--ctest_filter=first_test_a", 0, "first_test_a,");
+
+    /* no test at all */
+    failedTests += check_run_all("--ctest_filter=no_such_test", CTEST_RETURN_CODE_NO_TESTS_RAN, "");
+
+    /* an invalid option runs nothing */
+    failedTests += check_run_all("--ctest_shard_count=x", 1, "");
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define CTEST_USE_SECTION_REGISTRATION
+#include "ctest.h"
+
+#include "ctest_section_registration_ut.h"
+
+static int test_count;
+
+int ctest_section_registration_large_ut_get_test_count(void)
+{
+    return test_count;
+}
+
+/* the indirection expands the name before CTEST_FUNCTION pastes it */
+#define GENERATED_TEST_FUNCTION(funcName) CTEST_FUNCTION(funcName)
+#define GENERATED_TEST(suffix) GENERATED_TEST_FUNCTION(MU_C2(generated_test_, suffix)) { test_count++; }
+
+#define GENERATED_TESTS_10(prefix) \
+    GENERATED_TEST(MU_C2(prefix, 0)) GENERATED_TEST(MU_C2(prefix, 1)) GENERATED_TEST(MU_C2(prefix, 2)) GENERATED_TEST(MU_C2(prefix, 3)) GENERATED_TEST(MU_C2(prefix, 4)) \
+    GENERATED_TEST(MU_C2(prefix, 5)) GENERATED_TEST(MU_C2(prefix, 6)) GENERATED_TEST(MU_C2(prefix, 7)) GENERATED_TEST(MU_C2(prefix, 8)) GENERATED_TEST(MU_C2(prefix, 9))
+
+#define GENERATED_TESTS_100(prefix) \
+    GENERATED_TESTS_10(MU_C2(prefix, 0)) GENERATED_TESTS_10(MU_C2(prefix, 1)) GENERATED_TESTS_10(MU_C2(prefix, 2)) GENERATED_TESTS_10(MU_C2(prefix, 3)) GENERATED_TESTS_10(MU_C2(prefix, 4)) \
+    GENERATED_TESTS_10(MU_C2(prefix, 5)) GENERATED_TESTS_10(MU_C2(prefix, 6)) GENERATED_TESTS_10(MU_C2(prefix, 7)) GENERATED_TESTS_10(MU_C2(prefix, 8)) GENERATED_TESTS_10(MU_C2(prefix, 9))
+
+#define GENERATED_TESTS_1000(prefix) \
+    GENERATED_TESTS_100(MU_C2(prefix, 0)) GENERATED_TESTS_100(MU_C2(prefix, 1)) GENERATED_TESTS_100(MU_C2(prefix, 2)) GENERATED_TESTS_100(MU_C2(prefix, 3)) GENERATED_TESTS_100(MU_C2(prefix, 4)) \
+    GENERATED_TESTS_100(MU_C2(prefix, 5)) GENERATED_TESTS_100(MU_C2(prefix, 6)) GENERATED_TESTS_100(MU_C2(prefix, 7)) GENERATED_TESTS_100(MU_C2(prefix, 8)) GENERATED_TESTS_100(MU_C2(prefix, 9))
+
+CTEST_BEGIN_TEST_SUITE(ctest_section_registration_large_ut)
+
+/* CTEST_SECTION_REGISTRATION_LARGE_TEST_COUNT tests */
+GENERATED_TESTS_1000(a)
+GENERATED_TESTS_1000(b)
+GENERATED_TESTS_1000(c)
+
+CTEST_END_TEST_SUITE(ctest_section_registration_large_ut)
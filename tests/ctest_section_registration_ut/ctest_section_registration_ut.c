@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define CTEST_USE_SECTION_REGISTRATION
+#include "ctest.h"
+
+#include "ctest_section_registration_ut.h"
+
+static int suite_initialize_count;
+static int suite_cleanup_count;
+static int test_function_initialize_count;
+static int test_function_cleanup_count;
+static int test_count;
+
+int ctest_section_registration_ut_get_suite_initialize_count(void)
+{
+    return suite_initialize_count;
+}
+
+int ctest_section_registration_ut_get_suite_cleanup_count(void)
+{
+    return suite_cleanup_count;
+}
+
+int ctest_section_registration_ut_get_test_function_initialize_count(void)
+{
+    return test_function_initialize_count;
+}
+
+int ctest_section_registration_ut_get_test_function_cleanup_count(void)
+{
+    return test_function_cleanup_count;
+}
+
+int ctest_section_registration_ut_get_test_count(void)
+{
+    return test_count;
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_section_registration_ut)
+
+CTEST_SUITE_INITIALIZE()
+{
+    suite_initialize_count++;
+}
+
+CTEST_SUITE_CLEANUP()
+{
+    suite_cleanup_count++;
+}
+
+CTEST_FUNCTION_INITIALIZE()
+{
+    test_function_initialize_count++;
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+    test_function_cleanup_count++;
+}
+
+CTEST_FUNCTION(test_1)
+{
+    test_count++;
+}
+
+CTEST_FUNCTION(test_2)
+{
+    test_count++;
+}
+
+CTEST_FUNCTION(test_that_fails)
+{
+    test_count++;
+    CTEST_ASSERT_FAIL("expected failure");
+}
+
+CTEST_END_TEST_SUITE(ctest_section_registration_ut)
@@ -0,0 +1,18 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_SECTION_REGISTRATION_UT_H
+#define CTEST_SECTION_REGISTRATION_UT_H
+
+/* number of tests of ctest_section_registration_large_ut, more than MU_INC/MU_DEC support */
+#define CTEST_SECTION_REGISTRATION_LARGE_TEST_COUNT 3000
+
+int ctest_section_registration_ut_get_suite_initialize_count(void);
+int ctest_section_registration_ut_get_suite_cleanup_count(void);
+int ctest_section_registration_ut_get_test_function_initialize_count(void);
+int ctest_section_registration_ut_get_test_function_cleanup_count(void);
+int ctest_section_registration_ut_get_test_count(void);
+
+int ctest_section_registration_large_ut_get_test_count(void);
+
+#endif /* CTEST_SECTION_REGISTRATION_UT_H */
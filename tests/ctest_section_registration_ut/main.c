@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_section_registration_ut.h"
+
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    {
+        size_t temp_failed_tests = 0;
+        CTEST_RUN_TEST_SUITE(ctest_section_registration_ut, temp_failed_tests);
+        if (temp_failed_tests != 1)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_section_registration_ut expected 1 failed test, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if ((ctest_section_registration_ut_get_test_count() != 3) ||
+            (ctest_section_registration_ut_get_test_function_initialize_count() != 3) ||
+            (ctest_section_registration_ut_get_test_function_cleanup_count() != 3))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_section_registration_ut expected 3 tests with their fixtures, got %d tests, %d TEST_FUNCTION_INITIALIZE, %d TEST_FUNCTION_CLEANUP",
+                ctest_section_registration_ut_get_test_count(), ctest_section_registration_ut_get_test_function_initialize_count(), ctest_section_registration_ut_get_test_function_cleanup_count());
+            failedTests++;
+        }
+        if ((ctest_section_registration_ut_get_suite_initialize_count() != 1) ||
+            (ctest_section_registration_ut_get_suite_cleanup_count() != 1))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_section_registration_ut expected 1 TEST_SUITE_INITIALIZE and 1 TEST_SUITE_CLEANUP, got %d and %d",
+                ctest_section_registration_ut_get_suite_initialize_count(), ctest_section_registration_ut_get_suite_cleanup_count());
+            failedTests++;
+        }
+    }
+
+    {
+        size_t temp_failed_tests = 0;
+        CTEST_RUN_TEST_SUITE(ctest_section_registration_large_ut, temp_failed_tests);
+        if (temp_failed_tests != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_section_registration_large_ut expected no failed test, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if (ctest_section_registration_large_ut_get_test_count() != CTEST_SECTION_REGISTRATION_LARGE_TEST_COUNT)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_section_registration_large_ut expected %d tests, got %d",
+                CTEST_SECTION_REGISTRATION_LARGE_TEST_COUNT, ctest_section_registration_large_ut_get_test_count());
+            failedTests++;
+        }
+    }
+
+    {
+        /* a filter on the large suite, the other suite of the section is not mixed in */
+        size_t temp_failed_tests = 0;
+        CTEST_RUN_TEST_SUITE(ctest_section_registration_large_ut, temp_failed_tests, "generated_test_a12*,test_1");
+        if (temp_failed_tests != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_section_registration_large_ut with filter expected no failed test, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if (ctest_section_registration_large_ut_get_test_count() != CTEST_SECTION_REGISTRATION_LARGE_TEST_COUNT + 10)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_section_registration_large_ut with filter expected 10 more tests, got %d",
+                ctest_section_registration_large_ut_get_test_count() - CTEST_SECTION_REGISTRATION_LARGE_TEST_COUNT);
+            failedTests++;
+        }
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+#include "ctest_sharding_ut.h"
+
+static int execution_count;
+
+int ctest_sharding_single_test_ut_get_execution_count(void)
+{
+    return execution_count;
+}
+
+/* with more shards than tests, some shards have nothing to run */
+CTEST_BEGIN_TEST_SUITE(ctest_sharding_single_test_ut)
+
+CTEST_FUNCTION(the_only_test)
+{
+    execution_count++;
+}
+
+CTEST_END_TEST_SUITE(ctest_sharding_single_test_ut)
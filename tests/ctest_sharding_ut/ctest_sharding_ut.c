@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+#include "ctest_sharding_ut.h"
+
+static int execution_counts[CTEST_SHARDING_UT_TEST_COUNT];
+
+int ctest_sharding_ut_get_execution_count(int test_number)
+{
+    return execution_counts[test_number];
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_sharding_ut)
+
+CTEST_FUNCTION(sharded_test_0)
+{
+    execution_counts[0]++;
+}
+
+CTEST_FUNCTION(sharded_test_1)
+{
+    execution_counts[1]++;
+}
+
+CTEST_FUNCTION(sharded_test_2)
+{
+    execution_counts[2]++;
+}
+
+CTEST_FUNCTION(sharded_test_3)
+{
+    execution_counts[3]++;
+}
+
+CTEST_FUNCTION(sharded_test_4)
+{
+    execution_counts[4]++;
+}
+
+CTEST_FUNCTION(sharded_test_5)
+{
+    execution_counts[5]++;
+}
+
+CTEST_FUNCTION(sharded_test_6)
+{
+    execution_counts[6]++;
+}
+
+CTEST_FUNCTION(sharded_test_7)
+{
+    execution_counts[7]++;
+}
+
+CTEST_END_TEST_SUITE(ctest_sharding_ut)
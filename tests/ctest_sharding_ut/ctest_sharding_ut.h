@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_SHARDING_UT_H
+#define CTEST_SHARDING_UT_H
+
+#define CTEST_SHARDING_UT_TEST_COUNT 8
+
+/* number of times each test of ctest_sharding_ut was executed */
+int ctest_sharding_ut_get_execution_count(int test_number);
+
+int ctest_sharding_single_test_ut_get_execution_count(void);
+
+#endif /* CTEST_SHARDING_UT_H */
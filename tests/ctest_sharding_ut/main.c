@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_sharding_ut.h"
+
+#define SHARD_COUNT 3
+
+static const char* shard_arguments[SHARD_COUNT] = { "--ctest_shard_index=0", "--ctest_shard_index=1", "--ctest_shard_index=2" };
+
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    for (int shard_index = 0; shard_index < SHARD_COUNT; shard_index++)
+    {
+        char* argv[] = { "ctest_sharding_ut", "--not_a_ctest_option", (char*)shard_arguments[shard_index], "--ctest_shard_count=3", NULL };
+        if (ctest_parse_command_line(4, argv) != 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed for shard %d", shard_index);
+            failedTests++;
+        }
+
+        CTEST_RUN_TEST_SUITE(ctest_sharding_ut, failedTests);
+
+        /* an empty shard is not a failure */
+        CTEST_RUN_TEST_SUITE(ctest_sharding_single_test_ut, failedTests);
+    }
+
+    /* every test runs in exactly one shard */
+    for (int i = 0; i < CTEST_SHARDING_UT_TEST_COUNT; i++)
+    {
+        if (ctest_sharding_ut_get_execution_count(i) != 1)
+        {
+            LogError("CTEST TEST FAILED !!! sharded_test_%d executed %d times, expected once", i, ctest_sharding_ut_get_execution_count(i));
+            failedTests++;
+        }
+    }
+    if (ctest_sharding_single_test_ut_get_execution_count() != 1)
+    {
+        LogError("CTEST TEST FAILED !!! the_only_test executed %d times, expected once", ctest_sharding_single_test_ut_get_execution_count());
+        failedTests++;
+    }
+
+    {
+        char* argv[] = { "ctest_sharding_ut", "--ctest_shard_index=3", "--ctest_shard_count=3", NULL };
+        if (ctest_parse_command_line(3, argv) == 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parse_command_line accepted a shard index out of range");
+            failedTests++;
+        }
+    }
+    {
+        char* argv[] = { "ctest_sharding_ut", "--ctest_shard_count=two", NULL };
+        if (ctest_parse_command_line(2, argv) == 0)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_parse_command_line accepted an invalid shard count");
+            failedTests++;
+        }
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
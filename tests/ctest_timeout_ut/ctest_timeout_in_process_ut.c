@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <unistd.h>
+
+#include "ctest.h"
+
+/* runs with CTEST_WORKER_PROCESSES=1, main expects the process to abort */
+
+CTEST_BEGIN_TEST_SUITE(ctest_timeout_in_process_ut)
+
+CTEST_SUITE_INITIALIZE()
+{
+}
+
+CTEST_SUITE_CLEANUP()
+{
+}
+
+CTEST_FUNCTION_INITIALIZE()
+{
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+}
+
+CTEST_FUNCTION(test_before_the_hang)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 1, 1);
+}
+
+CTEST_FUNCTION(test_that_hangs)
+{
+    for (;;)
+    {
+        (void)sleep(1);
+    }
+}
+
+CTEST_END_TEST_SUITE(ctest_timeout_in_process_ut)
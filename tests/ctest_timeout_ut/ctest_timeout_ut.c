@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <unistd.h>
+
+#include "ctest.h"
+
+#include "ctest_timeout_ut.h"
+
+static int suite_cleanup_count;
+
+int ctest_timeout_ut_get_suite_cleanup_count(void)
+{
+    return suite_cleanup_count;
+}
+
+CTEST_BEGIN_TEST_SUITE(ctest_timeout_ut)
+
+CTEST_SUITE_INITIALIZE()
+{
+}
+
+CTEST_SUITE_CLEANUP()
+{
+    suite_cleanup_count++;
+}
+
+CTEST_FUNCTION_INITIALIZE()
+{
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+}
+
+CTEST_FUNCTION(test_before_the_hang)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 1, 1);
+}
+
+CTEST_FUNCTION(test_that_hangs)
+{
+    for (;;)
+    {
+        (void)sleep(1);
+    }
+}
+
+CTEST_FUNCTION(test_after_the_hang_1)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 1, 1);
+}
+
+CTEST_FUNCTION(test_after_the_hang_2)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 1, 1);
+}
+
+CTEST_END_TEST_SUITE(ctest_timeout_ut)
@@ -0,0 +1,9 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_TIMEOUT_UT_H
+#define CTEST_TIMEOUT_UT_H
+
+int ctest_timeout_ut_get_suite_cleanup_count(void);
+
+#endif /* CTEST_TIMEOUT_UT_H */
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <signal.h>
+#include <stddef.h>  // for size_t
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_timeout_ut.h"
+
+/* a hung test that runs in process aborts the process, so the suite runs in a child process */
+static size_t run_in_process_suite_in_child_process(void)
+{
+    size_t result;
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LogError("CTEST TEST FAILED !!! fork failed");
+        result = 1;
+    }
+    else if (pid == 0)
+    {
+        size_t failed_tests = 0;
+        /* the configuration is read by the first RunTests, this process did not call it yet */
+        (void)setenv("CTEST_WORKER_PROCESSES", "1", 1);
+        CTEST_RUN_TEST_SUITE(ctest_timeout_in_process_ut, failed_tests);
+        _exit(0);
+    }
+    else
+    {
+        int status;
+        if (waitpid(pid, &status, 0) != pid)
+        {
+            LogError("CTEST TEST FAILED !!! waitpid failed");
+            result = 1;
+        }
+        else if (!WIFSIGNALED(status) || (WTERMSIG(status) != SIGABRT))
+        {
+            LogError("CTEST TEST FAILED !!! ctest_timeout_in_process_ut expected the process to abort, status=%d", status);
+            result = 1;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/* CMakeLists.txt runs this executable with CTEST_WORKER_PROCESSES=2 and CTEST_TEST_TIMEOUT_MS=500 */
+int main(void)
+{
+    size_t failedTests = 0;
+
+    (void)logger_init();
+
+    failedTests += run_in_process_suite_in_child_process();
+
+    {
+        size_t temp_failed_tests = 0;
+        CTEST_RUN_TEST_SUITE(ctest_timeout_ut, temp_failed_tests);
+        if (temp_failed_tests != 1) // the hung test
+        {
+            LogError("CTEST TEST FAILED !!! ctest_timeout_ut expected 1 failed test, got %zu", temp_failed_tests);
+            failedTests++;
+        }
+        if (ctest_timeout_ut_get_suite_cleanup_count() != 1)
+        {
+            LogError("CTEST TEST FAILED !!! ctest_timeout_ut expected 1 suite cleanup, got %d", ctest_timeout_ut_get_suite_cleanup_count());
+            failedTests++;
+        }
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
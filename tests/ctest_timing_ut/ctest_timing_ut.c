@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <time.h>
+
+#include "ctest.h"
+
+#include "ctest_timing_ut.h"
+
+#if defined _MSC_VER
+#include "windows.h"
+#define ctest_timing_ut_sleep_ms(ms) Sleep(ms)
+#else
+#include <unistd.h>
+#define ctest_timing_ut_sleep_ms(ms) (void)usleep((ms) * 1000)
+#endif
+
+static volatile unsigned int g_sink;
+
+CTEST_BEGIN_TEST_SUITE(ctest_timing_ut)
+
+CTEST_FUNCTION_INITIALIZE()
+{
+    ctest_timing_ut_sleep_ms(CTEST_TIMING_UT_FIXTURE_SLEEP_MS);
+}
+
+CTEST_FUNCTION(test_that_sleeps)
+{
+    ctest_timing_ut_sleep_ms(CTEST_TIMING_UT_TEST_SLEEP_MS);
+}
+
+/* spins until the process has used the CPU for CTEST_TIMING_UT_TEST_BUSY_MS */
+CTEST_FUNCTION(test_that_keeps_the_cpu_busy)
+{
+    clock_t start = clock();
+    while ((double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC < CTEST_TIMING_UT_TEST_BUSY_MS)
+    {
+        g_sink++;
+    }
+}
+
+CTEST_FUNCTION(test_that_returns_at_once)
+{
+    g_sink++;
+}
+
+CTEST_END_TEST_SUITE(ctest_timing_ut)
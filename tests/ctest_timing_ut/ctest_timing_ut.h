@@ -0,0 +1,12 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_TIMING_UT_H
+#define CTEST_TIMING_UT_H
+
+/* the time TEST_FUNCTION_INITIALIZE sleeps, and the times the tests sleep or spend on the CPU */
+#define CTEST_TIMING_UT_FIXTURE_SLEEP_MS 10
+#define CTEST_TIMING_UT_TEST_SLEEP_MS 60
+#define CTEST_TIMING_UT_TEST_BUSY_MS 25
+
+#endif /* CTEST_TIMING_UT_H */
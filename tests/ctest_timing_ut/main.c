@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+#include "ctest_timing_ut.h"
+
+/* the timings are checked with a lot of margin, a loaded machine only makes the tests slower */
+#define CTEST_TIMING_UT_MAX_MS 5000.0
+
+static size_t check_range(const char* test_name, const char* what, double value_ms, double min_ms, double max_ms)
+{
+    size_t result = 0;
+    if ((value_ms < min_ms) || (value_ms > max_ms))
+    {
+        LogError("CTEST TEST FAILED !!! %s took %.3f ms %s, expected between %.3f and %.3f", test_name, value_ms, what, min_ms, max_ms);
+        result = 1;
+    }
+    return result;
+}
+
+/* checks the timing logged with the result of the test */
+static size_t check_test_timing(const char* test_name, double min_wall_ms, double min_cpu_ms, double max_cpu_ms)
+{
+    size_t result = 0;
+    char expected[256];
+    const char* logged;
+    double wall_ms;
+    double cpu_ms;
+    double fixture_wall_ms;
+    double fixture_cpu_ms;
+
+    (void)snprintf(expected, sizeof(expected), "Test %s result = Succeeded. (", test_name);
+    if (((logged = strstr(ctest_ut_get_captured_log(), expected)) == NULL) ||
+        (sscanf(logged + strlen(expected), "%lf ms wall, %lf ms cpu, fixtures %lf ms wall, %lf ms cpu", &wall_ms, &cpu_ms, &fixture_wall_ms, &fixture_cpu_ms) != 4))
+    {
+        LogError("CTEST TEST FAILED !!! no timing logged for %s", test_name);
+        result = 1;
+    }
+    else
+    {
+        result += check_range(test_name, "wall", wall_ms, min_wall_ms, CTEST_TIMING_UT_MAX_MS);
+        result += check_range(test_name, "cpu", cpu_ms, min_cpu_ms, max_cpu_ms);
+        /* the CPU time cannot exceed the wall time of the thread */
+        result += check_range(test_name, "cpu (relative to wall)", cpu_ms, 0.0, wall_ms + 1.0);
+        result += check_range(test_name, "fixture wall", fixture_wall_ms, CTEST_TIMING_UT_FIXTURE_SLEEP_MS * 0.9, CTEST_TIMING_UT_MAX_MS);
+        result += check_range(test_name, "fixture cpu", fixture_cpu_ms, 0.0, CTEST_TIMING_UT_FIXTURE_SLEEP_MS * 0.5);
+    }
+    return result;
+}
+
+/* the slowest tests table lists the 2 slowest tests (CTEST_SLOWEST_TESTS=2). Their order is not checked: the wall time of the spinning
+   test grows with the load of the machine and can go over the one of the sleeping test */
+static size_t check_slowest_tests(void)
+{
+    size_t result = 0;
+    const char* table = strstr(ctest_ut_get_captured_log(), " ### 2 slowest tests of ctest_timing_ut");
+    const char* sleeping_row = (table == NULL) ? NULL : strstr(table, "  test_that_sleeps\n");
+    const char* busy_row = (table == NULL) ? NULL : strstr(table, "  test_that_keeps_the_cpu_busy\n");
+    if ((table == NULL) || (sleeping_row == NULL) || (busy_row == NULL))
+    {
+        LogError("CTEST TEST FAILED !!! expected the slowest tests test_that_sleeps and test_that_keeps_the_cpu_busy in:\n%s", ctest_ut_get_captured_log());
+        result = 1;
+    }
+    if ((table != NULL) && (strstr(table, "  test_that_returns_at_once\n") != NULL))
+    {
+        LogError("CTEST TEST FAILED !!! test_that_returns_at_once is not one of the 2 slowest tests:\n%s", table);
+        result++;
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+    size_t suite_failed_tests = 0;
+
+    (void)logger_init();
+
+    ctest_ut_begin_log_capture();
+    CTEST_RUN_TEST_SUITE(ctest_timing_ut, suite_failed_tests);
+    ctest_ut_end_log_capture();
+
+    if (suite_failed_tests != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_timing_ut had %zu failed tests", suite_failed_tests);
+        failedTests++;
+    }
+
+    /* sleeping takes wall time but no CPU time, spinning takes both */
+    failedTests += check_test_timing("test_that_sleeps", CTEST_TIMING_UT_TEST_SLEEP_MS * 0.9, 0.0, CTEST_TIMING_UT_TEST_SLEEP_MS * 0.5);
+    failedTests += check_test_timing("test_that_keeps_the_cpu_busy", CTEST_TIMING_UT_TEST_BUSY_MS * 0.9, CTEST_TIMING_UT_TEST_BUSY_MS * 0.5, CTEST_TIMING_UT_MAX_MS);
+    failedTests += check_test_timing("test_that_returns_at_once", 0.0, 0.0, CTEST_TIMING_UT_MAX_MS);
+    failedTests += check_slowest_tests();
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
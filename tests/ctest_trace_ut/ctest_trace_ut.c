@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "ctest.h"
+
+CTEST_BEGIN_TEST_SUITE(ctest_trace_ut)
+
+CTEST_SUITE_INITIALIZE()
+{
+}
+
+CTEST_SUITE_CLEANUP()
+{
+}
+
+CTEST_FUNCTION_INITIALIZE()
+{
+}
+
+CTEST_FUNCTION_CLEANUP()
+{
+}
+
+CTEST_FUNCTION(test_1)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 2, 1 + 1);
+}
+
+CTEST_FUNCTION(test_2)
+{
+    CTEST_ASSERT_ARE_EQUAL(int, 2, 1 + 1);
+}
+
+CTEST_END_TEST_SUITE(ctest_trace_ut)
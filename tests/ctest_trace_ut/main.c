@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>  // for size_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest.h"
+
+#include "ctest_ut_helpers.h"
+
+/* the trace written so far (the closing ']' is written at exit) starts with the process name */
+static size_t check_trace_start(const char* path)
+{
+    size_t result = 0;
+    char* text = ctest_ut_read_file(path);
+    if (text == NULL)
+    {
+        result = 1;
+    }
+    else
+    {
+        if (strncmp(text, "[\n{\"name\":\"process_name\",\"ph\":\"M\"", 33) != 0)
+        {
+            LogError("CTEST TEST FAILED !!! expected %s to start with the process name:\n%s", path, text);
+            result++;
+        }
+        free(text);
+    }
+    return result;
+}
+
+int main(void)
+{
+    size_t failedTests = 0;
+    char* argv[] = { "ctest_trace_ut", "--ctest_trace=ctest_trace_ut.json" };
+
+    (void)logger_init();
+
+    if (ctest_parse_command_line(2, argv) != 0)
+    {
+        LogError("CTEST TEST FAILED !!! ctest_parse_command_line failed");
+        failedTests++;
+    }
+    else
+    {
+        /* two suites in the same trace */
+        for (int i = 0; i < 2; i++)
+        {
+            size_t temp_failed_tests = 0;
+            CTEST_RUN_TEST_SUITE(ctest_trace_ut, temp_failed_tests);
+            if (temp_failed_tests != 0)
+            {
+                LogError("CTEST TEST FAILED !!! ctest_trace_ut expected 0 failed tests, got %zu", temp_failed_tests);
+                failedTests++;
+            }
+        }
+
+        failedTests += check_trace_start("ctest_trace_ut.json");
+        failedTests += CTEST_UT_CHECK_FILE("ctest_trace_ut.json", 2, NULL,
+            "{\"name\":\"TEST_SUITE_INITIALIZE\",\"cat\":\"fixture\",\"ph\":\"X\",\"ts\":",
+            "{\"name\":\"TEST_SUITE_CLEANUP\",\"cat\":\"fixture\",\"ph\":\"X\",\"ts\":",
+            "{\"name\":\"test_1\",\"cat\":\"test\",\"ph\":\"X\",\"ts\":",
+            "{\"name\":\"test_2\",\"cat\":\"test\",\"ph\":\"X\",\"ts\":");
+        failedTests += CTEST_UT_CHECK_FILE("ctest_trace_ut.json", 4, NULL,
+            "{\"name\":\"TEST_FUNCTION_INITIALIZE\",\"cat\":\"fixture\",\"ph\":\"X\",\"ts\":",
+            "{\"name\":\"TEST_FUNCTION_CLEANUP\",\"cat\":\"fixture\",\"ph\":\"X\",\"ts\":");
+        /* the fixtures and the body of each run of test_1, on the thread calling RunTests */
+        failedTests += CTEST_UT_CHECK_FILE("ctest_trace_ut.json", 6, NULL,
+            ",\"tid\":1,\"args\":{\"suite\":\"ctest_trace_ut\",\"test\":\"test_1\"}}");
+    }
+
+    logger_deinit();
+
+    return (int)failedTests;
+}
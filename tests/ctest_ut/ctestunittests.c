@@ -200,6 +200,79 @@ int main()
             LogError("CTEST TEST FAILED !!! FilterTestSuite with non-existent filter should not run any tests");
             failedTests++;
         }
+        if (FilterTestSuite_GetSuiteFixtureCount() != 0)
+        {
+            LogError("CTEST TEST FAILED !!! FilterTestSuite with non-existent filter should not run the suite fixtures");
+            failedTests++;
+        }
+    }
+
+    {
+        /* Test: filters with several patterns, globs, suite qualified names and negative patterns */
+        static const struct
+        {
+            const char* filter;
+            int test1_executed;
+            int test2_executed;
+            int test3_executed;
+        } filter_cases[] =
+        {
+            { "FilterTest1,FilterTest3", 1, 0, 1 },
+            { " FilterTest1 , FilterTest3 ", 1, 0, 1 },
+            { "FilterTest*", 1, 1, 1 },
+            { "Filter*3", 0, 0, 1 },
+            { "FilterTest?", 1, 1, 1 },
+            { "*Test2*", 0, 1, 0 },
+            { "FilterTestSuite.FilterTest2", 0, 1, 0 },
+            { "FilterTest*.FilterTest?", 1, 1, 1 },
+            { "-FilterTest2", 1, 0, 1 },
+            { "FilterTest*,-FilterTest1,-*3", 0, 1, 0 },
+            { "-OtherSuite.*", 1, 1, 1 },
+            { ",,FilterTest1,", 1, 0, 0 },
+        };
+
+        for (size_t i = 0; i < sizeof(filter_cases) / sizeof(filter_cases[0]); i++)
+        {
+            size_t temp_failed_tests = 0;
+            FilterTestSuite_ResetExecutionTracking();
+            CTEST_RUN_TEST_SUITE(FilterTestSuite, temp_failed_tests, filter_cases[i].filter);
+            if (temp_failed_tests != 0)
+            {
+                LogError("CTEST TEST FAILED !!! FilterTestSuite with filter \"%s\" failed", filter_cases[i].filter);
+                failedTests++;
+            }
+            if ((FilterTestSuite_WasTest1Executed() != filter_cases[i].test1_executed) ||
+                (FilterTestSuite_WasTest2Executed() != filter_cases[i].test2_executed) ||
+                (FilterTestSuite_WasTest3Executed() != filter_cases[i].test3_executed))
+            {
+                LogError("CTEST TEST FAILED !!! FilterTestSuite with filter \"%s\" executed FilterTest1=%d FilterTest2=%d FilterTest3=%d, expected %d %d %d",
+                    filter_cases[i].filter, FilterTestSuite_WasTest1Executed(), FilterTestSuite_WasTest2Executed(), FilterTestSuite_WasTest3Executed(),
+                    filter_cases[i].test1_executed, filter_cases[i].test2_executed, filter_cases[i].test3_executed);
+                failedTests++;
+            }
+        }
+    }
+
+    {
+        /* Test: filters excluding every test do not run the suite fixtures */
+        static const char* const excluding_filters[] = { "OtherSuite.FilterTest1", "-FilterTest*", "FilterTest1,-FilterTest1", "FilterTest" };
+
+        for (size_t i = 0; i < sizeof(excluding_filters) / sizeof(excluding_filters[0]); i++)
+        {
+            size_t temp_failed_tests = 0;
+            FilterTestSuite_ResetExecutionTracking();
+            CTEST_RUN_TEST_SUITE(FilterTestSuite, temp_failed_tests, excluding_filters[i]);
+            if (temp_failed_tests != CTEST_RETURN_CODE_NO_TESTS_RAN)
+            {
+                LogError("CTEST TEST FAILED !!! FilterTestSuite with filter \"%s\" should return CTEST_RETURN_CODE_NO_TESTS_RAN, got %zu", excluding_filters[i], temp_failed_tests);
+                failedTests++;
+            }
+            if (FilterTestSuite_GetSuiteFixtureCount() != 0)
+            {
+                LogError("CTEST TEST FAILED !!! FilterTestSuite with filter \"%s\" should not run the suite fixtures", excluding_filters[i]);
+                failedTests++;
+            }
+        }
     }
 
     logger_deinit();
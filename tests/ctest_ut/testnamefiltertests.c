@@ -7,6 +7,7 @@
 static int g_FilterTestSuiteTest1_was_executed = 0;
 static int g_FilterTestSuiteTest2_was_executed = 0;
 static int g_FilterTestSuiteTest3_was_executed = 0;
+static int g_FilterTestSuite_suite_fixture_count = 0;
 
 /* Function to reset execution tracking */
 void FilterTestSuite_ResetExecutionTracking(void)
@@ -14,6 +15,7 @@ void FilterTestSuite_ResetExecutionTracking(void)
     g_FilterTestSuiteTest1_was_executed = 0;
     g_FilterTestSuiteTest2_was_executed = 0;
     g_FilterTestSuiteTest3_was_executed = 0;
+    g_FilterTestSuite_suite_fixture_count = 0;
 }
 
 /* Function to check which tests were executed */
@@ -32,8 +34,23 @@ int FilterTestSuite_WasTest3Executed(void)
     return g_FilterTestSuiteTest3_was_executed;
 }
 
+int FilterTestSuite_GetSuiteFixtureCount(void)
+{
+    return g_FilterTestSuite_suite_fixture_count;
+}
+
 CTEST_BEGIN_TEST_SUITE(FilterTestSuite)
 
+CTEST_SUITE_INITIALIZE()
+{
+    g_FilterTestSuite_suite_fixture_count++;
+}
+
+CTEST_SUITE_CLEANUP()
+{
+    g_FilterTestSuite_suite_fixture_count++;
+}
+
 CTEST_FUNCTION(FilterTest1)
 {
     g_FilterTestSuiteTest1_was_executed = 1;
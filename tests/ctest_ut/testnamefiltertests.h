@@ -9,5 +9,7 @@ void FilterTestSuite_ResetExecutionTracking(void);
 int FilterTestSuite_WasTest1Executed(void);
 int FilterTestSuite_WasTest2Executed(void);
 int FilterTestSuite_WasTest3Executed(void);
+/* number of TEST_SUITE_INITIALIZE and TEST_SUITE_CLEANUP calls */
+int FilterTestSuite_GetSuiteFixtureCount(void);
 
 #endif /* TESTNAMEFILTERTESTS_H */
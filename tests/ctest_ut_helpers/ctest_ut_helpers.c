@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c_logging/logger.h"
+
+#include "ctest_ut_helpers.h"
+
+char* ctest_ut_read_file(const char* path)
+{
+    char* result = NULL;
+    FILE* file;
+#if defined _MSC_VER
+    if (fopen_s(&file, path, "rb") != 0)
+    {
+        file = NULL;
+    }
+#else
+    file = fopen(path, "rb");
+#endif
+    if (file == NULL)
+    {
+        LogError("CTEST TEST FAILED !!! cannot open %s", path);
+    }
+    else
+    {
+        size_t capacity = 4096;
+        size_t length = 0;
+        result = malloc(capacity);
+        while (result != NULL)
+        {
+            length += fread(result + length, 1, capacity - length - 1, file);
+            if (length < capacity - 1)
+            {
+                result[length] = '\0';
+                break;
+            }
+            capacity *= 2;
+            char* new_result = realloc(result, capacity);
+            if (new_result == NULL)
+            {
+                free(result);
+            }
+            result = new_result;
+        }
+        (void)fclose(file);
+    }
+    return result;
+}
+
+size_t ctest_ut_count_occurrences(const char* text, const char* expected)
+{
+    size_t result = 0;
+    for (const char* found = strstr(text, expected); found != NULL; found = strstr(found + 1, expected))
+    {
+        result++;
+    }
+    return result;
+}
+
+size_t ctest_ut_check_file(const char* path, const char* const* expected, size_t expected_count, size_t count, const char* expected_end)
+{
+    size_t result = 0;
+    char* text = ctest_ut_read_file(path);
+    if (text == NULL)
+    {
+        result = 1;
+    }
+    else
+    {
+        for (size_t i = 0; i < expected_count; i++)
+        {
+            size_t found_count = ctest_ut_count_occurrences(text, expected[i]);
+            if ((count == CTEST_UT_AT_LEAST_ONCE) ? (found_count == 0) : (found_count != count))
+            {
+                if (count == CTEST_UT_AT_LEAST_ONCE)
+                {
+                    LogError("CTEST TEST FAILED !!! expected %s in %s:\n%s", expected[i], path, text);
+                }
+                else
+                {
+                    LogError("CTEST TEST FAILED !!! expected %s %zu times in %s, found it %zu times:\n%s", expected[i], count, path, found_count, text);
+                }
+                result++;
+            }
+        }
+        if (expected_end != NULL)
+        {
+            size_t text_length = strlen(text);
+            size_t end_length = strlen(expected_end);
+            if ((text_length < end_length) || (strcmp(text + text_length - end_length, expected_end) != 0))
+            {
+                LogError("CTEST TEST FAILED !!! expected %s to end with %s:\n%s", path, expected_end, text);
+                result++;
+            }
+        }
+        free(text);
+    }
+    return result;
+}
+
+static char g_captured_log[1024 * 1024];
+static size_t g_captured_log_length = 0;
+static LOGGER_CONFIG g_original_logger_config;
+
+static void ctest_ut_capture_log(LOG_LEVEL log_level, LOG_CONTEXT_HANDLE log_context, const char* file, const char* func, int line_no, const char* message_format, ...)
+{
+    (void)log_level;
+    (void)log_context;
+    (void)file;
+    (void)func;
+    (void)line_no;
+    if (g_captured_log_length < sizeof(g_captured_log) - 1)
+    {
+        va_list args;
+        va_start(args, message_format);
+        int length = vsnprintf(g_captured_log + g_captured_log_length, sizeof(g_captured_log) - g_captured_log_length - 1, message_format, args);
+        va_end(args);
+        if (length > 0)
+        {
+            g_captured_log_length += (size_t)length;
+            if (g_captured_log_length > sizeof(g_captured_log) - 2)
+            {
+                g_captured_log_length = sizeof(g_captured_log) - 2;
+            }
+            g_captured_log[g_captured_log_length++] = '\n';
+            g_captured_log[g_captured_log_length] = '\0';
+        }
+    }
+}
+
+static const LOG_SINK_IF g_capture_sink = { NULL, NULL, ctest_ut_capture_log };
+static const LOG_SINK_IF* g_capture_sinks[] = { &g_capture_sink };
+
+void ctest_ut_begin_log_capture(void)
+{
+    LOGGER_CONFIG capture_config = { 1, g_capture_sinks };
+    g_captured_log_length = 0;
+    g_captured_log[0] = '\0';
+    g_original_logger_config = logger_get_config();
+    logger_set_config(capture_config);
+}
+
+void ctest_ut_end_log_capture(void)
+{
+    logger_set_config(g_original_logger_config);
+}
+
+const char* ctest_ut_get_captured_log(void)
+{
+    return g_captured_log;
+}
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CTEST_UT_HELPERS_H
+#define CTEST_UT_HELPERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* the content of the file at path, NUL terminated, to free. NULL (logged as a test failure) when it cannot be read */
+char* ctest_ut_read_file(const char* path);
+
+/* the number of times expected is in text */
+size_t ctest_ut_count_occurrences(const char* text, const char* expected);
+
+/* for ctest_ut_check_file: each expected string is in the file at least once */
+#define CTEST_UT_AT_LEAST_ONCE SIZE_MAX
+
+/* checks that the file at path has each of expected count times (CTEST_UT_AT_LEAST_ONCE: any number of times but 0) and, when
+   expected_end is not NULL, ends with it (a complete document). Returns the number of failed checks, logged as test failures */
+size_t ctest_ut_check_file(const char* path, const char* const* expected, size_t expected_count, size_t count, const char* expected_end);
+
+#define CTEST_UT_CHECK_FILE(path, count, expected_end, ...) \
+    ctest_ut_check_file(path, (const char* const[]) { __VA_ARGS__ }, sizeof((const char* const[]) { __VA_ARGS__ }) / sizeof(const char*), count, expected_end)
+
+/* between ctest_ut_begin_log_capture and ctest_ut_end_log_capture what is logged only goes to memory, one message per line, returned
+   by ctest_ut_get_captured_log until the next capture begins */
+void ctest_ut_begin_log_capture(void);
+void ctest_ut_end_log_capture(void);
+const char* ctest_ut_get_captured_log(void);
+
+#endif /* CTEST_UT_HELPERS_H */